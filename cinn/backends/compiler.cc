@@ -11,19 +11,42 @@
 #endif
 
 namespace cinn {
+
+DEFINE_string(cinn_compile_cache_dir, "", "The directory of the on-disk compilation cache, disabled if empty.");
+DEFINE_int32(cinn_num_compile_threads, 1, "The number of threads to compile the functions of a X86 module with.");
+DEFINE_bool(cinn_lazy_compile, false, "Whether to compile the functions of a X86 module on their first calls.");
+
 namespace backends {
 using ir::Module;
 
-void Compiler::Build(const Module& module, const std::string& code) {
+namespace {
+ExecutionOptions DefaultExecutionOptions() {
+  ExecutionOptions options;
+  options.object_cache_dir    = FLAGS_cinn_compile_cache_dir;
+  options.num_compile_threads = FLAGS_cinn_num_compile_threads;
+  options.lazy_compile        = FLAGS_cinn_lazy_compile;
+  return options;
+}
+}  // namespace
+
+Compiler::Compiler(const Target& target)
+    : target_(target), engine_(ExecutionEngine::Create(DefaultExecutionOptions())) {}
+
+void Compiler::Build(const Module& module, const std::string& code, const std::string& signature) {
   if (target_.arch == Target::Arch::NVGPU) {
     CompileCudaModule(module, code);
   } else if (target_.arch == Target::Arch::X86) {
-    CompileX86Module(module);
+    CompileX86Module(module, signature);
   } else {
     CINN_NOT_IMPLEMENTED
   }
 }
 
+bool Compiler::BuildFromCache(const std::string& signature) {
+  if (target_.arch != Target::Arch::X86) return false;
+  return engine_->LinkCachedObject(signature);
+}
+
 std::string Compiler::GetSourceCode(const ir::Module& module) {
   if (target_.arch == Target::Arch::NVGPU) {
 #ifdef CINN_WITH_CUDA
@@ -83,7 +106,7 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
   }
 
   {  // compile host jit
-    engine_ = ExecutionEngine::Create(ExecutionOptions());
+    engine_ = ExecutionEngine::Create(DefaultExecutionOptions());
     engine_->Link<CodeGenCUDA_Host>(host_module);
   }
 
@@ -92,7 +115,9 @@ void Compiler::CompileCudaModule(const Module& module, const std::string& code)
 #endif
 }
 
-void Compiler::CompileX86Module(const Module& module) { engine_->Link<CodeGenX86>(module); }
+void Compiler::CompileX86Module(const Module& module, const std::string& signature) {
+  engine_->Link<CodeGenX86>(module, signature);
+}
 
 lower_func_ptr_t Compiler::Lookup(std::string_view fn_name) {
   CHECK(engine_);
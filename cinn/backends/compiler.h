@@ -1,5 +1,7 @@
 #pragma once
 
+#include <gflags/gflags.h>
+
 #include <memory>
 #include <string>
 #include <string_view>
@@ -13,6 +15,11 @@
 #endif
 
 namespace cinn {
+
+DECLARE_string(cinn_compile_cache_dir);
+DECLARE_int32(cinn_num_compile_threads);
+DECLARE_bool(cinn_lazy_compile);
+
 namespace backends {
 
 class Compiler final {
@@ -23,15 +30,25 @@ class Compiler final {
 
   /**
    * Compile and link to a CINN module.
+   * @param module The module to compile.
+   * @param code The CUDA source code to use instead of the generated one, only for NVGPU.
+   * @param signature The content identifying \p module in the on-disk compilation cache, only for X86.
+   */
+  void Build(const ir::Module& module, const std::string& code = "", const std::string& signature = "");
+
+  /**
+   * Link the objects compiled earlier, possibly by another process, for \p signature. It skips the codegen entirely.
+   * @return false if the on-disk compilation cache(FLAGS_cinn_compile_cache_dir) is disabled or misses.
    */
-  void Build(const ir::Module& module, const std::string& code = "");
+  bool BuildFromCache(const std::string& signature);
 
   std::string GetSourceCode(const ir::Module& module);
 
   void BuildDefault(const ir::Module& module);
 
   /**
-   * Retrieve a function by \p fn_name.
+   * Retrieve a function by \p fn_name. With FLAGS_cinn_lazy_compile, a X86 function is a stub compiling the function
+   * on its first call.
    * @return function address or null if not exists.
    */
   lower_func_ptr_t Lookup(std::string_view fn_name);
@@ -39,9 +56,9 @@ class Compiler final {
  private:
   void CompileCudaModule(const ir::Module& module, const std::string& code = "");
 
-  void CompileX86Module(const ir::Module& module);
+  void CompileX86Module(const ir::Module& module, const std::string& signature = "");
 
-  explicit Compiler(const Target& target) : target_(target), engine_(ExecutionEngine::Create(ExecutionOptions())) {}
+  explicit Compiler(const Target& target);
 
   CINN_DISALLOW_COPY_AND_ASSIGN(Compiler);
 
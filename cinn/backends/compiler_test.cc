@@ -1,9 +1,15 @@
 #include "cinn/backends/compiler.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
 
+#include <regex>
 #include <vector>
 
+#include "cinn/backends/llvm/execution_engine.h"
 #include "cinn/cinn.h"
 #include "cinn/common/test_helper.h"
 #include "cinn/hlir/pe/elementwise.h"
@@ -59,6 +65,131 @@ TEST(Compiler, x86) {
   }
 }
 
+TEST(Compiler, x86_compile_cache) {
+  Expr M(32), N(32);
+
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  auto C = Compute(
+      {M, N}, [=](Expr i, Expr j) { return A(i, j) * B(i, j); }, "C");
+
+  auto stages = CreateStages({C});
+  auto fn     = Lower("fn_cached", stages, {A, B, C});
+
+  ir::Module::Builder builder("cached_module", common::DefaultHostTarget());
+  builder.AddFunction(fn);
+
+  gflags::FlagSaver flag_saver;
+  llvm::SmallString<128> cache_dir;
+  llvm::sys::path::system_temp_directory(/*ErasedOnReboot=*/true, cache_dir);
+  llvm::sys::path::append(cache_dir, "compile_cache_test");
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(cache_dir, cache_dir));
+  FLAGS_cinn_compile_cache_dir = cache_dir.str().str();
+  const std::string signature  = "x86_compile_cache";
+
+  {  // cold start, compile and persist the object.
+    auto compiler = Compiler::Create(common::DefaultHostTarget());
+    ASSERT_FALSE(compiler->BuildFromCache(signature));
+    compiler->Build(builder.Build(), "", signature);
+    ASSERT_TRUE(compiler->Lookup("fn_cached"));
+  }
+
+  // warm start, link the persisted object only.
+  auto compiler = Compiler::Create(common::DefaultHostTarget());
+  ASSERT_TRUE(compiler->BuildFromCache(signature));
+  llvm::sys::fs::remove_directories(FLAGS_cinn_compile_cache_dir);
+
+  auto* fnp = compiler->Lookup("fn_cached");
+  ASSERT_TRUE(fnp);
+
+  auto* Ab = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_random().Build();
+  auto* Bb = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_random().Build();
+  auto* Cb = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_zero().Build();
+
+  auto args = common::ArgsBuilder().Add(Ab).Add(Bb).Add(Cb).Build();
+  fnp(args.data(), args.size());
+
+  auto* Ad = reinterpret_cast<float*>(Ab->memory);
+  auto* Bd = reinterpret_cast<float*>(Bb->memory);
+  auto* Cd = reinterpret_cast<float*>(Cb->memory);
+  for (int i = 0; i < Ab->num_elements(); i++) {
+    ASSERT_NEAR(Ad[i] * Bd[i], Cd[i], 1e-5);
+  }
+}
+
+TEST(Compiler, x86_parallel_compile) {
+  Expr M(64), N(64);
+
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  auto C = Compute(
+      {M, N}, [=](Expr i, Expr j) { return A(i, j) + B(i, j); }, "C");
+  auto D = Compute(
+      {M, N}, [=](Expr i, Expr j) { return lang::Sqrt(A(i, j)) * B(i, j); }, "D");
+
+  auto create_module = [&]() {
+    auto stages0 = CreateStages({C});
+    auto stages1 = CreateStages({D});
+    stages1[D]->Vectorize(1, 8);
+    ir::Module::Builder builder("parallel_module", common::DefaultHostTarget());
+    builder.AddFunction(Lower("fn_add", stages0, {A, B, C}));
+    builder.AddFunction(Lower("fn_sqrt_mul", stages1, {A, B, D}));
+    return builder.Build();
+  };
+
+  // The concurrent compilation should emit exactly the same code. The numbers of the attribute groups and the metadata
+  // depend on the other functions in the same LLVM module, so they are left out.
+  auto optimized_ir = [&](int num_compile_threads, const std::string& fn_name) {
+    ExecutionOptions options;
+    options.num_compile_threads = num_compile_threads;
+    options.keep_optimized_ir   = true;
+    auto engine                 = ExecutionEngine::Create(options);
+    engine->Link<CodeGenX86>(create_module());
+    static const std::regex numbered(R"([#!][0-9]+)");
+    return std::regex_replace(engine->GetOptimizedIR(fn_name), numbered, "");
+  };
+  for (auto& fn_name : {"fn_add", "fn_sqrt_mul"}) {
+    ASSERT_EQ(optimized_ir(1, fn_name), optimized_ir(4, fn_name)) << fn_name;
+  }
+
+  auto run = [&](int num_compile_threads) {
+    gflags::FlagSaver flag_saver;
+    FLAGS_cinn_num_compile_threads = num_compile_threads;
+    auto compiler                  = Compiler::Create(common::DefaultHostTarget());
+    compiler->Build(create_module());
+
+    srand(0);
+    auto* Ab = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_random().Build();
+    auto* Bb = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_random().Build();
+    auto* Cb = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_zero().Build();
+    auto* Db = common::BufferBuilder(Float(32), {M.as_int32(), N.as_int32()}).set_zero().Build();
+
+    auto* fn_add      = compiler->Lookup("fn_add");
+    auto* fn_sqrt_mul = compiler->Lookup("fn_sqrt_mul");
+    CHECK(fn_add);
+    CHECK(fn_sqrt_mul);
+    auto args0 = common::ArgsBuilder().Add(Ab).Add(Bb).Add(Cb).Build();
+    auto args1 = common::ArgsBuilder().Add(Ab).Add(Bb).Add(Db).Build();
+    fn_add(args0.data(), args0.size());
+    fn_sqrt_mul(args1.data(), args1.size());
+
+    auto* Cd = reinterpret_cast<float*>(Cb->memory);
+    auto* Dd = reinterpret_cast<float*>(Db->memory);
+    std::vector<float> res(Cd, Cd + Cb->num_elements());
+    res.insert(res.end(), Dd, Dd + Db->num_elements());
+    return res;
+  };
+
+  auto serial   = run(1);
+  auto parallel = run(4);
+  ASSERT_EQ(FLAGS_cinn_num_compile_threads, 1);
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (int i = 0; i < serial.size(); i++) {
+    // The same code computes bitwise identical results.
+    ASSERT_EQ(serial[i], parallel[i]) << i;
+  }
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(Compiler, cuda) {
   Expr M(1024), N(1024);
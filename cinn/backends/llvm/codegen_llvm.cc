@@ -8,6 +8,7 @@
 #include <llvm/IR/Intrinsics.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Metadata.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
 
@@ -54,6 +55,15 @@ bool is_integral_type(common::Type t) { return t.is_int() || t.is_uint(); }
 
 bool is_floating_type(common::Type t) { return t.is_float(); }
 
+//! Whether the host converts float32 to bfloat16 with the instructions of AVX-512 BF16.
+bool HostHasAVX512BF16() {
+  static bool has_bf16 = [] {
+    llvm::StringMap<bool> features;
+    return llvm::sys::getHostCPUFeatures(features) && features.lookup("avx512bf16");
+  }();
+  return has_bf16;
+}
+
 llvm::Value *EmitComparison(llvm::CmpInst::Predicate predicate,
                             llvm::Value *lhs,
                             llvm::Value *rhs,
@@ -215,7 +225,13 @@ llvm::Value *CodeGenLLVM::Visit(const ir::UIntImm *op) {
   return llvm::ConstantInt::get(type, op->value, false);
 }
 
-llvm::Value *CodeGenLLVM::Visit(const ir::FloatImm *op) { return llvm::ConstantFP::get(b_->getFloatTy(), op->value); }
+llvm::Value *CodeGenLLVM::Visit(const ir::FloatImm *op) {
+  if (op->type().is_bfloat16()) {
+    return llvm::ConstantInt::get(CinnTypeToLLVMType(op->type(), m_), common::bfloat16(op->value).x);
+  }
+  if (op->type().is_float16()) return llvm::ConstantFP::get(b_->getHalfTy(), op->value);
+  return llvm::ConstantFP::get(b_->getFloatTy(), op->value);
+}
 
 llvm::Value *CodeGenLLVM::LLVMGenGlobalStringVar(const std::string &data) { return b_->CreateGlobalStringPtr(data); }
 
@@ -318,8 +334,8 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
   auto from = op->v().type();
   auto to   = op->type();
 
-  llvm::Type *source = CinnTypeToLLVMType(from, m_);
-  llvm::Type *target = CinnTypeToLLVMType(to, m_);
+  llvm::Type *source = CinnTypeToLLVMType(from, m_, true);
+  llvm::Type *target = CinnTypeToLLVMType(to, m_, true);
   CHECK(source) << "source ir type is null";
   CHECK(target) << "target ir type is null";
 
@@ -354,6 +370,20 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
     return Call(callee, std::vector<llvm::Value *>({value}), "pod_value_cast");
   }
 
+  // The bfloat16 is cast through the float32, whose upper half it is. It is an i16 in LLVM, so it can not be told from
+  // an int16 by the LLVM types below.
+  if (from.is_bfloat16() && to.is_bfloat16()) return value;
+  if (from.is_bfloat16()) {
+    value  = EmitBFloat16ToFloat(value, from.lanes());
+    from   = Float(32, from.lanes());
+    source = value->getType();
+  }
+  const bool to_bfloat16 = to.is_bfloat16();
+  if (to_bfloat16) {
+    to     = Float(32, to.lanes());
+    target = CinnTypeToLLVMType(to, m_, true);
+  }
+
   do {
     if (value->getType() == target) break;
 
@@ -401,13 +431,38 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
       break;
     }
 
-    CHECK(from.is_float() && to.is_float());
+    CHECK(from.is_float() && to.is_float()) << "Can not cast " << op->v().type() << " to " << op->type();
     value = FPCast(value, target);
   } while (false);
 
+  if (to_bfloat16) value = EmitFloatToBFloat16(value, to.lanes());
   return value;
 }
 
+llvm::Value *CodeGenLLVM::EmitBFloat16ToFloat(llvm::Value *value, int lanes) {
+  // The bits of a bfloat16 are the upper half of the ones of the float.
+  llvm::Type *i32   = CinnTypeToLLVMType(Int(32, lanes), m_, true);
+  llvm::Value *bits = b_->CreateShl(b_->CreateZExt(value, i32), llvm::ConstantInt::get(i32, 16));
+  return BitCast(bits, CinnTypeToLLVMType(Float(32, lanes), m_, true));
+}
+
+llvm::Value *CodeGenLLVM::EmitFloatToBFloat16(llvm::Value *value, int lanes) {
+  llvm::Type *i16 = CinnTypeToLLVMType(BFloat(16, lanes), m_, true);
+  if (lanes == 16 && HostHasAVX512BF16()) {
+    // vcvtneps2bf16, which rounds to the nearest even as well.
+    return Call(llvm::Intrinsic::getDeclaration(m_, llvm::Intrinsic::x86_avx512bf16_cvtneps2bf16_512), {value});
+  }
+  llvm::Type *i32   = CinnTypeToLLVMType(Int(32, lanes), m_, true);
+  llvm::Value *bits = BitCast(value, i32);
+  // Round to the nearest even, by adding 0x7fff and the lowest bit kept before truncating the lower half.
+  llvm::Value *half    = llvm::ConstantInt::get(i32, 16);
+  llvm::Value *odd     = b_->CreateAnd(b_->CreateLShr(bits, half), llvm::ConstantInt::get(i32, 1));
+  llvm::Value *rounded = b_->CreateAdd(b_->CreateAdd(bits, llvm::ConstantInt::get(i32, 0x7fff)), odd);
+  llvm::Value *res     = b_->CreateTrunc(b_->CreateLShr(rounded, half), i16);
+  // A nan would be rounded to an inf, it is a quiet nan instead.
+  return Select(b_->CreateFCmpUNO(value, value), llvm::ConstantInt::get(i16, 0x7fc0), res);
+}
+
 llvm::Value *CodeGenLLVM::CreateSerialFor(const ir::For *op, int stride) {
   SymbolTableGuard symbol_table_guard(*symbol_table_);
 
@@ -183,6 +183,12 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::Value *CreateBufferVecPtr(Type t, llvm::Value *buffer, llvm::Value *index);
   llvm::Value *CreateVecSlice(llvm::Value *vec, int begin, int lanes);
 
+  //! Convert between bfloat16, which is kept as i16 since it is not computed by LLVM, and float32.
+  // @{
+  llvm::Value *EmitBFloat16ToFloat(llvm::Value *value, int lanes);
+  llvm::Value *EmitFloatToBFloat16(llvm::Value *value, int lanes);
+  // @}
+
   llvm::Value *DenseVectorLoad(const ir::Load *load);
   llvm::Value *CreateSerialFor(const ir::For *op, int stride = 1);
 
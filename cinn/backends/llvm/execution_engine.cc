@@ -1,7 +1,9 @@
 #include "cinn/backends/llvm/execution_engine.h"
 
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/AsmParser/Parser.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/Core.h>
@@ -19,8 +21,10 @@
 #include <llvm/PassRegistry.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
 #include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA1.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
@@ -33,14 +37,18 @@
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
 
+#include <atomic>
 #include <cmath>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "cinn/backends/codegen_cuda_host.h"
+#include "cinn/backends/llvm/cinn_build_id.h"
 #include "cinn/backends/llvm/cinn_runtime_llvm_ir.h"
 #include "cinn/backends/llvm/codegen_llvm.h"
 #include "cinn/backends/llvm/codegen_x86.h"
@@ -49,6 +57,8 @@
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/profiler.h"
+#include "cinn/utils/string.h"
 
 namespace cinn::backends {
 namespace {
@@ -71,23 +81,148 @@ void InitializeLLVMPasses() {
   // llvm::initializeTarget(registry);
   // llvm::initializeCodeGenPreparePass(registry);
 }
+
+//! Load the runtime into \p ctx lazily, the body of a function is read only when it is materialized.
+std::unique_ptr<llvm::Module> LoadRuntime(llvm::LLVMContext *ctx) {
+  auto buffer = llvm::MemoryBuffer::getMemBuffer(AsStringRef(backends::kRuntimeLlvmBitcode), "cinn_runtime", false);
+  return llvm::cantFail(llvm::getOwningLazyBitcodeModule(std::move(buffer), *ctx));
+}
+
+//! Emit \p module into a new LLVM module holding the runtime functions it calls too.
+template <typename CodeGenT>
+std::unique_ptr<llvm::Module> EmitModule(const ir::Module &module, llvm::LLVMContext *ctx) {
+  utils::RecordEvent event("EmitLLVMIR", "llvm");
+  auto m = LoadRuntime(ctx);
+  std::vector<llvm::GlobalValue *> runtime;
+  for (auto &fn : *m) {
+    if (fn.isMaterializable()) runtime.push_back(&fn);
+  }
+  for (auto &var : m->globals()) {
+    if (!var.isDeclaration() && !var.getName().startswith("llvm.")) runtime.push_back(&var);
+  }
+
+  auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
+  auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
+  VLOG(3) << "ir_emitter->Compile(module) Begin";
+  ir_emitter->Compile(module);
+  VLOG(3) << "ir_emitter->Compile(module) Succeed!";
+
+  // Materialize the runtime functions called, transitively, and leave the others as declarations.
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto &fn : *m) {
+      if (fn.isMaterializable() && !fn.use_empty()) {
+        llvm::cantFail(fn.materialize());
+        changed = true;
+      }
+    }
+  }
+  for (auto &fn : *m) {
+    if (fn.isMaterializable()) fn.deleteBody();
+  }
+  llvm::cantFail(m->materializeAll());
+  // Each module holds a private copy of the runtime it calls, so the modules linked into a JIT never clash and the
+  // optimizer is free to inline and drop them.
+  for (auto *value : runtime) {
+    if (value->isDeclaration()) continue;
+    value->setLinkage(llvm::GlobalValue::InternalLinkage);
+    if (auto *object = llvm::dyn_cast<llvm::GlobalObject>(value)) object->setComdat(nullptr);
+  }
+
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
+  // The in-memory object cache is keyed by the module identifier.
+  m->setModuleIdentifier(module->name);
+  return m;
+}
+
+std::unique_ptr<llvm::TargetMachine> CreateHostMachine() {
+  return llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine());
+}
+
+void OptimizeModule(llvm::Module *m, LLVMModuleOptimizer *optimize) {
+  utils::RecordEvent event("LLVMOptimize", "llvm");
+  (*optimize)(m);
+  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
+}
+
+/**
+ * Record the compilation of the modules to objects by the build profiler, on the threads the JIT compiles on, and
+ * count them into \p num_compiled.
+ */
+class ProfiledIRCompiler : public llvm::orc::IRCompileLayer::IRCompiler {
+ public:
+  ProfiledIRCompiler(std::unique_ptr<IRCompiler> compiler, std::atomic<int> *num_compiled)
+      : IRCompiler(compiler->getManglingOptions()), compiler_(std::move(compiler)), num_compiled_(num_compiled) {}
+
+  llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(llvm::Module &m) override {
+    utils::RecordEvent event("EmitObject", "llvm");
+    (*num_compiled_)++;
+    return (*compiler_)(m);
+  }
+
+ private:
+  std::unique_ptr<IRCompiler> compiler_;
+  std::atomic<int> *num_compiled_;
+};
+
 }  // namespace
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
-  cached_objects_[m->getModuleIdentifier()] =
-      llvm::MemoryBuffer::getMemBufferCopy(obj_buffer.getBuffer(), obj_buffer.getBufferIdentifier());
+  const auto &key = m->getModuleIdentifier();
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    cached_objects_[key] =
+        llvm::MemoryBuffer::getMemBufferCopy(obj_buffer.getBuffer(), obj_buffer.getBufferIdentifier());
+  }
+  if (!persistent()) return;
+
+  // Write to a unique temporary file and rename it, so that the processes sharing the cache directory never see a
+  // partially written object.
+  if (auto ec = llvm::sys::fs::create_directories(cache_dir_)) {
+    LOG(WARNING) << "Failed to create the object cache directory [" << cache_dir_ << "]: " << ec.message();
+    return;
+  }
+  const std::string path = ObjectPath(key);
+  int fd;
+  llvm::SmallString<128> tmp_path;
+  if (auto ec = llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tmp_path)) {
+    LOG(WARNING) << "Failed to persist the object of " << key << ": " << ec.message();
+    return;
+  }
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << obj_buffer.getBuffer();
+  }
+  if (auto ec = llvm::sys::fs::rename(tmp_path, path)) {
+    LOG(WARNING) << "Failed to persist the object of " << key << ": " << ec.message();
+    llvm::sys::fs::remove(tmp_path);
+    return;
+  }
+  VLOG(1) << "Object for " << key << " persisted to " << path;
 }
 
 std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Module *m) {
-  auto it = cached_objects_.find(m->getModuleIdentifier());
+  return getObject(m->getModuleIdentifier());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(llvm::StringRef key) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = cached_objects_.find(key);
+  if (it == cached_objects_.end() && persistent()) {
+    if (auto buffer = llvm::MemoryBuffer::getFile(ObjectPath(key))) {
+      it = cached_objects_.try_emplace(key, std::move(*buffer)).first;
+    }
+  }
   if (it == cached_objects_.end()) {
-    VLOG(1) << "No object for " << m->getModuleIdentifier() << " in cache. Compiling.";
+    VLOG(1) << "No object for " << key.str() << " in cache. Compiling.";
     return nullptr;
   }
 
-  LOG(INFO) << "Object for " << m->getModuleIdentifier() << " loaded from cache.";
+  LOG(INFO) << "Object for " << key.str() << " loaded from cache.";
   return llvm::MemoryBuffer::getMemBuffer(it->second->getMemBufferRef());
 }
 
+std::string NaiveObjectCache::ObjectPath(llvm::StringRef key) const { return cache_dir_ + "/" + key.str() + ".o"; }
+
 /*static*/ std::unique_ptr<ExecutionEngine> ExecutionEngine::Create(const ExecutionOptions &config) {
   VLOG(1) << "===================== Create CINN ExecutionEngine begin ====================";
   VLOG(1) << "initialize llvm config";
@@ -97,15 +232,34 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   llvm::InitializeNativeTargetAsmPrinter();
   InitializeLLVMPasses();
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  auto engine = std::unique_ptr<ExecutionEngine>(new ExecutionEngine(config));
+  // A TargetMachine is not thread-safe, so each compile thread optimizes with its own.
+  for (int i = 0; i < std::max(1, config.num_compile_threads); i++) {
+    engine->machines_.push_back(CreateHostMachine());
+    engine->optimizers_.push_back(
+        std::make_unique<LLVMModuleOptimizer>(engine->machines_.back().get(), config.opt_level, llvm::FastMathFlags()));
+    engine->idle_optimizers_.push_back(engine->optimizers_.back().get());
+  }
+  if (config.num_compile_threads > 1) {
+    engine->compile_pool_ = std::make_unique<utils::ThreadPool>(config.num_compile_threads);
+  }
 
   auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+    // The lazily compiled modules are compiled on the threads calling them, maybe concurrently.
+    if (engine->options_.num_compile_threads > 1 || engine->options_.lazy_compile) {
+      VLOG(1) << "create llvm concurrent compile layer";
+      return std::make_unique<ProfiledIRCompiler>(
+          std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), engine->cache_.get()),
+          &engine->num_compiled_modules_);
+    }
     auto machine = llvm::cantFail(jtmb.createTargetMachine());
     VLOG(1) << "create llvm compile layer";
     VLOG(1) << "Target Name: " << machine->getTarget().getName();
     VLOG(1) << "Target CPU: " << machine->getTargetCPU().str() << std::endl;
-    return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(machine), engine->cache_.get());
+    return std::make_unique<ProfiledIRCompiler>(
+        std::make_unique<llvm::orc::TMOwningSimpleCompiler>(std::move(machine), engine->cache_.get()),
+        &engine->num_compiled_modules_);
   };
 
   auto object_layer_creator = [&](llvm::orc::ExecutionSession &session, const llvm::Triple &triple) {
@@ -119,10 +273,34 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   };
 
   VLOG(2) << "create jit execution engine";
-  engine->jit_ = llvm::cantFail(llvm::orc::LLJITBuilder()
-                                    .setCompileFunctionCreator(compile_layer_creator)
-                                    .setObjectLinkingLayerCreator(object_layer_creator)
-                                    .create());
+  const int num_compile_threads = config.num_compile_threads > 1 ? config.num_compile_threads : 0;
+  auto setup_builder            = [&](auto &builder) {
+    builder.setCompileFunctionCreator(compile_layer_creator)
+        .setObjectLinkingLayerCreator(object_layer_creator)
+        .setNumCompileThreads(num_compile_threads);
+  };
+  if (config.lazy_compile) {
+    llvm::orc::LLLazyJITBuilder builder;
+    setup_builder(builder);
+    auto jit = llvm::cantFail(builder.create());
+    // The modules are split by the functions on linking already.
+    jit->setPartitionFunction(llvm::orc::CompileOnDemandLayer::compileWholeModule);
+    engine->lazy_jit_ = jit.get();
+    engine->jit_      = std::move(jit);
+    auto optimize = [engine = engine.get()](llvm::orc::ThreadSafeModule tsm,
+                                            auto &) -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+      tsm.withModuleDo([&](llvm::Module &m) {
+        std::lock_guard<std::mutex> lock(engine->lazy_optimize_mu_);
+        OptimizeModule(&m, engine->optimizers_[0].get());
+      });
+      return std::move(tsm);
+    };
+    engine->jit_->getIRTransformLayer().setTransform(std::move(optimize));
+  } else {
+    llvm::orc::LLJITBuilder builder;
+    setup_builder(builder);
+    engine->jit_ = llvm::cantFail(builder.create());
+  }
   engine->jit_->getMainJITDylib().addGenerator(llvm::cantFail(
       llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(engine->jit_->getDataLayout().getGlobalPrefix())));
 
@@ -135,22 +313,36 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
 }
 
 template <typename CodeGenT>
-void ExecutionEngine::Link(const ir::Module &module) {
-  llvm::SMDiagnostic error;
-  auto ctx        = std::make_unique<llvm::LLVMContext>();
-  auto m          = llvm::parseAssemblyString(AsStringRef(backends::kRuntimeLlvmIr), error, *ctx);
-  auto b          = std::make_unique<llvm::IRBuilder<>>(*ctx);
-  auto ir_emitter = std::make_unique<CodeGenT>(m.get(), b.get());
-  VLOG(3) << "ir_emitter->Compile(module) Begin";
-  ir_emitter->Compile(module);
-  VLOG(3) << "ir_emitter->Compile(module) Succeed!";
-  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
+void ExecutionEngine::Link(const ir::Module &module, std::string_view signature) {
+  std::string cache_key;
+  if (cache_->persistent()) {
+    cache_key = ObjectCacheKey(signature.empty() ? utils::GetStreamCnt(module) : signature);
+    if (auto object = cache_->getObject(cache_key)) {
+      llvm::cantFail(jit_->addObjectFile(std::move(object)));
+      return;
+    }
+  }
 
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
-  optimize(m.get());
-  CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
+  // The on-disk object cache stores a single object per module, so compile the functions lazily or concurrently only
+  // without it.
+  if (lazy_jit_ && cache_key.empty()) {
+    LinkLazily<CodeGenT>(module);
+    return;
+  }
+  if (options_.num_compile_threads > 1 && cache_key.empty() && module.functions().size() > 1) {
+    LinkConcurrently<CodeGenT>(module);
+    return;
+  }
+
+  auto ctx = std::make_unique<llvm::LLVMContext>();
+  auto m   = EmitModule<CodeGenT>(module, ctx.get());
+  // The IR layer of the lazy JIT optimizes the modules by itself.
+  if (!lazy_jit_) {
+    OptimizeModule(m.get(), optimizers_[0].get());
+    KeepOptimizedIR(module, *m);
+  }
+  // The module identifier is the key the object cache stores the compiled object with.
+  if (!cache_key.empty()) m->setModuleIdentifier(cache_key);
   for (auto &f : *m) {
     VLOG(3) << "function: " << DumpToString(f);
   }
@@ -185,6 +377,104 @@ bool ExecutionEngine::AddModule(std::unique_ptr<llvm::Module> module, std::uniqu
   return true;
 }
 
+template <typename CodeGenT>
+void ExecutionEngine::LinkConcurrently(const ir::Module &module) {
+  const auto &functions = module.functions();
+  std::vector<std::unique_ptr<llvm::LLVMContext>> contexts(functions.size());
+  std::vector<std::unique_ptr<llvm::Module>> modules(functions.size());
+
+  // The CINN IR emission is not thread-safe, so emit the functions serially.
+  for (int i = 0; i < functions.size(); i++) {
+    ir::Module::Builder builder(module->name + "_" + functions[i]->name, module->target);
+    builder.AddFunction(functions[i]);
+    contexts[i] = std::make_unique<llvm::LLVMContext>();
+    modules[i]  = EmitModule<CodeGenT>(builder.Build(), contexts[i].get());
+  }
+
+  // The runtime is private to each module, so they can be optimized and compiled independently.
+  auto optimize = [&](int i) {
+    LLVMModuleOptimizer *optimizer;
+    {
+      std::unique_lock<std::mutex> lock(optimizers_mu_);
+      optimizers_cv_.wait(lock, [&] { return !idle_optimizers_.empty(); });
+      optimizer = idle_optimizers_.back();
+      idle_optimizers_.pop_back();
+    }
+    OptimizeModule(modules[i].get(), optimizer);
+    {
+      std::lock_guard<std::mutex> lock(optimizers_mu_);
+      idle_optimizers_.push_back(optimizer);
+    }
+    optimizers_cv_.notify_one();
+  };
+  compile_pool_->ParallelFor(
+      modules.size(), [](int i, void *data) { (*static_cast<decltype(optimize) *>(data))(i); }, &optimize);
+  for (int i = 0; i < modules.size(); i++) KeepOptimizedIR(module, *modules[i]);
+
+  for (int i = 0; i < modules.size(); i++) {
+    CHECK(AddModule(std::move(modules[i]), std::move(contexts[i])));
+  }
+
+  // Look up all the functions at once, so that the execution session dispatches the compilation of all the modules
+  // onto its compile threads.
+  llvm::orc::SymbolLookupSet symbols;
+  for (auto &fn : functions) symbols.add(jit_->mangleAndIntern(fn->name));
+  llvm::cantFail(jit_->getExecutionSession().lookup(llvm::orc::makeJITDylibSearchOrder(&jit_->getMainJITDylib()),
+                                                    std::move(symbols)));
+}
+
+template <typename CodeGenT>
+void ExecutionEngine::LinkLazily(const ir::Module &module) {
+  // Only the emission is done here, the optimization and the compilation of a module happen on the first call of its
+  // function, see the transform of the IR layer in Create.
+  for (auto &fn : module.functions()) {
+    ir::Module::Builder builder(module->name + "_" + fn->name, module->target);
+    builder.AddFunction(fn);
+    auto ctx = std::make_unique<llvm::LLVMContext>();
+    auto m   = EmitModule<CodeGenT>(builder.Build(), ctx.get());
+    m->setDataLayout(jit_->getDataLayout());
+    llvm::orc::ThreadSafeModule tsm(std::move(m), llvm::orc::ThreadSafeContext(std::move(ctx)));
+    llvm::cantFail(lazy_jit_->addLazyIRModule(std::move(tsm)));
+  }
+}
+
+bool ExecutionEngine::LinkCachedObject(std::string_view signature) {
+  if (!cache_->persistent()) return false;
+  auto object = cache_->getObject(ObjectCacheKey(signature));
+  if (!object) return false;
+  llvm::cantFail(jit_->addObjectFile(std::move(object)));
+  return true;
+}
+
+std::string ExecutionEngine::ObjectCacheKey(std::string_view signature) const {
+  std::stringstream ss;
+  // The objects of an older CINN may call the runtime or the extern functions in a way the current one does not.
+  ss << CINN_BUILD_ID << "\n"
+     << LLVM_VERSION_STRING << "\n"
+     << llvm::sys::getProcessTriple() << "\n"
+     << llvm::sys::getHostCPUName().str() << "\n"
+     << options_.opt_level << " " << options_.enable_debug_info << "\n"
+     << backends::kRuntimeLlvmBitcode << "\n"
+     << signature;
+  auto content = ss.str();
+  return llvm::toHex(llvm::SHA1::hash(llvm::arrayRefFromStringRef(content)), /*LowerCase=*/true);
+}
+
+void ExecutionEngine::KeepOptimizedIR(const ir::Module &module, const llvm::Module &m) {
+  if (!options_.keep_optimized_ir) return;
+  std::lock_guard<std::mutex> lock(mu_);
+  for (auto &fn : module.functions()) {
+    if (auto *f = m.getFunction(fn->name); f && !f->isDeclaration()) optimized_ir_[fn->name] = DumpToString(*f);
+  }
+}
+
+std::string ExecutionEngine::GetOptimizedIR(const std::string &name) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = optimized_ir_.find(name);
+  CHECK(it != optimized_ir_.end()) << "No optimized IR of " << name << ", is keep_optimized_ir set?";
+  return it->second;
+}
+
 void *ExecutionEngine::Lookup(std::string_view name) {
   std::lock_guard<std::mutex> lock(mu_);
   if (auto symbol = jit_->lookup(AsStringRef(name))) {
@@ -204,8 +494,51 @@ void ExecutionEngine::RegisterRuntimeSymbols() {
   }
 }
 
-template void ExecutionEngine::Link<CodeGenLLVM>(const ir::Module &module);
-template void ExecutionEngine::Link<CodeGenX86>(const ir::Module &module);
-template void ExecutionEngine::Link<CodeGenCUDA_Host>(const ir::Module &module);
+template <typename CodeGenT>
+void EmitObjectFile(const ir::Module &module,
+                    const std::string &path,
+                    const std::map<std::string, std::string> &getters) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+  InitializeLLVMPasses();
+
+  llvm::LLVMContext ctx;
+  auto m = EmitModule<CodeGenT>(module, &ctx);
+  for (auto &[name, value] : getters) {
+    auto *fn_type = llvm::FunctionType::get(llvm::Type::getInt8PtrTy(ctx), false);
+    auto *fn      = llvm::Function::Create(fn_type, llvm::Function::ExternalLinkage, name, m.get());
+    llvm::IRBuilder<> b(llvm::BasicBlock::Create(ctx, "entry", fn));
+    b.CreateRet(b.CreateGlobalStringPtr(value, name + "_str"));
+  }
+  // The object is linked into a shared library, so it should be position independent.
+  auto jtmb = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  jtmb.setRelocationModel(llvm::Reloc::PIC_);
+  auto machine = llvm::cantFail(jtmb.createTargetMachine());
+  m->setTargetTriple(machine->getTargetTriple().str());
+  m->setDataLayout(machine->createDataLayout());
+  LLVMModuleOptimizer optimize(machine.get(), 3, llvm::FastMathFlags());
+  OptimizeModule(m.get(), &optimize);
+
+  std::error_code ec;
+  llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_None);
+  CHECK(!ec) << "Failed to open " << path << ": " << ec.message();
+  llvm::legacy::PassManager pm;
+  CHECK(!machine->addPassesToEmitFile(pm, os, nullptr, llvm::CGFT_ObjectFile))
+      << "The target machine can not emit object files";
+  {
+    utils::RecordEvent event("EmitObject", "llvm");
+    pm.run(*m);
+  }
+  os.flush();
+  VLOG(1) << "Module " << module->name << " compiled to " << path;
+}
+
+template void EmitObjectFile<CodeGenX86>(const ir::Module &module,
+                                         const std::string &path,
+                                         const std::map<std::string, std::string> &getters);
+
+template void ExecutionEngine::Link<CodeGenLLVM>(const ir::Module &module, std::string_view signature);
+template void ExecutionEngine::Link<CodeGenX86>(const ir::Module &module, std::string_view signature);
+template void ExecutionEngine::Link<CodeGenCUDA_Host>(const ir::Module &module, std::string_view signature);
 
 }  // namespace cinn::backends
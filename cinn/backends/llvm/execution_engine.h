@@ -22,33 +22,65 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/ir/module.h"
+#include "cinn/utils/thread_pool.h"
 
 namespace cinn::backends {
 
+/**
+ * An object cache keyed by the module identifier. If a cache directory is given, the compiled objects are also
+ * persisted to disk, so that they can be reused across processes.
+ */
 class NaiveObjectCache : public llvm::ObjectCache {
  public:
+  NaiveObjectCache() = default;
+  explicit NaiveObjectCache(const std::string &cache_dir) : cache_dir_(cache_dir) {}
+
   void notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *) override;
 
+  //! Get the object of the module identified by \p key, null if it is neither in memory nor on disk.
+  std::unique_ptr<llvm::MemoryBuffer> getObject(llvm::StringRef key);
+
+  bool persistent() const { return !cache_dir_.empty(); }
+
  private:
+  std::string ObjectPath(llvm::StringRef key) const;
+
+  std::string cache_dir_;
+  // The objects might be compiled concurrently.
+  std::mutex mu_;
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cached_objects_;
 };
 
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
+  //! The directory to persist the compiled objects in, the on-disk object cache is disabled if empty.
+  std::string object_cache_dir;
+  //! The number of threads to optimize and compile the functions with. If it is greater than 1, each function of a
+  //! module is compiled in its own LLVMContext, and the on-disk object cache is bypassed.
+  int num_compile_threads{1};
+  //! Compile a function on its first call instead of on linking. A function looked up is a stub that compiles the
+  //! module of the function and jumps to it. The on-disk object cache is bypassed.
+  bool lazy_compile{false};
+  //! Keep the optimized LLVM IR of the functions linked, see ExecutionEngine::GetOptimizedIR. Not for lazy_compile.
+  bool keep_optimized_ir{false};
   // TODO(fc500110)
-  // int num_compile_threads{1};
   // bool enable_fast_math;
 };
 
@@ -58,24 +90,85 @@ class ExecutionEngine {
 
   void *Lookup(std::string_view name);
 
+  /**
+   * Compile and link a CINN module.
+   * @param module The module to link.
+   * @param signature The content identifying the module in the on-disk object cache, if it is empty, the printed
+   * module is used instead. Only used when the on-disk object cache is enabled.
+   */
   template <typename CodeGenT = CodeGenLLVM>
-  void Link(const ir::Module &module);
+  void Link(const ir::Module &module, std::string_view signature = {});
+
+  /**
+   * Link the object compiled earlier, possibly by another process, for \p signature.
+   * @return false if the on-disk object cache is disabled or there is no such object.
+   */
+  bool LinkCachedObject(std::string_view signature);
 
   bool AddModule(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context);
 
+  //! The number of the LLVM modules compiled to objects so far, not counting the objects from the cache.
+  int num_compiled_modules() const { return num_compiled_modules_.load(); }
+
+  //! The optimized LLVM IR of the function \p name linked, if ExecutionOptions::keep_optimized_ir is set.
+  std::string GetOptimizedIR(const std::string &name) const;
+
  protected:
-  explicit ExecutionEngine(bool enable_object_cache) : cache_(std::make_unique<NaiveObjectCache>()) {}
+  explicit ExecutionEngine(const ExecutionOptions &options)
+      : options_(options), cache_(std::make_unique<NaiveObjectCache>(options.object_cache_dir)) {}
 
   void RegisterRuntimeSymbols();
 
   bool SetupTargetTriple(llvm::Module *module);
 
-  friend std::unique_ptr<ExecutionEngine> std::make_unique<ExecutionEngine>(bool &&);
+  //! Emit each function of \p module into its own LLVM module, then optimize and compile them concurrently.
+  template <typename CodeGenT>
+  void LinkConcurrently(const ir::Module &module);
+
+  //! Emit each function of \p module into its own LLVM module, to optimize and compile on the first call.
+  template <typename CodeGenT>
+  void LinkLazily(const ir::Module &module);
+
+  //! Get the object cache key of \p signature, it also covers the CINN build, the host, the LLVM version and options.
+  std::string ObjectCacheKey(std::string_view signature) const;
+
+  //! Keep the optimized IR of the functions of \p module in \p m if ExecutionOptions::keep_optimized_ir is set.
+  void KeepOptimizedIR(const ir::Module &module, const llvm::Module &m);
 
  private:
+  ExecutionOptions options_;
   mutable std::mutex mu_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
+  //! The same as jit_ if lazy_compile is set, or null.
+  llvm::orc::LLLazyJIT *lazy_jit_{};
   std::unique_ptr<NaiveObjectCache> cache_;
+  //! The target machines and optimizers of the compile threads, created once for all the modules linked.
+  std::vector<std::unique_ptr<llvm::TargetMachine>> machines_;
+  std::vector<std::unique_ptr<LLVMModuleOptimizer>> optimizers_;
+  //! The pool optimizing the modules of LinkConcurrently, kept for all the modules linked if num_compile_threads is
+  //! greater than 1.
+  std::unique_ptr<utils::ThreadPool> compile_pool_;
+  //! The optimizers not in use by a task of compile_pool_, the tasks run inline when the pool is busy with another
+  //! Link, so there might be more of them than the optimizers.
+  std::vector<LLVMModuleOptimizer *> idle_optimizers_;
+  std::mutex optimizers_mu_;
+  std::condition_variable optimizers_cv_;
+  //! The modules compiled lazily are optimized on the threads calling them, with the first optimizer.
+  std::mutex lazy_optimize_mu_;
+  std::atomic<int> num_compiled_modules_{0};
+  //! The optimized IR of the functions by the names, guarded by mu_.
+  std::map<std::string, std::string> optimized_ir_;
 };
 
+/**
+ * Compile \p module ahead of time into the position independent object file \p path for the host CPU. The runtime is
+ * compiled into the object too, so that it can be linked into a shared library and run with no JIT.
+ * @param getters The functions to define besides the ones of \p module, each of them takes no argument and returns
+ * a constant C string, e.g. to embed the metadata of the module.
+ */
+template <typename CodeGenT = CodeGenLLVM>
+void EmitObjectFile(const ir::Module &module,
+                    const std::string &path,
+                    const std::map<std::string, std::string> &getters = {});
+
 }  // namespace cinn::backends
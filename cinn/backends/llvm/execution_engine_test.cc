@@ -18,6 +18,7 @@
 #include <iomanip>
 #include <memory>
 #include <random>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -302,5 +303,43 @@ TEST(ExecutionEngine, call_extern) {
   }
 }
 
+TEST(ExecutionEngine, lazy_compile) {
+  ir::Expr M(kM);
+  ir::Expr N(kN);
+  Module::Builder builder("module_lazy", common::DefaultHostTarget());
+  for (auto *name : {"lazy_add", "lazy_mul"}) {
+    Placeholder<float> x("x", {M, N});
+    Placeholder<float> y("y", {M, N});
+    bool add = std::string(name) == "lazy_add";
+    auto out = Compute(
+        {M, N}, [=](Var i, Var j) { return add ? x(i, j) + y(i, j) : x(i, j) * y(i, j); }, "out");
+    builder.AddFunction(Lower(name, CreateStages({out}), {x, y, out}));
+  }
+
+  ExecutionOptions options;
+  options.lazy_compile = true;
+  auto engine          = backends::ExecutionEngine::Create(options);
+  engine->Link<CodeGenX86>(builder.Build());
+
+  // Both are stubs, only lazy_add is compiled, on the call.
+  ASSERT_TRUE(engine->Lookup("lazy_mul"));
+  auto lazy_add = reinterpret_cast<void (*)(void *, int32_t)>(engine->Lookup("lazy_add"));
+  ASSERT_TRUE(lazy_add);
+  ASSERT_EQ(engine->num_compiled_modules(), 0);
+
+  auto [ab, bb, cb] = CreateTestBuffer();  // NOLINT
+  cinn_pod_value_t args[3] = {cinn_pod_value_t(ab), cinn_pod_value_t(bb), cinn_pod_value_t(cb)};
+  for (int i = 0; i < 2; i++) lazy_add(args, 3);
+  // The module of lazy_add is compiled once, and the one of lazy_mul never.
+  ASSERT_EQ(engine->num_compiled_modules(), 1);
+
+  auto *ad = reinterpret_cast<float *>(ab->memory);
+  auto *bd = reinterpret_cast<float *>(bb->memory);
+  auto *cd = reinterpret_cast<float *>(cb->memory);
+  for (int i = 0; i < kM * kN; i++) {
+    ASSERT_NEAR(cd[i], ad[i] + bd[i], 1e-5);
+  }
+}
+
 }  // namespace backends
 }  // namespace cinn
@@ -7,6 +7,7 @@ import subprocess
 def main():
     path = sys.argv[1]
     out_path = sys.argv[2]
+    bitcode_path = sys.argv[3] if len(sys.argv) > 3 else None
 
     srcs = []
     srcs.append('#include <string_view>')
@@ -20,6 +21,19 @@ def main():
     srcs.append(')ROC"')
     srcs.append(');\n')
 
+    # The bitcode of the runtime, it is loaded lazily and much faster than parsing the IR above.
+    if bitcode_path:
+        with open(bitcode_path, 'rb') as fr:
+            bitcode = fr.read()
+        srcs.append("inline constexpr char kRuntimeLlvmBitcodeData[] = {")
+        for i in range(0, len(bitcode), 16):
+            srcs.append("  " + ", ".join(
+                str(b if b < 128 else b - 256) for b in bitcode[i:i + 16]) + ",")
+        srcs.append("};")
+        srcs.append(
+            "inline constexpr std::string_view kRuntimeLlvmBitcode(kRuntimeLlvmBitcodeData, sizeof(kRuntimeLlvmBitcodeData));\n"
+        )
+
     cmd = "llvm-config --version"
     version = subprocess.check_output(
         cmd, shell=True).decode('utf-8').strip().split('.')
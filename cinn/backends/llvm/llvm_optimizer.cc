@@ -107,8 +107,6 @@ LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine,
     : opt_level_(opt_level), print_passes_(print_passes), machine_(machine) {}
 
 void LLVMModuleOptimizer::operator()(llvm::Module *m) {
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
   auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
   // fpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
   // fpm->add(llvm::createInstructionCombiningPass());
@@ -128,8 +126,8 @@ void LLVMModuleOptimizer::operator()(llvm::Module *m) {
   // mpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
   // LOG(INFO) << "llvm run pass: target machine: name[" << machine_->getTarget().getName() << "]";
   // LOG(INFO) << "llvm run pass: target machine: cpu[" << machine_->getTargetCPU().str() << "]";
-  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
+  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
+  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
   auto builder           = std::make_unique<llvm::PassManagerBuilder>();
   builder->OptLevel      = opt_level_;
   builder->Inliner       = llvm::createFunctionInliningPass();
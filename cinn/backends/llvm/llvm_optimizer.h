@@ -15,6 +15,7 @@ namespace cinn::backends {
 // llvm module optimizer
 class LLVMModuleOptimizer final {
  public:
+  //! \p machine should outlive the optimizer, and it is not thread-safe, so neither is the optimizer.
   explicit LLVMModuleOptimizer(llvm::TargetMachine *machine,
                                int opt_level,
                                llvm::FastMathFlags fast_math_flags,
@@ -20,6 +20,7 @@ using common::Shared;
 using common::UniqName;
 
 // Type related.
+using common::BFloat;
 using common::Bool;
 using common::Float;
 using common::Int;
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+//! The 16-bit floating point types on the host, to read and write the tensors of the reduced precisions.
+
+namespace cinn {
+namespace common {
+
+namespace detail {
+
+inline uint32_t FloatBits(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+inline float BitsFloat(uint32_t bits) {
+  float x;
+  std::memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+}  // namespace detail
+
+/**
+ * The IEEE 754 half precision, with 5 bits of exponent and 10 bits of mantissa. The conversion from float rounds to the
+ * nearest even, the values too large become infinities and the ones too small become subnormals or zeros.
+ */
+struct float16 {
+  uint16_t x{0};
+
+  float16() = default;
+  explicit float16(float value) : x(FromFloat(value)) {}
+
+  operator float() const { return ToFloat(x); }
+
+  static float16 FromBits(uint16_t bits) {
+    float16 res;
+    res.x = bits;
+    return res;
+  }
+
+ private:
+  static uint16_t FromFloat(float value) {
+    uint32_t bits     = detail::FloatBits(value);
+    uint16_t sign     = (bits >> 16) & 0x8000;
+    uint32_t abs_bits = bits & 0x7fffffff;
+    if (abs_bits >= 0x7f800000) {
+      // inf or nan, a nan keeps a mantissa bit set.
+      return sign | 0x7c00 | (abs_bits > 0x7f800000 ? 0x200 : 0);
+    }
+    // 65520 and above round to inf.
+    if (abs_bits >= 0x477ff000) return sign | 0x7c00;
+    if (abs_bits < 0x38800000) {
+      // A subnormal half, the value is rounded at the unit 2^-24 by adding it as a float with the same exponent.
+      float rounded = detail::BitsFloat(abs_bits) + 0.5f;
+      return sign | static_cast<uint16_t>(detail::FloatBits(rounded) - detail::FloatBits(0.5f));
+    }
+    uint32_t odd = (abs_bits >> 13) & 1;
+    abs_bits += 0xc8000fff + odd;  // rebias the exponent from 127 to 15 and round to the nearest even.
+    return sign | static_cast<uint16_t>(abs_bits >> 13);
+  }
+
+  static float ToFloat(uint16_t h) {
+    uint32_t sign     = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    if (exponent == 0x1f) return detail::BitsFloat(sign | 0x7f800000 | (mantissa << 13));
+    if (exponent == 0) {
+      // zero or a subnormal, mantissa * 2^-24.
+      float value = static_cast<float>(mantissa) * detail::BitsFloat(0x33800000);
+      return detail::BitsFloat(sign | detail::FloatBits(value));
+    }
+    return detail::BitsFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+  }
+};
+
+/**
+ * The brain floating point, the upper 16 bits of a float with 8 bits of exponent and 7 bits of mantissa. The
+ * conversion from float rounds to the nearest even, the same as the codegen of Cast, see CodeGenLLVM.
+ */
+struct bfloat16 {
+  uint16_t x{0};
+
+  bfloat16() = default;
+  explicit bfloat16(float value) : x(FromFloat(value)) {}
+
+  operator float() const { return detail::BitsFloat(static_cast<uint32_t>(x) << 16); }
+
+  static bfloat16 FromBits(uint16_t bits) {
+    bfloat16 res;
+    res.x = bits;
+    return res;
+  }
+
+ private:
+  static uint16_t FromFloat(float value) {
+    uint32_t bits = detail::FloatBits(value);
+    if ((bits & 0x7fffffff) > 0x7f800000) return 0x7fc0;  // a quiet nan
+    bits += 0x7fff + ((bits >> 16) & 1);
+    return static_cast<uint16_t>(bits >> 16);
+  }
+};
+
+static_assert(sizeof(float16) == 2, "float16 should take 2 bytes");
+static_assert(sizeof(bfloat16) == 2, "bfloat16 should take 2 bytes");
+
+}  // namespace common
+}  // namespace cinn
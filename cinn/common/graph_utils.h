@@ -190,6 +190,9 @@ class Graph {
   std::set<GraphNode*> CollectNodes(std::function<bool(const common::GraphNode*)>&& teller);
 
   void DropNode(GraphNode* n) {
+    for (auto it = registry_.begin(); it != registry_.end();) {
+      it = it->second == n ? registry_.erase(it) : std::next(it);
+    }
     auto it = std::find_if(nodes_.begin(), nodes_.end(), [&](auto& x) { return x.get() == n; });
     if (it != nodes_.end()) {
       nodes_.erase(it);
@@ -49,6 +49,36 @@ int Target::get_target_bits() const {
   return -1;
 }
 
+int Target::vector_bits() const {
+  switch (arch) {
+    case Arch::X86:
+      // The code of X86 is compiled for the host CPU.
+#if defined(__x86_64__) || defined(__i386__)
+      if (__builtin_cpu_supports("avx512f")) return 512;
+      if (__builtin_cpu_supports("avx")) return 256;
+#endif
+      return 128;
+    case Arch::ARM:
+      return 128;
+    default:
+      return 0;
+  }
+}
+
+int Target::num_vector_registers() const {
+  switch (arch) {
+    case Arch::X86:
+#if defined(__x86_64__) || defined(__i386__)
+      if (__builtin_cpu_supports("avx512f")) return 32;
+#endif
+      return 16;
+    case Arch::ARM:
+      return bits == Bit::k64 ? 32 : 16;
+    default:
+      return 0;
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const Target &target) {
   os << "Target<";
   switch (target.os) {
@@ -67,6 +67,12 @@ struct Target {
 
   int get_target_bits() const;
 
+  //! The width in bits of the vector registers of the CPU targets, that of the host CPU for X86, 0 for NVGPU.
+  int vector_bits() const;
+
+  //! The number of the vector registers of the CPU targets, that of the host CPU for X86, 0 for NVGPU.
+  int num_vector_registers() const;
+
   std::vector<Lib> get_target_libs() const;
 
   bool operator==(const Target& other) const;
@@ -1,5 +1,6 @@
 #include "cinn/common/type.h"
 
+#include <unordered_map>
 #include <utility>
 
 namespace cinn {
@@ -42,6 +43,9 @@ std::ostream &operator<<(std::ostream &os, const Type &t) {
     case Type::type_t::Float:
       os << "float" << t.bits();
       break;
+    case Type::type_t::BFloat:
+      os << "bfloat" << t.bits();
+      break;
     case Type::type_t::Void:
       os << "void";
       break;
@@ -77,6 +81,9 @@ std::ostream &operator<<(std::ostream &os, Type::type_t t) {
     case Type::type_t::Float:
       os << "Float";
       break;
+    case Type::type_t::BFloat:
+      os << "BFloat";
+      break;
     case Type::type_t::Unk:
       os << "Unk";
       break;
@@ -224,6 +231,9 @@ bool Type::is_void() const { return type() == type_t::Void; }
 bool Type::is_vector() const { return lanes() > 1; }
 bool Type::is_scalar() const { return lanes() == 1; }
 bool Type::is_float(int bits) const { return type() == type_t::Float && (bits < 0 || bits == this->bits()); }
+bool Type::is_float16() const { return is_float(16); }
+bool Type::is_bfloat16() const { return type() == type_t::BFloat && bits() == 16; }
+bool Type::is_reduced_float() const { return is_float16() || is_bfloat16(); }
 bool Type::is_uint(int bits) const { return type() == type_t::UInt && (bits < 0 || bits == this->bits()); }
 bool Type::is_int(int bits) const { return type() == type_t::Int && (bits < 0 || bits == this->bits()); }
 bool Type::is_integer(int bits) const {
@@ -243,6 +253,7 @@ const std::string &Type::customized_type() const { return GetStorage().customize
 bool Type::is_customized_type() const { return !GetStorage().customized_type_.empty(); }
 Type::type_t Type::type() const { return GetStorage().type_; }
 int Type::bits() const { return GetStorage().bits_; }
+int Type::bytes() const { return (bits() + 7) / 8; }
 int Type::lanes() const { return GetStorage().lanes_; }
 Type::cpp_type_t Type::cpp_type() const { return GetStorage().cpp_type_; }
 bool Type::operator==(const Type &other) const {
@@ -266,6 +277,10 @@ const Type &F16() {
   static auto t = Float(16);
   return t;
 }
+const Type &BF16() {
+  static auto t = BFloat(16);
+  return t;
+}
 const Type &F32() {
   static auto t = Float(32);
   return t;
@@ -315,5 +330,20 @@ const Type &UI1() {
   return t;
 }
 
+Type Str2Type(const std::string &name) {
+  static const std::unordered_map<std::string, Type> types{{"float16", F16()},
+                                                           {"bfloat16", BF16()},
+                                                           {"float32", F32()},
+                                                           {"float64", F64()},
+                                                           {"int8", I8()},
+                                                           {"int32", I32()},
+                                                           {"int64", I64()},
+                                                           {"uint8", UI8()},
+                                                           {"bool", Bool()}};
+  auto it = types.find(name);
+  CHECK(it != types.end()) << "Unknown type " << name;
+  return it->second;
+}
+
 }  // namespace common
 }  // namespace cinn
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 
+#include "cinn/common/float16.h"
 #include "cinn/common/macros.h"
 #include "cinn/runtime/cinn_runtime.h"
 
@@ -27,6 +28,8 @@ struct Type {
     Void,
     // stupid idea to mix the Customized with other primitive types, large refactor needs here.
     Customized,  // Customized type
+    //! The brain floating point, with the exponent of a float and a shorter mantissa.
+    BFloat,
   };
 
   //! type decorators in C++, the different code can used together.
@@ -55,6 +58,10 @@ struct Type {
   CINN_NODISCARD bool is_vector() const;
   CINN_NODISCARD bool is_scalar() const;
   CINN_NODISCARD bool is_float(int bits = -1) const;
+  CINN_NODISCARD bool is_float16() const;
+  CINN_NODISCARD bool is_bfloat16() const;
+  //! float16 or bfloat16, which are computed in float32.
+  CINN_NODISCARD bool is_reduced_float() const;
   CINN_NODISCARD bool is_int(int bits = -1) const;
   CINN_NODISCARD bool is_integer(int bits = -1) const;
   CINN_NODISCARD bool is_uint(int bits = -1) const;
@@ -88,6 +95,8 @@ struct Type {
   // @{
   type_t type() const;
   int bits() const;
+  //! The bytes of an element, a bool takes a byte.
+  int bytes() const;
   int lanes() const;
   cpp_type_t cpp_type() const;
   // @}
@@ -127,12 +136,14 @@ inline Type Void() { return Type(Type::type_t ::Void, 1, 0); }
 inline Type Int(int bits, int lanes = 1) { return Type(Type::type_t ::Int, bits, lanes); }
 inline Type UInt(int bits, int lanes = 1) { return Type(Type::type_t ::UInt, bits, lanes); }
 inline Type Float(int bits, int lanes = 1) { return Type(Type::type_t ::Float, bits, lanes); }
+inline Type BFloat(int bits, int lanes = 1) { return Type(Type::type_t ::BFloat, bits, lanes); }
 inline Type Bool(int lanes = 1) { return Type(Type::type_t ::UInt, 1, lanes); }
 inline Type String() { return Type(Type::type_t::String, 1, 1); }
 
 //! Builtin native types as global singletons.
 // @{
 const Type& F16();
+const Type& BF16();
 const Type& F32();
 const Type& F64();
 const Type& I8();
@@ -152,6 +163,8 @@ Type type_of();
 
 // clang-format off
 template <> inline Type type_of<float>() { return F32(); }
+template <> inline Type type_of<float16>() { return F16(); }
+template <> inline Type type_of<bfloat16>() { return BF16(); }
 template <> inline Type type_of<double>() { return F64(); }
 template <> inline Type type_of<unsigned char>() { return UI8(); }
 template <> inline Type type_of<int16_t>() { return UI16(); }
@@ -197,6 +210,9 @@ inline Type type_of<double*>() {
 
 std::ostream& operator<<(std::ostream& os, Type::type_t t);
 
+//! The type of the name \p name of the frontend, e.g. "float32" or "bfloat16".
+Type Str2Type(const std::string& name);
+
 namespace customized_type {
 
 static const char* kArgs_type_repr     = "Args";
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 namespace cinn::common {
 
 TEST(Type, basic) {
@@ -14,4 +16,21 @@ TEST(Type, basic) {
   LOG(INFO) << type_of<float>();
 }
 
+TEST(Type, reduced_float) {
+  ASSERT_EQ(Str2Type("bfloat16"), BF16());
+  ASSERT_EQ(Str2Type("float16"), F16());
+  ASSERT_TRUE(BF16().is_reduced_float());
+  ASSERT_FALSE(BF16().is_float());
+  ASSERT_EQ(BF16().bytes(), 2);
+
+  // Rounded to the nearest even.
+  ASSERT_EQ(bfloat16(1.f + 1.f / 256).x, bfloat16(1.f).x);
+  ASSERT_EQ(static_cast<float>(bfloat16(1.f + 3.f / 256)), 1.f + 4.f / 256);
+  ASSERT_EQ(static_cast<float>(float16(1.f + 1.f / 2048)), 1.f);
+  ASSERT_EQ(static_cast<float>(float16(65504.f)), 65504.f);
+  ASSERT_TRUE(std::isinf(static_cast<float>(float16(65520.f))));
+  ASSERT_EQ(static_cast<float>(float16(1.f / (1 << 24))), 1.f / (1 << 24));
+  ASSERT_TRUE(std::isnan(static_cast<float>(bfloat16(NAN))));
+}
+
 }  // namespace cinn::common
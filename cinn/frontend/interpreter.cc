@@ -1,10 +1,28 @@
 #include "cinn/frontend/interpreter.h"
 
+#include <any>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+#include "cinn/frontend/paddle/model_parser.h"
 #include "cinn/frontend/syntax.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+DEFINE_bool(cinn_constant_folding, true, "Whether to compute the ops of the parameters only once at build time.");
+DEFINE_bool(cinn_conv_epilogue_fusion, true, "Whether to fuse the batchnorm and the activation following a conv.");
+DEFINE_bool(cinn_elementwise_fusion, true, "Whether to fuse the elementwise ops and the epilogues on X86.");
+DEFINE_bool(cinn_reduce_prologue_fusion, true, "Whether to fuse the elementwise producers into a reduction on X86.");
+DEFINE_bool(cinn_memory_plan,
+            false,
+            "Whether to share the memory of the intermediate tensors not live at the same time. The intermediate "
+            "tensors fetched by GetTensor after the run are overwritten then, only the ones without consumers are kept.");
+}  // namespace cinn
 
 namespace cinn::frontend {
 
@@ -23,42 +41,137 @@ struct Interpreter::Impl {
 
  private:
   friend class Interpreter;
+  friend class ExecutionContext;
+
+  //! The program compiled for a batch size.
+  struct Bucket {
+    int batch_size{};
+    std::shared_ptr<hlir::framework::Graph> graph;
+    std::shared_ptr<hlir::framework::Scope> scope;
+    std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
+    std::unique_ptr<hlir::framework::Program> runtime_program;
+  };
+
+  void BuildBucket(const std::vector<Variable>& input_vars,
+                   const std::vector<hlir::framework::shape_t>& input_shapes,
+                   const Target& target,
+                   Bucket* bucket);
+
+  const Bucket& current_bucket() const {
+    CHECK(!buckets_.empty()) << "The model is not loaded";
+    return buckets_[current_bucket_];
+  }
+
+  //! The index of the smallest bucket not less than \p batch_size.
+  int FindBucket(int batch_size) const;
+
+  //! Get the tensor called \p name in cinn or in paddle from \p scope.
+  hlir::framework::Tensor GetTensor(const hlir::framework::Scope& scope, const std::string& name) const;
 
   std::vector<std::string> input_names_;
   std::vector<hlir::framework::shape_t> input_shapes_;
 
   std::shared_ptr<hlir::framework::Scope> scope_;
   std::unique_ptr<frontend::Program> program_;
-  std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler_;
 
   std::unordered_map<std::string, Variable> var_map_;
   std::unordered_map<std::string, std::string> var_map_paddle_to_cinn_;
   std::unordered_map<std::string, std::string> var_map_cinn_to_paddle_;
 
-  std::unique_ptr<hlir::framework::Program> runtime_program_;
+  //! The samples of the inputs to calibrate the int8 quantization with, empty to run in float32.
+  std::vector<std::unordered_map<std::string, std::vector<float>>> calibration_samples_;
+
+  //! The batch sizes to compile for in ascending order, empty to compile for the input shapes only.
+  std::vector<int> batch_sizes_;
+  std::vector<Bucket> buckets_;
+  int current_bucket_{};
+
+  //! Loading the parameters of the model in the background of LoadPaddleModel.
+  std::unique_ptr<paddle::ParamLoader> param_loader_;
+  LoadStats load_stats_;
+
+  //! Serializing the runs of the contexts on NVGPU.
+  mutable std::mutex gpu_run_mu_;
 };
 
+void Interpreter::SetBatchBuckets(const std::vector<int>& batch_sizes) {
+  CHECK(!batch_sizes.empty());
+  CHECK(impl_->buckets_.empty()) << "SetBatchBuckets should be called before loading the model";
+  auto& sizes = impl_->batch_sizes_;
+  sizes       = batch_sizes;
+  std::sort(sizes.begin(), sizes.end());
+  sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+  CHECK_GT(sizes.front(), 0) << "The batch sizes should be positive";
+}
+
+void Interpreter::SetInt8Calibration(const std::vector<std::unordered_map<std::string, std::vector<float>>>& samples) {
+  CHECK(!samples.empty()) << "No sample to calibrate the int8 quantization with";
+  CHECK(impl_->buckets_.empty()) << "SetInt8Calibration should be called before loading the model";
+  impl_->calibration_samples_ = samples;
+}
+
+int Interpreter::Impl::FindBucket(int batch_size) const {
+  CHECK(!buckets_.empty()) << "The model is not loaded";
+  CHECK(!batch_sizes_.empty()) << "The model is compiled without batch buckets, see SetBatchBuckets";
+  auto it = std::lower_bound(buckets_.begin(), buckets_.end(), batch_size, [](const Bucket& bucket, int size) {
+    return bucket.batch_size < size;
+  });
+  CHECK(it != buckets_.end()) << "The batch size " << batch_size << " exceeds the largest bucket "
+                              << buckets_.back().batch_size;
+  VLOG(3) << "Run batch size " << batch_size << " with the bucket " << it->batch_size;
+  return it - buckets_.begin();
+}
+
+void Interpreter::SetBatchSize(int batch_size) { impl_->current_bucket_ = impl_->FindBucket(batch_size); }
+
 void Interpreter::LoadPaddleModel(const std::string& model_dir, const Target& target, bool params_combined) {
+  utils::Timer timer;
+  timer.Start();
+  auto& loader = impl_->param_loader_;
+  loader.reset(new paddle::ParamLoader(impl_->scope_.get(), target, FLAGS_cinn_load_params_threads));
   auto [program, var_map, var_map_paddle_to_program] =
-      LoadPaddleProgram(model_dir, impl_->scope_.get(), params_combined, target);
+      LoadPaddleProgram(model_dir, impl_->scope_.get(), params_combined, target, loader.get());
   impl_->program_.reset(program.release());
   impl_->var_map_                = var_map;
   impl_->var_map_paddle_to_cinn_ = var_map_paddle_to_program;
+  double parse_end_ms            = timer.Stop();
+  double parse_wait_ms           = loader->wait_ms();
 
   impl_->Build(impl_->input_names_, impl_->input_shapes_, target);
+
+  auto& stats       = impl_->load_stats_;
+  stats.total_ms    = timer.Stop();
+  stats.io_wait_ms  = loader->wait_ms();
+  stats.parse_ms    = parse_end_ms - parse_wait_ms;
+  stats.compile_ms  = stats.total_ms - parse_end_ms - (stats.io_wait_ms - parse_wait_ms);
+  stats.io_ms       = loader->load_ms();
+  stats.num_params  = loader->num_params();
+  stats.param_bytes = loader->bytes();
+  loader.reset();
+  VLOG(3) << "The model is ready in " << stats.total_ms << " ms: parse " << stats.parse_ms << " ms, compile "
+          << stats.compile_ms << " ms, " << stats.num_params << " params of " << stats.param_bytes / 1e6
+          << " MB loaded in " << stats.io_ms << " ms with " << FLAGS_cinn_load_params_threads << " threads, of which "
+          << stats.io_wait_ms << " ms not overlapped";
 }
 
-void Interpreter::Run() { impl_->runtime_program_->Execute(); }
+const Interpreter::LoadStats& Interpreter::load_stats() const { return impl_->load_stats_; }
+
+void Interpreter::Run() { impl_->current_bucket().runtime_program->Execute(); }
 
 hlir::framework::Tensor Interpreter::GetTensor(const std::string& name) {
-  if (impl_->scope_->FindVar(name)) return impl_->scope_->GetTensor(name);
+  return impl_->GetTensor(*impl_->current_bucket().scope, name);
+}
+
+hlir::framework::Tensor Interpreter::Impl::GetTensor(const hlir::framework::Scope& scope,
+                                                     const std::string& name) const {
+  if (scope.FindVar(name)) return scope.GetTensor(name);
 
-  auto it = impl_->var_map_paddle_to_cinn_.find(name);
-  if (it == impl_->var_map_paddle_to_cinn_.end()) {
+  auto it = var_map_paddle_to_cinn_.find(name);
+  if (it == var_map_paddle_to_cinn_.end()) {
     LOG(FATAL) << "No variable called [" << name
-               << "] found in executor\nThe existing vars: " << utils::Join(impl_->scope_->var_names(), ", ");
+               << "] found in executor\nThe existing vars: " << utils::Join(scope.var_names(), ", ");
   }
-  return impl_->scope_->GetTensor(it->second);
+  return scope.GetTensor(it->second);
 }
 
 void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
@@ -73,6 +186,38 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
     return var_map_.at(x);
   });
 
+  if (batch_sizes_.empty()) {
+    buckets_.resize(1);
+    buckets_[0].batch_size = input_shapes.front().empty() ? 0 : input_shapes.front()[0];
+    buckets_[0].scope      = scope_;
+    BuildBucket(input_vars, input_shapes, target, &buckets_[0]);
+    return;
+  }
+
+  // The parameters loaded are shared by the buckets, the other tensors are of the bucket's batch size.
+  std::vector<std::string> param_names;
+  for (auto& name : scope_->var_names()) param_names.emplace_back(name);
+  buckets_.resize(batch_sizes_.size());
+  for (int i = 0; i < batch_sizes_.size(); i++) {
+    auto& bucket      = buckets_[i];
+    bucket.batch_size = batch_sizes_[i];
+    bucket.scope      = std::make_shared<hlir::framework::Scope>();
+    for (auto& name : param_names) *bucket.scope->Var<hlir::framework::Tensor>(name) = *scope_->FindVar(name);
+    auto shapes = input_shapes;
+    for (auto& shape : shapes) {
+      CHECK(!shape.empty()) << "The inputs should have the batch dim to compile for the batch buckets";
+      shape[0] = bucket.batch_size;
+    }
+    BuildBucket(input_vars, shapes, target, &bucket);
+  }
+  // The largest bucket is used till SetBatchSize is called.
+  current_bucket_ = buckets_.size() - 1;
+}
+
+void Interpreter::Impl::BuildBucket(const std::vector<Variable>& input_vars,
+                                    const std::vector<hlir::framework::shape_t>& input_shapes,
+                                    const Target& target,
+                                    Bucket* bucket) {
   for (int i = 0; i < input_vars.size(); i++) input_vars[i]->shape = input_shapes[i];
 
   program_->SetInputs({input_vars});
@@ -80,23 +225,114 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
 
   LOG(INFO) << "Program:\n" << *program_;
 
-  auto graph = std::make_shared<hlir::framework::Graph>(*program_, target);
+  auto graph    = std::make_shared<hlir::framework::Graph>(*program_, target);
+  bucket->graph = graph;
 
   hlir::framework::ApplyPass(graph.get(), "InferShape");
-  if (target.arch == Target::Arch::NVGPU) {
-    hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  // The passes reading the parameters wait for them, and the rest is compiled afterwards.
+  graph->attrs["param_scope"] = std::make_shared<std::any>(bucket->scope);
+  graph->attrs["wait_params"] = std::make_shared<std::any>(std::function<void()>([this] {
+    if (param_loader_) param_loader_->WaitAll();
+  }));
+  if (FLAGS_cinn_constant_folding) {
+    hlir::framework::ApplyPass(graph.get(), "ConstantFolding");
+  }
+  if (FLAGS_cinn_conv_epilogue_fusion) {
+    hlir::framework::ApplyPass(graph.get(), "ConvEpilogueFusion");
+  }
+  if (!calibration_samples_.empty()) {
+    CHECK(target.arch == Target::Arch::X86) << "The int8 quantization is only implemented on X86";
+    // The samples fill the first rows of the inputs of the bucket, the rest are zeros.
+    int next_sample = 0;
+    graph->attrs["calibration_feed"] = std::make_shared<std::any>(
+        std::function<bool(hlir::framework::Scope*)>([=](hlir::framework::Scope* scope) mutable {
+          if (next_sample == calibration_samples_.size()) return false;
+          for (auto& [name, data] : calibration_samples_[next_sample]) {
+            auto tensor = scope->GetTensor(var_map_.at(name)->id);
+            CHECK_LE(data.size(), tensor->shape().numel()) << "The sample of " << name << " exceeds the input";
+            auto* input = tensor->mutable_data<float>(target);
+            std::fill(std::copy(data.begin(), data.end(), input), input + tensor->shape().numel(), 0.f);
+          }
+          next_sample++;
+          return true;
+        }));
+    hlir::framework::ApplyPass(graph.get(), "Calibrate");
+    hlir::framework::ApplyPass(graph.get(), "Quantize");
   }
-  // Target target = common::DefaultHostTarget();
-  scope_ = hlir::framework::BuildScope(target, graph, scope_);
-  graph_compiler_.reset(new hlir::framework::GraphCompiler(target, scope_, graph));
-  runtime_program_ = graph_compiler_->Build();
+  if (target.arch == Target::Arch::X86) {
+    graph->attrs["op_fusion_elementwise"]     = std::make_shared<std::any>(FLAGS_cinn_elementwise_fusion);
+    graph->attrs["op_fusion_reduce_prologue"] = std::make_shared<std::any>(FLAGS_cinn_reduce_prologue_fusion);
+  }
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  if (FLAGS_cinn_memory_plan) {
+    hlir::framework::ApplyPass(graph.get(), "MemoryPlan");
+  }
+  // The graph is compiled while the parameters are loading, they should be loaded before the scope is built.
+  bucket->graph_compiler.reset(new hlir::framework::GraphCompiler(target, bucket->scope, graph));
+  bucket->graph_compiler->Compile();
+  if (param_loader_) param_loader_->WaitAll();
+  bucket->scope           = hlir::framework::BuildScope(target, graph, bucket->scope);
+  bucket->runtime_program = bucket->graph_compiler->Build();
 }
 
+size_t Interpreter::num_instructions() const { return impl_->current_bucket().runtime_program->size(); }
+
 std::shared_ptr<hlir::framework::Scope> Interpreter::scope() {
-  CHECK(impl_->scope_);
-  return impl_->scope_;
+  if (impl_->buckets_.empty()) {
+    CHECK(impl_->scope_);
+    return impl_->scope_;
+  }
+  return impl_->current_bucket().scope;
+}
+
+std::unique_ptr<ExecutionContext> Interpreter::CreateContext() const {
+  CHECK(!impl_->buckets_.empty()) << "The model is not loaded";
+  return std::unique_ptr<ExecutionContext>(new ExecutionContext(impl_.get()));
 }
 
+ExecutionContext::ExecutionContext(const Interpreter::Impl* impl)
+    : impl_(impl), instances_(impl->buckets_.size()), current_bucket_(impl->buckets_.size() - 1) {}
+
+void ExecutionContext::SetBatchSize(int batch_size) { current_bucket_ = impl_->FindBucket(batch_size); }
+
+ExecutionContext::Instance& ExecutionContext::instance() {
+  auto& instance = instances_[current_bucket_];
+  if (instance) return *instance;
+
+  // The tensors with no producer are the parameters, except the inputs.
+  auto& bucket = impl_->buckets_[current_bucket_];
+  std::unordered_set<std::string> input_ids;
+  for (auto& name : impl_->input_names_) input_ids.insert(impl_->var_map_.at(name)->id);
+  instance.reset(new Instance);
+  instance->scope = std::make_shared<hlir::framework::Scope>();
+  for (auto* graph_node : bucket.graph->nodes()) {
+    auto* data = graph_node->safe_as<hlir::framework::NodeData>();
+    if (!data || !data->inlinks().empty() || input_ids.count(data->id())) continue;
+    auto* param = bucket.scope->FindVar(data->id());
+    CHECK(param) << "The parameter " << data->id() << " is not loaded";
+    *instance->scope->Var<hlir::framework::Tensor>(data->id()) = *param;
+  }
+  hlir::framework::BuildScope(bucket.graph->target_, bucket.graph, instance->scope);
+  instance->program = bucket.runtime_program->Clone(instance->scope);
+  return *instance;
+}
+
+void ExecutionContext::Run() {
+  auto& program = *instance().program;
+  if (impl_->buckets_[current_bucket_].graph->target_.arch == Target::Arch::NVGPU) {
+    std::lock_guard<std::mutex> lock(impl_->gpu_run_mu_);
+    program.Execute();
+    return;
+  }
+  program.Execute();
+}
+
+hlir::framework::Tensor ExecutionContext::GetTensor(const std::string& name) {
+  return impl_->GetTensor(*instance().scope, name);
+}
+
+ExecutionContext::~ExecutionContext() {}
+
 Interpreter::Interpreter(const std::vector<std::string>& input_names,
                          const std::vector<hlir::framework::shape_t>& input_shapes)
     : impl_(new Impl(input_names, input_shapes)) {}
@@ -1,4 +1,6 @@
 #pragma once
+#include <gflags/gflags.h>
+
 #include <algorithm>
 #include <memory>
 #include <string>
@@ -10,8 +12,17 @@
 #include "cinn/hlir/framework/scope.h"
 
 namespace cinn {
+
+DECLARE_bool(cinn_constant_folding);
+DECLARE_bool(cinn_conv_epilogue_fusion);
+DECLARE_bool(cinn_elementwise_fusion);
+DECLARE_bool(cinn_reduce_prologue_fusion);
+DECLARE_bool(cinn_memory_plan);
+
 namespace frontend {
 
+class ExecutionContext;
+
 /**
  * The executor for a model.
  */
@@ -20,12 +31,54 @@ class Interpreter final {
   Interpreter(const std::vector<std::string>& input_names, const std::vector<hlir::framework::shape_t>& input_shapes);
 
   /**
-   * Load a Paddle model.
+   * Compile the model for each of the batch sizes, that is the dim 0 of the inputs, so that a run of any batch size up
+   * to the largest one needs no recompiling. It should be called before LoadPaddleModel, without it the model is
+   * compiled for the input shapes only.
+   * @param batch_sizes The batch sizes to compile for, e.g. {1, 2, 4, 8, 16}.
+   */
+  void SetBatchBuckets(const std::vector<int>& batch_sizes);
+
+  /**
+   * Select the program of the smallest batch bucket not less than \p batch_size for the following runs. The tensors
+   * got from GetTensor after it are of the bucket's batch size, the inputs should be filled with \p batch_size rows and
+   * only the first \p batch_size rows of the outputs are valid.
+   */
+  void SetBatchSize(int batch_size);
+
+  /**
+   * Quantize the conv2d and mul of the model to int8 on X86, by the scales calibrated on running the model in float32
+   * over \p samples, see the Calibrate and Quantize passes. It should be called before LoadPaddleModel.
+   * @param samples The data of the inputs by their names in each sample, which fills the first rows of the inputs of
+   * each batch bucket.
+   */
+  void SetInt8Calibration(const std::vector<std::unordered_map<std::string, std::vector<float>>>& samples);
+
+  //! The time LoadPaddleModel takes to get the model ready to run, in milliseconds.
+  struct LoadStats {
+    //! Parsing the program desc and converting it to a frontend program, with no wait for the parameters.
+    double parse_ms{};
+    //! Building the graph and compiling it, with no wait for the parameters.
+    double compile_ms{};
+    //! Loading the parameters in the background, overlapped with the parsing and compiling.
+    double io_ms{};
+    //! Blocked on the parameters, that is the part of io_ms not overlapped.
+    double io_wait_ms{};
+    double total_ms{};
+    int num_params{};
+    int64_t param_bytes{};
+  };
+
+  /**
+   * Load a Paddle model. The parameters are loaded by FLAGS_cinn_load_params_threads threads in the background of the
+   * converting and compiling of the program.
    * @param model_dir The directory path to the model.
    * @param params_combined Whether the parameters are composed to a single file.
    */
   void LoadPaddleModel(const std::string& model_dir, const Target& target, bool params_combined = false);
 
+  //! The time the last LoadPaddleModel took.
+  const LoadStats& load_stats() const;
+
   /**
    * Run the executor.
    */
@@ -33,14 +86,66 @@ class Interpreter final {
 
   hlir::framework::Tensor GetTensor(const std::string& name);
 
+  //! The number of the instructions run for the current batch bucket, each of them a group of the ops fused.
+  size_t num_instructions() const;
+
   std::shared_ptr<hlir::framework::Scope> scope();
 
+  /**
+   * Create a context to run the model loaded with its own activations, e.g. one for each thread serving the requests.
+   * The contexts share the compiled code and the parameters with the interpreter, which should outlive them. It can be
+   * called concurrently.
+   */
+  std::unique_ptr<ExecutionContext> CreateContext() const;
+
   ~Interpreter();
 
  private:
+  friend class ExecutionContext;
+
   class Impl;
   std::unique_ptr<Impl> impl_;
 };
 
+/**
+ * A lightweight instance of the model loaded by an Interpreter, see Interpreter::CreateContext. It owns only the
+ * inputs, outputs and intermediate tensors, the parameters are shared and read only. The contexts can run concurrently
+ * in different threads, while a context should be used by one thread at a time.
+ *
+ * On X86 the instructions of a context run one by one in the calling thread, the parallel loops in them use
+ * runtime::CpuThreadPool() if it is idle and run inline otherwise, so the concurrent requests keep all the cores busy
+ * with no oversubscription. On NVGPU the runs are serialized, as they share the stream and the cudnn handle.
+ */
+class ExecutionContext final {
+ public:
+  //! Select the batch bucket for the following runs, the same as Interpreter::SetBatchSize.
+  void SetBatchSize(int batch_size);
+
+  void Run();
+
+  //! Get a tensor of the context, or a parameter shared by all the contexts which should not be written.
+  hlir::framework::Tensor GetTensor(const std::string& name);
+
+  ~ExecutionContext();
+
+ private:
+  friend class Interpreter;
+
+  //! The tensors and the program of the context in a batch bucket.
+  struct Instance {
+    std::shared_ptr<hlir::framework::Scope> scope;
+    std::unique_ptr<hlir::framework::Program> program;
+  };
+
+  explicit ExecutionContext(const Interpreter::Impl* impl);
+
+  //! The instance of the current bucket, created on the first use.
+  Instance& instance();
+
+  const Interpreter::Impl* impl_;
+  std::vector<std::unique_ptr<Instance>> instances_;
+  int current_bucket_{};
+};
+
 }  // namespace frontend
 }  // namespace cinn
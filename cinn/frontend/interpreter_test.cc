@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include "cinn/runtime/use_extern_funcs.h"
 
 DEFINE_string(model_dir, "", "");
@@ -15,4 +19,103 @@ TEST(Interpreter, basic) {
   executor.GetTensor("fc_0.tmp_2");
 }
 
+TEST(Interpreter, fetch_intermediate) {
+  // The intermediate tensors of the fc keep their values after the run, with the memory plan off by default.
+  gflags::FlagSaver flag_saver;
+  FLAGS_cinn_elementwise_fusion = false;
+  Interpreter executor({"A"}, {{1, 30}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+  auto input = executor.GetTensor("A");
+  auto* data = input->mutable_data<float>(common::DefaultHostTarget());
+  for (int i = 0; i < input->shape().numel(); i++) data[i] = i % 7 * 0.1f - 0.3f;
+  executor.Run();
+
+  auto biased = executor.GetTensor("fc_0.tmp_1");
+  auto output = executor.GetTensor("fc_0.tmp_2");
+  ASSERT_EQ(biased->shape().numel(), output->shape().numel());
+  for (int i = 0; i < output->shape().numel(); i++) {
+    ASSERT_NEAR(output->data<float>()[i], std::max(biased->data<float>()[i], 0.f), 1e-6);
+  }
+}
+
+TEST(Interpreter, op_fusion) {
+  // The fc of the model is a mul, an elementwise_add of the bias and a relu, fused into one kernel on X86 too.
+  gflags::FlagSaver flag_saver;
+  for (bool fuse : {false, true}) {
+    FLAGS_cinn_elementwise_fusion = fuse;
+    Interpreter executor({"A"}, {{1, 30}});
+    executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+    ASSERT_EQ(executor.num_instructions(), fuse ? 1UL : 3UL);
+    executor.Run();
+  }
+}
+
+TEST(Interpreter, batch_buckets) {
+  Interpreter executor({"A"}, {{1, 30}});
+  executor.SetBatchBuckets({1, 4, 16});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+
+  for (int batch_size : {1, 3, 16}) {
+    executor.SetBatchSize(batch_size);
+    auto input = executor.GetTensor("A");
+    ASSERT_EQ(input->shape().data()[0], batch_size == 3 ? 4 : batch_size);
+    auto* data = input->mutable_data<float>(common::DefaultHostTarget());
+    for (int i = 0; i < input->shape().numel(); i++) data[i] = i % 30 * 0.1f;
+    executor.Run();
+  }
+
+  // The rows of the same input get the same output in all the buckets.
+  executor.SetBatchSize(1);
+  auto output = executor.GetTensor("fc_0.tmp_2");
+  std::vector<float> expected(output->data<float>(), output->data<float>() + output->shape().numel());
+  executor.SetBatchSize(16);
+  output = executor.GetTensor("fc_0.tmp_2");
+  ASSERT_EQ(output->shape().data()[0], 16);
+  for (int i = 0; i < output->shape().numel(); i++) {
+    ASSERT_NEAR(output->data<float>()[i], expected[i % expected.size()], 1e-5);
+  }
+}
+
+TEST(Interpreter, contexts) {
+  Interpreter executor({"A"}, {{4, 30}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+
+  // The expected outputs of each thread's input, run by the interpreter itself.
+  const int num_threads = 4;
+  auto fill_input       = [](hlir::framework::Tensor input, int thread_id) {
+    auto* data = input->mutable_data<float>(common::DefaultHostTarget());
+    for (int i = 0; i < input->shape().numel(); i++) data[i] = (i % 30 + thread_id) * 0.1f;
+  };
+  std::vector<std::vector<float>> expected(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    fill_input(executor.GetTensor("A"), t);
+    executor.Run();
+    auto output = executor.GetTensor("fc_0.tmp_2");
+    expected[t].assign(output->data<float>(), output->data<float>() + output->shape().numel());
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<float>> results(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      auto context = executor.CreateContext();
+      for (int repeat = 0; repeat < 10; repeat++) {
+        fill_input(context->GetTensor("A"), t);
+        context->Run();
+      }
+      auto output = context->GetTensor("fc_0.tmp_2");
+      results[t].assign(output->data<float>(), output->data<float>() + output->shape().numel());
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (int t = 0; t < num_threads; t++) {
+    ASSERT_EQ(results[t].size(), expected[t].size());
+    for (int i = 0; i < expected[t].size(); i++) ASSERT_NEAR(results[t][i], expected[t][i], 1e-5);
+  }
+  // The inputs are of the context's own.
+  auto context = executor.CreateContext();
+  ASSERT_NE(context->GetTensor("A")->data<float>(), executor.GetTensor("A")->data<float>());
+}
+
 }  // namespace cinn::frontend
@@ -1,5 +1,7 @@
 #include "cinn/frontend/paddle/model_parser.h"
 
+#include <climits>
+#include <cstring>
 #include <fstream>
 #include <vector>
 
@@ -9,9 +11,56 @@
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/common.h"
 #include "cinn/frontend/paddle/compatible_pb.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+DEFINE_bool(cinn_mmap_params,
+            true,
+            "Whether to map the files of the parameters into the memory and share the mapping with the tensors, "
+            "instead of reading them into buffers.");
+DEFINE_int32(cinn_load_params_threads,
+             4,
+             "The number of the threads to load the parameters of a Paddle model with in the background of the "
+             "converting and compiling, 0 to load them before converting.");
+}  // namespace cinn
 
 namespace cinn::frontend::paddle {
 
+namespace {
+
+//! The alignment the memory of a tensor shared with a mapped file should have, the loads and stores generated by
+//! CodeGenLLVM assume 8 bytes.
+constexpr uintptr_t kMappedTensorAlignment = 8;
+
+//! Read the values of a mapped file in order.
+class MappedFileReader {
+ public:
+  MappedFileReader(const utils::MappedFile& file, size_t offset) : file_(file), offset_(offset) {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Skip(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  //! Skip \p size bytes and return the address of them.
+  const uint8_t* Skip(size_t size) {
+    CHECK_LE(offset_ + size, file_.size()) << "Unexpected end of the file " << file_.path();
+    const uint8_t* data = file_.data() + offset_;
+    offset_ += size;
+    return data;
+  }
+
+  size_t offset() const { return offset_; }
+
+ private:
+  const utils::MappedFile& file_;
+  size_t offset_;
+};
+
+}  // namespace
+
 int SizeOfType(framework_proto::VarType::Type type) {
   using Type = framework_proto::VarType::Type;
   switch (static_cast<int>(type)) {
@@ -115,6 +164,71 @@ void LoadLoDTensor(std::istream &is, hlir::framework::Variable *var, const commo
   TensorFromStream(is, tensor.operator->(), target);
 }
 
+void LoadLoDTensor(const std::shared_ptr<utils::MappedFile> &file,
+                   size_t *offset,
+                   hlir::framework::Variable *var,
+                   const common::Target &target) {
+  using Type   = framework_proto::VarType::Type;
+  auto &tensor = std::get<hlir::framework::Tensor>(*var);
+  MappedFileReader reader(*file, *offset);
+  uint32_t version = reader.Read<uint32_t>();
+  VLOG(3) << "model version " << version;
+  // The LoD information is not used.
+  uint64_t lod_level = reader.Read<uint64_t>();
+  for (uint64_t i = 0; i < lod_level; ++i) reader.Skip(reader.Read<uint64_t>());
+
+  CHECK_EQ(reader.Read<uint32_t>(), 0U) << "Only version 0 is supported";
+  framework_proto::VarType::TensorDesc desc;
+  int32_t desc_size = reader.Read<int32_t>();
+  CHECK(desc.ParseFromArray(reader.Skip(desc_size), desc_size)) << "Cannot parse tensor desc";
+  std::vector<int32_t> dims_vec(desc.dims().begin(), desc.dims().end());
+  tensor->Resize(hlir::framework::Shape(dims_vec));
+  size_t size = tensor->shape().numel() * SizeOfType(desc.data_type());
+  auto *data  = const_cast<uint8_t *>(reader.Skip(size));
+  *offset     = reader.offset();
+
+  if (target.arch == Target::Arch::X86) {
+    // The tensor keeps the file mapped.
+    bool shared = reinterpret_cast<uintptr_t>(data) % kMappedTensorAlignment == 0;
+    switch (static_cast<int>(desc.data_type())) {
+#define SET_TENSOR(desc, type, precision)                          \
+  case Type::VarType_Type_##desc:                                  \
+    if (shared) {                                                  \
+      tensor->ShareMemory(file, data, size);                       \
+      file->Prefetch(data, size);                                  \
+    } else {                                                       \
+      std::memcpy(tensor->mutable_data<type>(target), data, size); \
+      file->Discard(data, size);                                   \
+    }                                                              \
+    tensor->set_type(precision);                                   \
+    break
+
+      SET_TENSOR(FP32, float, Float(32));
+      SET_TENSOR(INT8, int8_t, Int(8));
+      SET_TENSOR(INT16, int16_t, Int(16));
+      SET_TENSOR(INT32, int32_t, Int(32));
+      SET_TENSOR(INT64, int64_t, Int(64));
+#undef SET_TENSOR
+      default:
+        LOG(FATAL) << "unknown type " << desc.data_type();
+    }
+    VLOG(4) << "Loaded a tensor of " << size << " bytes at offset " << data - file->data() << " of " << file->path()
+            << (shared ? " without copy" : " by copy");
+  } else if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    if (desc.data_type() != Type::VarType_Type_FP32) LOG(FATAL) << "[CUDA] The type is not fp32!!";
+    auto *dst = tensor->mutable_data<float>(target);
+    tensor->set_type(Float(32));
+    CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(dst), data, size, cudaMemcpyHostToDevice));
+    file->Discard(data, size);
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
 void ReadBinaryFile(const std::string &filename, std::string *contents) {
   std::ifstream fin(filename, std::ios::in | std::ios::binary);
   CHECK(fin.is_open()) << "Cannot open file: " << filename;
@@ -143,6 +257,11 @@ void LoadParams(const std::string &path) {}
 
 // Load directly to CPU, and latter transfer to other devices.
 void LoadParam(const std::string &path, hlir::framework::Variable *out, const common::Target &target) {
+  if (FLAGS_cinn_mmap_params) {
+    size_t offset = 0;
+    LoadLoDTensor(utils::MappedFile::Open(path), &offset, out, target);
+    return;
+  }
   std::ifstream fin(path, std::ios::binary);
   CHECK(fin.is_open()) << "failed to open file " << path;
   LoadLoDTensor(fin, out, target);
@@ -190,6 +309,15 @@ void LoadCombinedParamsPb(const std::string &path,
   if (params_from_memory) {
     std::stringstream fin(path, std::ios::in | std::ios::binary);
     load_var_func(fin);
+  } else if (FLAGS_cinn_mmap_params) {
+    // The tensors share the mapping of the whole file.
+    auto file     = utils::MappedFile::Open(path);
+    size_t offset = 0;
+    for (auto &name : paramlist) {
+      LoadLoDTensor(file, &offset, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(name)), target);
+    }
+    CHECK_EQ(offset, file->size()) << "You are not allowed to load partial data via"
+                                   << " LoadCombinedParamsPb, use LoadParam instead.";
   } else {
     std::ifstream fin(path, std::ios::binary);
     CHECK(fin.is_open());
@@ -204,7 +332,8 @@ void LoadModelPb(const std::string &model_dir,
                  cpp::ProgramDesc *cpp_prog,
                  bool combined,
                  bool model_from_memory,
-                 const common::Target &target) {
+                 const common::Target &target,
+                 ParamLoader *loader) {
   CHECK(cpp_prog);
   CHECK(scope);
   cpp_prog->ClearBlocks();
@@ -230,6 +359,11 @@ void LoadModelPb(const std::string &model_dir,
   CHECK(!(!combined && model_from_memory)) << "If you want use the model_from_memory,"
                                            << " you should load the combined model using cfg.set_model_buffer "
                                               "interface.";
+  if (loader && !model_from_memory) {
+    loader->Start(model_dir, combined ? param_file_temp : "", *cpp_prog);
+    VLOG(4) << "Start loading the params of [" << model_dir << "] in the background";
+    return;
+  }
   if (combined) {
     LoadCombinedParamsPb(param_file_temp, scope, *cpp_prog, model_from_memory, target);
   } else {
@@ -240,10 +374,9 @@ void LoadModelPb(const std::string &model_dir,
       std::string file_path = model_dir + "/" + var.name();
       VLOG(4) << "reading weight " << var.name();
 
-      std::ifstream file(file_path, std::ios::binary);
       switch (var.type().type()) {
         case framework_proto::VarType_Type_LOD_TENSOR:
-          LoadLoDTensor(file, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
+          LoadParam(file_path, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
           break;
         default:
           LOG(FATAL) << "unknown weight type";
@@ -254,4 +387,189 @@ void LoadModelPb(const std::string &model_dir,
   VLOG(4) << "Load protobuf model in [" << model_dir << "] successfully";
 }
 
+namespace {
+
+//! The offset of the end of the LoD tensor at \p offset of \p file, only the header of the tensor is read.
+size_t SkipLoDTensor(const utils::MappedFile &file, size_t offset) {
+  MappedFileReader reader(file, offset);
+  reader.Read<uint32_t>();
+  uint64_t lod_level = reader.Read<uint64_t>();
+  for (uint64_t i = 0; i < lod_level; ++i) reader.Skip(reader.Read<uint64_t>());
+  CHECK_EQ(reader.Read<uint32_t>(), 0U) << "Only version 0 is supported";
+  framework_proto::VarType::TensorDesc desc;
+  int32_t desc_size = reader.Read<int32_t>();
+  CHECK(desc.ParseFromArray(reader.Skip(desc_size), desc_size)) << "Cannot parse tensor desc";
+  size_t size = SizeOfType(desc.data_type());
+  for (auto dim : desc.dims()) size *= dim;
+  reader.Skip(size);
+  return reader.offset();
+}
+
+}  // namespace
+
+ParamLoader::ParamLoader(hlir::framework::Scope *scope, const common::Target &target, int num_threads)
+    : scope_(scope), target_(target), num_threads_(num_threads) {
+  CHECK(scope_);
+  CHECK_GE(num_threads_, 0);
+}
+
+void ParamLoader::Start(const std::string &model_dir, const std::string &param_file, const cpp::ProgramDesc &prog) {
+  CHECK(threads_.empty() && params_.empty()) << "The loader is started already";
+  start_     = std::chrono::steady_clock::now();
+  end_       = start_;
+  model_dir_ = model_dir;
+
+  auto program = prog;
+  auto &block  = *program.GetBlock<cpp::BlockDesc>(0);
+  for (size_t i = 0; i < block.VarsSize(); ++i) {
+    auto &var = *block.GetVar<cpp::VarDesc>(i);
+    if (!IsPersistable(var)) continue;
+    CHECK(var.GetType() == cpp::VarDescAPI::Type::LOD_TENSOR) << "unknown weight type of " << var.Name();
+    Param param;
+    param.file_name = var.Name();
+    param.name      = utils::TransValidVarName(var.Name());
+    for (auto dim : var.GetShape()) param.shape.push_back(dim);
+    // A dim unknown in the desc is got from the tensor loaded.
+    if (std::any_of(param.shape.begin(), param.shape.end(), [](int dim) { return dim <= 0; })) param.shape.clear();
+    params_.push_back(std::move(param));
+  }
+
+  bool stream = false;
+  if (!param_file.empty()) {
+    // The combined parameters are in the order of their names.
+    std::sort(params_.begin(), params_.end(), [](auto &a, auto &b) { return a.file_name < b.file_name; });
+    if (FLAGS_cinn_mmap_params) {
+      combined_file_ = utils::MappedFile::Open(param_file);
+      size_t offset  = 0;
+      for (auto &param : params_) {
+        param.offset = offset;
+        offset       = SkipLoDTensor(*combined_file_, offset);
+      }
+      CHECK_EQ(offset, combined_file_->size()) << "You are not allowed to load partial data via"
+                                               << " LoadCombinedParamsPb, use LoadParam instead.";
+    } else {
+      stream = true;
+    }
+  }
+  if (!stream) {
+    // Load the parameters used by the first ops first, so that the converting of them waits the least.
+    std::unordered_map<std::string, int> first_uses;
+    for (size_t i = 0; i < block.OpsSize(); ++i) {
+      for (auto &arg : block.GetOp<cpp::OpDesc>(i)->InputArgumentNames()) first_uses.emplace(arg, first_uses.size());
+    }
+    auto first_use = [&](const Param &param) {
+      auto it = first_uses.find(param.file_name);
+      return it == first_uses.end() ? INT_MAX : it->second;
+    };
+    std::stable_sort(params_.begin(), params_.end(), [&](auto &a, auto &b) { return first_use(a) < first_use(b); });
+  }
+
+  // The scope is not thread safe, the variables are created before the loading.
+  for (int i = 0; i < params_.size(); i++) {
+    params_[i].var                = scope_->Var<hlir::framework::Tensor>(params_[i].name);
+    param_index_[params_[i].name] = i;
+  }
+  VLOG(3) << "Start loading " << params_.size() << " params with " << num_threads_ << " threads"
+          << (stream ? " by streaming " + param_file : "");
+
+  if (stream) {
+    if (num_threads_ == 0) {
+      Stream(param_file);
+    } else {
+      threads_.emplace_back([this, param_file] { Stream(param_file); });
+    }
+  } else if (num_threads_ == 0) {
+    WorkerLoop();
+  } else {
+    int num_threads = std::min<int>(num_threads_, params_.size());
+    for (int i = 0; i < num_threads; i++) threads_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+void ParamLoader::WorkerLoop() {
+  for (int i = next_param_++; i < params_.size(); i = next_param_++) {
+    Load(i);
+    MarkLoaded(i);
+  }
+}
+
+void ParamLoader::Load(int index) {
+  auto &param = params_[index];
+  utils::RecordEvent event("LoadParam", "io", param.name);
+  if (combined_file_) {
+    size_t offset = param.offset;
+    LoadLoDTensor(combined_file_, &offset, param.var, target_);
+  } else {
+    LoadParam(model_dir_ + "/" + param.file_name, param.var, target_);
+  }
+}
+
+void ParamLoader::Stream(const std::string &path) {
+  std::ifstream fin(path, std::ios::binary);
+  CHECK(fin.is_open()) << "failed to open file " << path;
+  for (int i = 0; i < params_.size(); i++) {
+    CHECK(static_cast<bool>(fin)) << "There is a problem with loading model parameters";
+    {
+      utils::RecordEvent event("LoadParam", "io", params_[i].name);
+      LoadLoDTensor(fin, params_[i].var, target_);
+    }
+    MarkLoaded(i);
+  }
+  fin.peek();
+  CHECK(fin.eof()) << "You are not allowed to load partial data via"
+                   << " LoadCombinedParamsPb, use LoadParam instead.";
+}
+
+void ParamLoader::MarkLoaded(int index) {
+  auto &param  = params_[index];
+  auto &tensor = std::get<hlir::framework::Tensor>(*param.var);
+  // The program is converted with the shape in the desc before the parameter is loaded.
+  if (!param.shape.empty()) {
+    CHECK(tensor->shape().data() == param.shape)
+        << "The shape of the param " << param.name << " loaded differs from the one in the program desc";
+  }
+  bytes_ += tensor->shape().numel() * tensor->type().bytes();
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    param.loaded = true;
+    end_         = std::chrono::steady_clock::now();
+    num_loaded_++;
+  }
+  loaded_cv_.notify_all();
+}
+
+void ParamLoader::Wait(const std::string &name) {
+  auto it = param_index_.find(name);
+  if (it == param_index_.end()) return;
+  auto &param = params_[it->second];
+  std::unique_lock<std::mutex> lock(mu_);
+  if (param.loaded) return;
+  auto start = std::chrono::steady_clock::now();
+  loaded_cv_.wait(lock, [&] { return param.loaded; });
+  wait_ms_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ParamLoader::WaitAll() {
+  {
+    std::unique_lock<std::mutex> lock(mu_);
+    auto start = std::chrono::steady_clock::now();
+    loaded_cv_.wait(lock, [&] { return num_loaded_ == params_.size(); });
+    wait_ms_ += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+  for (auto &thread : threads_) thread.join();
+  threads_.clear();
+}
+
+double ParamLoader::load_ms() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return std::chrono::duration<double, std::milli>(end_ - start_).count();
+}
+
+double ParamLoader::wait_ms() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return wait_ms_;
+}
+
+ParamLoader::~ParamLoader() { WaitAll(); }
+
 }  // namespace cinn::frontend::paddle
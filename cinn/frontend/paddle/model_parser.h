@@ -1,7 +1,15 @@
 #pragma once
+#include <gflags/gflags.h>
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "cinn/frontend/paddle/cpp/program_desc.h"
@@ -11,11 +19,20 @@
 #include "cinn/frontend/paddle/pb/program_desc.h"
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/framework/tensor.h"
+#include "cinn/utils/mapped_file.h"
+
+namespace cinn {
+DECLARE_bool(cinn_mmap_params);
+DECLARE_int32(cinn_load_params_threads);
+}  // namespace cinn
 
 namespace cinn::frontend::paddle {
 namespace framework_proto = ::paddle::framework::proto;
 
-// Read a model and files of parameters in pb format.
+class ParamLoader;
+
+// Read a model and files of parameters in pb format. If \p loader is given, the parameters are loaded by it in the
+// background, see ParamLoader.
 void LoadModelPb(const std::string& model_dir,
                  const std::string& model_file,
                  const std::string& param_file,
@@ -23,13 +40,24 @@ void LoadModelPb(const std::string& model_dir,
                  cpp::ProgramDesc* cpp_prog,
                  bool combined                = true,
                  bool model_from_memory       = false,
-                 const common::Target& target = common::DefaultHostTarget());
+                 const common::Target& target = common::DefaultHostTarget(),
+                 ParamLoader* loader          = nullptr);
 
 // Read a __model__ file.
 std::unique_ptr<framework_proto::ProgramDesc> LoadProgram(const std::string& path, bool program_from_memory = false);
 
 void LoadLoDTensor(std::istream& is, hlir::framework::Variable* var, const common::Target& target);
 
+/**
+ * Load the LoD tensor at \p *offset of the mapped \p file into \p var, and move \p *offset past it. On X86 the tensor
+ * shares the memory of the mapping if its data is aligned, otherwise the data is copied once and the pages copied are
+ * dropped from the memory of the process.
+ */
+void LoadLoDTensor(const std::shared_ptr<utils::MappedFile>& file,
+                   size_t* offset,
+                   hlir::framework::Variable* var,
+                   const common::Target& target);
+
 // Read a single file containing all the parameters.
 void LoadParams(const std::string& path);
 
@@ -49,4 +77,95 @@ void TensorFromStream(std::istream& is,
                       const common::Target& target = common::DefaultHostTarget());
 void ReadBinaryFile(const std::string& filename, std::string* contents);
 
+/**
+ * ParamLoader loads the parameters of a model into a scope on background threads, so that the loading overlaps with
+ * the converting and compiling of the program. The variables of the parameters are created in the scope when the
+ * loading starts, the tensor of a parameter should not be accessed before Wait for it returns.
+ *
+ * The parameters are loaded in the order of their first uses by the ops. The ones in separate files are loaded in
+ * parallel. The combined ones are located by a scan of the tensor headers and loaded in parallel if the file is mapped,
+ * see FLAGS_cinn_mmap_params, otherwise the file is streamed by a single thread, tensor by tensor in the order of the
+ * file, with no buffer besides the tensors.
+ */
+class ParamLoader {
+ public:
+  /**
+   * @param num_threads The number of the threads to load with, 0 to load in the calling thread of Start.
+   */
+  ParamLoader(hlir::framework::Scope* scope, const common::Target& target, int num_threads);
+
+  /**
+   * Start loading the persistable variables of the main block of \p prog.
+   * @param model_dir The directory of the separate files of the parameters, each named after its variable.
+   * @param param_file The file of the combined parameters, empty if the parameters are in separate files.
+   */
+  void Start(const std::string& model_dir, const std::string& param_file, const cpp::ProgramDesc& prog);
+
+  //! Whether \p name, a valid variable name, is a parameter being loaded.
+  bool IsParam(const std::string& name) const { return param_index_.count(name); }
+
+  //! The shape of the parameter \p name in the program desc, available before it is loaded, empty if it is unknown.
+  const std::vector<int>& GetShape(const std::string& name) const { return params_[param_index_.at(name)].shape; }
+
+  //! Block till the parameter \p name is loaded, it returns at once if \p name is not a parameter.
+  void Wait(const std::string& name);
+
+  //! Block till all the parameters are loaded.
+  void WaitAll();
+
+  int num_params() const { return params_.size(); }
+  int num_threads() const { return num_threads_; }
+  //! The bytes of the parameters loaded.
+  int64_t bytes() const { return bytes_; }
+  //! The milliseconds from Start to the last parameter loaded, valid after WaitAll.
+  double load_ms() const;
+  //! The milliseconds the callers of Wait and WaitAll are blocked.
+  double wait_ms() const;
+
+  ~ParamLoader();
+
+ private:
+  struct Param {
+    //! The name of the variable in the model, that is of its file if the parameters are in separate files.
+    std::string file_name;
+    //! The valid name of the variable in the scope.
+    std::string name;
+    std::vector<int> shape;
+    hlir::framework::Variable* var{};
+    //! The offset of the tensor in the combined file.
+    size_t offset{};
+    bool loaded{};
+  };
+
+  void WorkerLoop();
+  //! Load params_[\p index] from the separate file or the mapped combined file.
+  void Load(int index);
+  //! Load all the parameters in the order of the combined file \p path, which is not mapped.
+  void Stream(const std::string& path);
+  void MarkLoaded(int index);
+
+  hlir::framework::Scope* scope_{};
+  common::Target target_;
+  int num_threads_{};
+
+  std::string model_dir_;
+  std::shared_ptr<utils::MappedFile> combined_file_;
+  std::vector<Param> params_;
+  std::unordered_map<std::string, int> param_index_;
+
+  std::vector<std::thread> threads_;
+  std::atomic<int> next_param_{0};
+  std::atomic<int64_t> bytes_{0};
+
+  mutable std::mutex mu_;
+  std::condition_variable loaded_cv_;
+  //! The fields below are guarded by mu_.
+  int num_loaded_{};
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+  double wait_ms_{};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ParamLoader);
+};
+
 }  // namespace cinn::frontend::paddle
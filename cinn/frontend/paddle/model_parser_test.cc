@@ -2,6 +2,14 @@
 
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 DEFINE_string(model_dir, "<NOTEXIST>", "model directory path");
 
@@ -28,4 +36,142 @@ TEST(LoadModelPb, naive_model) {
   // fetch
 }
 
+namespace {
+
+//! A directory unique to the test process, removed with the files in it.
+class TempDir {
+ public:
+  TempDir() {
+    std::string pattern = ::testing::TempDir() + "cinn_model_parser_test_XXXXXX";
+    char* path          = mkdtemp(pattern.data());
+    CHECK(path) << "Failed to create a temporary directory from " << pattern;
+    path_ = path;
+  }
+
+  ~TempDir() {
+    for (auto& file : files_) std::remove(file.c_str());
+    rmdir(path_.c_str());
+  }
+
+  const std::string& path() const { return path_; }
+
+  //! The path of the file \p name in the directory, it is removed with the directory.
+  std::string File(const std::string& name) {
+    files_.push_back(path_ + "/" + name);
+    return files_.back();
+  }
+
+ private:
+  std::string path_;
+  std::vector<std::string> files_;
+};
+
+// Write a float LoD tensor in the format of Paddle, returns the offset of its data.
+size_t WriteLoDTensor(std::ostream& os, const std::vector<int>& dims, const std::vector<float>& data) {
+  auto write = [&](const auto& value) { os.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+  write(uint32_t(0));  // version
+  write(uint64_t(0));  // lod level
+  write(uint32_t(0));  // tensor version
+  framework_proto::VarType::TensorDesc desc;
+  desc.set_data_type(framework_proto::VarType::FP32);
+  for (int dim : dims) desc.add_dims(dim);
+  std::string desc_str = desc.SerializeAsString();
+  write(int32_t(desc_str.size()));
+  os.write(desc_str.data(), desc_str.size());
+  size_t offset = os.tellp();
+  os.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+  return offset;
+}
+
+}  // namespace
+
+TEST(LoadLoDTensor, mapped) {
+  // Tensors of different ranks, so that their data are at different alignments.
+  std::vector<std::vector<int>> dims{{32}, {4, 8}, {2, 4, 4}, {1, 2, 4, 4}};
+  std::vector<float> data(32);
+  for (int i = 0; i < data.size(); i++) data[i] = i * 0.5f;
+  TempDir dir;
+  std::string path = dir.File("mapped_params");
+  std::vector<size_t> data_offsets;
+  {
+    std::ofstream os(path, std::ios::binary);
+    for (auto& d : dims) data_offsets.push_back(WriteLoDTensor(os, d, data));
+  }
+
+  hlir::framework::Scope scope;
+  auto file     = utils::MappedFile::Open(path);
+  size_t offset = 0;
+  for (int i = 0; i < dims.size(); i++) {
+    auto name = "param_" + std::to_string(i);
+    LoadLoDTensor(file, &offset, scope.Var<hlir::framework::Tensor>(name), common::DefaultHostTarget());
+    auto tensor = scope.GetTensor(name);
+    ASSERT_EQ(tensor->shape().data(), dims[i]);
+    ASSERT_EQ(tensor->type(), Float(32));
+    // The mapping is page aligned, the tensors at 8 bytes aligned offsets share it.
+    bool shared = tensor->data<float>() == reinterpret_cast<const float*>(file->data() + data_offsets[i]);
+    ASSERT_EQ(shared, data_offsets[i] % 8 == 0);
+    for (int j = 0; j < data.size(); j++) ASSERT_EQ(tensor->data<float>()[j], data[j]);
+  }
+  ASSERT_EQ(offset, file->size());
+
+  // The tensors keep the file mapped.
+  file.reset();
+  std::remove(path.c_str());
+  ASSERT_EQ(scope.GetTensor("param_0")->data<float>()[31], data[31]);
+}
+
+TEST(ParamLoader, combined_and_separate) {
+  // The params are used in the reverse order of their names, that is of the combined file.
+  std::vector<std::string> names{"w_c", "w_b", "w_a"};
+  std::vector<std::vector<int>> dims{{32}, {4, 8}, {2, 4, 4}};
+  std::vector<float> data(32);
+  for (int i = 0; i < data.size(); i++) data[i] = i * 0.5f;
+  TempDir dir;
+  std::string path = dir.File("combined_params");
+  {
+    std::ofstream os(path, std::ios::binary);
+    for (int i = names.size() - 1; i >= 0; i--) WriteLoDTensor(os, dims[i], data);
+  }
+  for (int i = 0; i < names.size(); i++) {
+    std::ofstream os(dir.File(names[i]), std::ios::binary);
+    WriteLoDTensor(os, dims[i], data);
+  }
+
+  cpp::ProgramDesc prog;
+  auto* block = prog.AddBlock<cpp::BlockDesc>();
+  for (int i = 0; i < names.size(); i++) {
+    auto* var = block->AddVar<cpp::VarDesc>();
+    var->SetName(names[i]);
+    var->SetType(cpp::VarDescAPI::Type::LOD_TENSOR);
+    var->SetPersistable(true);
+    var->SetShape(std::vector<int64_t>(dims[i].begin(), dims[i].end()));
+    auto* op = block->AddOp<cpp::OpDesc>();
+    op->SetType("relu");
+    op->SetInput("X", {names[i]});
+  }
+
+  for (auto [param_file, mmap] : std::vector<std::pair<std::string, bool>>{{path, true}, {path, false}, {"", true}}) {
+    FLAGS_cinn_mmap_params = mmap;
+    hlir::framework::Scope scope;
+    ParamLoader loader(&scope, common::DefaultHostTarget(), 2);
+    loader.Start(dir.path(), param_file, prog);
+    ASSERT_EQ(loader.num_params(), names.size());
+    for (int i = 0; i < names.size(); i++) {
+      ASSERT_TRUE(loader.IsParam(names[i]));
+      // The shape is known before the param is loaded.
+      ASSERT_EQ(loader.GetShape(names[i]), dims[i]);
+      loader.Wait(names[i]);
+      auto tensor = scope.GetTensor(names[i]);
+      ASSERT_EQ(tensor->shape().data(), dims[i]);
+      for (int j = 0; j < data.size(); j++) ASSERT_EQ(tensor->data<float>()[j], data[j]);
+    }
+    ASSERT_FALSE(loader.IsParam("x"));
+    loader.Wait("x");
+    loader.WaitAll();
+    ASSERT_EQ(loader.bytes(), names.size() * data.size() * sizeof(float));
+    ASSERT_GE(loader.load_ms(), 0);
+  }
+  FLAGS_cinn_mmap_params = true;
+}
+
 }  // namespace cinn::frontend::paddle
@@ -71,6 +71,7 @@ void PaddleModelToProgram::AddOpMapper_scale() {
     } else {  // the newly refactored format
       // load scale tensor
       CHECK_EQ(op_desc.Input("ScaleTensor").size(), 1UL);
+      WaitVar(utils::TransValidVarName(op_desc.Input("ScaleTensor").front()));
       auto* scale_tensor_var = scope_->FindVar(op_desc.Input("ScaleTensor").front());
       CHECK(scale_tensor_var) << "No scale tensor found in the scope";
       auto& scale_tensor = std::get<hlir::framework::Tensor>(*scale_tensor_var);
@@ -408,8 +409,13 @@ void PaddleModelToProgram::AddOp(const paddle::cpp::OpDesc& op_desc) {
   LOG(FATAL) << "Not supported op [" << op_desc.Type() << "] found";
 }
 
+void PaddleModelToProgram::WaitVar(const std::string& name) {
+  if (param_loader_) param_loader_->Wait(name);
+}
+
 void PaddleModelToProgram::TransposeVar(const std::string& name) {
   CheckVarNameValid(name);
+  WaitVar(name);
   auto* var = scope_->FindVar(name);
   if (var) {
     auto& tensor = std::get<hlir::framework::Tensor>(*var);
@@ -456,6 +462,7 @@ void PaddleModelToProgram::TransposeVar(const std::string& name) {
 
 void PaddleModelToProgram::ReverseHWVar(const std::string& name) {
   CheckVarNameValid(name);
+  WaitVar(name);
   auto* var = scope_->FindVar(name);
   if (var) {
     auto& tensor = std::get<hlir::framework::Tensor>(*var);
@@ -498,7 +505,13 @@ Variable PaddleModelToProgram::GetVar(const std::string& name) {
     auto& tensor = std::get<hlir::framework::Tensor>(*var);
     Variable var;
     var.set_id(name);
-    var->shape = tensor->shape().data();
+    if (param_loader_ && param_loader_->IsParam(name) && !param_loader_->GetShape(name).empty()) {
+      // The parameter may be loading in the background, the shape in the program desc needs no wait.
+      var->shape = param_loader_->GetShape(name);
+    } else {
+      WaitVar(name);
+      var->shape = tensor->shape().data();
+    }
     // TODO(Superjomn) Make this determined by model.
     var->type = Float(32);
     AddVar(name, var);
@@ -511,7 +524,7 @@ Variable PaddleModelToProgram::GetVar(const std::string& name) {
 
 std::unique_ptr<Program> PaddleModelToProgram::operator()(const std::string& model_dir, bool is_combined) {
   paddle::cpp::ProgramDesc program_desc;
-  paddle::LoadModelPb(model_dir, "__model__", "", scope_, &program_desc, is_combined, false, target_);
+  paddle::LoadModelPb(model_dir, "__model__", "", scope_, &program_desc, is_combined, false, target_, param_loader_);
   CHECK_EQ(program_desc.BlocksSize(), 1) << "CINN can only support the model with a single block";
   auto* block_desc = program_desc.GetBlock<paddle::cpp::BlockDesc>(0);
 
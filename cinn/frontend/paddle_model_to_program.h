@@ -22,10 +22,20 @@
 namespace cinn {
 namespace frontend {
 
+namespace paddle {
+class ParamLoader;
+}  // namespace paddle
+
 class PaddleModelToProgram {
  public:
-  explicit PaddleModelToProgram(hlir::framework::Scope* scope, const common::Target& target)
-      : scope_(scope), target_(target), program_(new Program) {
+  /**
+   * @param param_loader If given, the parameters are loaded by it in the background and the converting waits only for
+   * the ones whose data it reads, otherwise they are loaded before converting.
+   */
+  explicit PaddleModelToProgram(hlir::framework::Scope* scope,
+                                const common::Target& target,
+                                paddle::ParamLoader* param_loader = nullptr)
+      : scope_(scope), target_(target), param_loader_(param_loader), program_(new Program) {
     CHECK(scope_);
 
     AddOpMapper_feed();
@@ -82,6 +92,9 @@ class PaddleModelToProgram {
 
   void ReverseHWVar(const std::string& name);
 
+  //! Wait for the data of the parameter \p name to be loaded, if it is loaded in the background.
+  void WaitVar(const std::string& name);
+
  private:
   std::unordered_map<std::string, std::function<void(const paddle::cpp::OpDesc&)>> op_mappers_;
   std::unique_ptr<Program> program_;
@@ -90,6 +103,7 @@ class PaddleModelToProgram {
   std::unordered_map<std::string, std::string> var_model_to_program_map_;
   hlir::framework::Scope* scope_{};
   common::Target target_;
+  paddle::ParamLoader* param_loader_{};
 };
 
 }  // namespace frontend
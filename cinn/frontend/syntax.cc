@@ -150,9 +150,13 @@ std::ostream& operator<<(std::ostream& os, const Instruction& instr) {
 std::tuple<std::unique_ptr<Program>,
            std::unordered_map<std::string, Variable>,
            std::unordered_map<std::string, std::string>>
-LoadPaddleProgram(const std::string& model_dir, Scope* scope, bool is_combined, const common::Target& target) {
+LoadPaddleProgram(const std::string& model_dir,
+                  Scope* scope,
+                  bool is_combined,
+                  const common::Target& target,
+                  paddle::ParamLoader* param_loader) {
   LOG(INFO) << "Loading Paddle model from " << model_dir;
-  PaddleModelToProgram _(scope, target);
+  PaddleModelToProgram _(scope, target, param_loader);
   return std::make_tuple(_(model_dir, is_combined), _.var_map(), _.var_model_to_program_map());
 }
 
@@ -190,6 +194,50 @@ Variable Program::elementwise_mul(const Variable& a, const Variable& b, int axis
   return instr.GetOutput(0);
 }
 
+#define REDUCTION_METHOD(op__)                                                            \
+  Variable Program::op__(const Variable& a, const std::vector<int>& dim, bool keep_dim) { \
+    Instruction instr(#op__, {a});                                                        \
+    instr.SetAttr("dim", dim);                                                            \
+    instr.SetAttr("keep_dim", keep_dim);                                                  \
+    AppendInstruction(instr);                                                             \
+    return instr.GetOutput(0);                                                            \
+  }
+
+REDUCTION_METHOD(reduce_sum)
+REDUCTION_METHOD(reduce_prod)
+REDUCTION_METHOD(reduce_max)
+REDUCTION_METHOD(reduce_min)
+#undef REDUCTION_METHOD
+
+Variable Program::cast(const Variable& a, const std::string& dtype) {
+  Instruction instr("cast", {a});
+  instr.SetAttr("dtype", dtype);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable Program::quantize(const Variable& a, float scale) {
+  Instruction instr("quantize", {a});
+  instr.SetAttr("scale", scale);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable Program::dequantize(const Variable& a, float scale) {
+  Instruction instr("dequantize", {a});
+  instr.SetAttr("scale", scale);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable Program::requantize(const Variable& a, float scale, float out_scale) {
+  Instruction instr("requantize", {a});
+  instr.SetAttr("scale", scale);
+  instr.SetAttr("out_scale", out_scale);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable Program::relu(const Variable& a) {
   Instruction instr("relu", {a});
   AppendInstruction(instr);
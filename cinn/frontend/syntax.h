@@ -21,6 +21,10 @@
 namespace cinn {
 namespace frontend {
 
+namespace paddle {
+class ParamLoader;
+}  // namespace paddle
+
 struct Program;
 struct Variable;
 
@@ -188,6 +192,41 @@ struct Program {
    */
   Variable elementwise_mul(const Variable& a, const Variable& b, int axis = -1);
 
+  /**
+   * Reduce the input Variable over the axes \p dim, all the axes if it is empty.
+   *
+   * @param a The input variable.
+   * @param dim The axes to reduce, a negative one counts from the last axis.
+   * @param keep_dim Whether the reduced axes are left in the result as dims of extent 1.
+   * @return The result.
+   */
+  Variable reduce_sum(const Variable& a, const std::vector<int>& dim, bool keep_dim = false);
+  Variable reduce_prod(const Variable& a, const std::vector<int>& dim, bool keep_dim = false);
+  Variable reduce_max(const Variable& a, const std::vector<int>& dim, bool keep_dim = false);
+  Variable reduce_min(const Variable& a, const std::vector<int>& dim, bool keep_dim = false);
+
+  /**
+   * Cast the elements of the input Variable to another type, e.g. to compute in bfloat16.
+   *
+   * @param a The input variable.
+   * @param dtype The name of the type, e.g. "float32", "float16" or "bfloat16".
+   * @return The result.
+   */
+  Variable cast(const Variable& a, const std::string& dtype);
+
+  /**
+   * Quantize the float32 input Variable to int8, round(a / scale) clamped to [-127, 127].
+   *
+   * @param a The input variable.
+   * @param scale The value each step of the int8 stands for, e.g. the max of the magnitudes of \p a divided by 127.
+   * @return The int8 result.
+   */
+  Variable quantize(const Variable& a, float scale);
+  //! The float32 of the int8 or int32 input Variable quantized by \p scale.
+  Variable dequantize(const Variable& a, float scale);
+  //! The int32 input Variable quantized by \p scale, requantized to int8 by \p out_scale.
+  Variable requantize(const Variable& a, float scale, float out_scale);
+
   /**
    * Apply Rectified Linear Unit on input Variable.
    * Actually apply: outupt = max(input,0)
@@ -267,6 +306,8 @@ struct Program {
  * Load a Paddle model and return a frontend program.
  * @param model_dir The directory of the model.
  * @param is_combined Whether the parameters in the Paddle model is combined.
+ * @param param_loader The loader to load the parameters with in the background, the program is converted meanwhile and
+ * the caller should wait for it before running. If it is null, the parameters are loaded before converting.
  * @returns program, a map from name to variable and a map from variable name in Paddle model to the corresponding in
  * program
  */
@@ -276,7 +317,8 @@ std::tuple<std::unique_ptr<Program>,
 LoadPaddleProgram(const std::string& model_dir,
                   hlir::framework::Scope* scope,
                   bool is_combined,
-                  const common::Target& target = common::DefaultHostTarget());
+                  const common::Target& target      = common::DefaultHostTarget(),
+                  paddle::ParamLoader* param_loader = nullptr);
 
 std::ostream& operator<<(std::ostream& os, const Variable& x);
 std::ostream& operator<<(std::ostream& os, const Instruction& instr);
@@ -0,0 +1,238 @@
+#include "cinn/hlir/framework/aot_module.h"
+
+#include <dlfcn.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "cinn/runtime/cpu/thread_backend.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+// The loader builds with no cinncore, so it splits the names by itself instead of by utils::Split.
+std::vector<std::string> SplitNames(const std::string& str) {
+  std::vector<std::string> res;
+  if (str == "-") return res;
+  std::stringstream ss(str);
+  for (std::string name; std::getline(ss, name, ',');) res.push_back(name);
+  return res;
+}
+
+std::string JoinNames(const std::vector<std::string>& names) { return names.empty() ? "-" : utils::Join(names, ","); }
+
+template <typename T>
+void WritePod(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadPod(std::istream& is) {
+  T value;
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  CHECK(is) << "Unexpected end of the parameters file";
+  return value;
+}
+
+void WriteString(std::ostream& os, const std::string& str) {
+  WritePod<uint32_t>(os, str.size());
+  os.write(str.data(), str.size());
+}
+
+std::string ReadString(std::istream& is) {
+  std::string str(ReadPod<uint32_t>(is), '\0');
+  is.read(str.data(), str.size());
+  return str;
+}
+
+uint64_t NumBytes(const std::string& dtype, const std::vector<int>& shape) {
+  uint64_t res = AotDtype(dtype).bytes();
+  for (int dim : shape) res *= dim;
+  return res;
+}
+
+constexpr uint32_t kParamsMagic = 0x43504152;  // "CPAR"
+// The offsets in the slab are aligned to the cache line, see the MemoryPlan pass.
+constexpr int kAlignment = 64;
+
+}  // namespace
+
+std::string AotManifest::ToString() const {
+  std::stringstream ss;
+  ss << "slab " << slab_size << "\n";
+  for (auto& tensor : tensors) {
+    ss << "tensor " << tensor.name << " " << tensor.dtype << " "
+       << (tensor.shape.empty() ? "-" : utils::Join(tensor.shape, ",")) << " " << tensor.offset << "\n";
+  }
+  for (auto& instr : instrs) {
+    ss << "instr " << instr.fn_name << " " << JoinNames(instr.inputs) << " " << JoinNames(instr.outputs) << "\n";
+  }
+  return ss.str();
+}
+
+AotManifest AotManifest::FromString(const std::string& str) {
+  AotManifest manifest;
+  std::stringstream ss(str);
+  std::string line;
+  while (std::getline(ss, line)) {
+    if (line.empty()) continue;
+    std::stringstream fields(line);
+    std::string kind;
+    fields >> kind;
+    if (kind == "slab") {
+      fields >> manifest.slab_size;
+    } else if (kind == "tensor") {
+      TensorInfo tensor;
+      std::string shape;
+      fields >> tensor.name >> tensor.dtype >> shape >> tensor.offset;
+      for (auto& dim : SplitNames(shape)) tensor.shape.push_back(std::stoi(dim));
+      manifest.tensors.push_back(std::move(tensor));
+    } else if (kind == "instr") {
+      InstrInfo instr;
+      std::string inputs, outputs;
+      fields >> instr.fn_name >> inputs >> outputs;
+      instr.inputs  = SplitNames(inputs);
+      instr.outputs = SplitNames(outputs);
+      manifest.instrs.push_back(std::move(instr));
+    } else {
+      LOG(FATAL) << "Invalid line in the manifest: " << line;
+    }
+    CHECK(fields) << "Invalid line in the manifest: " << line;
+  }
+  return manifest;
+}
+
+cinn_type_t AotDtype(const std::string& dtype) {
+  if (dtype == "float32") return cinn_float32_t();
+  if (dtype == "float16") return cinn_float16_t();
+  if (dtype == "bfloat16") return cinn_bfloat16_t();
+  if (dtype == "float64") return cinn_float64_t();
+  if (dtype == "int8") return cinn_int8_t();
+  if (dtype == "int32") return cinn_int32_t();
+  LOG(FATAL) << "The dtype " << dtype
+             << " is not supported by the exported libraries, only float16, bfloat16, float32, float64, int8 and int32 "
+                "are";
+  return cinn_unk_t();
+}
+
+void SaveParams(const std::vector<AotParam>& params, const std::string& path) {
+  std::ofstream file(path, std::ios::binary);
+  CHECK(file) << "Failed to open " << path;
+  WritePod<uint32_t>(file, kParamsMagic);
+  WritePod<uint32_t>(file, params.size());
+  for (auto& param : params) {
+    WriteString(file, param.name);
+    WriteString(file, param.dtype);
+    WritePod<uint32_t>(file, param.shape.size());
+    for (int dim : param.shape) WritePod<int32_t>(file, dim);
+    file.write(reinterpret_cast<const char*>(param.data), NumBytes(param.dtype, param.shape));
+  }
+  CHECK(file) << "Failed to write " << path;
+}
+
+int LoadParams(const std::string& path, AotModule* module) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file) << "Failed to open " << path;
+  CHECK_EQ(ReadPod<uint32_t>(file), kParamsMagic) << path << " is not a parameters file";
+  uint32_t num_params = ReadPod<uint32_t>(file);
+  for (uint32_t i = 0; i < num_params; i++) {
+    std::string name  = ReadString(file);
+    std::string dtype = ReadString(file);
+    std::vector<int> dims(ReadPod<uint32_t>(file));
+    for (auto& dim : dims) dim = ReadPod<int32_t>(file);
+    auto* buffer = module->GetBuffer(name);
+    std::vector<int> shape(buffer->dims, buffer->dims + buffer->dimensions);
+    CHECK(shape == dims) << "The shape of the parameter " << name << " mismatches, [" << utils::Join(dims, ",")
+                         << "] vs [" << utils::Join(shape, ",") << "]";
+    CHECK(AotDtype(dtype) == buffer->type) << "The dtype of the parameter " << name << " mismatches";
+    file.read(reinterpret_cast<char*>(buffer->memory), NumBytes(dtype, dims));
+    CHECK(file) << "Unexpected end of the parameters file " << path;
+  }
+  return num_params;
+}
+
+std::unique_ptr<AotModule> AotModule::Load(const std::string& path) {
+  std::unique_ptr<AotModule> module(new AotModule);
+  module->handle_ = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  CHECK(module->handle_) << "Failed to load " << path << ": " << dlerror();
+  auto* get_manifest = reinterpret_cast<const char* (*)()>(dlsym(module->handle_, kAotManifestGetter));
+  CHECK(get_manifest) << path << " is not exported by GraphCompiler::ExportLibrary";
+  module->manifest_ = AotManifest::FromString(get_manifest());
+  auto& manifest    = module->manifest_;
+
+  // Reproduce the buffer layout of BuildScope.
+  auto allocate = [&](uint64_t nbytes) {
+    nbytes = std::max<uint64_t>((nbytes + kAlignment - 1) / kAlignment * kAlignment, kAlignment);
+    auto* memory = static_cast<uint8_t*>(std::aligned_alloc(kAlignment, nbytes));
+    CHECK(memory) << "Failed to allocate " << nbytes << " bytes";
+    module->memory_.emplace_back(memory, std::free);
+    return memory;
+  };
+  uint8_t* slab = manifest.slab_size > 0 ? allocate(manifest.slab_size) : nullptr;
+  for (auto& info : manifest.tensors) {
+    CHECK_LT(info.shape.size(), CINN_BUFFER_MAX_DIMS) << "The tensor " << info.name << " has too many dims";
+    auto buffer              = std::make_unique<cinn_buffer_t>();
+    buffer->device           = cinn_x86_device;
+    buffer->device_interface = cinn_x86_device_interface();
+    buffer->type             = AotDtype(info.dtype);
+    buffer->resize(info.shape.data(), info.shape.size());
+    buffer->memory_size = NumBytes(info.dtype, info.shape);
+    buffer->align       = kAlignment;
+    if (info.offset >= 0) {
+      CHECK(slab) << "The tensor " << info.name << " is planned in an empty slab";
+      CHECK_LE(info.offset + buffer->memory_size, manifest.slab_size) << "The tensor " << info.name << " exceeds the slab";
+      buffer->memory = slab + info.offset;
+    } else {
+      buffer->memory = allocate(buffer->memory_size);
+    }
+    module->buffers_[info.name] = std::move(buffer);
+  }
+
+  std::ifstream params(path + ".params");
+  if (params) {
+    params.close();
+    int num_params = LoadParams(path + ".params", module.get());
+    VLOG(1) << "Loaded " << num_params << " parameters of " << path;
+  }
+
+  // The arguments of an instruction are the inputs followed by the outputs, the same as Instruction.
+  for (auto& info : manifest.instrs) {
+    auto* fn = reinterpret_cast<lower_func_ptr_t>(dlsym(module->handle_, info.fn_name.c_str()));
+    CHECK(fn) << "No function " << info.fn_name << " in " << path;
+    std::vector<cinn_pod_value_t> args;
+    for (auto& name : info.inputs) args.emplace_back(module->GetBuffer(name));
+    for (auto& name : info.outputs) args.emplace_back(module->GetBuffer(name));
+    module->instrs_.emplace_back(fn, std::move(args));
+  }
+  // Start the threads of the parallel jobs on loading instead of on the first run.
+  runtime::CpuThreadPool();
+  return module;
+}
+
+void AotModule::Execute() {
+  for (auto& [fn, args] : instrs_) fn(args.data(), args.size());
+}
+
+cinn_buffer_t* AotModule::GetBuffer(const std::string& name) {
+  auto it = buffers_.find(name);
+  CHECK(it != buffers_.end()) << "No tensor " << name << " in the library";
+  return it->second.get();
+}
+
+AotModule::~AotModule() {
+  // The instructions refer to the functions in the library.
+  instrs_.clear();
+  if (handle_) dlclose(handle_);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/macros.h"
+#include "cinn/runtime/cinn_runtime.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+//! The function a library exported by GraphCompiler::ExportLibrary returns its AotManifest by.
+constexpr char kAotManifestGetter[] = "cinn_aot_manifest";
+
+/**
+ * The program in a library exported by GraphCompiler::ExportLibrary: the tensors with their layout and the
+ * instructions in the order to run.
+ */
+struct AotManifest {
+  struct TensorInfo {
+    std::string name;
+    //! The type of the elements as CINN prints it, e.g. float32, bfloat16 or int8.
+    std::string dtype;
+    std::vector<int> shape;
+    //! The offset in the slab the intermediate tensors share, -1 if the tensor has its own memory.
+    int offset{-1};
+  };
+
+  struct InstrInfo {
+    std::string fn_name;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+  };
+
+  //! The size in bytes of the slab planned by the MemoryPlan pass.
+  uint32_t slab_size{};
+  std::vector<TensorInfo> tensors;
+  std::vector<InstrInfo> instrs;
+
+  //! A line per tensor and instruction, the names of CINN contain no whitespace.
+  std::string ToString() const;
+
+  static AotManifest FromString(const std::string& str);
+};
+
+/**
+ * The runtime type of the elements named \p dtype in an AotManifest, only the dtypes GraphCompiler compiles are
+ * supported, that is float16, bfloat16, float32, float64, int8 and int32.
+ */
+cinn_type_t AotDtype(const std::string& dtype);
+
+//! A tensor to save by SaveParams.
+struct AotParam {
+  std::string name;
+  std::string dtype;
+  std::vector<int> shape;
+  const void* data{};
+};
+
+/**
+ * Save the tensors \p params to the file \p path, in the order given.
+ */
+void SaveParams(const std::vector<AotParam>& params, const std::string& path);
+
+class AotModule;
+
+/**
+ * Load the tensors saved by SaveParams into the tensors of \p module, which should be of the same dtypes and shapes.
+ * @return the number of the tensors loaded.
+ */
+int LoadParams(const std::string& path, AotModule* module);
+
+/**
+ * AotModule runs a library exported by GraphCompiler::ExportLibrary. It opens the library with dlopen and takes the
+ * functions from it, so no code is generated or compiled on loading.
+ *
+ * It depends only on the runtime of CINN, and builds into cinn_aot_loader too, so a process serving the libraries does
+ * not link cinncore and LLVM. The library calls the extern functions of CINN, e.g. the math functions and
+ * cinn_backend_parallel_launch, which the shared cinn_runtime_cpu the loader links provides.
+ */
+class AotModule {
+ public:
+  /**
+   * Load the library \p path and the parameters in \p path.params if it exists.
+   */
+  static std::unique_ptr<AotModule> Load(const std::string& path);
+
+  //! Run the instructions in order.
+  void Execute();
+
+  //! The buffer of the tensor \p name on host, to fill the inputs and read the outputs by.
+  cinn_buffer_t* GetBuffer(const std::string& name);
+
+  const AotManifest& manifest() const { return manifest_; }
+
+  ~AotModule();
+
+ private:
+  AotModule() = default;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(AotModule);
+
+  void* handle_{};
+  AotManifest manifest_;
+  //! The memory of the tensors, the planned ones share a slab.
+  std::vector<std::shared_ptr<uint8_t>> memory_;
+  std::unordered_map<std::string, std::unique_ptr<cinn_buffer_t>> buffers_;
+  std::vector<std::pair<lower_func_ptr_t, std::vector<cinn_pod_value_t>>> instrs_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,81 @@
+#include "cinn/hlir/framework/aot_module.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(AotManifest, to_string) {
+  AotManifest manifest;
+  manifest.slab_size = 256;
+  manifest.tensors.push_back({"A", "float32", {4, 8}});
+  manifest.tensors.push_back({"B", "int8", {4, 8}, 128});
+  manifest.instrs.push_back({"fn_relu_0", {"A"}, {"B"}});
+  manifest.instrs.push_back({"fn_fill_1", {}, {"A"}});
+
+  auto parsed = AotManifest::FromString(manifest.ToString());
+  ASSERT_EQ(parsed.slab_size, 256U);
+  ASSERT_EQ(parsed.tensors.size(), 2UL);
+  ASSERT_EQ(parsed.tensors[0].shape, (std::vector<int>{4, 8}));
+  ASSERT_EQ(parsed.tensors[1].dtype, "int8");
+  ASSERT_EQ(parsed.tensors[0].offset, -1);
+  ASSERT_EQ(parsed.tensors[1].offset, 128);
+  ASSERT_EQ(parsed.instrs.size(), 2UL);
+  ASSERT_EQ(parsed.instrs[0].fn_name, "fn_relu_0");
+  ASSERT_EQ(parsed.instrs[0].outputs, std::vector<std::string>{"B"});
+  ASSERT_TRUE(parsed.instrs[1].inputs.empty());
+}
+
+TEST(AotModule, export_and_load) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable w("W");
+  Type t   = Float(32);
+  a->shape = {32, 16};
+  w->shape = {32, 16};
+  a->type  = t;
+  w->type  = t;
+  auto c   = prog.add(a, w);
+  auto d   = prog.relu(c);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPasses(graph.get(), {"InferShape", "OpFusion", "MemoryPlan"});
+  auto scope = BuildScope(target, graph);
+
+  auto* w_ptr = scope->GetTensor("W")->mutable_data<float>(target);
+  for (int i = 0; i < 32 * 16; i++) w_ptr[i] = i % 7 - 3.f;
+
+  std::string path = "./test_aot_module.so";
+  GraphCompiler gc(target, scope, graph);
+  gc.ExportLibrary(path, {"W"});
+
+  // The library runs in buffers of its own, with the parameters loaded from the sidecar file.
+  auto module = AotModule::Load(path);
+  std::remove(path.c_str());
+  std::remove((path + ".params").c_str());
+  auto* a_ptr = reinterpret_cast<float*>(module->GetBuffer("A")->memory);
+  for (int i = 0; i < 32 * 16; i++) a_ptr[i] = i % 5 - 2.f;
+  module->Execute();
+
+  auto* d_ptr = reinterpret_cast<const float*>(module->GetBuffer(d->id)->memory);
+  for (int i = 0; i < 32 * 16; i++) {
+    ASSERT_NEAR(d_ptr[i], std::max(a_ptr[i] + w_ptr[i], 0.f), 1e-5);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,424 @@
+#include "cinn/hlir/framework/auto_tuner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/utils/string.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+
+DEFINE_string(cinn_tuning_log, "", "The tuning log of the schedule configs GraphCompiler uses, disabled if empty.");
+
+namespace hlir {
+namespace framework {
+
+namespace {
+
+struct AttrPrinter {
+  std::ostream& os;
+  explicit AttrPrinter(std::ostream& os) : os(os) {}
+
+  template <typename T>
+  void operator()(const T& v) {
+    os << v;
+  }
+  template <typename T>
+  void operator()(const std::vector<T>& vs) {
+    os << utils::Join(vs, ",");
+  }
+};
+
+//! All the combinations of the candidates of \p knobs, the one of the default values goes first.
+std::vector<pe::ScheduleConfig> EnumerateConfigs(const std::vector<pe::ScheduleConfig::Knob>& knobs) {
+  std::vector<pe::ScheduleConfig> configs(1);
+  pe::ScheduleConfig default_config;
+  for (auto& knob : knobs) {
+    default_config.Set(knob.name, knob.default_value);
+    std::vector<pe::ScheduleConfig> extended;
+    for (auto& config : configs) {
+      for (int value : knob.candidates) {
+        extended.push_back(config);
+        extended.back().Set(knob.name, value);
+      }
+    }
+    configs = std::move(extended);
+  }
+  auto it = std::find_if(configs.begin(), configs.end(), [&](const pe::ScheduleConfig& config) {
+    return config.factors() == default_config.factors();
+  });
+  CHECK(it != configs.end()) << "The candidates of a factor should contain its default value";
+  std::iter_swap(configs.begin(), it);
+  return configs;
+}
+
+//! The distance of two configs in the log2 space of the factors.
+double Distance(const pe::ScheduleConfig& a, const pe::ScheduleConfig& b) {
+  double distance = 0;
+  for (auto& [name, value] : a.factors()) {
+    auto it = b.factors().find(name);
+    if (it != b.factors().end()) distance += std::abs(std::log2(value) - std::log2(it->second));
+  }
+  return distance;
+}
+
+/**
+ * A quadratic model of the log cost in the log2 space of the factors, fitted to the configs measured by the ridge
+ * regression. It ranks the candidates not measured yet.
+ */
+class CostModel {
+ public:
+  explicit CostModel(const std::vector<pe::ScheduleConfig::Knob>& knobs) : knobs_(knobs) {}
+
+  //! The number of the features, the model predicts nothing till it has as many samples.
+  int num_features() const { return 1 + 2 * knobs_.size(); }
+
+  void AddSample(const pe::ScheduleConfig& config, double cost_us) {
+    features_.push_back(Features(config));
+    targets_.push_back(std::log(cost_us));
+  }
+
+  bool trained() const { return !weights_.empty(); }
+
+  void Train() {
+    if (features_.size() < static_cast<size_t>(num_features())) return;
+    // Solve (X^T X + lambda I) w = X^T y by the Gaussian elimination with partial pivoting.
+    const int n = num_features();
+    std::vector<std::vector<double>> a(n, std::vector<double>(n + 1));
+    for (int s = 0; s < features_.size(); s++) {
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) a[i][j] += features_[s][i] * features_[s][j];
+        a[i][n] += features_[s][i] * targets_[s];
+      }
+    }
+    for (int i = 0; i < n; i++) a[i][i] += kLambda;
+    for (int col = 0; col < n; col++) {
+      int pivot = col;
+      for (int row = col + 1; row < n; row++) {
+        if (std::abs(a[row][col]) > std::abs(a[pivot][col])) pivot = row;
+      }
+      std::swap(a[col], a[pivot]);
+      for (int row = 0; row < n; row++) {
+        if (row == col) continue;
+        double ratio = a[row][col] / a[col][col];
+        for (int k = col; k <= n; k++) a[row][k] -= ratio * a[col][k];
+      }
+    }
+    weights_.resize(n);
+    for (int i = 0; i < n; i++) weights_[i] = a[i][n] / a[i][i];
+  }
+
+  //! The predicted log cost of \p config.
+  double Predict(const pe::ScheduleConfig& config) const {
+    CHECK(trained());
+    auto features = Features(config);
+    double res    = 0;
+    for (int i = 0; i < features.size(); i++) res += weights_[i] * features[i];
+    return res;
+  }
+
+ private:
+  static constexpr double kLambda = 1e-3;
+
+  std::vector<double> Features(const pe::ScheduleConfig& config) const {
+    std::vector<double> res{1.};
+    for (auto& knob : knobs_) {
+      auto it  = config.factors().find(knob.name);
+      double x = std::log2(it == config.factors().end() ? knob.default_value : it->second);
+      res.push_back(x);
+      res.push_back(x * x);
+    }
+    return res;
+  }
+
+  std::vector<pe::ScheduleConfig::Knob> knobs_;
+  std::vector<std::vector<double>> features_;
+  std::vector<double> targets_;
+  std::vector<double> weights_;
+};
+
+//! Create the inputs and outputs of \p node, with the inputs filled randomly.
+std::shared_ptr<Scope> CreateScope(const Node* node, const Graph& graph, const Target& target) {
+  auto& shape_dict = graph.GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto scope       = std::make_shared<Scope>();
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  auto create = [&](const std::string& id, bool fill) {
+    auto tensor = std::get<Tensor>(*scope->Var<Tensor>(id));
+    tensor->Resize(Shape(shape_dict.at(id)));
+    auto* data = tensor->mutable_data<float>(target);
+    if (fill) {
+      for (int i = 0; i < tensor->shape().numel(); i++) data[i] = dist(rng);
+    }
+  };
+  for (auto& in : node->inlinks_in_order()) create(in->source()->as<NodeData>()->id(), true);
+  for (auto& out : node->outlinks_in_order()) create(out->sink()->as<NodeData>()->id(), false);
+  return scope;
+}
+
+//! The average cost of \p instr in microseconds.
+double MeasureCost(Instruction* instr, int num_repeats) {
+  // Warm up the caches, and bind the arguments.
+  instr->Run();
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < num_repeats; i++) instr->Run();
+  return timer.Stop() * 1000. / num_repeats;
+}
+
+//! Whether \p outputs match \p reference, up to the rounding of the reordered float accumulations.
+bool OutputsMatch(const std::vector<std::vector<float>>& outputs, const std::vector<std::vector<float>>& reference) {
+  if (outputs.size() != reference.size()) return false;
+  for (int i = 0; i < outputs.size(); i++) {
+    if (outputs[i].size() != reference[i].size()) return false;
+    for (int j = 0; j < outputs[i].size(); j++) {
+      if (!(std::abs(outputs[i][j] - reference[i][j]) <= 1e-3f * std::max(1.f, std::abs(reference[i][j])))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string GetWorkloadKey(const Node* node, const Graph& graph) {
+  auto& shape_dict = graph.GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph.GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  std::stringstream ss;
+  ss << node->op()->name << "(";
+  for (auto& in : node->inlinks_in_order()) {
+    std::string id = in->source()->as<NodeData>()->id();
+    ss << dtype_dict.at(id) << "[" << utils::Join(shape_dict.at(id), ",") << "]";
+  }
+  ss << ")";
+  // Sort the attributes to make the key independent of the hash map's iteration order.
+  std::map<std::string, AttrType> attrs(node->attrs.attr_store.begin(), node->attrs.attr_store.end());
+  for (auto& [name, attr] : attrs) {
+    ss << " " << name << "=";
+    std::visit(AttrPrinter(ss), attr);
+  }
+  return ss.str();
+}
+
+TuningLog& TuningLog::Global() {
+  static TuningLog* log = [] {
+    auto* log = new TuningLog;
+    if (!FLAGS_cinn_tuning_log.empty() && log->Load(FLAGS_cinn_tuning_log)) {
+      VLOG(1) << "Loaded " << log->size() << " tuning records from " << FLAGS_cinn_tuning_log;
+    }
+    return log;
+  }();
+  return *log;
+}
+
+bool TuningLog::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) continue;
+    auto first  = line.find('\t');
+    auto second = line.rfind('\t');
+    if (first == std::string::npos || first == second) {
+      LOG(WARNING) << "Skip the invalid tuning record: " << line;
+      continue;
+    }
+    Update(line.substr(0, first),
+           pe::ScheduleConfig::FromString(line.substr(first + 1, second - first - 1)),
+           std::stod(line.substr(second + 1)));
+  }
+  return true;
+}
+
+void TuningLog::Save(const std::string& path) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  std::ofstream file(path);
+  CHECK(file) << "Failed to open the tuning log " << path;
+  for (auto& [workload, record] : records_) {
+    file << workload << "\t" << record.config << "\t" << record.cost_us << "\n";
+  }
+}
+
+bool TuningLog::Lookup(const std::string& workload, pe::ScheduleConfig* config) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = records_.find(workload);
+  if (it == records_.end()) return false;
+  *config = pe::ScheduleConfig::FromString(it->second.config);
+  return true;
+}
+
+void TuningLog::Update(const std::string& workload, const pe::ScheduleConfig& config, double cost_us) {
+  std::lock_guard<std::mutex> lock(mu_);
+  auto it = records_.find(workload);
+  if (it != records_.end() && it->second.cost_us <= cost_us) return;
+  records_[workload] = Record{config.ToString(), cost_us};
+}
+
+size_t TuningLog::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return records_.size();
+}
+
+AutoTuner::AutoTuner(const Target& target, const TuningOptions& options) : target_(target), options_(options) {
+  CHECK(target_.arch == Target::Arch::X86) << "AutoTuner only supports X86 now";
+  CHECK_GT(options_.batch_size, 0);
+  CHECK_GT(options_.num_measure_threads, 0);
+  if (options_.num_threads <= 0) options_.num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+}
+
+int AutoTuner::Tune(const std::shared_ptr<Graph>& graph, TuningLog* log) {
+  GraphCompiler compiler(target_, std::make_shared<Scope>(), graph);
+  std::unordered_set<std::string> visited;
+  int num_tuned = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node) continue;
+    auto workload = GetWorkloadKey(node, *graph);
+    pe::ScheduleConfig config;
+    if (!visited.insert(workload).second || log->Lookup(workload, &config)) continue;
+    if (TuneNode(&compiler, node, workload, log)) num_tuned++;
+  }
+  return num_tuned;
+}
+
+bool AutoTuner::TuneNode(GraphCompiler* compiler, const Node* node, const std::string& workload, TuningLog* log) {
+  // Lower once to collect the tunable factors of the schedule.
+  pe::ScheduleConfig recorder;
+  {
+    pe::ScheduleConfig::Guard guard(&recorder);
+    compiler->GetOpFunc(node);
+  }
+  if (recorder.knobs().empty()) return false;
+  auto configs = EnumerateConfigs(recorder.knobs());
+  VLOG(1) << "Tuning " << workload << " over " << configs.size() << " configs";
+
+  // A scope for each measuring thread, filled with the same inputs.
+  std::vector<std::shared_ptr<Scope>> scopes;
+  for (int i = 0; i < options_.num_measure_threads; i++) {
+    scopes.push_back(CreateScope(node, *compiler->graph_, target_));
+  }
+  backends::ExecutionOptions exec_options;
+  exec_options.num_compile_threads = options_.num_threads;
+
+  CostModel model(recorder.knobs());
+  // The outputs of the default config, the other configs should compute the same.
+  std::vector<std::vector<float>> reference;
+  std::vector<bool> measured(configs.size());
+  int best              = -1;
+  double best_cost      = std::numeric_limits<double>::max();
+  double default_cost   = 0;
+  int num_measured      = 0;
+  int num_rejected      = 0;
+  int num_stale_batches = 0;
+  while (num_measured < std::min<int>(options_.num_trials, configs.size()) &&
+         num_stale_batches < options_.early_stopping) {
+    // The default config goes first. Then the cheapest candidates by the cost model go first once it is trained, or
+    // the closest ones to the best config till then.
+    std::vector<std::pair<double, int>> ranks;
+    for (int i = 0; i < configs.size(); i++) {
+      if (measured[i]) continue;
+      double score = best < 0 ? Distance(configs[i], configs[0])
+                              : model.trained() ? model.Predict(configs[i]) : Distance(configs[i], configs[best]);
+      ranks.emplace_back(i == 0 ? -std::numeric_limits<double>::max() : score, i);
+    }
+    int batch_size =
+        std::min({options_.batch_size, static_cast<int>(ranks.size()), options_.num_trials - num_measured});
+    std::partial_sort(ranks.begin(), ranks.begin() + batch_size, ranks.end());
+
+    // Lower the batch on this thread, and compile the functions concurrently in a single module.
+    ir::Module::Builder builder(UniqName("tuning_module"), target_);
+    std::vector<std::string> fn_names;
+    for (int i = 0; i < batch_size; i++) {
+      pe::ScheduleConfig::Guard guard(&configs[ranks[i].second]);
+      auto func = compiler->GetOpFunc(node);
+      func->name += "_config_" + std::to_string(i);
+      fn_names.push_back(func->name);
+      builder.AddFunction(func);
+    }
+    auto engine = backends::ExecutionEngine::Create(exec_options);
+    engine->Link<backends::CodeGenX86>(builder.Build());
+
+    // Measure the batch on the measuring threads, each config in the scope of its thread, and keep its outputs.
+    std::vector<double> costs(batch_size);
+    std::vector<std::vector<std::vector<float>>> outputs(batch_size);
+    std::atomic<int> next{0};
+    auto measure = [&](Scope* scope) {
+      for (int i = next++; i < batch_size; i = next++) {
+        // Poison the outputs, so a config leaving some of them unwritten does not pass with the ones of the last.
+        for (auto& name : compiler->OpGetOutputNames(node)) {
+          auto tensor = scope->GetTensor(name);
+          std::fill_n(tensor->mutable_data<float>(target_), tensor->shape().numel(), std::nanf(""));
+        }
+        Instruction instr(target_,
+                          scope,
+                          compiler->OpGetInputNames(node),
+                          compiler->OpGetOutputNames(node),
+                          node->op()->name);
+        instr.SetLoweredFunc(reinterpret_cast<lower_func_ptr_t>(engine->Lookup(fn_names[i])));
+        costs[i] = MeasureCost(&instr, options_.num_repeats);
+        for (auto& name : compiler->OpGetOutputNames(node)) {
+          auto tensor = scope->GetTensor(name);
+          auto* data  = tensor->data<float>();
+          outputs[i].emplace_back(data, data + tensor->shape().numel());
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 1; t < std::min(options_.num_measure_threads, batch_size); t++) {
+      threads.emplace_back(measure, scopes[t].get());
+    }
+    measure(scopes[0].get());
+    for (auto& thread : threads) thread.join();
+
+    bool improved = false;
+    for (int i = 0; i < batch_size; i++) {
+      int index       = ranks[i].second;
+      double cost     = costs[i];
+      measured[index] = true;
+      num_measured++;
+      if (index == 0) {
+        default_cost = cost;
+        reference    = std::move(outputs[i]);
+      } else if (!OutputsMatch(outputs[i], reference)) {
+        LOG(WARNING) << "The config [" << configs[index].ToString() << "] of " << workload
+                     << " computes wrong outputs, rejected";
+        num_rejected++;
+        continue;
+      }
+      VLOG(2) << "Config [" << configs[index].ToString() << "] costs " << cost << " us";
+      model.AddSample(configs[index], cost);
+      if (cost < best_cost) {
+        improved  = best >= 0;
+        best      = index;
+        best_cost = cost;
+      }
+    }
+    model.Train();
+    num_stale_batches = improved ? 0 : num_stale_batches + 1;
+  }
+
+  VLOG(1) << "The best config of " << workload << " is [" << configs[best].ToString() << "], " << best_cost
+          << " us, the heuristic one costs " << default_cost << " us, " << num_rejected << " configs rejected";
+  log->Update(workload, configs[best], best_cost);
+  return true;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <gflags/gflags.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/pe/schedule_config.h"
+
+namespace cinn {
+
+DECLARE_string(cinn_tuning_log);
+
+namespace hlir {
+namespace framework {
+
+class GraphCompiler;
+
+/**
+ * Get the key of the workload of \p node in the tuning log: the op, the types and shapes of its inputs and its
+ * attributes. The ops of the same key share the best schedule config.
+ */
+std::string GetWorkloadKey(const Node* node, const Graph& graph);
+
+/**
+ * The best schedule configs measured by the AutoTuner, by the workload keys. It is saved to a text file of a record
+ * per line: the workload key, the config and the cost in microseconds separated by tabs.
+ */
+class TuningLog {
+ public:
+  struct Record {
+    std::string config;
+    double cost_us{};
+  };
+
+  //! The log loaded from FLAGS_cinn_tuning_log on the first call, GraphCompiler looks the configs up in it.
+  static TuningLog& Global();
+
+  /**
+   * Load the records in \p path, the cheaper record of a workload wins.
+   * @return false if the file can not be opened.
+   */
+  bool Load(const std::string& path);
+
+  void Save(const std::string& path) const;
+
+  /**
+   * Get the best config of \p workload.
+   * @return false if the workload is not tuned.
+   */
+  bool Lookup(const std::string& workload, pe::ScheduleConfig* config) const;
+
+  //! Record \p config of \p workload if it is cheaper than the one recorded.
+  void Update(const std::string& workload, const pe::ScheduleConfig& config, double cost_us);
+
+  size_t size() const;
+
+ private:
+  mutable std::mutex mu_;
+  std::map<std::string, Record> records_;
+};
+
+struct TuningOptions {
+  //! The max number of configs measured for a workload.
+  int num_trials{64};
+  //! The number of configs compiled together, the functions of a batch are compiled concurrently.
+  int batch_size{8};
+  //! Stop tuning a workload after the batches of no improvement.
+  int early_stopping{2};
+  //! The number of runs to average the cost of a config over, after a warm-up run.
+  int num_repeats{10};
+  //! The number of threads to compile a batch with, 0 for the number of cores.
+  int num_threads{0};
+  //! The number of configs of a batch measured concurrently, each in inputs of its own. The concurrent configs share
+  //! the cores and the memory bandwidth, so more than 1 trades the accuracy of the costs for the tuning time.
+  int num_measure_threads{1};
+};
+
+/**
+ * AutoTuner searches the factors of the CPU schedules, see pe::ScheduleConfig, by compiling and measuring them on the
+ * local CPU, and records the best configs in a TuningLog.
+ *
+ * Only the split factors the schedules expose by pe::GetTunableFactor are searched, over the cartesian product of
+ * their candidates; the order of the loops and the choices to vectorize, unroll, parallelize or compute at are left
+ * to the heuristics of the schedules.
+ *
+ * The search of a workload starts at the config of the heuristics. The candidates are measured in batches. Once there
+ * are as many configs measured as the features of the cost model, a quadratic regression of the log cost on the log2
+ * factors, the cheapest candidates by the model go first; till then the ones closest to the best config so far go
+ * first, so that the search climbs to a local optimum in a bounded number of trials.
+ *
+ * The outputs of each config are compared with the ones of the heuristic config on the same random inputs, and the
+ * configs of different outputs are rejected, so a wrong schedule is never recorded.
+ */
+class AutoTuner {
+ public:
+  explicit AutoTuner(const Target& target, const TuningOptions& options = TuningOptions());
+
+  /**
+   * Tune the ops of \p graph with tunable schedules, skipping the workloads recorded in \p log already. The InferShape
+   * pass should be applied to \p graph first.
+   * @return the number of the workloads tuned.
+   */
+  int Tune(const std::shared_ptr<Graph>& graph, TuningLog* log);
+
+ private:
+  //! Tune the workload of \p node, returns false if its schedule has no tunable factors.
+  bool TuneNode(GraphCompiler* compiler, const Node* node, const std::string& workload, TuningLog* log);
+
+  Target target_;
+  TuningOptions options_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,120 @@
+#include "cinn/hlir/framework/auto_tuner.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(ScheduleConfig, to_string) {
+  auto config = pe::ScheduleConfig::FromString("bm=8,bk=16");
+  ASSERT_EQ(config.factors().at("bm"), 8);
+  ASSERT_EQ(config.factors().at("bk"), 16);
+  ASSERT_EQ(config.ToString(), "bk=16,bm=8");
+  ASSERT_EQ(pe::ScheduleConfig::FromString(config.ToString()).factors(), config.factors());
+}
+
+TEST(ScheduleConfig, guard) {
+  ASSERT_EQ(pe::GetTunableFactor("bm", 4, {2, 8}), 4);
+  pe::ScheduleConfig config;
+  config.Set("bm", 8);
+  {
+    pe::ScheduleConfig::Guard guard(&config);
+    ASSERT_EQ(pe::GetTunableFactor("bm", 4, {2, 8}), 8);
+    ASSERT_EQ(pe::GetTunableFactor("bk", 4, {2, 8}), 4);
+  }
+  ASSERT_EQ(pe::ScheduleConfig::Current(), nullptr);
+  // The default values join the candidates.
+  ASSERT_EQ(config.knobs().size(), 2UL);
+  ASSERT_EQ(config.knobs()[0].candidates, (std::vector<int>{2, 4, 8}));
+  ASSERT_EQ(pe::GetSplitCandidates(24, 4, 16), (std::vector<int>{4, 6, 8, 12}));
+}
+
+TEST(TuningLog, save_load) {
+  TuningLog log;
+  log.Update("mul", pe::ScheduleConfig::FromString("bm=8"), 10.);
+  log.Update("mul", pe::ScheduleConfig::FromString("bm=16"), 20.);
+  log.Update("conv2d", pe::ScheduleConfig::FromString("ow_bn=4"), 5.);
+
+  std::string path = "./tuning_log_test.txt";
+  log.Save(path);
+  TuningLog loaded;
+  ASSERT_TRUE(loaded.Load(path));
+  std::remove(path.c_str());
+
+  ASSERT_EQ(loaded.size(), 2UL);
+  pe::ScheduleConfig config;
+  ASSERT_TRUE(loaded.Lookup("mul", &config));
+  ASSERT_EQ(config.ToString(), "bm=8");
+  ASSERT_FALSE(loaded.Lookup("relu", &config));
+}
+
+#ifndef CINN_WITH_MKL_CBLAS
+TEST(AutoTuner, matmul) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {64, 128};
+  b->shape = {128, 64};
+  a->type  = t;
+  b->type  = t;
+  frontend::Instruction instr("matmul", {a, b});
+  prog.AppendInstruction(instr);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPasses(graph.get(), {"InferShape"});
+
+  TuningOptions options;
+  options.num_trials  = 4;
+  options.batch_size  = 2;
+  options.num_repeats = 2;
+  TuningLog log;
+  ASSERT_EQ(AutoTuner(target, options).Tune(graph, &log), 1);
+  ASSERT_EQ(log.size(), 1UL);
+
+  // The workloads in the log are skipped.
+  ASSERT_EQ(AutoTuner(target, options).Tune(graph, &log), 0);
+}
+
+TEST(AutoTuner, matmul_concurrent_measure) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {64, 128};
+  b->shape = {128, 64};
+  a->type  = t;
+  b->type  = t;
+  frontend::Instruction instr("matmul", {a, b});
+  prog.AppendInstruction(instr);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPasses(graph.get(), {"InferShape"});
+
+  // Enough trials for the cost model to rank the later batches.
+  TuningOptions options;
+  options.num_trials          = 16;
+  options.batch_size          = 4;
+  options.early_stopping      = 4;
+  options.num_repeats         = 2;
+  options.num_measure_threads = 2;
+  TuningLog log;
+  ASSERT_EQ(AutoTuner(target, options).Tune(graph, &log), 1);
+  ASSERT_EQ(log.size(), 1UL);
+}
+#endif
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -1,5 +1,7 @@
 #include "cinn/hlir/framework/buffer.h"
 
+#include <utility>
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -11,8 +13,9 @@ void Buffer::Resize(uint32_t size) {
   }
 
   if (size_ != size) {
-    data_.memory = reinterpret_cast<uint8_t*>(Malloc(size));
-    size_        = size;
+    data_.memory      = reinterpret_cast<uint8_t*>(Malloc(size));
+    data_.memory_size = size;
+    size_             = size;
   }
 }
 
@@ -23,8 +26,9 @@ void Buffer::Resize(uint32_t alignment, uint32_t size) {
   }
 
   if (size_ != size) {
-    data_.memory = reinterpret_cast<uint8_t*>(AlignedAlloc(alignment, size));
-    size_        = size;
+    data_.memory      = reinterpret_cast<uint8_t*>(AlignedAlloc(alignment, size));
+    data_.memory_size = size;
+    size_             = size;
   }
 }
 
@@ -33,6 +37,27 @@ void Buffer::SetTarget(const common::Target& target) {
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
 }
 
+void Buffer::ShareMemory(const std::shared_ptr<Buffer>& base, uint32_t offset, uint32_t size) {
+  CHECK(base->data_.memory) << "The memory to share is not allocated yet";
+  CHECK_LE(offset + size, base->size_) << "The shared memory is out of the range of the base buffer";
+  Free();
+  SetTarget(base->target_);
+  base_             = base;
+  data_.memory      = base->data_.memory + offset;
+  data_.memory_size = size;
+  size_             = size;
+}
+
+void Buffer::ShareMemory(std::shared_ptr<void> owner, void* memory, uint32_t size) {
+  CHECK(owner) << "The owner of the external memory is null";
+  Free();
+  SetTarget(common::DefaultHostTarget());
+  owner_            = std::move(owner);
+  data_.memory      = reinterpret_cast<uint8_t*>(memory);
+  data_.memory_size = size;
+  size_             = size;
+}
+
 void Buffer::ResizeLazy(uint32_t size) {
   if (size <= size_) return;
   Resize(size);
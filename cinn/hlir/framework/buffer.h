@@ -39,12 +39,24 @@ struct Buffer final {
 
   void SetTarget(const common::Target& target);
 
+  //! Take \p size bytes at \p offset of \p base as the memory instead of allocating, \p base is kept alive by this.
+  void ShareMemory(const std::shared_ptr<Buffer>& base, uint32_t offset, uint32_t size);
+
+  //! Take the \p size bytes of host memory at \p memory instead of allocating, \p owner keeps the memory alive, e.g. a
+  //! file mapped into the memory.
+  void ShareMemory(std::shared_ptr<void> owner, void* memory, uint32_t size);
+
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
   //! Free all the memory owned by this buffer.
   void Free() {
     if (!data_.memory) return;
+    if (base_ || owner_) {
+      base_.reset();
+      owner_.reset();
+      return;
+    }
     memory_mng_cache_->free(data_.memory);
   }
 
@@ -70,6 +82,11 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! The buffer the memory is shared from, null if the memory is owned.
+  std::shared_ptr<Buffer> base_;
+  //! The owner of the external memory shared, null if the memory is not external.
+  std::shared_ptr<void> owner_;
 };
 
 }  // namespace framework
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <any>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/graph_test_helper.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(ConstantFolding, params_only) {
+  const int n = 100 * 32;
+  frontend::Program prog;
+  auto a = MakeVariable("A", {100, 32});
+  auto b = MakeVariable("B", {100, 32});
+  auto c = MakeVariable("C", {100, 32});
+  auto d = prog.add(b, c);
+  auto e = prog.relu(d);
+  auto f = prog.add(a, e);
+  ASSERT_EQ(prog.size(), 3UL);
+
+  // B and C are the parameters, A is the input.
+  Target target = common::DefaultHostTarget();
+  auto scope    = std::make_shared<Scope>();
+  for (auto* name : {"B", "C"}) std::get<Tensor>(*scope->Var<Tensor>(name))->Resize(Shape{{n}});
+  auto* b_ptr = SetRandom(scope.get(), "B");
+  auto* c_ptr = SetRandom(scope.get(), "C");
+
+  auto graph = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  ASSERT_EQ(NumOps(graph.get()), 3);
+  graph->attrs["param_scope"] = std::make_shared<std::any>(scope);
+  ApplyPass(graph.get(), "ConstantFolding");
+
+  // Only the add of A is left, with relu(B + C) computed into a parameter.
+  ASSERT_EQ(NumOps(graph.get()), 1);
+  auto& shape_dict = graph->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  ASSERT_FALSE(shape_dict.count(d->id));
+  ASSERT_TRUE(shape_dict.count(e->id));
+  auto* e_ptr = scope->GetTensor(e->id)->data<float>();
+  for (int i = 0; i < n; i++) {
+    ASSERT_NEAR(std::max(b_ptr[i] + c_ptr[i], 0.f), e_ptr[i], 1e-5);
+  }
+
+  BuildScope(target, graph, scope);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+  auto* a_ptr  = SetRandom(scope.get(), "A", 0.f, 1.f);
+  program->Execute();
+
+  auto* f_ptr = scope->GetTensor(f->id)->data<float>();
+  for (int i = 0; i < n; i++) {
+    ASSERT_NEAR(a_ptr[i] + std::max(b_ptr[i] + c_ptr[i], 0.f), f_ptr[i], 1e-5);
+  }
+}
+
+TEST(ConstantFolding, no_params) {
+  frontend::Program prog;
+  auto c = prog.add(MakeVariable("A", {100, 32}), MakeVariable("B", {100, 32}));
+  prog.relu(c);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  graph->attrs["param_scope"] = std::make_shared<std::any>(std::make_shared<Scope>());
+  ApplyPass(graph.get(), "ConstantFolding");
+  ASSERT_EQ(NumOps(graph.get()), 2);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/graph_test_helper.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(ConvEpilogueFusion, conv2d_batchnorm_relu) {
+  const int c = 16, h = 8, w = 8;
+  frontend::Program prog;
+  auto a        = MakeVariable("A", {1, c, h, w});
+  auto weights  = MakeVariable("W", {c, c, 3, 3});
+  auto scale    = MakeVariable("Scale", {c});
+  auto bias     = MakeVariable("Bias", {c});
+  auto mean     = MakeVariable("Mean", {c});
+  auto variance = MakeVariable("Variance", {c});
+
+  std::unordered_map<std::string, frontend::Program::attr_t> conv_attrs, bn_attrs;
+  conv_attrs["stride"]   = std::vector<int>({1, 1});
+  conv_attrs["dilation"] = std::vector<int>({1, 1});
+  conv_attrs["padding"]  = std::vector<int>({1, 1});
+  bn_attrs["epsilon"]    = 1e-5f;
+  auto conv = prog.conv2d(a, weights, conv_attrs);
+  auto bn   = prog.batchnorm(conv, scale, bias, mean, variance, bn_attrs);
+  auto out  = prog.relu(bn);
+  ASSERT_EQ(prog.size(), 3UL);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  ApplyPass(graph.get(), "ConvEpilogueFusion");
+
+  // Only the conv is left, it stores the output of relu and no longer the ones of conv and batchnorm.
+  ASSERT_EQ(NumOps(graph.get()), 1);
+  auto& shape_dict = graph->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  ASSERT_FALSE(shape_dict.count(conv->id));
+  ASSERT_FALSE(shape_dict.count(bn->id));
+  ASSERT_TRUE(shape_dict.count(out->id));
+
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program    = gc.Build();
+  auto* a_ptr     = SetRandom(scope.get(), "A", -1.f, 1.f);
+  auto* w_ptr     = SetRandom(scope.get(), "W", -1.f, 1.f);
+  auto* scale_ptr = SetRandom(scope.get(), "Scale", 0.5f, 1.5f);
+  auto* bias_ptr  = SetRandom(scope.get(), "Bias", -1.f, 1.f);
+  auto* mean_ptr  = SetRandom(scope.get(), "Mean", -1.f, 1.f);
+  auto* var_ptr   = SetRandom(scope.get(), "Variance", 0.5f, 1.5f);
+  program->Execute();
+
+  auto* out_ptr = scope->GetTensor(out->id)->data<float>();
+  for (int oc = 0; oc < c; oc++) {
+    for (int y = 0; y < h; y++) {
+      for (int x = 0; x < w; x++) {
+        float sum = 0.f;
+        for (int ic = 0; ic < c; ic++) {
+          for (int ky = 0; ky < 3; ky++) {
+            for (int kx = 0; kx < 3; kx++) {
+              int iy = y + ky - 1, ix = x + kx - 1;
+              if (iy < 0 || iy >= h || ix < 0 || ix >= w) continue;
+              sum += a_ptr[(ic * h + iy) * w + ix] * w_ptr[((oc * c + ic) * 3 + ky) * 3 + kx];
+            }
+          }
+        }
+        float expected = (sum - mean_ptr[oc]) * scale_ptr[oc] / std::sqrt(var_ptr[oc] + 1e-5f) + bias_ptr[oc];
+        ASSERT_NEAR(std::max(expected, 0.f), out_ptr[(oc * h + y) * w + x], 1e-3);
+      }
+    }
+  }
+}
+
+TEST(ConvEpilogueFusion, shared_output) {
+  frontend::Program prog;
+  auto a       = MakeVariable("A", {1, 16, 8, 8});
+  auto weights = MakeVariable("W", {16, 16, 1, 1});
+  std::unordered_map<std::string, frontend::Program::attr_t> attrs;
+  attrs["stride"]   = std::vector<int>({1, 1});
+  attrs["dilation"] = std::vector<int>({1, 1});
+  attrs["padding"]  = std::vector<int>({0, 0});
+  auto conv         = prog.conv2d(a, weights, attrs);
+  auto relu         = prog.relu(conv);
+  prog.add(conv, relu);
+
+  // The output of the conv is used by the add too, so it has to be stored and relu is not fused.
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  ApplyPass(graph.get(), "ConvEpilogueFusion");
+  ASSERT_EQ(NumOps(graph.get()), 3);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
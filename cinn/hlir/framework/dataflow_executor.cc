@@ -0,0 +1,116 @@
+#include "cinn/hlir/framework/dataflow_executor.h"
+
+#include <algorithm>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+struct Access {
+  const cinn_buffer_t* buffer{};
+  bool write{};
+};
+
+bool Conflicts(const Access& a, const Access& b) {
+  if (!a.write && !b.write) return false;
+  if (a.buffer == b.buffer) return true;
+  const uint8_t* a_begin = a.buffer->memory;
+  const uint8_t* b_begin = b.buffer->memory;
+  // The memory a buffer gets later may be shared with the other.
+  if (!a_begin || !b_begin) return true;
+  return a_begin < b_begin + b.buffer->memory_size && b_begin < a_begin + a.buffer->memory_size;
+}
+
+std::vector<Access> CollectAccesses(Instruction* instr) {
+  auto& args     = instr->GetPodArgs();
+  int num_inputs = instr->GetInArgs().size();
+  CHECK_EQ(args.size(), num_inputs + instr->GetOutArgs().size()) << "The instruction should be bound first";
+  std::vector<Access> accesses;
+  for (int i = 0; i < args.size(); i++) {
+    accesses.push_back(Access{static_cast<cinn_buffer_t*>(args[i]), i >= num_inputs});
+  }
+  return accesses;
+}
+
+}  // namespace
+
+DataflowExecutor::DataflowExecutor(const std::vector<std::unique_ptr<Instruction>>& instrs, utils::ThreadPool* pool)
+    : nodes_(new Node[instrs.size()]), num_nodes_(instrs.size()), pool_(pool) {
+  for (int i = 0; i < num_nodes_; i++) {
+    auto& node     = nodes_[i];
+    node.instr     = instrs[i].get();
+    node.executor  = this;
+    node.task.fn   = RunNode;
+    node.task.data = &node;
+  }
+  Build();
+}
+
+void DataflowExecutor::Build() {
+  std::vector<std::vector<Access>> accesses;
+  buffer_states_.clear();
+  for (int i = 0; i < num_nodes_; i++) {
+    accesses.push_back(CollectAccesses(nodes_[i].instr));
+    for (auto& access : accesses.back()) {
+      buffer_states_.push_back(BufferState{access.buffer, access.buffer->memory, access.buffer->memory_size});
+    }
+  }
+
+  roots_.clear();
+  int num_edges = 0;
+  for (int j = 0; j < num_nodes_; j++) {
+    auto& node = nodes_[j];
+    node.successors.clear();
+    node.num_deps = 0;
+  }
+  for (int j = 0; j < num_nodes_; j++) {
+    auto& node = nodes_[j];
+    for (int i = 0; i < j; i++) {
+      bool depends = false;
+      for (auto& a : accesses[i]) {
+        for (auto& b : accesses[j]) depends = depends || Conflicts(a, b);
+      }
+      if (!depends) continue;
+      nodes_[i].successors.push_back(&node);
+      node.num_deps++;
+      num_edges++;
+    }
+    if (node.num_deps == 0) roots_.push_back(&node.task);
+  }
+  VLOG(3) << "DataflowExecutor: " << num_nodes_ << " instructions, " << num_edges << " dependencies, "
+          << roots_.size() << " roots, " << pool_->num_threads() << " threads";
+}
+
+bool DataflowExecutor::BuffersChanged() const {
+  return std::any_of(buffer_states_.begin(), buffer_states_.end(), [](const BufferState& state) {
+    return state.buffer->memory != state.memory || state.buffer->memory_size != state.memory_size;
+  });
+}
+
+void DataflowExecutor::Run() {
+  if (BuffersChanged()) {
+    VLOG(3) << "DataflowExecutor: the memory of the buffers changed, rebuild the dependencies";
+    Build();
+  }
+  for (int i = 0; i < num_nodes_; i++) {
+    nodes_[i].pending.store(nodes_[i].num_deps, std::memory_order_relaxed);
+  }
+  pool_->Run(roots_.data(), roots_.size());
+}
+
+void DataflowExecutor::RunNode(void* data) {
+  auto* node     = static_cast<Node*>(data);
+  auto* executor = node->executor;
+  node->instr->Run();
+  for (auto* successor : node->successors) {
+    if (successor->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      executor->pool_->Spawn(&successor->task);
+    }
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/utils/thread_pool.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * DataflowExecutor runs the instructions of a Program concurrently on a work-stealing thread pool. An instruction is
+ * dispatched as soon as all the instructions it depends on are finished, tracked by an atomic counter per instruction.
+ *
+ * The dependencies are built from the buffers the instructions read and write, two instructions depend on each other
+ * if one writes a buffer the other accesses, or a buffer sharing memory with it, e.g. by the MemoryPlan pass. A buffer
+ * of no memory yet may share it with any other. The memory of the buffers is checked on each run, and the
+ * dependencies are rebuilt if a buffer is reallocated or shares other memory since, e.g. by Buffer::ResizeLazy or
+ * Tensor::ShareMemory.
+ */
+class DataflowExecutor {
+ public:
+  /**
+   * Constructor.
+   * @param instrs The instructions in the sequential order, they should be bound already.
+   * @param pool The thread pool to run the instructions on. If it is runtime::CpuThreadPool(), the parallel loops inside
+   * the instructions share the same threads.
+   */
+  DataflowExecutor(const std::vector<std::unique_ptr<Instruction>>& instrs, utils::ThreadPool* pool);
+
+  /**
+   * Run all the instructions, returns when all of them are finished.
+   */
+  void Run();
+
+ private:
+  struct Node {
+    Instruction* instr{};
+    DataflowExecutor* executor{};
+    std::vector<Node*> successors;
+    int num_deps{};
+    std::atomic<int> pending{0};
+    utils::ThreadPool::Task task{};
+  };
+
+  //! The memory of a buffer when the dependencies were built.
+  struct BufferState {
+    const cinn_buffer_t* buffer{};
+    const uint8_t* memory{};
+    uint64_t memory_size{};
+  };
+
+  //! Build the dependencies from the current memory of the buffers.
+  void Build();
+
+  //! Whether the memory of a buffer changed since the dependencies were built.
+  bool BuffersChanged() const;
+
+  static void RunNode(void* data);
+
+  std::unique_ptr<Node[]> nodes_;
+  std::vector<BufferState> buffer_states_;
+  int num_nodes_{};
+  std::vector<utils::ThreadPool::Task*> roots_;
+  utils::ThreadPool* pool_{};
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,171 @@
+#include "cinn/hlir/framework/dataflow_executor.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+float* GetData(void* args, int i) {
+  cinn_buffer_t* buffer = static_cast<cinn_pod_value_t*>(args)[i];
+  return reinterpret_cast<float*>(buffer->memory);
+}
+
+int GetNumElements(void* args, int i) {
+  cinn_buffer_t* buffer = static_cast<cinn_pod_value_t*>(args)[i];
+  return buffer->memory_size / sizeof(float);
+}
+
+void AddOne(void* args, int32_t num_args) {
+  auto* x = GetData(args, 0);
+  auto* y = GetData(args, 1);
+  for (int i = 0; i < GetNumElements(args, 1); i++) y[i] = x[i] + 1;
+}
+
+void Add(void* args, int32_t num_args) {
+  auto* x = GetData(args, 0);
+  auto* y = GetData(args, 1);
+  auto* z = GetData(args, 2);
+  for (int i = 0; i < GetNumElements(args, 2); i++) z[i] = x[i] + y[i];
+}
+
+}  // namespace
+
+// Several independent chains of AddOne, summed up at the end.
+TEST(DataflowExecutor, branches) {
+  const int num_branches = 8;
+  const int chain_length = 10;
+  const int num_elements = 256;
+  Scope scope;
+  auto get_tensor = [&](const std::string& name) {
+    auto& tensor = std::get<Tensor>(*scope.Var<Tensor>(name));
+    tensor->Resize(Shape{{num_elements}});
+    return tensor->mutable_data<float>(common::DefaultHostTarget());
+  };
+
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  auto add_instr = [&](const std::vector<std::string>& in_args, const std::string& out_arg, lower_func_ptr_t fn) {
+    get_tensor(out_arg);
+    instrs.emplace_back(new Instruction(common::DefaultHostTarget(), &scope, in_args, {out_arg}));
+    instrs.back()->SetLoweredFunc(fn);
+    instrs.back()->Bind();
+  };
+
+  auto* x = get_tensor("x");
+  for (int b = 0; b < num_branches; b++) {
+    std::string prev = "x";
+    for (int i = 0; i < chain_length; i++) {
+      std::string name = "t_" + std::to_string(b) + "_" + std::to_string(i);
+      add_instr({prev}, name, AddOne);
+      prev = name;
+    }
+  }
+  std::string sum = "t_0_" + std::to_string(chain_length - 1);
+  for (int b = 1; b < num_branches; b++) {
+    std::string name = "sum_" + std::to_string(b);
+    add_instr({sum, "t_" + std::to_string(b) + "_" + std::to_string(chain_length - 1)}, name, Add);
+    sum = name;
+  }
+
+  utils::ThreadPool pool(4);
+  DataflowExecutor executor(instrs, &pool);
+  auto* out = get_tensor(sum);
+  for (int repeat = 0; repeat < 100; repeat++) {
+    for (int i = 0; i < num_elements; i++) x[i] = repeat + i;
+    executor.Run();
+    for (int i = 0; i < num_elements; i++) {
+      ASSERT_EQ(out[i], num_branches * (repeat + i + chain_length));
+    }
+  }
+}
+
+// The instructions writing the memory shared with another tensor wait for the readers of it.
+TEST(DataflowExecutor, shared_memory) {
+  const int num_elements = 64;
+  Scope scope;
+  auto slab = std::make_shared<Buffer>(common::DefaultHostTarget());
+  slab->Resize(num_elements * sizeof(float) * 2);
+  auto get_tensor = [&](const std::string& name) -> Tensor& {
+    auto& tensor = std::get<Tensor>(*scope.Var<Tensor>(name));
+    tensor->Resize(Shape{{num_elements}});
+    return tensor;
+  };
+  auto* x = get_tensor("x")->mutable_data<float>(common::DefaultHostTarget());
+  auto* z = get_tensor("z")->mutable_data<float>(common::DefaultHostTarget());
+  // y0 and y1 share the same memory.
+  get_tensor("y0")->ShareMemory(slab, 0, num_elements * sizeof(float));
+  get_tensor("y1")->ShareMemory(slab, 0, num_elements * sizeof(float));
+  get_tensor("w")->mutable_data<float>(common::DefaultHostTarget());
+
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  auto add_instr = [&](const std::vector<std::string>& in_args, const std::string& out_arg, lower_func_ptr_t fn) {
+    instrs.emplace_back(new Instruction(common::DefaultHostTarget(), &scope, in_args, {out_arg}));
+    instrs.back()->SetLoweredFunc(fn);
+    instrs.back()->Bind();
+  };
+  add_instr({"x"}, "y0", AddOne);
+  add_instr({"y0"}, "w", AddOne);
+  add_instr({"x"}, "y1", AddOne);
+  add_instr({"y1", "w"}, "z", Add);
+
+  utils::ThreadPool pool(4);
+  DataflowExecutor executor(instrs, &pool);
+  for (int repeat = 0; repeat < 100; repeat++) {
+    for (int i = 0; i < num_elements; i++) x[i] = repeat + i;
+    executor.Run();
+    for (int i = 0; i < num_elements; i++) {
+      ASSERT_EQ(z[i], (repeat + i + 1) + (repeat + i + 2));
+    }
+  }
+}
+
+// The dependencies follow the memory the buffers share after the executor is built.
+TEST(DataflowExecutor, share_memory_after_build) {
+  const int num_elements = 64;
+  Scope scope;
+  auto get_tensor = [&](const std::string& name) -> Tensor& {
+    auto& tensor = std::get<Tensor>(*scope.Var<Tensor>(name));
+    tensor->Resize(Shape{{num_elements}});
+    return tensor;
+  };
+  auto* x = get_tensor("x")->mutable_data<float>(common::DefaultHostTarget());
+  auto* z = get_tensor("z")->mutable_data<float>(common::DefaultHostTarget());
+  get_tensor("y0")->mutable_data<float>(common::DefaultHostTarget());
+  get_tensor("y1")->mutable_data<float>(common::DefaultHostTarget());
+  get_tensor("w")->mutable_data<float>(common::DefaultHostTarget());
+
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  auto add_instr = [&](const std::vector<std::string>& in_args, const std::string& out_arg, lower_func_ptr_t fn) {
+    instrs.emplace_back(new Instruction(common::DefaultHostTarget(), &scope, in_args, {out_arg}));
+    instrs.back()->SetLoweredFunc(fn);
+    instrs.back()->Bind();
+  };
+  add_instr({"x"}, "y0", AddOne);
+  add_instr({"y0"}, "w", AddOne);
+  add_instr({"x"}, "y1", AddOne);
+  add_instr({"y1", "w"}, "z", Add);
+
+  utils::ThreadPool pool(4);
+  DataflowExecutor executor(instrs, &pool);
+  // y0 and y1 share the same memory from now on, the writer of y1 should wait for the reader of y0.
+  auto slab = std::make_shared<Buffer>(common::DefaultHostTarget());
+  slab->Resize(num_elements * sizeof(float));
+  get_tensor("y0")->ShareMemory(slab, 0, num_elements * sizeof(float));
+  get_tensor("y1")->ShareMemory(slab, 0, num_elements * sizeof(float));
+  for (int repeat = 0; repeat < 100; repeat++) {
+    for (int i = 0; i < num_elements; i++) x[i] = repeat + i;
+    executor.Run();
+    for (int i = 0; i < num_elements; i++) {
+      ASSERT_EQ(z[i], (repeat + i + 1) + (repeat + i + 2));
+    }
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -39,6 +39,25 @@ Graph::Graph(const frontend::Program& prog, const Target& target) {
   this->attrs["inferdtype"] = std::make_shared<std::any>(dtype_dict);
 }
 
+std::vector<std::vector<Node*>> Graph::FusionGroups() const {
+  if (HasAttr("fusion_groups")) {
+    return GetAttrs<std::vector<std::vector<Node*>>>("fusion_groups");
+  }
+  std::vector<std::vector<Node*>> groups;
+  for (auto* graph_node : std::get<0>(topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (node) groups.push_back({node});
+  }
+  return groups;
+}
+
+void Graph::RemoveNode(common::GraphNode* node) {
+  CHECK(node->inlinks().empty() && node->outlinks().empty()) << "The node " << node->id() << " is still linked";
+  // The graph lets go of an op node with no destroying it.
+  if (node->safe_as<Node>()) common::ref_count(node).Inc();
+  DropNode(node);
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -65,6 +65,20 @@ class Graph : public cinn::common::Graph {
     return std::any_cast<T&>(*it->second);
   }
 
+  /**
+   * \brief Get the op nodes grouped by the OpFusion pass, each group is compiled into a single kernel.
+   * @return the groups in topological order, and the nodes of a group in topological order too. Each op node is a
+   * group by itself if the graph is not fused.
+   */
+  std::vector<std::vector<Node*>> FusionGroups() const;
+
+  /**
+   * \brief Remove a node unlinked from the others. An op node is owned by the NodeData of its outputs too, see the
+   * constructor, so it is destroyed with the last of them.
+   * @param node the node to remove
+   */
+  void RemoveNode(common::GraphNode* node);
+
   /**
    * \brief Check whether has a specific attribute.
    * @param attr_name the name of the attribute
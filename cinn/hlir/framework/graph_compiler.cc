@@ -1,14 +1,32 @@
 #include "cinn/hlir/framework/graph_compiler.h"
 
+#include <llvm/Support/Program.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <sstream>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "cinn/backends/codegen_cuda_dev.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/hlir/framework/aot_module.h"
+#include "cinn/hlir/framework/auto_tuner.h"
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
+#include "cinn/lang/placeholder.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/profiler.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
+
+DEFINE_bool(cinn_parallel_execute, false, "Whether to run the independent instructions of a X86 Program concurrently.");
+DEFINE_string(cinn_aot_linker, "cc", "The command to link the objects exported by GraphCompiler into libraries.");
+
 namespace hlir {
 namespace framework {
 // Store params from node to instruction
@@ -35,6 +53,60 @@ void AddAttrs(const std::unordered_map<std::string, AttrType>& attrs_store,
   }
 }
 
+namespace {
+
+// The types the graph computes with, the floats and the int8 and int32 of the quantized ops.
+bool IsSupportedDtype(const Type& dtype) {
+  return dtype.is_float() || dtype.is_bfloat16() || dtype.is_int(8) || dtype.is_int(32);
+}
+
+// The name of \p dtype in the AotManifest, see AotDtype.
+std::string DtypeName(const Type& dtype) {
+  std::stringstream ss;
+  ss << dtype;
+  return ss.str();
+}
+
+// The placeholder of an input of the functions.
+ir::Tensor CreateInput(const std::string& id, const shape_t& shape, const Type& dtype) {
+  CHECK(IsSupportedDtype(dtype)) << "The dtype of node " << id << " is " << dtype
+                                 << ", only the float ones, int8 and int32 are implemented yet.";
+  std::vector<Expr> dims(shape.begin(), shape.end());
+  return lang::CreatePlaceHolder(dims, dtype, id);
+}
+
+// Estimate the floating point operations of a node from its shapes, a multiply-add counts as two.
+double EstimateFlops(const Node* node, const std::unordered_map<std::string, shape_t>& shape_dict) {
+  auto numel = [&](const std::string& id) {
+    double res = 1;
+    for (int dim : shape_dict.at(id)) res *= dim;
+    return res;
+  };
+  std::vector<std::string> in_ids, out_ids;
+  for (auto& in : node->inlinks_in_order()) in_ids.push_back(in->source()->as<NodeData>()->id());
+  for (auto& out : node->outlinks_in_order()) out_ids.push_back(out->sink()->as<NodeData>()->id());
+  if (out_ids.empty()) return 0;
+  double out_numel = numel(out_ids[0]);
+  auto& op_name    = node->op()->name;
+
+  if ((op_name == "matmul" || op_name == "mul" || op_name == "mulbias") && in_ids.size() >= 2) {
+    // The rows of the output times the reduced dimension is the size of the first input, however it is transposed.
+    double k = numel(in_ids[0]) * shape_dict.at(out_ids[0]).back() / out_numel;
+    return 2 * out_numel * k + (op_name == "mulbias" ? out_numel : 0);
+  }
+  if ((op_name == "conv2d" || op_name == "depthwise_conv2d" || op_name == "conv2d_NCHWc") && in_ids.size() >= 2) {
+    // Each output reduces the weights of its output channel, the NCHWc weights are [oc_chunk, ic_chunk, h, w, ic, oc].
+    auto& weight_shape = shape_dict.at(in_ids[1]);
+    double channels    = weight_shape[0] * (weight_shape.size() == 6 ? weight_shape.back() : 1);
+    return 2 * out_numel * numel(in_ids[1]) / channels;
+  }
+  if (utils::Startswith(op_name, "pool") && !in_ids.empty()) return numel(in_ids[0]);
+  if (op_name == "softmax") return 3 * out_numel;
+  return out_numel;
+}
+
+}  // namespace
+
 void GraphCompiler::PrintFunc() {
   auto [nodes, edges] = graph_->topological_order();
   for (auto& n : nodes) {
@@ -46,13 +118,9 @@ void GraphCompiler::PrintFunc() {
 }
 
 std::string GraphCompiler::GenSourceCode() {
-  auto [nodes, edges] = graph_->topological_order();
-  for (auto& n : nodes) {
-    auto* node = n->safe_as<Node>();
-    if (node) {
-      auto lowered_func = GetOpFunc(node);
-      m_builder_.AddFunction(lowered_func);
-    }
+  for (auto& group : graph_->FusionGroups()) {
+    auto lowered_func = group.size() > 1 ? GetOpFunc(group) : GetOpFunc(group.front());
+    m_builder_.AddFunction(lowered_func);
   }
   // compile the module
   if (!compiler_) {
@@ -65,203 +133,324 @@ std::string GraphCompiler::GenSourceCode() {
 }
 
 std::unique_ptr<Program> GraphCompiler::Build(const std::string& code) {
-  auto [nodes, edges] = graph_->topological_order();
-  for (int i = 0; i < nodes.size(); i++) {
-    auto* node = nodes[i]->safe_as<Node>();
-    if (node && node->attrs.attr_store.count("FuseNumber") > 0) {
-      int fuse_number = std::get<int>(node->attrs.attr_store["FuseNumber"]);
-      std::vector<Node*> fuse_nodes;
-      for (int j = 0; j < fuse_number; j++) {
-        CHECK_LT(i, nodes.size());
-        auto* temp_node = nodes[i]->safe_as<Node>();
-        CHECK(temp_node) << "Temp node null Error!!";
-        fuse_nodes.push_back(temp_node);
-        // Here nodes holds both op node and tensor node. Since a op node is
-        // connnected to a tensor node, in order to visit only the op node,
-        // we use i = i + 2 instead of i = i + 1.
-        i = i + 2;
-      }
-      // When jump out of the previous loop, we did one more time of i = i + 2.
-      // So to ensure each node is traversed, we do i = i - 2.
-      i                 = i - 2;
-      auto lowered_func = GetOpFunc(fuse_nodes);
-      m_builder_.AddFunction(lowered_func);
-      continue;
-    } else if (node) {
-      auto lowered_func = GetOpFunc(node);
-      m_builder_.AddFunction(lowered_func);
-    }
+  // The builds nested in this one, e.g. those of the constant folding, are profiled as part of it.
+  thread_local int build_depth = 0;
+  build_depth++;
+  auto program = BuildProgram(code);
+  if (--build_depth == 0 && !FLAGS_cinn_build_profile.empty()) {
+    // The profile covers the phases since the last build, and is reset for the next one.
+    auto& profiler = utils::BuildProfiler::Global();
+    profiler.SaveChromeTrace(FLAGS_cinn_build_profile);
+    LOG(INFO) << "The build profile, saved to " << FLAGS_cinn_build_profile << ":\n" << profiler.Summary();
+    profiler.Clear();
   }
-  // compile the module
+  return program;
+}
+
+void GraphCompiler::Compile(const std::string& code) {
+  CHECK(!compiled_) << "The graph is compiled already";
+  compiled_ = true;
+  utils::RecordEvent event("GraphCompiler::Compile", "hlir");
   if (!compiler_) {
     compiler_ = backends::Compiler::Create(target_);
   }
 
+  std::string signature;
+  if (target_.arch == Target::Arch::X86 && !FLAGS_cinn_compile_cache_dir.empty()) {
+    signature = GenGraphSignature();
+    if (compiler_->BuildFromCache(signature)) {
+      VLOG(1) << "Graph compiled from the on-disk compilation cache";
+      return;
+    }
+  }
+
+  for (auto& group : graph_->FusionGroups()) {
+    auto lowered_func = group.size() > 1 ? GetOpFunc(group) : GetOpFunc(group.front());
+    m_builder_.AddFunction(lowered_func);
+  }
   auto build_module = m_builder_.Build();
 
-  if (this->target_.arch == Target::Arch::X86) {
+  // The C code is for reading only, generating it takes a considerable part of the build of a large graph.
+  if (this->target_.arch == Target::Arch::X86 && VLOG_IS_ON(3)) {
+    utils::RecordEvent event("CodeGenCX86", "codegen");
     CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
     codegen.SetInlineBuiltinCodes(false);
     auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
-    LOG(INFO) << "[X86] C Code is:\n" << out;
+    VLOG(3) << "[X86] C Code is:\n" << out;
   }
 
-  compiler_->Build(build_module, code);
+  {
+    utils::RecordEvent event("Compiler::Build", "codegen");
+    compiler_->Build(build_module, code, signature);
+  }
+}
+
+namespace {
 
+//! Link the object file \p object_path into the shared library \p path by FLAGS_cinn_aot_linker, run without a shell.
+void LinkLibrary(const std::string& path, const std::string& object_path) {
+  // The linker may come with its own options, e.g. "clang -fuse-ld=lld".
+  std::vector<std::string> args;
+  std::istringstream linker(FLAGS_cinn_aot_linker);
+  for (std::string arg; linker >> arg;) args.push_back(arg);
+  CHECK(!args.empty()) << "No linker is set by FLAGS_cinn_aot_linker";
+  args.insert(args.end(), {"-shared", "-o", path, object_path});
+
+  auto program = llvm::sys::findProgramByName(args.front());
+  CHECK(program) << "Failed to find the linker " << args.front() << ": " << program.getError().message();
+  std::vector<llvm::StringRef> argv(args.begin(), args.end());
+  std::string cmd = utils::Join(args, " ");
+  VLOG(1) << "Link the library: " << cmd;
+  std::string error;
+  int status = llvm::sys::ExecuteAndWait(*program, argv, llvm::None, {}, 0, 0, &error);
+  CHECK_EQ(status, 0) << "Failed to link " << path << " by: " << cmd << "\nThe linker "
+                      << (status < 0 ? "failed to run: " + error : "exited with status " + std::to_string(status));
+}
+
+}  // namespace
+
+std::unique_ptr<Program> GraphCompiler::BuildProgram(const std::string& code) {
+  utils::RecordEvent event("GraphCompiler::Build", "hlir");
+  if (!compiled_) Compile(code);
   return std::unique_ptr<Program>(new Program(scope_, BuildInstructions()));
 }
 
+void GraphCompiler::ExportLibrary(const std::string& path, const std::vector<std::string>& param_names) {
+  CHECK(target_.arch == Target::Arch::X86) << "Only the X86 graphs can be exported ahead of time";
+  // Reject the tensors AotModule can not allocate before lowering.
+  auto& dtype_dict = graph_->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  for (auto& [id, dtype] : dtype_dict) {
+    CHECK(IsSupportedDtype(dtype)) << "The dtype of node " << id << " is " << dtype
+                                   << ", only the float ones, int8 and int32 can be exported.";
+  }
+  ir::Module::Builder builder(UniqName("aot_module"), target_);
+  for (auto& group : graph_->FusionGroups()) {
+    builder.AddFunction(group.size() > 1 ? GetOpFunc(group) : GetOpFunc(group.front()));
+  }
+
+  const bool object_only        = utils::Endswith(path, ".o");
+  const std::string object_path = object_only ? path : path + ".o";
+  backends::EmitObjectFile<backends::CodeGenX86>(
+      builder.Build(), object_path, {{kAotManifestGetter, GenAotManifest()}});
+  if (!object_only) {
+    LinkLibrary(path, object_path);
+    std::remove(object_path.c_str());
+  }
+  if (!param_names.empty()) {
+    std::vector<AotParam> params;
+    for (auto& name : param_names) {
+      auto tensor = scope_->GetTensor(name);
+      params.push_back({name, DtypeName(dtype_dict.at(name)), tensor->shape().data(), tensor->buffer()->memory});
+    }
+    SaveParams(params, path + ".params");
+  }
+}
+
+std::string GraphCompiler::GenAotManifest() const {
+  auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  const std::unordered_map<std::string, int>* memory_plan = nullptr;
+  if (graph_->HasAttr("memory_plan")) {
+    memory_plan = &graph_->GetAttrs<std::unordered_map<std::string, int>>("memory_plan");
+  }
+
+  AotManifest manifest;
+  // Sort the tensors to make the library reproducible.
+  std::map<std::string, shape_t> shapes(shape_dict.begin(), shape_dict.end());
+  for (auto& [id, shape] : shapes) {
+    auto& dtype = dtype_dict.at(id);
+    AotManifest::TensorInfo tensor{id, DtypeName(dtype), shape};
+    if (memory_plan && memory_plan->count(id)) {
+      tensor.offset      = memory_plan->at(id);
+      manifest.slab_size = std::max<uint32_t>(manifest.slab_size, tensor.offset + Shape(shape).numel() * dtype.bytes());
+    }
+    manifest.tensors.push_back(std::move(tensor));
+  }
+  // The same as BuildInstructions.
+  for (auto& group : graph_->FusionGroups()) {
+    auto* node = group.front();
+    if (group.size() > 1) {
+      std::string fn_name = GenOpFuncName(node) + "_fused";
+      manifest.instrs.push_back({fn_name, GroupGetInputNames(group), GroupGetOutputNames(group)});
+    } else {
+      manifest.instrs.push_back({GenOpFuncName(node), OpGetInputNames(node), OpGetOutputNames(node)});
+    }
+  }
+  return manifest.ToString();
+}
+
+std::string GraphCompiler::GenGraphSignature() const {
+  auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+
+  std::stringstream ss;
+  auto [nodes, edges] = graph_->topological_order();
+  for (auto* n : nodes) {
+    auto* node = n->safe_as<Node>();
+    if (!node) continue;
+    // The workload key covers the op, the input types and shapes and the attributes, the output shapes are printed
+    // too as some of them do not follow from those, e.g. the partial results of a reduction.
+    ss << node->id() << " = " << GetWorkloadKey(node, *graph_) << " (";
+    for (auto& in : node->inlinks_in_order()) ss << in->source()->as<NodeData>()->id() << " ";
+    ss << ") -> (";
+    for (auto& out : node->outlinks_in_order()) {
+      auto& id = out->sink()->as<NodeData>()->id();
+      ss << id << ":" << dtype_dict.at(id) << "[" << utils::Join(shape_dict.at(id), ",") << "] ";
+    }
+    ss << ")";
+    pe::ScheduleConfig config;
+    if (GetTunedConfig(node, &config)) ss << " tuned=" << config.ToString();
+    ss << "\n";
+  }
+  for (auto& group : graph_->FusionGroups()) {
+    if (group.size() == 1) continue;
+    ss << "fused(";
+    for (auto* node : group) ss << node->id() << " ";
+    ss << ")\n";
+  }
+  return ss.str();
+}
+
 std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions() {
+  // The lookups of the functions finish the compilation of the JIT.
+  utils::RecordEvent event("BuildInstructions", "hlir");
   std::vector<std::unique_ptr<Instruction>> instructions;
 
-  auto [nodes, edges] = graph_->topological_order();
-  for (int i = 0; i < nodes.size(); i++) {
-    auto* node = nodes[i]->safe_as<Node>();
-    if (node && node->attrs.attr_store.count("FuseNumber") > 0) {
-      int fuse_number = std::get<int>(node->attrs.attr_store["FuseNumber"]);
-      std::vector<std::string> inputNames;
-      std::vector<std::string> outputNames;
-      for (int j = 0; j < fuse_number; j++) {
-        auto* temp_node = nodes[i + 2 * j]->safe_as<Node>();
-        CHECK(temp_node);
-        auto temp_inputnames = OpGetInputNames(temp_node);
-        if (j == 0) {
-          inputNames.insert(inputNames.end(), temp_inputnames.begin(), temp_inputnames.end());
-        } else {
-          inputNames.insert(inputNames.end(), temp_inputnames.begin() + 1, temp_inputnames.end());
-        }
-        if (j == fuse_number - 1) {
-          auto temp_outputnames = OpGetOutputNames(temp_node);
-          outputNames.insert(outputNames.end(), temp_outputnames.begin(), temp_outputnames.end());
-        }
-      }
-      auto instr = std::unique_ptr<Instruction>(
-          new Instruction(target_, scope_.get(), inputNames, outputNames, node->op()->name + "_fused"));
+  for (auto& group : graph_->FusionGroups()) {
+    if (group.size() > 1) {
+      auto* node = group.front();
+      auto instr = std::unique_ptr<Instruction>(new Instruction(
+          target_, scope_.get(), GroupGetInputNames(group), GroupGetOutputNames(group), node->op()->name + "_fused"));
       auto* fn = compiler_->Lookup(GenOpFuncName(node) + "_fused");
       CHECK(fn);
       instr->SetLoweredFunc(fn);
+      EstimateCost(group, instr.get());
       instructions.push_back(std::move(instr));
-      i = i + 2 * fuse_number - 2;
       continue;
-    } else if (node) {
-      auto instr = std::unique_ptr<Instruction>(
-          new Instruction(target_, scope_.get(), OpGetInputNames(node), OpGetOutputNames(node), node->op()->name));
-      if (target_.arch == Target::Arch::NVGPU) {
-        if (node->op()->name == "conv2d") {
-          auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
-          for (auto& in_node : node->inlinks_in_order()) {
-            std::string in_id = in_node->source()->safe_as<NodeData>()->id();
-            auto in_shape     = shape_dict.at(in_id);
-            instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
-          }
-          AddAttrs(node->attrs.attr_store, {"padding", "stride", "dilation"}, instr.get());
-          if (node->attrs.attr_store.find("groups") != node->attrs.attr_store.end()) {
-            auto groups = std::get<int>(node->attrs.attr_store.at("groups"));
-            instr->attrs.push_back(groups);
-          } else {
-            instr->attrs.push_back(1);
-          }
-          CHECK(!node->outlinks_in_order().empty());
-          auto& out_node     = node->outlinks_in_order().front();
+    }
+    auto* node = group.front();
+    auto instr = std::unique_ptr<Instruction>(
+        new Instruction(target_, scope_.get(), OpGetInputNames(node), OpGetOutputNames(node), node->op()->name));
+    if (target_.arch == Target::Arch::NVGPU) {
+      if (node->op()->name == "conv2d") {
+        auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+        // The input and the weights, the params of a fused epilogue follow them.
+        auto& in_links = node->inlinks_in_order();
+        for (int i = 0; i < 2 && i < in_links.size(); i++) {
+          std::string in_id = in_links[i]->source()->safe_as<NodeData>()->id();
+          auto in_shape     = shape_dict.at(in_id);
+          instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
+        }
+        AddAttrs(node->attrs.attr_store, {"padding", "stride", "dilation"}, instr.get());
+        if (node->attrs.attr_store.find("groups") != node->attrs.attr_store.end()) {
+          auto groups = std::get<int>(node->attrs.attr_store.at("groups"));
+          instr->attrs.push_back(groups);
+        } else {
+          instr->attrs.push_back(1);
+        }
+        CHECK(!node->outlinks_in_order().empty());
+        auto& out_node     = node->outlinks_in_order().front();
+        std::string out_id = out_node->sink()->safe_as<NodeData>()->id();
+        auto out_shape     = shape_dict.at(out_id);
+        instr->attrs.insert(instr->attrs.end(), out_shape.begin(), out_shape.end());
+        CHECK_EQ(instr->attrs.size(), 19UL);
+      } else if (node->op()->name == "depthwise_conv2d") {
+        auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+        // The input and the weights, the params of a fused epilogue follow them.
+        auto& in_links = node->inlinks_in_order();
+        for (int i = 0; i < 2 && i < in_links.size(); i++) {
+          std::string in_id = in_links[i]->source()->safe_as<NodeData>()->id();
+          auto in_shape     = shape_dict.at(in_id);
+          instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
+        }
+        AddAttrs(node->attrs.attr_store, {"padding", "stride", "dilation"}, instr.get());
+        if (node->attrs.attr_store.find("groups") != node->attrs.attr_store.end()) {
+          auto groups = std::get<int>(node->attrs.attr_store.at("groups"));
+          instr->attrs.push_back(groups);
+        } else {
+          instr->attrs.push_back(instr->attrs[1]);
+        }
+        for (auto& out_node : node->outlinks_in_order()) {
           std::string out_id = out_node->sink()->safe_as<NodeData>()->id();
           auto out_shape     = shape_dict.at(out_id);
           instr->attrs.insert(instr->attrs.end(), out_shape.begin(), out_shape.end());
-          CHECK_EQ(instr->attrs.size(), 19UL);
-        } else if (node->op()->name == "depthwise_conv2d") {
-          auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
-          for (auto& in_node : node->inlinks_in_order()) {
-            std::string in_id = in_node->source()->safe_as<NodeData>()->id();
-            auto in_shape     = shape_dict.at(in_id);
-            instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
-          }
-          AddAttrs(node->attrs.attr_store, {"padding", "stride", "dilation"}, instr.get());
-          if (node->attrs.attr_store.find("groups") != node->attrs.attr_store.end()) {
-            auto groups = std::get<int>(node->attrs.attr_store.at("groups"));
-            instr->attrs.push_back(groups);
-          } else {
-            instr->attrs.push_back(instr->attrs[1]);
-          }
-          for (auto& out_node : node->outlinks_in_order()) {
-            std::string out_id = out_node->sink()->safe_as<NodeData>()->id();
-            auto out_shape     = shape_dict.at(out_id);
-            instr->attrs.insert(instr->attrs.end(), out_shape.begin(), out_shape.end());
-          }
-          CHECK_EQ(instr->attrs.size(), 19UL);
-        } else if (node->op()->name == "pool2d") {
-          auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
-          for (auto& in_node : node->inlinks_in_order()) {
-            std::string in_id = in_node->source()->safe_as<NodeData>()->id();
-            auto in_shape     = shape_dict.at(in_id);
-            CHECK_EQ(in_shape.size(), 4UL);
-            instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
-          }
-          bool global_pooling = false;
-          if (node->attrs.attr_store.find("global_pooling") != node->attrs.attr_store.end()) {
-            global_pooling = std::get<bool>(node->attrs.attr_store.at("global_pooling"));
-          }
-          if (node->attrs.attr_store.find("kernel_size") != node->attrs.attr_store.end()) {
-            if (global_pooling == false) {
-              auto padding = std::get<std::vector<int>>(node->attrs.attr_store.at("kernel_size"));
-              instr->attrs.insert(instr->attrs.end(), padding.begin(), padding.end());
-            } else {
-              instr->attrs.push_back(instr->attrs[2]);
-              instr->attrs.push_back(instr->attrs[3]);
-            }
-          }
-          if (node->attrs.attr_store.find("padding_size") != node->attrs.attr_store.end()) {
-            if (global_pooling == false) {
-              auto stride = std::get<std::vector<int>>(node->attrs.attr_store.at("padding_size"));
-              instr->attrs.insert(instr->attrs.end(), stride.begin(), stride.end());
-            } else {
-              instr->attrs.push_back(0);
-              instr->attrs.push_back(0);
-              instr->attrs.push_back(0);
-              instr->attrs.push_back(0);
-            }
-          }
-          AddAttrs(node->attrs.attr_store, {"stride_size", "pool_type"}, instr.get());
-
-          for (auto& out_node : node->outlinks_in_order()) {
-            std::string out_id = out_node->sink()->safe_as<NodeData>()->id();
-            auto out_shape     = shape_dict.at(out_id);
-            instr->attrs.insert(instr->attrs.end(), out_shape.begin(), out_shape.end());
-          }
-          CHECK_EQ(instr->attrs.size(), 16UL);
-          CHECK_EQ(instr->str_attrs.size(), 1UL);
-        } else if (node->op()->name == "softmax") {
-          auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
-          for (auto& in_node : node->inlinks_in_order()) {
-            std::string in_id = in_node->source()->safe_as<NodeData>()->id();
-            auto in_shape     = shape_dict.at(in_id);
-            instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
-          }
-          AddAttrs(node->attrs.attr_store, {"axis"}, instr.get());
-        } else if (node->op()->name == "mul") {
-          auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
-          for (auto& in_node : node->inlinks_in_order()) {
-            std::string in_id = in_node->source()->safe_as<NodeData>()->id();
-            auto in_shape     = shape_dict.at(in_id);
-            instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
-          }
-          if (node->attrs.attr_store.find("x_num_col_dims") != node->attrs.attr_store.end()) {
-            auto axis = std::get<int>(node->attrs.attr_store.at("x_num_col_dims"));
-            instr->attrs.push_back(axis);
+        }
+        CHECK_EQ(instr->attrs.size(), 19UL);
+      } else if (node->op()->name == "pool2d") {
+        auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+        for (auto& in_node : node->inlinks_in_order()) {
+          std::string in_id = in_node->source()->safe_as<NodeData>()->id();
+          auto in_shape     = shape_dict.at(in_id);
+          CHECK_EQ(in_shape.size(), 4UL);
+          instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
+        }
+        bool global_pooling = false;
+        if (node->attrs.attr_store.find("global_pooling") != node->attrs.attr_store.end()) {
+          global_pooling = std::get<bool>(node->attrs.attr_store.at("global_pooling"));
+        }
+        if (node->attrs.attr_store.find("kernel_size") != node->attrs.attr_store.end()) {
+          if (global_pooling == false) {
+            auto padding = std::get<std::vector<int>>(node->attrs.attr_store.at("kernel_size"));
+            instr->attrs.insert(instr->attrs.end(), padding.begin(), padding.end());
           } else {
-            instr->attrs.push_back(1);
+            instr->attrs.push_back(instr->attrs[2]);
+            instr->attrs.push_back(instr->attrs[3]);
           }
-          if (node->attrs.attr_store.find("y_num_col_dims") != node->attrs.attr_store.end()) {
-            auto axis = std::get<int>(node->attrs.attr_store.at("y_num_col_dims"));
-            instr->attrs.push_back(axis);
+        }
+        if (node->attrs.attr_store.find("padding_size") != node->attrs.attr_store.end()) {
+          if (global_pooling == false) {
+            auto stride = std::get<std::vector<int>>(node->attrs.attr_store.at("padding_size"));
+            instr->attrs.insert(instr->attrs.end(), stride.begin(), stride.end());
           } else {
-            instr->attrs.push_back(1);
+            instr->attrs.push_back(0);
+            instr->attrs.push_back(0);
+            instr->attrs.push_back(0);
+            instr->attrs.push_back(0);
           }
         }
+        AddAttrs(node->attrs.attr_store, {"stride_size", "pool_type"}, instr.get());
+
+        for (auto& out_node : node->outlinks_in_order()) {
+          std::string out_id = out_node->sink()->safe_as<NodeData>()->id();
+          auto out_shape     = shape_dict.at(out_id);
+          instr->attrs.insert(instr->attrs.end(), out_shape.begin(), out_shape.end());
+        }
+        CHECK_EQ(instr->attrs.size(), 16UL);
+        CHECK_EQ(instr->str_attrs.size(), 1UL);
+      } else if (node->op()->name == "softmax") {
+        auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+        for (auto& in_node : node->inlinks_in_order()) {
+          std::string in_id = in_node->source()->safe_as<NodeData>()->id();
+          auto in_shape     = shape_dict.at(in_id);
+          instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
+        }
+        AddAttrs(node->attrs.attr_store, {"axis"}, instr.get());
+      } else if (node->op()->name == "mul") {
+        auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+        for (auto& in_node : node->inlinks_in_order()) {
+          std::string in_id = in_node->source()->safe_as<NodeData>()->id();
+          auto in_shape     = shape_dict.at(in_id);
+          instr->attrs.insert(instr->attrs.end(), in_shape.begin(), in_shape.end());
+        }
+        if (node->attrs.attr_store.find("x_num_col_dims") != node->attrs.attr_store.end()) {
+          auto axis = std::get<int>(node->attrs.attr_store.at("x_num_col_dims"));
+          instr->attrs.push_back(axis);
+        } else {
+          instr->attrs.push_back(1);
+        }
+        if (node->attrs.attr_store.find("y_num_col_dims") != node->attrs.attr_store.end()) {
+          auto axis = std::get<int>(node->attrs.attr_store.at("y_num_col_dims"));
+          instr->attrs.push_back(axis);
+        } else {
+          instr->attrs.push_back(1);
+        }
       }
-      auto* fn = compiler_->Lookup(GenOpFuncName(node));
-      CHECK(fn);
-      instr->SetLoweredFunc(fn);
-      instructions.push_back(std::move(instr));
     }
+    auto* fn = compiler_->Lookup(GenOpFuncName(node));
+    CHECK(fn);
+    instr->SetLoweredFunc(fn);
+    EstimateCost(group, instr.get());
+    instructions.push_back(std::move(instr));
   }
   return instructions;
 }
@@ -274,13 +463,14 @@ ir::LoweredFunc GraphCompiler::GetOpFunc(const Node* node) {
   std::vector<common::CINNValue> cinn_inputs;
   std::vector<std::vector<int>> output_shapes;
   VLOG(2) << "GetOpFunc of op " << node->id();
+  utils::RecordEvent event("GetOpFunc", "hlir", node->id());
+  pe::ScheduleConfig tuned_config;
+  bool tuned = GetTunedConfig(node, &tuned_config);
+  pe::ScheduleConfig::Guard config_guard(tuned ? &tuned_config : pe::ScheduleConfig::Current());
   for (auto& i : node->inlinks_in_order()) {
     std::string input_id = i->source()->as<NodeData>()->id();
     auto in_shape        = shape_dict.at(input_id);
-    Type dtype           = dtype_dict.at(input_id);
-    CHECK_EQ(dtype, Float(32)) << "The dtype of node " << input_id
-                               << " is not float! Other dtype is not implemented yet.";
-    lang::Placeholder<float> temp(input_id, in_shape);
+    ir::Tensor temp      = CreateInput(input_id, in_shape, dtype_dict.at(input_id));
     inputs.push_back(temp);
     cinn_inputs.push_back(common::CINNValue(temp));
   }
@@ -292,17 +482,28 @@ ir::LoweredFunc GraphCompiler::GetOpFunc(const Node* node) {
     output_shapes.push_back(out_shape);
     out_types.push_back(dtype);
   }
-  auto impl = OpStrategy::SelectImpl(strategy[node->op()](node->attrs, inputs, out_types, output_shapes, target_));
+  std::shared_ptr<OpImpl> impl;
+  {
+    utils::RecordEvent select_event("SelectStrategy", "hlir");
+    impl = OpStrategy::SelectImpl(strategy[node->op()](node->attrs, inputs, out_types, output_shapes, target_));
+  }
 
-  common::CINNValuePack C = impl->fcompute(common::CINNValuePack{cinn_inputs});
-  poly::StageMap stages   = C.back();
+  common::CINNValuePack C(nullptr);
+  {
+    utils::RecordEvent compute_event("Compute", "hlir");
+    C = impl->fcompute(common::CINNValuePack{cinn_inputs});
+  }
+  poly::StageMap stages = C.back();
   // make sure all the tensors in the stages before schedule launch.
   for (int i = 0; i < C->size() - 1; i++) {
     ir::Expr temp = C[i];
     stages->InsertLazily(temp.as_tensor_ref());
   }
 
-  C = impl->fschedule(C);
+  {
+    utils::RecordEvent schedule_event("Schedule", "hlir");
+    C = impl->fschedule(C);
+  }
   for (int i = 0; i < C->size() - 1; i++) {
     ir::Expr temp = C[i];
     inputs.push_back(temp.as_tensor_ref());
@@ -318,51 +519,58 @@ ir::LoweredFunc GraphCompiler::GetOpFunc(const std::vector<Node*>& nodes) {
   auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
   auto& dtype_dict = graph_->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
   VLOG(2) << "GetOpFunc of fused op " << nodes[0]->id();
+  utils::RecordEvent event("GetOpFunc", "hlir", nodes[0]->id());
+  // The arguments of the function, the inputs of the group followed by its outputs.
   std::vector<ir::Tensor> inputs;
+  // The tensors computed so far by their ids.
+  std::unordered_map<std::string, ir::Expr> tensors;
+  for (auto& input_id : GroupGetInputNames(nodes)) {
+    ir::Tensor temp = CreateInput(input_id, shape_dict.at(input_id), dtype_dict.at(input_id));
+    inputs.push_back(temp);
+    tensors[input_id] = ir::Expr(temp);
+  }
+  auto output_names = GroupGetOutputNames(nodes);
+  std::unordered_set<std::string> group_outputs(output_names.begin(), output_names.end());
+
   poly::StageMap stages;
-  std::vector<int> init_shape{1};
-  int fuse_number = nodes.size();
-  lang::Placeholder<float> temp_out_ph("init", init_shape);
-  ir::Expr temp_out(temp_out_ph);
-  int index = 0;
   for (auto& node : nodes) {
     std::vector<ir::Tensor> temp_inputs;
     std::vector<common::CINNValue> cinn_inputs;
     std::vector<std::vector<int>> output_shapes;
-    int input_index = 0;
+    pe::ScheduleConfig tuned_config;
+    bool tuned = GetTunedConfig(node, &tuned_config);
+    pe::ScheduleConfig::Guard config_guard(tuned ? &tuned_config : pe::ScheduleConfig::Current());
     for (auto& i : node->inlinks_in_order()) {
-      if (index > 0 && input_index == 0) {
-        cinn_inputs.push_back(common::CINNValue(temp_out));
-        temp_inputs.push_back(temp_out.as_tensor_ref());
-      } else {
-        std::string input_id = i->source()->as<NodeData>()->id();
-        auto in_shape        = shape_dict.at(input_id);
-        Type dtype           = dtype_dict.at(input_id);
-        CHECK_EQ(dtype, Float(32)) << "The dtype of node " << input_id
-                                   << " is not float! Other dtype is not implemented yet.";
-        lang::Placeholder<float> temp(input_id, in_shape);
-        inputs.push_back(temp);
-        temp_inputs.push_back(temp);
-        cinn_inputs.push_back(common::CINNValue(temp));
-      }
-      input_index++;
+      ir::Expr temp = tensors.at(i->source()->as<NodeData>()->id());
+      temp_inputs.push_back(temp.as_tensor_ref());
+      cinn_inputs.push_back(common::CINNValue(temp));
     }
     std::vector<Type> out_types;
+    std::vector<std::string> out_ids;
     for (auto& out : node->outlinks_in_order()) {
       std::string out_id = out->sink()->safe_as<NodeData>()->id();
       auto out_shape     = shape_dict.at(out_id);
       Type dtype         = dtype_dict.at(out_id);
       output_shapes.push_back(out_shape);
       out_types.push_back(dtype);
+      out_ids.push_back(out_id);
+    }
+    std::shared_ptr<OpImpl> impl;
+    common::CINNValuePack C(nullptr);
+    {
+      // The phases of the nodes in the group are recorded on behalf of each node.
+      utils::RecordEvent select_event("SelectStrategy", "hlir", node->id());
+      impl = OpStrategy::SelectImpl(strategy[node->op()](node->attrs, temp_inputs, out_types, output_shapes, target_));
+    }
+    {
+      utils::RecordEvent compute_event("Compute", "hlir", node->id());
+      C = impl->fcompute(common::CINNValuePack{cinn_inputs});
+    }
+    {
+      utils::RecordEvent schedule_event("Schedule", "hlir", node->id());
+      C = impl->fschedule(C);
     }
-    auto impl =
-        OpStrategy::SelectImpl(strategy[node->op()](node->attrs, temp_inputs, out_types, output_shapes, target_));
-
-    common::CINNValuePack C = impl->fcompute(common::CINNValuePack{cinn_inputs});
-    C                       = impl->fschedule(C);
     CHECK_GE(C.size(), 2);
-    ir::Expr temp0             = C[0];
-    temp_out                   = temp0;
     poly::StageMap temp_stages = C.back();
 
     for (auto& i : temp_stages) {
@@ -372,22 +580,35 @@ ir::LoweredFunc GraphCompiler::GetOpFunc(const std::vector<Node*>& nodes) {
     for (int i = 0; i < C->size() - 1; i++) {
       ir::Expr temp = C[i];
       stages->InsertLazily(temp.as_tensor_ref(), temp_stages[temp.as_tensor_ref()]);
-      if (index < fuse_number - 1 && !temp.as_tensor_ref()->is_reduce_tensor()) {
+      // The temporary tensors of an op beyond its outputs are inlined too.
+      std::string out_id = i < out_ids.size() ? out_ids[i] : "";
+      if (!out_id.empty()) tensors[out_id] = temp;
+      if (group_outputs.count(out_id)) continue;
+      if (!temp.as_tensor_ref()->is_reduce_tensor()) {
         stages[temp.as_tensor_ref()]->ComputeInline();
-      } else if (index < fuse_number - 1 && temp.as_tensor_ref()->is_reduce_tensor()) {
+      } else {
         temp.as_tensor_ref()->WithBuffer("local", "_" + temp.as_tensor_ref()->name + "_temp_buffer");
         stages[temp.as_tensor_ref()]->SetScope(poly::ScopeKind::kLocal);
-      } else {
-        inputs.push_back(temp.as_tensor_ref());
       }
     }
-    index++;
+  }
+  const size_t num_inputs = inputs.size();
+  for (size_t i = 0; i < output_names.size(); i++) {
+    // The last op may compute fewer tensors than its outputs, e.g. a reduction in one phase, the rest are unused.
+    if (!tensors.count(output_names[i])) continue;
+    CHECK_EQ(inputs.size(), num_inputs + i)
+        << "The output " << output_names[i] << " of " << nodes[0]->id() << " follows the ones not computed";
+    inputs.push_back(tensors.at(output_names[i]).as_tensor_ref());
   }
 
-  for (auto& s : stages) {
-    if (s.second->tensor()->is_reduce_tensor()) {
-      stages[inputs.back()]->CopyTransform(s.second.get());
-      stages[inputs.back()]->CopyLoopInfo(s.second->forloop_infos(), s.second->transformed_domain());
+  // The epilogue of a reduction shares its loops, there is none if a reduction is the last, e.g. with a prologue only.
+  auto& last_output = inputs.back();
+  if (!last_output->is_reduce_tensor()) {
+    for (auto& s : stages) {
+      if (s.second->tensor()->is_reduce_tensor() && s.second->tensor()->name != last_output->name) {
+        stages[last_output]->CopyTransform(s.second.get());
+        stages[last_output]->CopyLoopInfo(s.second->forloop_infos(), s.second->transformed_domain());
+      }
     }
   }
   auto func = Lower(GenOpFuncName(nodes[0]) + "_fused", stages, inputs, {}, {}, nullptr, this->target_);
@@ -395,6 +616,29 @@ ir::LoweredFunc GraphCompiler::GetOpFunc(const std::vector<Node*>& nodes) {
   return func;
 }
 
+bool GraphCompiler::GetTunedConfig(const Node* node, pe::ScheduleConfig* config) const {
+  // The AutoTuner sets the config to try by itself.
+  if (target_.arch != Target::Arch::X86 || pe::ScheduleConfig::Current()) return false;
+  auto& log = TuningLog::Global();
+  return log.size() > 0 && log.Lookup(GetWorkloadKey(node, *graph_), config);
+}
+
+void GraphCompiler::EstimateCost(const std::vector<Node*>& nodes, Instruction* instr) const {
+  auto& shape_dict = graph_->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph_->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  instr->flops = 0;
+  for (auto* node : nodes) instr->flops += EstimateFlops(node, shape_dict);
+  // The intermediates of a fused group are inlined, only the arguments of the instruction go through the memory.
+  instr->bytes = 0;
+  auto args    = instr->GetInArgs();
+  for (auto& out : instr->GetOutArgs()) args.push_back(out);
+  for (auto& arg : args) {
+    double bytes = dtype_dict.at(arg).bytes();
+    for (int dim : shape_dict.at(arg)) bytes *= dim;
+    instr->bytes += bytes;
+  }
+}
+
 std::vector<std::string> GraphCompiler::OpGetInputNames(const Node* node) const {
   std::vector<std::string> res;
   for (auto& i : node->inlinks_in_order()) {
@@ -411,22 +655,84 @@ std::vector<std::string> GraphCompiler::OpGetOutputNames(const Node* node) const
   return res;
 }
 
+std::vector<std::string> GraphCompiler::GroupGetInputNames(const std::vector<Node*>& nodes) const {
+  std::unordered_set<std::string> produced;
+  for (auto* node : nodes) {
+    for (auto& id : OpGetOutputNames(node)) produced.insert(id);
+  }
+  std::vector<std::string> res;
+  std::unordered_set<std::string> visited;
+  for (auto* node : nodes) {
+    for (auto& id : OpGetInputNames(node)) {
+      if (!produced.count(id) && visited.insert(id).second) res.push_back(id);
+    }
+  }
+  return res;
+}
+
+std::vector<std::string> GraphCompiler::GroupGetOutputNames(const std::vector<Node*>& nodes) const {
+  std::unordered_set<const Node*> members(nodes.begin(), nodes.end());
+  std::unordered_set<const NodeData*> graph_outputs(graph_->outputs.begin(), graph_->outputs.end());
+  std::vector<std::string> res;
+  for (auto* node : nodes) {
+    for (auto& out : node->outlinks_in_order()) {
+      auto* data    = out->sink()->safe_as<NodeData>();
+      bool used_out = data->outlinks().empty() || graph_outputs.count(data);
+      for (auto& consumer : data->outlinks()) {
+        used_out = used_out || !members.count(consumer->sink()->safe_as<Node>());
+      }
+      if (used_out) res.push_back(data->id());
+    }
+  }
+  return res;
+}
+
 std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& graph, std::shared_ptr<Scope> scope) {
   auto& shape_dict = graph->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
   auto& dtype_dict = graph->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
   if (!scope) scope = std::make_shared<Scope>();
+
+  // The intermediate tensors planned by the MemoryPlan pass share the memory of a single slab.
+  const std::unordered_map<std::string, int>* memory_plan = nullptr;
+  std::shared_ptr<Buffer> slab;
+  if (graph->HasAttr("memory_plan")) {
+    memory_plan        = &graph->GetAttrs<std::unordered_map<std::string, int>>("memory_plan");
+    uint32_t slab_size = 0;
+    for (auto& [id, offset] : *memory_plan) {
+      slab_size = std::max(slab_size, offset + Shape(shape_dict.at(id)).numel() * dtype_dict.at(id).bytes());
+    }
+    slab = std::make_shared<Buffer>(target);
+    if (target == common::DefaultHostTarget()) {
+      slab->Resize(64, slab_size);
+    } else {
+      slab->Resize(slab_size);
+    }
+    VLOG(3) << "Slab of " << memory_plan->size() << " tensors resize to " << slab_size << " bytes";
+  }
+
   for (auto& iter : shape_dict) {
-    auto* var    = scope->Var<Tensor>(iter.first);
-    auto& tensor = std::get<Tensor>(*var);
+    bool planned = memory_plan && memory_plan->count(iter.first);
+    auto* var    = scope->FindVar(iter.first);
     std::vector<Shape::dim_t> shape;
     for (auto& shape_dim : iter.second) {
       shape.push_back(Shape::dim_t(shape_dim));
     }
+    Type dtype = dtype_dict.at(iter.first);
+    CHECK(IsSupportedDtype(dtype)) << "The dtype of node " << iter.first << " is " << dtype
+                                   << ", only the float ones, int8 and int32 are implemented yet.";
+    // No write to a shared tensor, the programs of other scopes may be reading it.
+    if (var && !planned) {
+      auto& tensor = std::get<Tensor>(*var);
+      if (tensor->shape().data() == shape && tensor->buffer()->memory) continue;
+    }
+    var          = scope->Var<Tensor>(iter.first);
+    auto& tensor = std::get<Tensor>(*var);
     VLOG(3) << "Tensor [" << iter.first << "] resize to " << utils::Join(shape, ",");
     tensor->Resize(Shape{shape});
-    CHECK_EQ(dtype_dict.at(iter.first), Float(32))
-        << "The dtype of node " << iter.first << " is not float! Other dtype is not implemented yet.";
-    tensor->mutable_data<float>(target);
+    if (planned) {
+      tensor->ShareMemory(slab, memory_plan->at(iter.first), tensor->shape().numel() * dtype.bytes());
+    }
+    tensor->mutable_data(target, dtype);
   }
   return scope;
 }
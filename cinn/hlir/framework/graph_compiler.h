@@ -8,15 +8,23 @@
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/cuda_util.h"
 #include "cinn/common/macros.h"
+#include "cinn/hlir/framework/dataflow_executor.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
 #include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/framework/program_profiler.h"
 #include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/pe/schedule_config.h"
 #include "cinn/ir/lowered_func.h"
 #include "cinn/lang/packed_func.h"
+#include "cinn/runtime/cpu/thread_backend.h"
 #include "cinn/utils/timer.h"
 
 namespace cinn {
+
+DECLARE_bool(cinn_parallel_execute);
+DECLARE_string(cinn_aot_linker);
+
 namespace hlir {
 namespace framework {
 
@@ -29,14 +37,35 @@ class Program {
    * Constructor.
    * @param scope The scope containing all the runtime variables.
    * @param instrs The instructions belonging to this program.
+   * @param parallel_execute Whether to run the independent instructions concurrently, see Execute.
    */
-  Program(const std::shared_ptr<Scope>& scope, std::vector<std::unique_ptr<Instruction>>&& instrs)
-      : scope_(scope), instrs_(std::move(instrs)) {}
+  Program(const std::shared_ptr<Scope>& scope,
+          std::vector<std::unique_ptr<Instruction>>&& instrs,
+          bool parallel_execute = FLAGS_cinn_parallel_execute)
+      : scope_(scope), instrs_(std::move(instrs)) {
+    for (auto& ins : instrs_) {
+      ins->Bind();
+    }
+    // The instructions on GPU are ordered by the stream already.
+    if (parallel_execute && !instrs_.empty() && instrs_[0]->target_.arch == Target::Arch::X86) {
+      executor_.reset(new DataflowExecutor(instrs_, runtime::CpuThreadPool()));
+    }
+  }
 
   /**
-   * Execute the program -- that is running all the instructions inside it.
+   * Execute the program -- that is running all the instructions inside it. The independent instructions run
+   * concurrently on runtime::CpuThreadPool() if FLAGS_cinn_parallel_execute is set, and one by one if the profiling is
+   * enabled.
    */
   void Execute() {
+    if (profiler_) {
+      profiler_->Run(instrs_);
+      return;
+    }
+    if (executor_) {
+      executor_->Run();
+      return;
+    }
     for (auto& ins : instrs_) {
       ins->Run();
     }
@@ -68,6 +97,29 @@ class Program {
     double test_op_time = timer1.Stop() / repeat_;
     LOG(INFO) << "Repeat times: [" << repeat_ << "], average op time: [" << test_op_time << "] ms";
   }
+  /**
+   * Record the latency of each instruction in the following executions, the first \p warmup executions are not
+   * recorded, and at most \p max_samples latencies of each instruction are kept for the percentiles. It restarts the
+   * recording if the profiling is enabled already.
+   */
+  void EnableProfiling(int warmup = 10, int max_samples = ProgramProfiler::kMaxSamples) {
+    profiler_.reset(new ProgramProfiler(warmup, max_samples));
+  }
+  void DisableProfiling() { profiler_.reset(); }
+  //! The profiler of the executions since EnableProfiling, nullptr if the profiling is disabled.
+  const ProgramProfiler* profiler() const { return profiler_.get(); }
+
+  /**
+   * A program running the same compiled code on the tensors of the same names in \p scope, e.g. the activations of
+   * another request sharing the parameters. The instructions run one by one, with no DataflowExecutor, so that the
+   * programs running in different threads do not wait for each other on runtime::CpuThreadPool().
+   */
+  std::unique_ptr<Program> Clone(const std::shared_ptr<Scope>& scope) const {
+    std::vector<std::unique_ptr<Instruction>> instrs;
+    for (auto& ins : instrs_) instrs.push_back(ins->CloneTo(scope.get()));
+    return std::unique_ptr<Program>(new Program(scope, std::move(instrs), false));
+  }
+
   /**
    * Get the number of instructions.
    */
@@ -77,8 +129,12 @@ class Program {
   // We need to hold scope to assure tensors alive used in instructions.
   std::shared_ptr<Scope> scope_;
   std::vector<std::unique_ptr<Instruction>> instrs_;
+  std::unique_ptr<DataflowExecutor> executor_;
+  std::unique_ptr<ProgramProfiler> profiler_;
 };
 
+class AutoTuner;
+
 /**
  * GraphCompiler compiles a graph and generate the runtime Program.
  */
@@ -89,38 +145,81 @@ class GraphCompiler final {
 
   std::unique_ptr<Program> Build(const std::string& code = "");
 
+  /**
+   * Lower and compile the graph with no access to the tensors of the scope, so that they can be prepared meanwhile,
+   * e.g. by BuildScope after the parameters are loaded. Build compiles the graph if it is not compiled by it.
+   */
+  void Compile(const std::string& code = "");
+
   std::string GenSourceCode();
 
+  /**
+   * Compile the graph ahead of time into a library to run with AotModule, with no JIT. Only for X86.
+   * @param path The shared library to export, linked by FLAGS_cinn_aot_linker. If it ends with ".o", the object file
+   * is exported instead, to be linked by the user.
+   * @param param_names The tensors to save to the sidecar file \p path.params with their data in the scope.
+   */
+  void ExportLibrary(const std::string& path, const std::vector<std::string>& param_names = {});
+
   void PrintFunc();
 
   const std::shared_ptr<Scope>& GetScope() const { return scope_; }
 
  private:
+  //! Estimate the floating point operations and the bytes moved by \p instr, which runs the group \p nodes.
+  void EstimateCost(const std::vector<Node*>& nodes, Instruction* instr) const;
+
+  //! The body of Build, recorded by the build profiler as a whole.
+  std::unique_ptr<Program> BuildProgram(const std::string& code);
+
+  //! Lower a fused group into a single function, the tensors used only in the group are inlined.
   ir::LoweredFunc GetOpFunc(const std::vector<Node*>& nodes);
 
   ir::LoweredFunc GetOpFunc(const Node* node);
 
   std::string GenOpFuncName(const Node* node) const { return "fn_" + node->id(); }
 
+  //! Get the content identifying the compiled module of the graph, it is available before lowering, so that a hit in
+  //! the on-disk compilation cache skips the lowering too.
+  std::string GenGraphSignature() const;
+
   // TODO(haozech) add implementation
   std::vector<std::string> OpGetInputNames(const Node* node) const;
   // TODO(haozech) add implementation
   std::vector<std::string> OpGetOutputNames(const Node* node) const;
 
+  //! The tensors a fused group reads and are produced out of it, in the order of the function arguments.
+  std::vector<std::string> GroupGetInputNames(const std::vector<Node*>& nodes) const;
+  //! The tensors a fused group writes, that is used out of it or an output of the graph.
+  std::vector<std::string> GroupGetOutputNames(const std::vector<Node*>& nodes) const;
+
   std::vector<std::unique_ptr<Instruction>> BuildInstructions();
 
+  //! The tensors and instructions of the program in the library ExportLibrary exports, see AotManifest.
+  std::string GenAotManifest() const;
+
+  //! Get the schedule config of \p node recorded in the tuning log, returns false if it is not tuned.
+  bool GetTunedConfig(const Node* node, pe::ScheduleConfig* config) const;
+
  private:
   Target target_;
   std::shared_ptr<Graph> graph_;
   std::shared_ptr<Scope> scope_;
 
   std::unique_ptr<backends::Compiler> compiler_;
+  bool compiled_{};
 
   ir::Module::Builder m_builder_;
 
+  friend class AutoTuner;
+
   CINN_DISALLOW_COPY_AND_ASSIGN(GraphCompiler);
 };
 
+/**
+ * Create the tensors of \p graph in \p scope, or in a new scope if it is nullptr, with their shapes and memory. A
+ * tensor already in \p scope with its shape and memory is kept as it is, e.g. a parameter shared by other scopes.
+ */
 std::shared_ptr<Scope> BuildScope(Target target,
                                   const std::shared_ptr<Graph>& graph,
                                   std::shared_ptr<Scope> scope = nullptr);
@@ -0,0 +1,47 @@
+#include "cinn/hlir/framework/graph_test_helper.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "cinn/hlir/framework/pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+int NumOps(Graph* graph) {
+  auto nodes = graph->nodes();
+  return std::count_if(nodes.begin(), nodes.end(), [](auto* node) { return node->template safe_as<Node>(); });
+}
+
+frontend::Variable MakeVariable(const std::string& name, const std::vector<int>& shape, Type type) {
+  frontend::Variable var(name);
+  var->shape = shape;
+  var->type  = type;
+  return var;
+}
+
+std::unique_ptr<Program> BuildHostProgram(const frontend::Program& prog,
+                                          const std::vector<std::string>& passes,
+                                          std::shared_ptr<Scope>* scope) {
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  for (auto& pass : passes) ApplyPass(graph.get(), pass);
+  *scope = BuildScope(target, graph);
+  GraphCompiler gc(target, *scope, graph);
+  return gc.Build();
+}
+
+float Random(float low, float high) { return low + (high - low) * rand() / RAND_MAX; }  // NOLINT
+
+float* SetRandom(Scope* scope, const std::string& name, float low, float high) {
+  auto tensor = scope->GetTensor(name);
+  auto* data  = tensor->mutable_data<float>(common::DefaultHostTarget());
+  for (int i = 0; i < tensor->shape().numel(); i++) data[i] = Random(low, high);
+  return data;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+//! The number of the op nodes in \p graph.
+int NumOps(Graph* graph);
+
+frontend::Variable MakeVariable(const std::string& name, const std::vector<int>& shape, Type type = Float(32));
+
+/**
+ * Compile \p prog for the host, with \p passes applied after InferShape. The scope of the tensors is returned in
+ * \p scope.
+ */
+std::unique_ptr<Program> BuildHostProgram(const frontend::Program& prog,
+                                          const std::vector<std::string>& passes,
+                                          std::shared_ptr<Scope>* scope);
+
+//! A random number uniform in [low, high].
+float Random(float low = -1.f, float high = 1.f);
+
+//! Fill the host float tensor \p name of \p scope with the random numbers in [low, high].
+float* SetRandom(Scope* scope, const std::string& name, float low = -1.f, float high = 1.f);
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
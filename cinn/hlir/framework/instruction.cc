@@ -24,6 +24,58 @@ std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs() {
   return args_cached_;
 }
 
+void Instruction::Bind() {
+  CHECK(fn_) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
+  PreparePodArgs();
+  dispatch_ = CallLoweredFunc;
+#ifdef CINN_WITH_CUDNN
+  if (target_.arch == Target::Arch::NVGPU) {
+    // Here conv2d and depthwise_conv2d are implemented by one cudnn api cudnnConvolutionForward
+    if (function_name_ == "conv2d" || function_name_ == "depthwise_conv2d") {
+      dispatch_ = CallCudnnConv2d;
+    } else if (function_name_ == "pool2d") {
+      dispatch_ = CallCudnnPool2d;
+    } else if (function_name_ == "softmax") {
+      CHECK_EQ(args_cached_.size(), 3);
+      dispatch_ = CallCudnnSoftmax;
+    } else if (function_name_ == "mul") {
+      CHECK_EQ(args_cached_.size(), 4);
+      dispatch_ = CallCublasMul;
+    }
+  }
+#endif
+}
+
+std::unique_ptr<Instruction> Instruction::CloneTo(Scope* scope) const {
+  std::unique_ptr<Instruction> instr(new Instruction(*this));
+  instr->scope_ = scope;
+  instr->args_cached_.clear();
+  instr->dispatch_ = nullptr;
+  return instr;
+}
+
+#ifdef CINN_WITH_CUDNN
+void Instruction::CallCudnnConv2d(Instruction* instr) {
+  auto& args = instr->args_cached_;
+  runtime::cuda::cinn_gpu_cudnn_conv2d(instr->attrs, args[0], args[1], args[2]);
+}
+
+void Instruction::CallCudnnPool2d(Instruction* instr) {
+  auto& args = instr->args_cached_;
+  runtime::cuda::cinn_gpu_cudnn_pool2d(instr->attrs, instr->str_attrs, args[0], args[1]);
+}
+
+void Instruction::CallCudnnSoftmax(Instruction* instr) {
+  auto& args = instr->args_cached_;
+  runtime::cuda::cinn_gpu_cudnn_softmax(instr->attrs, args[0], args[1]);
+}
+
+void Instruction::CallCublasMul(Instruction* instr) {
+  auto& args = instr->args_cached_;
+  runtime::cuda::cinn_gpu_cublas_mul(instr->attrs, args[0], args[1], args[2]);
+}
+#endif
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -43,43 +44,58 @@ class Instruction {
    * Set compiled function address.
    * @param fn The JIT compiled function address.
    */
-  void SetLoweredFunc(lower_func_ptr_t fn) { fn_ = fn; }
+  void SetLoweredFunc(lower_func_ptr_t fn) {
+    fn_       = fn;
+    dispatch_ = nullptr;
+  }
+
+  /**
+   * Resolve the arguments from the scope and pick the function to dispatch to. It is called once when the Program is
+   * constructed, so that Run does no lookup in the scope and no string compare.
+   */
+  void Bind();
+
+  /**
+   * A copy of the instruction calling the same function on the variables of the same names in \p scope, to run the
+   * compiled code on other tensors. It is bound by the next Bind or Run.
+   */
+  std::unique_ptr<Instruction> CloneTo(Scope* scope) const;
 
   /**
    * Run the Instruction.
    */
   void Run() {
-    CHECK(fn_) << "The LoweredFunc address should be set first by calling SetLoweredFunc method";
-    auto& pod_args = PreparePodArgs();
-#ifdef CINN_WITH_CUDNN
-    // Here conv2d and depthwise_conv2d are implemented by one cudnn api cudnnConvolutionForward
-    if ((function_name_ == "conv2d" || function_name_ == "depthwise_conv2d") && target_.arch == Target::Arch::NVGPU) {
-      runtime::cuda::cinn_gpu_cudnn_conv2d(attrs, pod_args[0], pod_args[1], pod_args[2]);
-    } else if (function_name_ == "pool2d" && target_.arch == Target::Arch::NVGPU) {
-      runtime::cuda::cinn_gpu_cudnn_pool2d(attrs, str_attrs, pod_args[0], pod_args[1]);
-    } else if (function_name_ == "softmax" && target_.arch == Target::Arch::NVGPU) {
-      CHECK_EQ(pod_args.size(), 3);
-      runtime::cuda::cinn_gpu_cudnn_softmax(attrs, pod_args[0], pod_args[1]);
-    } else if (function_name_ == "mul" && target_.arch == Target::Arch::NVGPU) {
-      CHECK_EQ(pod_args.size(), 4);
-      runtime::cuda::cinn_gpu_cublas_mul(attrs, pod_args[0], pod_args[1], pod_args[2]);
-    } else {
-      fn_(pod_args.data(), pod_args.size());
-    }
-#else
-    fn_(pod_args.data(), pod_args.size());
-#endif
+    if (!dispatch_) Bind();
+    dispatch_(this);
   }
+  //! The arguments passed to the LoweredFunc, the inputs followed by the outputs, available after Bind.
+  const std::vector<cinn_pod_value_t>& GetPodArgs() const { return args_cached_; }
   std::vector<std::string> GetInArgs() { return in_args_; }
   std::vector<std::string> GetOutArgs() { return out_args_; }
+  const std::string& function_name() const { return function_name_; }
   std::vector<int> attrs;
   std::vector<std::string> str_attrs;
+  //! The floating point operations and the bytes of memory moved by a run, estimated from the shapes of the graph.
+  double flops{};
+  double bytes{};
   Target target_;
 
  protected:
   std::vector<cinn_pod_value_t>& PreparePodArgs();
 
  private:
+  using dispatch_t = void (*)(Instruction*);
+
+  static void CallLoweredFunc(Instruction* instr) {
+    instr->fn_(instr->args_cached_.data(), instr->args_cached_.size());
+  }
+#ifdef CINN_WITH_CUDNN
+  static void CallCudnnConv2d(Instruction* instr);
+  static void CallCudnnPool2d(Instruction* instr);
+  static void CallCudnnSoftmax(Instruction* instr);
+  static void CallCublasMul(Instruction* instr);
+#endif
+
   Scope* scope_{};
   std::string function_name_;
   std::vector<std::string> in_args_;
@@ -88,6 +104,7 @@ class Instruction {
   std::vector<cinn_pod_value_t> args_cached_;
 
   lower_func_ptr_t fn_{};
+  dispatch_t dispatch_{};
 };
 
 }  // namespace framework
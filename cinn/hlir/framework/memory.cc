@@ -1,5 +1,14 @@
 #include "cinn/hlir/framework/memory.h"
 
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
 #ifdef CINN_WITH_CUDA
 #include <cuda.h>
 #include <cuda_runtime.h>
@@ -7,6 +16,10 @@
 #include "cinn/backends/cuda_util.h"
 #endif
 
+DEFINE_bool(cinn_caching_cuda_memory,
+            false,
+            "Whether to cache the CUDA memory freed by CachingMemoryMng instead of returning it by cudaFree.");
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -23,29 +36,263 @@ class X86MemoryMng : public MemoryInterface {
     ::free(data);
   }
   void* aligned_alloc(size_t alignment, size_t nbytes) override { return ::aligned_alloc(alignment, nbytes); }
+  bool has_aligned_alloc() const override { return true; }
 };
 
 #ifdef CINN_WITH_CUDA
 class CudaMemoryMng : public MemoryInterface {
  public:
+  //! @param null_on_oom Return nullptr when out of memory instead of aborting, for CachingMemoryMng to retry.
+  explicit CudaMemoryMng(bool null_on_oom = false) : null_on_oom_(null_on_oom) {}
+
   void* malloc(size_t nbytes) override {
     void* data;
-    CUDA_CALL(cudaMalloc(&data, nbytes));
+    auto status = cudaMalloc(&data, nbytes);
+    if (status == cudaErrorMemoryAllocation && null_on_oom_) {
+      // Clear the sticky error of the failed allocation.
+      cudaGetLastError();
+      return nullptr;
+    }
+    CUDA_CALL(status);
     return data;
   }
 
   void free(void* data) override { CUDA_CALL(cudaFree(data)); }
+
+  //! cudaMalloc aligns to 256 bytes at least.
+  size_t malloc_alignment() const override { return 256; }
+
+ private:
+  bool null_on_oom_;
 };
 
 #endif
 
+// The blocks larger than this skip the per-thread caches.
+constexpr size_t kMaxThreadCachedSize = 256 * 1024;
+// The max number of blocks of a size class kept in a per-thread cache.
+constexpr size_t kMaxThreadCachedBlocks = 8;
+// A cached block is not reused for a request less than 1 / kMaxBestFitRatio of its size.
+constexpr size_t kMaxBestFitRatio = 2;
+constexpr int kNumShards          = 16;
+
+std::atomic<uint64_t> caching_memory_mng_count{0};
+
+bool IsAligned(void* data, size_t alignment) { return reinterpret_cast<uintptr_t>(data) % alignment == 0; }
+
 }  // namespace
 
+struct CachingMemoryMng::Pool {
+  struct BlockInfo {
+    size_t size{};
+    size_t requested{};
+  };
+
+  //! The blocks in use, sharded by the address to reduce the contention.
+  struct Shard {
+    std::mutex mu;
+    std::unordered_map<void*, BlockInfo> blocks;
+  };
+
+  explicit Pool(MemoryInterface* upstream) : upstream(upstream) {}
+  ~Pool() { Release(); }
+
+  Shard& shard(void* data) { return shards[reinterpret_cast<uintptr_t>(data) / kMinAlignment % kNumShards]; }
+
+  //! Allocate from the upstream, returns nullptr if it is out of memory.
+  void* AllocateUpstream(size_t alignment, size_t size) {
+    if (upstream->has_aligned_alloc()) return upstream->aligned_alloc(alignment, size);
+    CHECK_LE(alignment, upstream->malloc_alignment())
+        << "The upstream has no aligned_alloc and its malloc is aligned to " << upstream->malloc_alignment()
+        << " only, but " << alignment << " is requested";
+    void* data = upstream->malloc(size);
+    if (data) CHECK(IsAligned(data, alignment)) << "The memory allocated is not aligned to " << alignment;
+    return data;
+  }
+
+  //! Take the smallest cached block fitting the request, returns nullptr if there is none.
+  void* TakeBestFit(size_t alignment, size_t size, size_t* block_size) {
+    std::lock_guard<std::mutex> lock(mu);
+    for (auto it = free_blocks.lower_bound(size); it != free_blocks.end() && it->first <= size * kMaxBestFitRatio;
+         ++it) {
+      if (!IsAligned(it->second, alignment)) continue;
+      void* data  = it->second;
+      *block_size = it->first;
+      free_blocks.erase(it);
+      return data;
+    }
+    return nullptr;
+  }
+
+  void Put(void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mu);
+    free_blocks.emplace(size, data);
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mu);
+    for (auto& [size, data] : free_blocks) {
+      upstream->free(data);
+      bytes_cached -= size;
+    }
+    free_blocks.clear();
+  }
+
+  std::unique_ptr<MemoryInterface> upstream;
+  std::mutex mu;
+  //! The cached blocks by size.
+  std::multimap<size_t, void*> free_blocks;
+  std::array<Shard, kNumShards> shards;
+
+  std::atomic<size_t> bytes_in_use{0};
+  std::atomic<size_t> bytes_requested{0};
+  std::atomic<size_t> bytes_cached{0};
+  std::atomic<size_t> num_requests{0};
+  std::atomic<size_t> num_hits{0};
+};
+
+/**
+ * The blocks of a CachingMemoryMng cached by a thread, they are given back to the shared pool when the thread exits.
+ * The blocks are leaked if the CachingMemoryMng is destroyed before.
+ */
+struct CachingMemoryMng::ThreadCache {
+  ~ThreadCache() {
+    auto shared_pool = pool.lock();
+    if (!shared_pool) return;
+    for (auto& [size, blocks] : bins) {
+      for (void* data : blocks) shared_pool->Put(data, size);
+    }
+  }
+
+  std::weak_ptr<Pool> pool;
+  //! The cached blocks by size.
+  std::unordered_map<size_t, std::vector<void*>> bins;
+};
+
+CachingMemoryMng::CachingMemoryMng(MemoryInterface* upstream)
+    : pool_(std::make_shared<Pool>(upstream)), id_(caching_memory_mng_count++) {
+  CHECK(upstream);
+}
+
+CachingMemoryMng::~CachingMemoryMng() { ReleaseCached(); }
+
+size_t CachingMemoryMng::RoundSize(size_t nbytes) {
+  if (nbytes <= kMinAlignment) return kMinAlignment;
+  // The largest power of 2 less than nbytes.
+  size_t base = size_t(1) << (63 - __builtin_clzll(nbytes - 1));
+  size_t step = base / 4;
+  return (nbytes + step - 1) / step * step;
+}
+
+CachingMemoryMng::ThreadCache& CachingMemoryMng::thread_cache() {
+  thread_local std::unordered_map<uint64_t, ThreadCache> caches;
+  auto& cache = caches[id_];
+  if (cache.pool.expired()) cache.pool = pool_;
+  return cache;
+}
+
+void* CachingMemoryMng::aligned_alloc(size_t alignment, size_t nbytes) {
+  CHECK_EQ(alignment & (alignment - 1), 0) << "The alignment should be a power of 2, but got " << alignment;
+  alignment   = std::max(alignment, kMinAlignment);
+  size_t size = (RoundSize(nbytes) + alignment - 1) / alignment * alignment;
+  pool_->num_requests++;
+
+  void* data        = nullptr;
+  size_t block_size = size;
+  if (size <= kMaxThreadCachedSize) {
+    auto& bins = thread_cache().bins;
+    auto it    = bins.find(size);
+    if (it != bins.end()) {
+      auto& blocks = it->second;
+      for (int i = static_cast<int>(blocks.size()) - 1; i >= 0; i--) {
+        if (!IsAligned(blocks[i], alignment)) continue;
+        data = blocks[i];
+        blocks.erase(blocks.begin() + i);
+        break;
+      }
+    }
+  }
+  if (!data) data = pool_->TakeBestFit(alignment, size, &block_size);
+
+  if (data) {
+    pool_->num_hits++;
+    pool_->bytes_cached -= block_size;
+  } else {
+    data = pool_->AllocateUpstream(alignment, size);
+    if (!data) {
+      LOG(WARNING) << "Out of memory when allocating " << size << " bytes, release the " << pool_->bytes_cached
+                   << " bytes cached and retry";
+      ReleaseCached();
+      data = pool_->AllocateUpstream(alignment, size);
+    }
+    CHECK(data) << "Out of memory when allocating " << size << " bytes";
+  }
+
+  {
+    auto& shard = pool_->shard(data);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    shard.blocks[data] = Pool::BlockInfo{block_size, nbytes};
+  }
+  pool_->bytes_in_use += block_size;
+  pool_->bytes_requested += nbytes;
+  return data;
+}
+
+void CachingMemoryMng::free(void* data) {
+  if (!data) return;
+  Pool::BlockInfo info;
+  {
+    auto& shard = pool_->shard(data);
+    std::lock_guard<std::mutex> lock(shard.mu);
+    auto it = shard.blocks.find(data);
+    CHECK(it != shard.blocks.end()) << "The memory to free is not allocated by this CachingMemoryMng";
+    info = it->second;
+    shard.blocks.erase(it);
+  }
+  pool_->bytes_in_use -= info.size;
+  pool_->bytes_requested -= info.requested;
+  pool_->bytes_cached += info.size;
+
+  if (info.size <= kMaxThreadCachedSize) {
+    auto& blocks = thread_cache().bins[info.size];
+    if (blocks.size() < kMaxThreadCachedBlocks) {
+      blocks.push_back(data);
+      return;
+    }
+  }
+  pool_->Put(data, info.size);
+}
+
+CachingMemoryMng::Stats CachingMemoryMng::stats() const {
+  Stats stats;
+  stats.bytes_in_use    = pool_->bytes_in_use;
+  stats.bytes_requested = pool_->bytes_requested;
+  stats.bytes_cached    = pool_->bytes_cached;
+  stats.num_requests    = pool_->num_requests;
+  stats.num_hits        = pool_->num_hits;
+  return stats;
+}
+
+void CachingMemoryMng::ReleaseCached() {
+  for (auto& [size, blocks] : thread_cache().bins) {
+    for (void* data : blocks) {
+      pool_->upstream->free(data);
+      pool_->bytes_cached -= size;
+    }
+    blocks.clear();
+  }
+  pool_->Release();
+}
+
 MemoryManager::MemoryManager() {
-  Register(Target::Arch::Unk, new X86MemoryMng);
-  Register(Target::Arch::X86, new X86MemoryMng);
+  Register(Target::Arch::Unk, new CachingMemoryMng(new X86MemoryMng));
+  Register(Target::Arch::X86, new CachingMemoryMng(new X86MemoryMng));
 #ifdef CINN_WITH_CUDA
-  Register(Target::Arch::NVGPU, new CudaMemoryMng);
+  if (FLAGS_cinn_caching_cuda_memory) {
+    Register(Target::Arch::NVGPU, new CachingMemoryMng(new CudaMemoryMng(true)));
+  } else {
+    Register(Target::Arch::NVGPU, new CudaMemoryMng);
+  }
 #endif
 }
 
@@ -2,6 +2,7 @@
 
 #include <glog/logging.h>
 
+#include <cstddef>
 #include <memory>
 #include <unordered_map>
 
@@ -17,9 +18,75 @@ class MemoryInterface {
   virtual void* malloc(size_t nbytes) = 0;
   virtual void free(void* data)       = 0;
   virtual void* aligned_alloc(size_t alignment, size_t nbytes) { return nullptr; }
+  //! Whether aligned_alloc is implemented, it returns nullptr only when out of memory then.
+  virtual bool has_aligned_alloc() const { return false; }
+  //! The alignment of the memory malloc returns.
+  virtual size_t malloc_alignment() const { return alignof(std::max_align_t); }
   virtual ~MemoryInterface() {}
 };
 
+/**
+ * CachingMemoryMng is a MemoryInterface recycling the freed blocks of another one instead of returning them.
+ *
+ * The requests are rounded up to size classes, four classes between two powers of 2. The small blocks freed are kept
+ * in a per-thread cache first, the others go to a shared pool serving the requests by best fit. All the blocks are
+ * aligned to kMinAlignment at least, so a block can be reused by any request not asking for a larger alignment.
+ *
+ * The upstream allocates by aligned_alloc if it has one, or by malloc if that is aligned enough. When the upstream runs
+ * out of memory, that is returns nullptr, the cached blocks are returned to it and the allocation is retried once.
+ */
+class CachingMemoryMng : public MemoryInterface {
+ public:
+  static constexpr size_t kMinAlignment = 64;
+
+  struct Stats {
+    //! The bytes of the blocks handed out and not freed yet.
+    size_t bytes_in_use{};
+    //! The bytes actually requested for the blocks in use.
+    size_t bytes_requested{};
+    //! The bytes of the freed blocks kept for reuse.
+    size_t bytes_cached{};
+    size_t num_requests{};
+    //! The number of requests served by a cached block.
+    size_t num_hits{};
+
+    double hit_rate() const { return num_requests ? static_cast<double>(num_hits) / num_requests : 0.; }
+    //! The fraction of the bytes in use wasted by the size class rounding and the best fit.
+    double fragmentation() const {
+      return bytes_in_use ? 1. - static_cast<double>(bytes_requested) / bytes_in_use : 0.;
+    }
+  };
+
+  //! Takes the ownership of \p upstream.
+  explicit CachingMemoryMng(MemoryInterface* upstream);
+  ~CachingMemoryMng();
+
+  void* malloc(size_t nbytes) override { return aligned_alloc(kMinAlignment, nbytes); }
+  void free(void* data) override;
+  void* aligned_alloc(size_t alignment, size_t nbytes) override;
+  bool has_aligned_alloc() const override { return true; }
+
+  Stats stats() const;
+
+  //! Return the blocks cached in the shared pool and in the cache of the current thread to the upstream.
+  void ReleaseCached();
+
+  //! Round \p nbytes up to its size class.
+  static size_t RoundSize(size_t nbytes);
+
+ private:
+  struct Pool;
+  struct ThreadCache;
+
+  ThreadCache& thread_cache();
+
+  std::shared_ptr<Pool> pool_;
+  //! Identifies the per-thread caches of this allocator, never reused.
+  const uint64_t id_;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(CachingMemoryMng);
+};
+
 /**
  * MemoryManager holds a map of MemoryInterface for each articture.
  */
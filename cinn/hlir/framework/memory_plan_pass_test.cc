@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <any>
+#include <string>
+#include <unordered_map>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(MemoryPlan, chain) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.add(c, b);
+  auto e   = prog.add(d, b);
+  auto f   = prog.add(e, b);
+  auto g   = prog.add(f, b);
+  ASSERT_EQ(prog.size(), 5UL);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPasses(graph.get(), {"InferShape", "MemoryPlan"});
+
+  // Only two intermediate tensors are live at the same time, and the output is kept till the end.
+  auto& memory_plan = graph->GetAttrs<std::unordered_map<std::string, int>>("memory_plan");
+  ASSERT_EQ(memory_plan.size(), 5UL);
+  int num_slots = 0;
+  for (auto& [id, offset] : memory_plan) {
+    num_slots = std::max(num_slots, offset / (100 * 32 * 4) + 1);
+  }
+  ASSERT_EQ(num_slots, 2);
+  ASSERT_NE(memory_plan.at(f->id), memory_plan.at(g->id));
+
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  auto A      = scope->GetTensor("A");
+  auto B      = scope->GetTensor("B");
+  auto* a_ptr = A->mutable_data<float>(target);
+  auto* b_ptr = B->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    a_ptr[i] = (rand() * 1.f) / RAND_MAX;  // NOLINT
+    b_ptr[i] = (rand() * 1.f) / RAND_MAX;  // NOLINT
+  }
+
+  program->Execute();
+
+  auto* g_ptr = scope->GetTensor(g->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    ASSERT_NEAR(a_ptr[i] + 5 * b_ptr[i], g_ptr[i], 1e-5);
+  }
+}
+
+TEST(MemoryPlan, fetched_output_with_consumer) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.add(c, b);
+  auto e   = prog.add(d, b);
+  auto f   = prog.add(e, b);
+  ASSERT_EQ(prog.size(), 4UL);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  // C is fetched by the caller though D consumes it, its memory should not be reused by E or F.
+  graph->outputs.push_back(graph->RetrieveNode(c->id)->safe_as<NodeData>());
+  ApplyPasses(graph.get(), {"InferShape", "MemoryPlan"});
+
+  auto& memory_plan = graph->GetAttrs<std::unordered_map<std::string, int>>("memory_plan");
+  ASSERT_EQ(memory_plan.size(), 4UL);
+  for (auto& id : {d->id, e->id, f->id}) {
+    ASSERT_NE(memory_plan.at(c->id), memory_plan.at(id));
+  }
+
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+
+  auto A      = scope->GetTensor("A");
+  auto B      = scope->GetTensor("B");
+  auto* a_ptr = A->mutable_data<float>(target);
+  auto* b_ptr = B->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    a_ptr[i] = (rand() * 1.f) / RAND_MAX;  // NOLINT
+    b_ptr[i] = (rand() * 1.f) / RAND_MAX;  // NOLINT
+  }
+
+  program->Execute();
+
+  auto* c_ptr = scope->GetTensor(c->id)->data<float>();
+  auto* f_ptr = scope->GetTensor(f->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    ASSERT_NEAR(a_ptr[i] + b_ptr[i], c_ptr[i], 1e-5);
+    ASSERT_NEAR(a_ptr[i] + 4 * b_ptr[i], f_ptr[i], 1e-5);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,168 @@
+#include "cinn/hlir/framework/memory.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/hlir/framework/buffer.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+class HostMemoryMng : public MemoryInterface {
+ public:
+  void* malloc(size_t nbytes) override {
+    num_allocs++;
+    return ::malloc(nbytes);
+  }
+  void free(void* data) override { ::free(data); }
+  void* aligned_alloc(size_t alignment, size_t nbytes) override {
+    num_allocs++;
+    return ::aligned_alloc(alignment, nbytes);
+  }
+  bool has_aligned_alloc() const override { return true; }
+
+  // The threads allocating through the caching manager call it concurrently.
+  std::atomic<int> num_allocs{0};
+};
+
+//! An upstream of limited capacity with no aligned_alloc, like cudaMalloc.
+class LimitedMemoryMng : public MemoryInterface {
+ public:
+  explicit LimitedMemoryMng(size_t capacity) : capacity_(capacity) {}
+
+  void* malloc(size_t nbytes) override {
+    if (used_ + nbytes > capacity_) return nullptr;
+    void* data = ::aligned_alloc(malloc_alignment(), nbytes);
+    sizes_[data] = nbytes;
+    used_ += nbytes;
+    return data;
+  }
+  void free(void* data) override {
+    used_ -= sizes_.at(data);
+    sizes_.erase(data);
+    ::free(data);
+  }
+  size_t malloc_alignment() const override { return 256; }
+
+ private:
+  size_t capacity_;
+  size_t used_{};
+  std::unordered_map<void*, size_t> sizes_;
+};
+
+}  // namespace
+
+TEST(CachingMemoryMng, round_size) {
+  ASSERT_EQ(CachingMemoryMng::RoundSize(1), 64);
+  ASSERT_EQ(CachingMemoryMng::RoundSize(64), 64);
+  ASSERT_EQ(CachingMemoryMng::RoundSize(65), 80);
+  ASSERT_EQ(CachingMemoryMng::RoundSize(128), 128);
+  ASSERT_EQ(CachingMemoryMng::RoundSize(1000), 1024);
+  ASSERT_EQ(CachingMemoryMng::RoundSize(1025), 1280);
+}
+
+TEST(CachingMemoryMng, reuse) {
+  auto* upstream = new HostMemoryMng;
+  CachingMemoryMng mng(upstream);
+
+  void* small = mng.malloc(1000);
+  void* large = mng.malloc(1 << 20);
+  auto stats  = mng.stats();
+  ASSERT_EQ(stats.bytes_in_use, 1024 + (1 << 20));
+  ASSERT_EQ(stats.bytes_requested, 1000 + (1 << 20));
+  ASSERT_GT(stats.fragmentation(), 0.);
+  mng.free(small);
+  mng.free(large);
+  ASSERT_EQ(mng.stats().bytes_in_use, 0);
+  ASSERT_EQ(mng.stats().bytes_cached, 1024 + (1 << 20));
+
+  // Served by the per-thread cache and by best fit from the shared pool.
+  ASSERT_EQ(mng.malloc(1010), small);
+  ASSERT_EQ(mng.malloc(900 * 1024), large);
+  ASSERT_EQ(upstream->num_allocs, 2);
+  stats = mng.stats();
+  ASSERT_EQ(stats.num_requests, 4);
+  ASSERT_EQ(stats.num_hits, 2);
+  ASSERT_EQ(stats.bytes_cached, 0);
+  ASSERT_DOUBLE_EQ(stats.hit_rate(), 0.5);
+
+  mng.free(small);
+  mng.free(large);
+  mng.ReleaseCached();
+  ASSERT_EQ(mng.stats().bytes_cached, 0);
+}
+
+TEST(CachingMemoryMng, alignment) {
+  CachingMemoryMng mng(new HostMemoryMng);
+  for (size_t alignment : {1, 32, 64, 128, 4096}) {
+    void* data = mng.aligned_alloc(alignment, 100);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % std::max<size_t>(alignment, 64), 0);
+    mng.free(data);
+    data = mng.aligned_alloc(alignment, 100);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data) % std::max<size_t>(alignment, 64), 0);
+    mng.free(data);
+  }
+}
+
+TEST(CachingMemoryMng, retry_out_of_memory) {
+  CachingMemoryMng mng(new LimitedMemoryMng(1 << 20));
+  void* small = mng.aligned_alloc(256, 600 * 1024);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(small) % 256, 0);
+  mng.free(small);
+  ASSERT_EQ(mng.stats().bytes_cached, 640 * 1024);
+
+  // The cached block is too small to reuse, and the upstream has no room for another, so the cache is released first.
+  void* large = mng.aligned_alloc(256, 800 * 1024);
+  ASSERT_TRUE(large);
+  ASSERT_EQ(mng.stats().bytes_cached, 0);
+  mng.free(large);
+}
+
+TEST(CachingMemoryMng, multi_thread) {
+  CachingMemoryMng mng(new HostMemoryMng);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&mng, t] {
+      std::vector<void*> blocks;
+      for (int i = 0; i < 1000; i++) {
+        blocks.push_back(mng.malloc(64 * (i % 16 + 1) + t));
+        if (blocks.size() == 8) {
+          for (void* data : blocks) mng.free(data);
+          blocks.clear();
+        }
+      }
+      for (void* data : blocks) mng.free(data);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto stats = mng.stats();
+  ASSERT_EQ(stats.bytes_in_use, 0);
+  ASSERT_EQ(stats.num_requests, 4000);
+  ASSERT_GT(stats.hit_rate(), 0.9);
+}
+
+TEST(CachingMemoryMng, buffer_resize) {
+  Buffer buffer(common::DefaultHostTarget());
+  buffer.Resize(4096);
+  void* data = buffer.data()->memory;
+  auto* mng  = dynamic_cast<CachingMemoryMng*>(MemoryManager::Global().Retrieve(common::Target::Arch::X86));
+  ASSERT_TRUE(mng);
+  auto num_hits = mng->stats().num_hits;
+  for (int i = 0; i < 10; i++) {
+    buffer.Resize(4096);
+    ASSERT_EQ(buffer.data()->memory, data);
+  }
+  ASSERT_EQ(mng->stats().num_hits, num_hits + 10);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+std::vector<std::vector<std::string>> GroupOps(const Graph& graph) {
+  std::vector<std::vector<std::string>> res;
+  for (auto& group : graph.FusionGroups()) {
+    res.emplace_back();
+    for (auto* node : group) res.back().push_back(node->op()->name);
+  }
+  return res;
+}
+
+}  // namespace
+
+TEST(OpFusion, epilogue) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  frontend::Variable bias("Bias");
+  Type t      = Float(32);
+  a->shape    = {32, 64};
+  b->shape    = {64, 16};
+  bias->shape = {16};
+  a->type     = t;
+  b->type     = t;
+  bias->type  = t;
+  auto c      = prog.mul(a, b);
+  auto d      = prog.elementwise_add(c, bias, 1);
+  auto e      = prog.relu(d);
+
+  auto graph = std::make_shared<Graph>(prog, common::DefaultHostTarget());
+  ApplyPasses(graph.get(), {"InferShape", "OpFusion"});
+
+  // The broadcast and elementwise ops fuse into the mul, the relu does not need to be adjacent to the add.
+  auto groups = GroupOps(*graph);
+  ASSERT_EQ(groups.size(), 1UL);
+  ASSERT_EQ(groups[0], (std::vector<std::string>{"mul", "elementwise_add", "relu"}));
+}
+
+TEST(OpFusion, no_cycle) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  a->shape = {32, 16};
+  a->type  = Float(32);
+  auto b   = prog.relu(a);
+  auto c   = prog.softmax(b, {});
+  auto d   = prog.add(b, c);
+
+  auto graph = std::make_shared<Graph>(prog, common::DefaultHostTarget());
+  ApplyPasses(graph.get(), {"InferShape", "OpFusion"});
+
+  // Fusing the add into the relu makes a cycle through the softmax.
+  auto groups = GroupOps(*graph);
+  ASSERT_EQ(groups.size(), 3UL);
+  ASSERT_EQ(groups[0], std::vector<std::string>{"relu"});
+  ASSERT_EQ(groups[1], std::vector<std::string>{"softmax"});
+  ASSERT_EQ(groups[2], std::vector<std::string>{"elementwise_add"});
+}
+
+TEST(OpFusion, multi_consumer) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {100, 32};
+  b->shape = {100, 32};
+  a->type  = t;
+  b->type  = t;
+  auto c   = prog.add(a, b);
+  auto d   = prog.relu(c);
+  auto e   = prog.add(c, b);
+  auto f   = prog.add(e, d);
+  auto g   = prog.relu(e);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPasses(graph.get(), {"InferShape", "OpFusion"});
+
+  // The consumers of c, d and e are all in the group, f and g are the outputs of the graph.
+  auto groups = GroupOps(*graph);
+  ASSERT_EQ(groups.size(), 1UL);
+  ASSERT_EQ(groups[0].size(), 5UL);
+
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+  ASSERT_EQ(program->size(), 1UL);
+
+  auto* a_ptr = scope->GetTensor("A")->mutable_data<float>(target);
+  auto* b_ptr = scope->GetTensor("B")->mutable_data<float>(target);
+  for (int i = 0; i < 100 * 32; i++) {
+    a_ptr[i] = (rand() * 2.f) / RAND_MAX - 1.f;  // NOLINT
+    b_ptr[i] = (rand() * 2.f) / RAND_MAX - 1.f;  // NOLINT
+  }
+
+  program->Execute();
+
+  auto* f_ptr = scope->GetTensor(f->id)->data<float>();
+  auto* g_ptr = scope->GetTensor(g->id)->data<float>();
+  for (int i = 0; i < 100 * 32; i++) {
+    float c_value = a_ptr[i] + b_ptr[i];
+    float e_value = c_value + b_ptr[i];
+    ASSERT_NEAR(f_ptr[i], e_value + std::max(c_value, 0.f), 1e-5);
+    ASSERT_NEAR(g_ptr[i], std::max(e_value, 0.f), 1e-5);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,150 @@
+#include "cinn/hlir/framework/program_profiler.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+//! The nearest-rank percentile \p p of the sorted \p values.
+double Percentile(const std::vector<float>& values, double p) {
+  if (values.empty()) return 0;
+  int rank = std::max<int>(1, std::ceil(p * values.size()));
+  return values[rank - 1];
+}
+
+void SyncDevice(const Instruction& instr) {
+#ifdef CINN_WITH_CUDA
+  if (instr.target_.arch == Target::Arch::NVGPU) {
+    CUDA_CALL(cudaDeviceSynchronize());
+  }
+#endif
+}
+
+}  // namespace
+
+void ProgramProfiler::Run(const std::vector<std::unique_ptr<Instruction>>& instrs) {
+  if (warmup_ > 0) {
+    warmup_--;
+    for (auto& instr : instrs) instr->Run();
+    if (!instrs.empty()) SyncDevice(*instrs.back());
+    return;
+  }
+
+  if (latencies_.size() != instrs.size()) {
+    for (auto& instr : instrs) {
+      names_.push_back(instr->function_name());
+      flops_.push_back(instr->flops);
+      bytes_.push_back(instr->bytes);
+    }
+    latencies_.resize(instrs.size());
+  }
+  for (int i = 0; i < instrs.size(); i++) {
+    int64_t start = SteadyNowNs();
+    instrs[i]->Run();
+    // The kernels on GPU are asynchronous, wait for each to finish.
+    SyncDevice(*instrs[i]);
+    double dur_us   = (SteadyNowNs() - start) / 1e3;
+    auto& latencies = latencies_[i];
+    latencies.count++;
+    latencies.sum_us += dur_us;
+    latencies.max_us = std::max(latencies.max_us, dur_us);
+    // Each of the latencies so far is kept with the same probability max_samples_ / count.
+    if (latencies.samples.size() < max_samples_) {
+      latencies.samples.push_back(dur_us);
+    } else {
+      auto slot = std::uniform_int_distribution<int64_t>(0, latencies.count - 1)(rng_);
+      if (slot < max_samples_) latencies.samples[slot] = dur_us;
+    }
+    if (trace_.size() < kMaxTraceEvents) trace_.push_back({i, start / 1000, dur_us});
+  }
+  num_runs_++;
+}
+
+std::vector<ProgramProfiler::InstructionStats> ProgramProfiler::GetStats() const {
+  std::vector<InstructionStats> res;
+  for (int i = 0; i < latencies_.size(); i++) {
+    auto& latencies = latencies_[i];
+    auto sorted     = latencies.samples;
+    std::sort(sorted.begin(), sorted.end());
+    InstructionStats stats;
+    stats.index       = i;
+    stats.name        = names_[i];
+    stats.count       = latencies.count;
+    stats.num_samples = sorted.size();
+    if (latencies.count > 0) {
+      stats.mean_us = latencies.sum_us / latencies.count;
+      stats.max_us  = latencies.max_us;
+    }
+    stats.p50_us = Percentile(sorted, 0.5);
+    stats.p90_us = Percentile(sorted, 0.9);
+    stats.p99_us = Percentile(sorted, 0.99);
+    stats.flops  = flops_[i];
+    stats.bytes  = bytes_[i];
+    res.push_back(stats);
+  }
+  return res;
+}
+
+std::string ProgramProfiler::Summary() const {
+  auto stats = GetStats();
+  double total_us = 0;
+  for (auto& s : stats) total_us += s.mean_us * s.count;
+  std::sort(stats.begin(), stats.end(), [](auto& a, auto& b) { return a.mean_us * a.count > b.mean_us * b.count; });
+
+  std::stringstream ss;
+  ss << "Profiled " << num_runs_ << " runs of " << stats.size() << " instructions, " << std::fixed
+     << std::setprecision(3) << (num_runs_ > 0 ? total_us / num_runs_ / 1e3 : 0.) << " ms per run\n";
+  ss << std::right << std::setw(5) << "#" << "  " << std::left << std::setw(28) << "Instruction" << std::right
+     << std::setw(8) << "Calls" << std::setw(8) << "%" << std::setw(12) << "Mean(us)" << std::setw(12) << "P50(us)"
+     << std::setw(12) << "P90(us)" << std::setw(12) << "P99(us)" << std::setw(12) << "Max(us)" << std::setw(10)
+     << "GFLOP/s" << std::setw(10) << "GB/s" << std::setw(10) << "FLOP/B"
+     << "\n";
+  ss << std::setprecision(2);
+  for (auto& s : stats) {
+    double share = total_us > 0 ? 100. * s.mean_us * s.count / total_us : 0.;
+    ss << std::right << std::setw(5) << s.index << "  " << std::left << std::setw(28) << s.name << std::right
+       << std::setw(8) << s.count << std::setw(8) << share << std::setw(12) << s.mean_us << std::setw(12) << s.p50_us
+       << std::setw(12) << s.p90_us << std::setw(12) << s.p99_us << std::setw(12) << s.max_us << std::setw(10)
+       << s.gflops_per_sec() << std::setw(10) << s.gbytes_per_sec() << std::setw(10)
+       << (s.bytes > 0 ? s.flops / s.bytes : 0.) << "\n";
+  }
+  return ss.str();
+}
+
+std::string ProgramProfiler::ToChromeTrace() const {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (int i = 0; i < trace_.size(); i++) {
+    auto& e = trace_[i];
+    if (i > 0) ss << ",";
+    ss << "\n{\"name\":\"" << names_[e.index] << "\",\"cat\":\"instruction\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":"
+       << e.start_us << ",\"dur\":" << e.dur_us << ",\"args\":{\"index\":" << e.index
+       << ",\"flops\":" << flops_[e.index] << ",\"bytes\":" << bytes_[e.index] << "}}";
+  }
+  ss << "\n]}\n";
+  return ss.str();
+}
+
+void ProgramProfiler::SaveChromeTrace(const std::string& path) const {
+  std::ofstream file(path);
+  CHECK(file) << "Failed to open " << path;
+  file << ToChromeTrace();
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/instruction.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * ProgramProfiler runs the instructions of a Program and records the latency of each run of each instruction, see
+ * Program::EnableProfiling. The instructions run one by one, so that their latencies do not interfere.
+ *
+ * The count, the mean and the max cover all the runs, while the percentiles are estimated from a uniform sample of at
+ * most max_samples latencies of each instruction, so that the memory is bounded however long the profiling lasts.
+ */
+class ProgramProfiler {
+ public:
+  struct InstructionStats {
+    int index{};
+    std::string name;
+    //! The number of the runs recorded, and the number of them sampled for the percentiles.
+    int64_t count{};
+    int64_t num_samples{};
+    double mean_us{};
+    double p50_us{};
+    double p90_us{};
+    double p99_us{};
+    double max_us{};
+    //! The estimated floating point operations and bytes moved by a run.
+    double flops{};
+    double bytes{};
+
+    double gflops_per_sec() const { return mean_us > 0 ? flops / mean_us / 1e3 : 0; }
+    double gbytes_per_sec() const { return mean_us > 0 ? bytes / mean_us / 1e3 : 0; }
+  };
+
+  /**
+   * @param warmup The number of the runs of the program to skip before recording.
+   * @param max_samples The number of the latencies of each instruction to keep for the percentiles.
+   */
+  explicit ProgramProfiler(int warmup, int max_samples = kMaxSamples) : warmup_(warmup), max_samples_(max_samples) {}
+
+  //! Run \p instrs once, recording the latencies if the warmup is over.
+  void Run(const std::vector<std::unique_ptr<Instruction>>& instrs);
+
+  //! The number of the runs of the program recorded.
+  int num_runs() const { return num_runs_; }
+
+  //! The statistics of the instructions in the order of the program.
+  std::vector<InstructionStats> GetStats() const;
+
+  //! A table of the instructions by their total time, with their achieved GFLOP/s and GB/s.
+  std::string Summary() const;
+
+  //! The runs recorded in the Trace Event Format, at most the first kMaxTraceEvents of them.
+  std::string ToChromeTrace() const;
+  void SaveChromeTrace(const std::string& path) const;
+
+  static constexpr int kMaxTraceEvents = 1 << 20;
+  static constexpr int kMaxSamples     = 1 << 16;
+
+ private:
+  struct TraceEvent {
+    int index;
+    int64_t start_us;
+    double dur_us;
+  };
+
+  //! The latencies of an instruction in microseconds.
+  struct Latencies {
+    int64_t count{};
+    double sum_us{};
+    double max_us{};
+    //! A reservoir sample of the latencies, see Run.
+    std::vector<float> samples;
+  };
+
+  int warmup_{};
+  int max_samples_{};
+  int num_runs_{};
+  std::vector<std::string> names_;
+  std::vector<double> flops_;
+  std::vector<double> bytes_;
+  //! The latencies by the index of the instruction.
+  std::vector<Latencies> latencies_;
+  std::mt19937_64 rng_;
+  std::vector<TraceEvent> trace_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,79 @@
+#include "cinn/hlir/framework/program_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(ProgramProfiler, matmul_relu) {
+  frontend::Program prog;
+  frontend::Variable a("A");
+  frontend::Variable b("B");
+  Type t   = Float(32);
+  a->shape = {64, 128};
+  b->shape = {128, 32};
+  a->type  = t;
+  b->type  = t;
+  frontend::Instruction matmul("matmul", {a, b});
+  prog.AppendInstruction(matmul);
+  auto c = prog.relu(matmul.GetOutput(0));
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPasses(graph.get(), {"InferShape"});
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+  ASSERT_EQ(program->profiler(), nullptr);
+
+  program->EnableProfiling(2);
+  for (int i = 0; i < 5; i++) program->Execute();
+  auto* profiler = program->profiler();
+  ASSERT_NE(profiler, nullptr);
+  ASSERT_EQ(profiler->num_runs(), 3);
+
+  auto stats = profiler->GetStats();
+  ASSERT_EQ(stats.size(), 2UL);
+  ASSERT_EQ(stats[0].count, 3);
+  ASSERT_GT(stats[0].mean_us, 0);
+  ASSERT_LE(stats[0].p50_us, stats[0].p99_us);
+  ASSERT_LE(stats[0].p99_us, stats[0].max_us);
+  // A multiply-add per element of the reduction, and the arguments read or written once, the matmul on X86 writes a
+  // packed copy of B besides.
+  ASSERT_DOUBLE_EQ(stats[0].flops, 2. * 64 * 32 * 128);
+  ASSERT_GE(stats[0].bytes, 4. * (64 * 128 + 128 * 32 + 64 * 32));
+  ASSERT_DOUBLE_EQ(stats[1].flops, 64. * 32);
+  ASSERT_DOUBLE_EQ(stats[1].bytes, 4. * 2 * 64 * 32);
+  ASSERT_GT(stats[0].gflops_per_sec(), 0);
+
+  auto summary = profiler->Summary();
+  LOG(INFO) << "The summary:\n" << summary;
+  ASSERT_NE(summary.find("matmul"), std::string::npos);
+  auto trace = profiler->ToChromeTrace();
+  ASSERT_NE(trace.find("\"name\":\"relu\""), std::string::npos);
+
+  // The percentiles of the long profiling are estimated from a bounded sample of the runs.
+  program->EnableProfiling(0, 4);
+  for (int i = 0; i < 10; i++) program->Execute();
+  stats = program->profiler()->GetStats();
+  ASSERT_EQ(stats[0].count, 10);
+  ASSERT_EQ(stats[0].num_samples, 4);
+  ASSERT_LE(stats[0].p99_us, stats[0].max_us);
+
+  program->DisableProfiling();
+  program->Execute();
+  ASSERT_EQ(program->profiler(), nullptr);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
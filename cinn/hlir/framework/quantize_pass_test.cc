@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <any>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/graph_test_helper.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+std::vector<float> RandomData(int num_elements) {
+  std::vector<float> data(num_elements);
+  for (auto& x : data) x = Random();
+  return data;
+}
+
+void SetData(Scope* scope, const std::string& name, const std::vector<float>& data) {
+  auto tensor = scope->GetTensor(name);
+  ASSERT_EQ(tensor->shape().numel(), data.size());
+  std::copy(data.begin(), data.end(), tensor->mutable_data<float>(common::DefaultHostTarget()));
+}
+
+/**
+ * Run \p prog on the host with the input "A" of \p input and the parameters of \p params, the ops quantized to int8
+ * over the calibration on \p input if \p quantize is set. Returns the output \p out_id, and the number of the ops
+ * compiled in \p num_ops.
+ */
+std::vector<float> Run(const frontend::Program& prog,
+                       const std::unordered_map<std::string, std::vector<float>>& params,
+                       const std::vector<float>& input,
+                       const std::string& out_id,
+                       bool quantize,
+                       int* num_ops) {
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  ApplyPass(graph.get(), "ConvEpilogueFusion");
+
+  auto& shape_dict = graph->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto scope       = std::make_shared<Scope>();
+  for (auto& [name, data] : params) {
+    auto& tensor = std::get<Tensor>(*scope->Var<Tensor>(name));
+    tensor->Resize(Shape{shape_dict.at(name)});
+    SetData(scope.get(), name, data);
+  }
+  if (quantize) {
+    int num_samples             = 0;
+    graph->attrs["param_scope"] = std::make_shared<std::any>(scope);
+    graph->attrs["calibration_feed"] =
+        std::make_shared<std::any>(std::function<bool(Scope*)>([&](Scope* calibration_scope) {
+          if (num_samples++ > 0) return false;
+          SetData(calibration_scope, "A", input);
+          return true;
+        }));
+    ApplyPass(graph.get(), "Calibrate");
+    ApplyPass(graph.get(), "Quantize");
+  }
+  *num_ops = NumOps(graph.get());
+
+  BuildScope(target, graph, scope);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+  SetData(scope.get(), "A", input);
+  program->Execute();
+  auto out = scope->GetTensor(out_id);
+  return std::vector<float>(out->data<float>(), out->data<float>() + out->shape().numel());
+}
+
+//! The int8 error of \p actual to \p expected is within \p tolerance of the largest magnitude of \p expected.
+void ExpectClose(const std::vector<float>& expected, const std::vector<float>& actual, float tolerance) {
+  ASSERT_EQ(expected.size(), actual.size());
+  float abs_max = 0.f;
+  for (float x : expected) abs_max = std::max(abs_max, std::abs(x));
+  ASSERT_GT(abs_max, 0.f);
+  for (int i = 0; i < expected.size(); i++) ASSERT_NEAR(expected[i], actual[i], tolerance * abs_max) << "at " << i;
+}
+
+}  // namespace
+
+TEST(Quantize, quantize_dequantize) {
+  const int n       = 1024;
+  const float scale = 1.f / 127;
+  frontend::Program prog;
+  auto quantized = prog.quantize(MakeVariable("A", {n}), scale);
+  auto out       = prog.dequantize(quantized, scale);
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<Graph>(prog, target);
+  ApplyPass(graph.get(), "InferShape");
+  auto& dtype_dict = graph->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  ASSERT_EQ(dtype_dict.at(quantized->id), Int(8));
+  ASSERT_EQ(dtype_dict.at(out->id), Float(32));
+
+  auto scope = BuildScope(target, graph);
+  GraphCompiler gc(target, scope, graph);
+  auto program = gc.Build();
+  auto input   = RandomData(n);
+  SetData(scope.get(), "A", input);
+  program->Execute();
+
+  auto* q_ptr   = scope->GetTensor(quantized->id)->data<int8_t>();
+  auto* out_ptr = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(static_cast<int>(std::round(input[i] * (1.f / scale))), q_ptr[i]);
+    ASSERT_NEAR(input[i], out_ptr[i], scale / 2 + 1e-6f);
+  }
+}
+
+TEST(Quantize, mul) {
+  const int m = 4, k = 64, n = 32;
+  frontend::Program prog;
+  auto out = prog.mul(MakeVariable("A", {m, k}), MakeVariable("W", {n, k}), 1, 1);
+  std::unordered_map<std::string, std::vector<float>> params{{"W", RandomData(n * k)}};
+  auto input = RandomData(m * k);
+
+  int num_ops;
+  auto expected = Run(prog, params, input, out->id, false, &num_ops);
+  auto actual   = Run(prog, params, input, out->id, true, &num_ops);
+  // The quantize of A, the int8 mul and the dequantize of its int32 output.
+  ASSERT_EQ(num_ops, 3);
+  ExpectClose(expected, actual, 0.02f);
+}
+
+TEST(Quantize, conv2d_requantize) {
+  const int c = 8, h = 16, w = 16;
+  frontend::Program prog;
+  std::unordered_map<std::string, frontend::Program::attr_t> attrs;
+  attrs["stride"]   = std::vector<int>({1, 1});
+  attrs["dilation"] = std::vector<int>({1, 1});
+  attrs["padding"]  = std::vector<int>({1, 1});
+  auto conv         = prog.conv2d(MakeVariable("A", {1, c, h, w}), MakeVariable("W0", {2 * c, c, 3, 3}), attrs);
+  auto relu         = prog.relu(conv);
+  auto out          = prog.conv2d(relu, MakeVariable("W1", {c, 2 * c, 3, 3}), attrs);
+  std::unordered_map<std::string, std::vector<float>> params{{"W0", RandomData(2 * c * c * 9)},
+                                                             {"W1", RandomData(2 * c * c * 9)}};
+  auto input = RandomData(c * h * w);
+
+  int num_ops;
+  auto expected = Run(prog, params, input, out->id, false, &num_ops);
+  auto actual   = Run(prog, params, input, out->id, true, &num_ops);
+  // The quantize of A and the two convs, the first one requantizes its output after the relu for the second one.
+  ASSERT_EQ(num_ops, 3);
+  ExpectClose(expected, actual, 0.02f);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -47,14 +47,29 @@ class _Tensor_ : public Object {
 
   template <typename T>
   inline T* mutable_data(const Target& target) {
-    set_type(type_of<T>());
+    return reinterpret_cast<T*>(mutable_data(target, type_of<T>()));
+  }
+
+  //! The memory of the elements of \p type, which is only known at runtime, e.g. from the dtype of a graph.
+  void* mutable_data(const Target& target, const Type& type) {
+    set_type(type);
     if (target == common::DefaultHostTarget()) {
-      int alignment = type_of<T>().ElementOf().bits();
-      buffer_->ResizeLazy(alignment, shape_.numel() * sizeof(T), target);
+      int alignment = type.ElementOf().bits();
+      buffer_->ResizeLazy(alignment, shape_.numel() * type.bytes(), target);
     } else {
-      buffer_->ResizeLazy(shape_.numel() * sizeof(T), target);
+      buffer_->ResizeLazy(shape_.numel() * type.bytes(), target);
     }
-    return reinterpret_cast<T*>(buffer_->data()->memory);
+    return buffer_->data()->memory;
+  }
+
+  //! Take \p nbytes at \p offset of \p slab as the memory instead of allocating it in mutable_data.
+  void ShareMemory(const std::shared_ptr<Buffer>& slab, uint32_t offset, uint32_t nbytes) {
+    buffer_->ShareMemory(slab, offset, nbytes);
+  }
+
+  //! Take the \p nbytes of host memory at \p memory, kept alive by \p owner, as the memory of the tensor.
+  void ShareMemory(std::shared_ptr<void> owner, void* memory, uint32_t nbytes) {
+    buffer_->ShareMemory(std::move(owner), memory, nbytes);
   }
 
   template <typename T>
@@ -68,6 +83,8 @@ class _Tensor_ : public Object {
   const Type& type() const { return type_; }
 
   cinn_buffer_t* buffer() { return buffer_->data(); }
+  //! The buffer holding the memory, to share the memory with others.
+  const std::shared_ptr<Buffer>& shared_buffer() const { return buffer_; }
 
   const char* type_info() const override { return __type_info__; }
 
@@ -52,7 +52,7 @@ std::shared_ptr<OpStrategy> StrategyForBroadcast(
     for (auto &iter : attrs.attr_store) {
       if (iter.first == "axis") {
         axis = Expr(std::get<int>(iter.second));
-      } else if (iter.first != "FuseNumber") {
+      } else {
         LOG(ERROR) << "unsupported attr_store: " << iter.first << std::endl;
       }
     }
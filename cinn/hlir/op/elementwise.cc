@@ -129,6 +129,31 @@ StrategyForUnary(bitwise_not, BitwiseNot);
 
 #undef StrategyForUnary
 
+//! The type of the attribute "dtype" of a cast, the name of it in the frontend, e.g. "bfloat16".
+Type GetCastType(const framework::NodeAttr &attrs) {
+  CHECK(attrs.attr_store.count("dtype")) << "The attribute dtype of cast is not set! Please check.";
+  return common::Str2Type(std::get<std::string>(attrs.attr_store.at("dtype")));
+}
+
+std::shared_ptr<OpStrategy> StrategyForCast(const framework::NodeAttr &attrs,
+                                            const std::vector<ir::Tensor> &inputs,
+                                            const std::vector<Type> &out_type,
+                                            const std::vector<std::vector<int>> &output_shapes,
+                                            const Target &target) {
+  Type type = GetCastType(attrs);
+  return StrategyForElementwise(
+      attrs, inputs, out_type, output_shapes, target, "cast", [=](const ir::Tensor &A, const std::string &out_name) {
+        return pe::Cast(A, type, out_name);
+      });
+}
+
+std::vector<Type> InferDtypeForCast(const std::vector<Type> &inputs_type,
+                                    const framework::NodeAttr &attrs,
+                                    const Target &target) {
+  CHECK_EQ(inputs_type.size(), 1UL) << "The input's type size is not 1! Please check again.";
+  return {GetCastType(attrs)};
+}
+
 }  // namespace op
 }  // namespace hlir
 }  // namespace cinn
@@ -174,5 +199,15 @@ CINN_REGISTER_HELPER(elementwise_ops) {
   CINN_REGISTER_UNARY(bitwise_not, BitwiseNot)
 #undef CINN_REGISTER_UNARY
 
+  CINN_REGISTER_OP(cast)
+      .describe("Cast the elements to the type of the attribute dtype, e.g. float32 or bfloat16.")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCast)
+      .set_attr("infershape", std::function(cinn::hlir::op::InferShapeForElementwise))
+      .set_attr("inferdtype", std::function(cinn::hlir::op::InferDtypeForCast))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
   return true;
 }
@@ -19,6 +19,61 @@ using framework::OpStrategy;
 using framework::shape_t;
 using framework::StrategyFunction;
 
+namespace {
+
+/**
+ * Whether a batchnorm or an activation is fused into the conv of \p attrs, see the ConvEpilogueFusion pass, or the
+ * conv is quantized, see the Quantize pass.
+ */
+bool HasConvEpilogue(const framework::NodeAttr &attrs) {
+  auto &attr_store = attrs.attr_store;
+  return attr_store.count("epilogue_batchnorm") || attr_store.count("epilogue_activation") ||
+         attr_store.count("epilogue_dequantize") || attr_store.count("epilogue_requantize_scale");
+}
+
+//! Whether the int32 sums of the int8 conv of \p attrs are dequantized by the scales of its last input.
+bool HasDequantize(const framework::NodeAttr &attrs) {
+  auto &attr_store = attrs.attr_store;
+  return attr_store.count("epilogue_dequantize") && std::get<bool>(attr_store.at("epilogue_dequantize"));
+}
+
+/**
+ * The epilogue fused into the conv of \p attrs by the ConvEpilogueFusion pass, the scale, bias, mean and variance of
+ * the batchnorm follow the input and the weights in \p inputs. The scales to dequantize an int8 conv by are the last
+ * input, and the scale to requantize the output by is the attr "epilogue_requantize_scale", see the Quantize pass.
+ */
+pe::ConvEpilogue GetConvEpilogue(const framework::NodeAttr &attrs, const CINNValuePack &inputs) {
+  pe::ConvEpilogue epilogue;
+  auto &attr_store = attrs.attr_store;
+  if (HasDequantize(attrs)) {
+    Expr scales                = inputs[inputs.size() - 1];
+    epilogue.dequantize_scales = scales.as_tensor_ref();
+  }
+  if (attr_store.count("epilogue_requantize_scale")) {
+    epilogue.requantize_scale = std::get<float>(attr_store.at("epilogue_requantize_scale"));
+  }
+  if (attr_store.count("epilogue_batchnorm") && std::get<bool>(attr_store.at("epilogue_batchnorm"))) {
+    CHECK_EQ(inputs.size(), HasDequantize(attrs) ? 7U : 6U) << "The batchnorm fused into a conv should have 4 params";
+    Expr scale        = inputs[2];
+    Expr bias         = inputs[3];
+    Expr mean         = inputs[4];
+    Expr variance     = inputs[5];
+    epilogue.scale    = scale.as_tensor_ref();
+    epilogue.bias     = bias.as_tensor_ref();
+    epilogue.mean     = mean.as_tensor_ref();
+    epilogue.variance = variance.as_tensor_ref();
+    if (attr_store.count("epilogue_epsilon")) {
+      epilogue.epsilon = std::get<float>(attr_store.at("epilogue_epsilon"));
+    }
+  }
+  if (attr_store.count("epilogue_activation")) {
+    epilogue.activation = std::get<std::string>(attr_store.at("epilogue_activation"));
+  }
+  return epilogue;
+}
+
+}  // namespace
+
 std::shared_ptr<OpStrategy> StrategyForRelu(const framework::NodeAttr &attrs,
                                             const std::vector<ir::Tensor> &inputs,
                                             const std::vector<Type> &out_type,
@@ -55,10 +110,10 @@ std::shared_ptr<OpStrategy> StrategyForRelu(const framework::NodeAttr &attrs,
 
   auto strategy = std::make_shared<framework::OpStrategy>();
   CHECK(out_type.size()) << "Out_type of relu op is empty! Please check.";
-  if (out_type[0] == Float(32)) {
+  if (out_type[0] == Float(32) || out_type[0].is_reduced_float()) {
     strategy->AddImpl(relu_compute, relu_schedule, "strategy.relu.x86", 1);
   } else {
-    LOG(FATAL) << "Relu op with dtype != float32 is not implemented yet!";
+    LOG(FATAL) << "Relu op with dtype " << out_type[0] << " is not implemented yet!";
   }
   return strategy;
 }
@@ -115,10 +170,10 @@ std::shared_ptr<OpStrategy> StrategyForRelu6(const framework::NodeAttr &attrs,
 
   auto strategy = std::make_shared<framework::OpStrategy>();
   CHECK(out_type.size()) << "Out_type of relu6 op is empty! Please check.";
-  if (out_type[0] == Float(32)) {
+  if (out_type[0] == Float(32) || out_type[0].is_reduced_float()) {
     strategy->AddImpl(relu_compute, relu_schedule, "strategy.relu6.x86", 1);
   } else {
-    LOG(FATAL) << "Relu6 op with dtype != float32 is not implemented yet!";
+    LOG(FATAL) << "Relu6 op with dtype " << out_type[0] << " is not implemented yet!";
   }
   return strategy;
 }
@@ -148,6 +203,8 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
   if (attrs.attr_store.find("groups") != attrs.attr_store.end()) {
     groups = std::get<int>(attrs.attr_store.at("groups"));
   }
+  // On X86 the epilogue is applied on unpacking the NCHWc output, on GPU it stores the output computed locally.
+  bool gpu_epilogue = HasConvEpilogue(attrs) && target.arch == Target::Arch::NVGPU;
   framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of conv2d compute is empty! Please check.\n";
     CINNValuePack a = args[0];
@@ -164,7 +221,12 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
 #ifdef CINN_WITH_MKLDNN
     use_mkldnn = true;
 #endif
-    use_mkldnn = use_mkldnn && target.arch == Target::Arch::X86;
+    use_mkldnn    = use_mkldnn && target.arch == Target::Arch::X86;
+    auto epilogue = GetConvEpilogue(attrs, a);
+    CHECK(epilogue.empty() || (data_format == "NCHW" && groups == 1))
+        << "Only the NCHW conv2d with no groups can be fused with an epilogue";
+    CHECK(A.as_tensor()->type() == Float(32) || (data_format == "NCHW" && groups == 1))
+        << "Only the NCHW conv2d with no groups supports the reduced floats and int8";
     if (data_format == "NCHW") {
       // A is input: [N, C, H, W], B is filter: [C_out, C_in/group, filter_h, filter_w]
       if (target.arch == Target::Arch::X86) {
@@ -178,7 +240,8 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
                                    dilation[0],
                                    dilation[1],
                                    UniqName("Conv2d_nchw_5d_out"),
-                                   target);
+                                   target,
+                                   epilogue);
         } else {
           out = pe::Conv2d_NCHW_MKLDNN(A.as_tensor_ref(),
                                        B.as_tensor_ref(),
@@ -200,6 +263,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
                               dilation[0],
                               dilation[1],
                               UniqName("Conv2d_nhwc_out"));
+        if (!epilogue.empty()) out.push_back(epilogue.Apply(out.back(), UniqName("Conv2d_epilogue_out")));
       }
     } else if (data_format == "NHWC") {
       // A is input: [N, H, W, C], B is filter: [C_out, C_in/group, filter_h, filter_w]
@@ -234,7 +298,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
     CINNValuePack arg_pack = args[0];
     CHECK(arg_pack.size() == 4UL || arg_pack.size() == 3UL || arg_pack.size() == 6UL);
     poly::StageMap stages = arg_pack.back();
-    if (arg_pack.size() == 4UL) {
+    if (arg_pack.size() == 4UL && !gpu_epilogue) {
       Expr input_pad = arg_pack[0];
       CHECK(input_pad.as_tensor());
       stages[input_pad.as_tensor_ref()]->ComputeInline();
@@ -248,7 +312,13 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
       ir::Tensor out_t   = Out.as_tensor_ref();
       ir::Tensor input_t = input_pad.as_tensor_ref();
       CHECK(Out.as_tensor());
-      pe::CudaScheduleConv(stages, input_t, out_t, target);
+      ir::Tensor epilogue_t;
+      if (gpu_epilogue) {
+        Expr epilogue = arg_pack[2];
+        CHECK(epilogue.as_tensor());
+        epilogue_t = epilogue.as_tensor_ref();
+      }
+      pe::CudaScheduleConv(stages, input_t, out_t, target, epilogue_t);
       arg_pack[1] = Expr(out_t);
       arg_pack[0] = Expr(input_t);
     } else if (target.arch == Target::Arch::X86) {
@@ -302,10 +372,12 @@ std::shared_ptr<OpStrategy> StrategyForConv2d(const framework::NodeAttr &attrs,
 
   auto strategy = std::make_shared<framework::OpStrategy>();
   CHECK(out_type.size()) << "Out_type of conv2d op is empty! Please check.";
-  if (out_type[0] == Float(32)) {
+  // The reduced floats and int8 are computed by Conv2d_NCHW_5D on X86 only.
+  Type in_type = inputs.empty() ? out_type[0] : inputs[0]->type();
+  if (in_type == Float(32) || ((in_type.is_reduced_float() || in_type.is_int(8)) && target.arch == Target::Arch::X86)) {
     strategy->AddImpl(conv2d_compute, conv2d_schedule, "strategy.conv2d.x86", 1);
   } else {
-    LOG(FATAL) << "Conv2d op with dtype != float32 is not implemented yet!";
+    LOG(FATAL) << "Conv2d op with dtype " << in_type << " is not implemented yet!";
   }
   return strategy;
 }
@@ -382,7 +454,16 @@ std::vector<Type> InferDtypeForConv2d(const std::vector<Type> &inputs_type,
                                       const framework::NodeAttr &attrs,
                                       const Target &target) {
   CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
-  std::vector<Type> res{inputs_type[0], inputs_type[0], inputs_type[0], inputs_type[0]};
+  // The packed output of the reduced floats is accumulated in float32 by Conv2d_NCHW_5D, and the one of int8 in int32,
+  // which is output unless it is dequantized to float32 or requantized to int8 by the epilogue.
+  Type acc_type = pe::AccumulationType(inputs_type[0]);
+  Type out_type = inputs_type[0].is_int(8) ? acc_type : inputs_type[0];
+  if (attrs.attr_store.count("epilogue_requantize_scale")) {
+    out_type = Int(8);
+  } else if (HasDequantize(attrs)) {
+    out_type = Float(32);
+  }
+  std::vector<Type> res{out_type, acc_type, inputs_type[0], inputs_type[0]};
   return res;
 }
 
@@ -412,6 +493,7 @@ std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &at
     groups = std::get<int>(attrs.attr_store.at("groups"));
   }
   CHECK(data_format == "NCHWc") << "conv2d_NCHWc op's data_format should be NCHWc";
+  bool fuse_epilogue = HasConvEpilogue(attrs);
   framework::CINNCompute conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of conv2d_NCHWc compute is empty! Please check.\n";
     CINNValuePack a = args[0];
@@ -442,10 +524,14 @@ std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &at
                            UniqName("T_conv2d_NCHWc_out"),
                            target);
 
+    CHECK(out.size() == 2U) << "The output tensor sizes of conv2d_NCHWc op should be 2\n";
+    // The epilogue follows the outputs, and is stored in place of the packed_out, see Conv2d_NCHWc_Schedule_CPU_Nofuse.
+    auto epilogue = GetConvEpilogue(attrs, a);
+    if (!epilogue.empty()) out.push_back(epilogue.Apply(out[0], UniqName("T_conv2d_NCHWc_epilogue_out")));
+
     auto stages = CreateStages({tensor_a, tensor_b});
 
     std::vector<CINNValue> res;
-    CHECK(out.size() == 2U) << "The output tensor sizes of conv2d_NCHWc op should be 2\n";
     for (auto &t : out) {
       stages->InsertLazily(t);
       res.push_back(CINNValue(t));
@@ -457,12 +543,18 @@ std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &at
   framework::CINNSchedule conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of conv2d_NCHWc schedule is empty! Please check.\n";
     CINNValuePack arg_pack = args[0];
-    CHECK_EQ(arg_pack.size(), 3UL);
+    CHECK_EQ(arg_pack.size(), fuse_epilogue ? 4UL : 3UL);
     poly::StageMap stages = arg_pack.back();
     Expr packed_out       = arg_pack[0];
     Expr input_pad        = arg_pack[1];
     CHECK(packed_out.as_tensor());
     CHECK(input_pad.as_tensor());
+    ir::Tensor epilogue;
+    if (fuse_epilogue) {
+      Expr epilogue_expr = arg_pack[2];
+      CHECK(epilogue_expr.as_tensor());
+      epilogue = epilogue_expr.as_tensor_ref();
+    }
     std::vector<Expr> kernel_shape = inputs[1]->shape;
     // kernel_h == 1 && kernel_w == 1
     CHECK_EQ(kernel_shape.size(), 6U) << "kernel_dialtion shape size should be 6";
@@ -475,10 +567,10 @@ std::shared_ptr<OpStrategy> StrategyForConv2dNCHWc(const framework::NodeAttr &at
     ir::Tensor packed_out_tensor = packed_out.as_tensor_ref();
     if (is_1x1) {
       pe::Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse(
-          stages, res, packed_out_tensor, input_pad.as_tensor_ref(), weights, data, target);
+          stages, res, packed_out_tensor, input_pad.as_tensor_ref(), weights, data, target, epilogue);
     } else {
       pe::Conv2d_NCHWc_Schedule_CPU_Nofuse(
-          stages, res, packed_out_tensor, input_pad.as_tensor_ref(), weights, data, target);
+          stages, res, packed_out_tensor, input_pad.as_tensor_ref(), weights, data, target, epilogue);
     }
     *ret = CINNValuePack{{CINNValue(packed_out_tensor), arg_pack[1], CINNValue(stages)}};
   });
@@ -572,6 +664,7 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
   if (attrs.attr_store.find("data_format") != attrs.attr_store.end()) {
     data_format = std::get<std::string>(attrs.attr_store.at("data_format"));
   }
+  bool fuse_epilogue = HasConvEpilogue(attrs);
 
   framework::CINNCompute depthwise_conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of depthwise_conv compute is empty! Please check.\n";
@@ -604,6 +697,14 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
     } else {
       LOG(FATAL) << "Only support NCHW and NHWC data layout\n";
     }
+    CHECK(out.size() == 2U || out.size() == 1U)
+        << "The output tensor sizes of depthwise_conv op in depthwise_conv op should be 1 or 2\n";
+    // The epilogue follows the outputs, and is stored in place of the conv.
+    auto epilogue = GetConvEpilogue(attrs, a);
+    if (!epilogue.empty()) {
+      CHECK(data_format == "NCHW") << "Only the NCHW depthwise_conv can be fused with an epilogue";
+      out.push_back(epilogue.Apply(out.back(), UniqName("T_depthwise_conv2d_epilogue_out")));
+    }
 
     auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref()});
     std::vector<CINNValue> res;
@@ -611,8 +712,6 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
       stages->InsertLazily(t);
       res.push_back(CINNValue(t));
     }
-    CHECK(out.size() == 2U || out.size() == 1U)
-        << "The output tensor sizes of depthwise_conv op in depthwise_conv op should be 1 or 2\n";
     res.push_back(CINNValue(stages));
     *ret = CINNValuePack{res};
   });
@@ -620,11 +719,12 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
   framework::CINNSchedule depthwise_conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input argument of depthwise_conv schedule is empty! Please check.\n";
     CINNValuePack arg_pack = args[0];
-    CHECK(arg_pack.size() == 2UL || arg_pack.size() == 3UL);
+    int num_tensors = arg_pack.size() - (fuse_epilogue ? 2 : 1);
+    CHECK(num_tensors == 1 || num_tensors == 2);
     poly::StageMap stages = arg_pack[arg_pack.size() - 1];
-    Expr Out              = arg_pack[arg_pack.size() - 2];
+    Expr Out              = arg_pack[num_tensors - 1];
     CHECK(Out.as_tensor());
-    if (arg_pack.size() == 3UL) {
+    if (num_tensors == 2) {
       Expr input_pad = arg_pack[0];
       CHECK(input_pad.as_tensor());
       stages[input_pad.as_tensor_ref()]->ComputeInline();
@@ -635,6 +735,24 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
       stages[Out.as_tensor_ref()]->Bind(2, "blockIdx.z");
       stages[Out.as_tensor_ref()]->Bind(3, "threadIdx.x");
     }
+    if (fuse_epilogue) {
+      // Each output value is computed into a local buffer and stored by the epilogue.
+      Expr epilogue = arg_pack[num_tensors];
+      CHECK(epilogue.as_tensor());
+      ir::Tensor out_t      = Out.as_tensor_ref();
+      ir::Tensor epilogue_t = epilogue.as_tensor_ref();
+      if (target.arch == Target::Arch::NVGPU) {
+        // The same as an epilogue fused by OpFusion, see GraphCompiler::GetOpFunc.
+        out_t->WithBuffer("local", "_" + out_t->name + "_temp_buffer");
+        stages[out_t]->SetScope(poly::ScopeKind::kLocal);
+        stages[epilogue_t]->CopyTransform(stages[out_t]);
+        stages[epilogue_t]->CopyLoopInfo(stages[out_t]->forloop_infos(), stages[out_t]->transformed_domain());
+      } else {
+        out_t->WithBuffer("local");
+        stages[out_t]->ComputeAt2(stages[epilogue_t], 3);
+      }
+      Out = epilogue;
+    }
 
     *ret = CINNValuePack{{CINNValue(Out), CINNValue(stages)}};
   });
@@ -652,7 +770,8 @@ std::shared_ptr<OpStrategy> StrategyForDepthwiseConv2d(const framework::NodeAttr
 std::vector<shape_t> InferShapeForDepthwiseConv2d(const std::vector<shape_t> &inputs_shape,
                                                   const framework::NodeAttr &attrs,
                                                   const Target &target) {
-  CHECK_EQ(inputs_shape.size(), 2U) << "at least 2 input tensors for depthwise_conv2d op\n";
+  // The params of a batchnorm fused follow the input and the weights, see the ConvEpilogueFusion pass.
+  CHECK(inputs_shape.size() == 2U || inputs_shape.size() == 6U) << "at least 2 input tensors for depthwise_conv2d op\n";
   CHECK_EQ(inputs_shape[0].size(), 4U) << "The input tensor's shape should be 4! Please check again.";
   CHECK_EQ(inputs_shape[1].size(), 4U) << "The input tensor's shape should be 4! Please check again.";
   std::vector<int> padding = {0, 0};
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/common/float16.h"
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/graph_test_helper.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(Operator, cast_bfloat16_float16) {
+  const int n = 1000;
+  frontend::Program prog;
+  auto a    = MakeVariable("A", {n}, Float(32));
+  auto bf16 = prog.cast(prog.cast(a, "bfloat16"), "float32");
+  auto f16  = prog.cast(prog.cast(a, "float16"), "float32");
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {}, &scope);
+  auto* a_ptr  = scope->GetTensor("A")->mutable_data<float>(common::DefaultHostTarget());
+  for (int i = 0; i < n; i++) a_ptr[i] = Random() * 1000.f;
+  program->Execute();
+
+  auto* bf16_ptr = scope->GetTensor(bf16->id)->data<float>();
+  auto* f16_ptr  = scope->GetTensor(f16->id)->data<float>();
+  for (int i = 0; i < n; i++) {
+    // The same rounding to the nearest even as the host types.
+    ASSERT_EQ(bf16_ptr[i], static_cast<float>(common::bfloat16(a_ptr[i])));
+    ASSERT_EQ(f16_ptr[i], static_cast<float>(common::float16(a_ptr[i])));
+  }
+}
+
+TEST(Operator, cast_bfloat16_int) {
+  const int n = 256;
+  frontend::Program prog;
+  auto a   = MakeVariable("A", {n}, Float(32));
+  auto out = prog.cast(prog.cast(prog.cast(a, "int32"), "bfloat16"), "int32");
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {}, &scope);
+  auto* a_ptr  = scope->GetTensor("A")->mutable_data<float>(common::DefaultHostTarget());
+  for (int i = 0; i < n; i++) a_ptr[i] = i - n / 2;
+  program->Execute();
+
+  // The integers up to 256 in magnitude are exact in bfloat16.
+  auto* out_ptr = scope->GetTensor(out->id)->data<int>();
+  for (int i = 0; i < n; i++) ASSERT_EQ(out_ptr[i], i - n / 2);
+}
+
+TEST(Operator, matmul_bfloat16) {
+  // The bfloat16 inputs are accumulated in float32, only the output is rounded to bfloat16.
+  const int m = 32, k = 256, n = 64;
+  frontend::Program prog;
+  frontend::Instruction matmul("matmul", {prog.cast(MakeVariable("A", {m, k}, Float(32)), "bfloat16"),
+                                          MakeVariable("B", {k, n}, common::BF16())});
+  prog.AppendInstruction(matmul);
+  auto out = prog.cast(prog.relu(matmul.GetOutput(0)), "float32");
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {}, &scope);
+  ASSERT_EQ(scope->GetTensor(matmul.GetOutput(0)->id)->type(), common::BF16());
+  auto* a_ptr = scope->GetTensor("A")->mutable_data<float>(common::DefaultHostTarget());
+  auto* b_ptr = scope->GetTensor("B")->mutable_data<common::bfloat16>(common::DefaultHostTarget());
+  for (int i = 0; i < m * k; i++) a_ptr[i] = Random();
+  for (int i = 0; i < k * n; i++) b_ptr[i] = common::bfloat16(Random());
+  program->Execute();
+
+  auto* out_ptr = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      double sum = 0.;
+      for (int r = 0; r < k; r++) {
+        sum += static_cast<float>(common::bfloat16(a_ptr[i * k + r])) * static_cast<float>(b_ptr[r * n + j]);
+      }
+      sum = std::max(sum, 0.);
+      // The rounding of the output to the 8 bits of the mantissa of bfloat16.
+      ASSERT_NEAR(sum, out_ptr[i * n + j], std::fabs(sum) / 128 + 1e-3);
+    }
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
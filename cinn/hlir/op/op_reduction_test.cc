@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/graph_test_helper.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+TEST(Operator, reduce_sum_last_axis) {
+  // The last axis is reduced in two phases, by the lanes and by the parts if there are threads to spare.
+  const int m = 4, n = 4096 * 16;
+  frontend::Program prog;
+  auto out = prog.reduce_sum(MakeVariable("A", {m, n}), {1});
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {}, &scope);
+  auto* a_ptr  = SetRandom(scope.get(), "A");
+  program->Execute();
+
+  auto out_tensor = scope->GetTensor(out->id);
+  ASSERT_EQ(out_tensor->shape().data(), std::vector<int>({m}));
+  auto* out_ptr = out_tensor->data<float>();
+  for (int i = 0; i < m; i++) {
+    double sum = 0.;
+    for (int j = 0; j < n; j++) sum += a_ptr[i * n + j];
+    ASSERT_NEAR(sum, out_ptr[i], 1e-2);
+  }
+}
+
+TEST(Operator, reduce_sum_middle_axis_keep_dim) {
+  // The last axis is not reduced, it is vectorized inside the reduced one.
+  const int m = 8, k = 32, n = 64;
+  frontend::Program prog;
+  auto out = prog.reduce_sum(MakeVariable("A", {m, k, n}), {-2}, true);
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {}, &scope);
+  auto* a_ptr  = SetRandom(scope.get(), "A");
+  program->Execute();
+
+  auto out_tensor = scope->GetTensor(out->id);
+  ASSERT_EQ(out_tensor->shape().data(), std::vector<int>({m, 1, n}));
+  auto* out_ptr = out_tensor->data<float>();
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      float sum = 0.f;
+      for (int r = 0; r < k; r++) sum += a_ptr[(i * k + r) * n + j];
+      ASSERT_NEAR(sum, out_ptr[i * n + j], 1e-4);
+    }
+  }
+}
+
+TEST(Operator, reduce_max_all) {
+  const int m = 64, n = 256;
+  frontend::Program prog;
+  auto out = prog.reduce_max(MakeVariable("A", {m, n}), {});
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {}, &scope);
+  auto* a_ptr  = SetRandom(scope.get(), "A");
+  program->Execute();
+
+  auto out_tensor = scope->GetTensor(out->id);
+  ASSERT_EQ(out_tensor->shape().data(), std::vector<int>({1}));
+  ASSERT_EQ(*std::max_element(a_ptr, a_ptr + m * n), out_tensor->data<float>()[0]);
+}
+
+TEST(Operator, reduce_sum_prologue) {
+  // The relu is inlined into the reduction by OpFusion, its output is never stored.
+  const int m = 16, n = 1024;
+  frontend::Program prog;
+  auto relu = prog.relu(MakeVariable("A", {m, n}));
+  auto out  = prog.reduce_sum(relu, {1});
+
+  std::shared_ptr<Scope> scope;
+  auto program = BuildHostProgram(prog, {"OpFusion"}, &scope);
+  ASSERT_EQ(program->size(), 1UL);
+  auto* a_ptr = SetRandom(scope.get(), "A");
+  program->Execute();
+
+  auto* out_ptr = scope->GetTensor(out->id)->data<float>();
+  for (int i = 0; i < m; i++) {
+    float sum = 0.f;
+    for (int j = 0; j < n; j++) sum += std::max(a_ptr[i * n + j], 0.f);
+    ASSERT_NEAR(sum, out_ptr[i], 1e-3);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,186 @@
+#include "cinn/hlir/pe/quantize.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/pe/schedule.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+using common::CINNValue;
+using common::CINNValuePack;
+using framework::OpStrategy;
+using framework::shape_t;
+using framework::StrategyFunction;
+
+namespace {
+
+//! The pe of a quantize op, of its input tensors, the values in them and the per channel scales if there are.
+using QuantizeFunc = std::function<ir::Tensor(const std::vector<ir::Tensor> &inputs, const std::string &out_name)>;
+
+float GetFloatAttr(const framework::NodeAttr &attrs, const std::string &name, float default_value) {
+  auto it = attrs.attr_store.find(name);
+  return it == attrs.attr_store.end() ? default_value : std::get<float>(it->second);
+}
+
+int GetAxis(const framework::NodeAttr &attrs) {
+  auto it = attrs.attr_store.find("axis");
+  return it == attrs.attr_store.end() ? 1 : std::get<int>(it->second);
+}
+
+//! The optional per channel scales in \p inputs, the second input.
+ir::Tensor GetScales(const std::vector<ir::Tensor> &inputs) { return inputs.size() > 1 ? inputs[1] : ir::Tensor(); }
+
+std::shared_ptr<OpStrategy> StrategyForQuantizeOp(const std::string &op_name,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target,
+                                                  const QuantizeFunc &pe_func) {
+  framework::CINNCompute quantize_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK(a.size() == 1U || a.size() == 2U) << "1 input tensor and the optional scales for " << op_name << " compute";
+    std::vector<ir::Tensor> inputs;
+    for (int i = 0; i < a.size(); i++) {
+      Expr input = a[i];
+      CHECK(input.as_tensor());
+      inputs.push_back(input.as_tensor_ref());
+    }
+    auto out    = pe_func(inputs, UniqName(op_name + "_Out"));
+    auto stages = CreateStages(inputs);
+    stages->InsertLazily(out);
+    *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule quantize_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr Out              = arg_pack[0];
+    poly::StageMap stages = arg_pack[1];
+    CHECK(Out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      pe::CudaScheduleInjective(stages[Out.as_tensor_ref()], output_shapes.back(), target);
+    } else if (target.arch == Target::Arch::X86) {
+      pe::ScheduleInjectiveCPU(stages[Out.as_tensor_ref()], output_shapes.back(), target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(quantize_compute, quantize_schedule, "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+}  // namespace
+
+std::shared_ptr<OpStrategy> StrategyForQuantize(const framework::NodeAttr &attrs,
+                                                const std::vector<ir::Tensor> &inputs,
+                                                const std::vector<Type> &out_type,
+                                                const std::vector<std::vector<int>> &output_shapes,
+                                                const Target &target) {
+  float scale = GetFloatAttr(attrs, "scale", 1.f);
+  return StrategyForQuantizeOp(
+      "quantize", output_shapes, target, [=](const std::vector<ir::Tensor> &inputs, const std::string &out_name) {
+        return pe::Quantize(inputs[0], scale, out_name);
+      });
+}
+
+std::shared_ptr<OpStrategy> StrategyForDequantize(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  float scale = GetFloatAttr(attrs, "scale", 1.f);
+  int axis    = GetAxis(attrs);
+  return StrategyForQuantizeOp(
+      "dequantize", output_shapes, target, [=](const std::vector<ir::Tensor> &inputs, const std::string &out_name) {
+        return pe::Dequantize(inputs[0], scale, GetScales(inputs), axis, out_name);
+      });
+}
+
+std::shared_ptr<OpStrategy> StrategyForRequantize(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  float scale     = GetFloatAttr(attrs, "scale", 1.f);
+  float out_scale = GetFloatAttr(attrs, "out_scale", 1.f);
+  int axis        = GetAxis(attrs);
+  return StrategyForQuantizeOp(
+      "requantize", output_shapes, target, [=](const std::vector<ir::Tensor> &inputs, const std::string &out_name) {
+        return pe::Requantize(inputs[0], scale, out_scale, GetScales(inputs), axis, out_name);
+      });
+}
+
+std::vector<shape_t> InferShapeForQuantize(const std::vector<shape_t> &inputs_shape,
+                                           const framework::NodeAttr &attrs,
+                                           const Target &target) {
+  CHECK(inputs_shape.size() == 1UL || inputs_shape.size() == 2UL) << "The input's shape size should be 1 or 2!";
+  if (inputs_shape.size() == 2UL) {
+    int rank = inputs_shape[0].size();
+    int axis = GetAxis(attrs) < 0 ? GetAxis(attrs) + rank : GetAxis(attrs);
+    CHECK(axis >= 0 && axis < rank) << "The axis of the scales is out of the " << rank << " dims";
+    CHECK_EQ(inputs_shape[1], shape_t({inputs_shape[0][axis]})) << "The scales should be one for each channel";
+  }
+  return {inputs_shape[0]};
+}
+
+std::vector<Type> InferDtypeForQuantize(const std::vector<Type> &inputs_type,
+                                        const framework::NodeAttr &attrs,
+                                        const Target &target) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {Int(8)};
+}
+
+std::vector<Type> InferDtypeForDequantize(const std::vector<Type> &inputs_type,
+                                          const framework::NodeAttr &attrs,
+                                          const Target &target) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {Float(32)};
+}
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(quantize_ops) {
+  CINN_REGISTER_OP(quantize)
+      .describe("Quantize the float32 input to int8 by the attr scale, round(x / scale) clamped to [-127, 127].")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantize)
+      .set_attr("infershape", std::function(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", std::function(cinn::hlir::op::InferDtypeForQuantize))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(dequantize)
+      .describe(
+          "Dequantize the int8 or int32 input to float32 by the attr scale, times the optional second input of the "
+          "scales of the channels of the attr axis.")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForDequantize)
+      .set_attr("infershape", std::function(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", std::function(cinn::hlir::op::InferDtypeForDequantize))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(requantize)
+      .describe("Requantize the int32 input to int8, dequantized as dequantize does and quantized by the out_scale.")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForRequantize)
+      .set_attr("infershape", std::function(cinn::hlir::op::InferShapeForQuantize))
+      .set_attr("inferdtype", std::function(cinn::hlir::op::InferDtypeForQuantize))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  return true;
+}
@@ -0,0 +1,204 @@
+#include "cinn/hlir/pe/reduction.h"
+
+#include "cinn/common/ir_util.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/pe/schedule.h"
+#include "cinn/ir/ir_operators.h"
+
+namespace cinn {
+namespace hlir {
+namespace op {
+using common::_CINNValuePack_;
+using common::CINNValue;
+using common::CINNValuePack;
+using framework::OpStrategy;
+using framework::shape_t;
+using framework::StrategyFunction;
+
+#define StrategyForReduction(op_name__, reduce_type__)                                                          \
+  std::shared_ptr<OpStrategy> StrategyFor##reduce_type__(const framework::NodeAttr &attrs,                      \
+                                                         const std::vector<ir::Tensor> &inputs,                 \
+                                                         const std::vector<Type> &out_type,                     \
+                                                         const std::vector<std::vector<int>> &output_shapes,    \
+                                                         const Target &target) {                                \
+    return StrategyForReduce(                                                                                   \
+        attrs, inputs, out_type, output_shapes, target, #op_name__, ir::Reduce::k##reduce_type__);              \
+  }
+
+namespace {
+
+void GetReduceAttrs(const framework::NodeAttr &attrs, std::vector<int> *dim, bool *keep_dim) {
+  for (auto &iter : attrs.attr_store) {
+    if (iter.first == "dim") {
+      *dim = std::get<std::vector<int>>(iter.second);
+    } else if (iter.first == "keep_dim") {
+      *keep_dim = std::get<bool>(iter.second);
+    } else {
+      LOG(ERROR) << "Unsupported attr: " << iter.first << std::endl;
+    }
+  }
+}
+
+//! The reduction of one phase, with the PEs of the reduce types.
+ir::Tensor ReduceBase(const ir::Tensor &A,
+                      poly::StageMap stages,
+                      ir::Reduce::ReduceType reduce_type,
+                      const std::vector<int> &dim,
+                      bool keep_dim,
+                      const std::string &output_name) {
+  std::vector<Expr> axes;
+  for (int axis : dim) axes.push_back(Expr(axis));
+  switch (reduce_type) {
+    case ir::Reduce::kSum:
+      return pe::Sum(A, stages, axes, keep_dim, common::make_const(A->type(), 0), output_name);
+    case ir::Reduce::kMul:
+      return pe::Prod(A, stages, axes, keep_dim, common::make_const(A->type(), 1), output_name);
+    case ir::Reduce::kMax:
+      return pe::Max(A, stages, axes, keep_dim, output_name);
+    case ir::Reduce::kMin:
+      return pe::Min(A, stages, axes, keep_dim, output_name);
+    default:
+      LOG(FATAL) << "Unsupported reduce type: " << reduce_type;
+  }
+  return ir::Tensor();
+}
+
+}  // namespace
+
+std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
+                                              const std::vector<ir::Tensor> &inputs,
+                                              const std::vector<Type> &out_type,
+                                              const std::vector<std::vector<int>> &output_shapes,
+                                              const Target &target,
+                                              const std::string &op_name,
+                                              ir::Reduce::ReduceType reduce_type) {
+  std::vector<int> dim;
+  bool keep_dim = false;
+  GetReduceAttrs(attrs, &dim, &keep_dim);
+  CHECK(!inputs.empty()) << "The input tensor of " << op_name << " is empty! Please check.";
+  std::vector<int> input_shape;
+  for (auto &shape : inputs[0]->shape) input_shape.push_back(shape.as_int32());
+
+  framework::CINNCompute reduce_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 1U) << "1 input tensor for " << op_name << " compute";
+    Expr A_expr = a[0];
+    CHECK(A_expr.as_tensor());
+    ir::Tensor A = A_expr.as_tensor_ref();
+    auto stages  = CreateStages({A});
+    std::vector<ir::Tensor> out;
+    if (target.arch == Target::Arch::X86) {
+      out = pe::ReduceCPU(A, stages, reduce_type, dim, keep_dim, target, UniqName(op_name + "_out"));
+    } else {
+      out = {ReduceBase(A, stages, reduce_type, dim, keep_dim, UniqName(op_name + "_out"))};
+    }
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule reduce_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK(arg_pack.size() == 2UL || arg_pack.size() == 3UL);
+    Expr out              = arg_pack[0];
+    poly::StageMap stages = arg_pack.back();
+    CHECK(out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      pe::CudaScheduleReduce(stages[out.as_tensor_ref()], output_shapes[0], target);
+    } else if (target.arch == Target::Arch::X86) {
+      ir::Tensor partial;
+      if (arg_pack.size() == 3UL) {
+        Expr partial_expr = arg_pack[1];
+        CHECK(partial_expr.as_tensor());
+        partial = partial_expr.as_tensor_ref();
+      }
+      pe::ReduceScheduleCPU(stages, out.as_tensor_ref(), partial, input_shape, dim, target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(reduce_compute, reduce_schedule, "strategy." + op_name + ".x86", 1);
+
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForReduction(const std::vector<shape_t> &inputs_shape,
+                                            const framework::NodeAttr &attrs,
+                                            const Target &target) {
+  CHECK_EQ(inputs_shape.size(), 1UL) << "The input's shape size should be 1! Please check again.";
+  auto &input_shape = inputs_shape[0];
+  CHECK(!input_shape.empty()) << "The input of a reduction can not be a scalar! Please check.";
+  std::vector<int> dim;
+  bool keep_dim = false;
+  GetReduceAttrs(attrs, &dim, &keep_dim);
+  int ndim = input_shape.size();
+  std::vector<bool> reduced(ndim, dim.empty());
+  for (int axis : dim) {
+    CHECK(axis >= -ndim && axis < ndim) << "The reduced axis " << axis << " exceeds the dims " << ndim;
+    reduced[axis < 0 ? axis + ndim : axis] = true;
+  }
+  shape_t output_shape;
+  for (int i = 0; i < ndim; i++) {
+    if (!reduced[i]) {
+      output_shape.push_back(input_shape[i]);
+    } else if (keep_dim) {
+      output_shape.push_back(1);
+    }
+  }
+  if (output_shape.empty()) output_shape.push_back(1);
+
+  // The partial results of the first phase on X86, which are a temporary of the op.
+  shape_t partial_shape;
+  if (target.arch == Target::Arch::X86) partial_shape = pe::GetReducePartialShape(input_shape, dim, target);
+  if (partial_shape.empty()) partial_shape.push_back(1);
+  return {output_shape, partial_shape};
+}
+
+std::vector<Type> InferDtypeForReduction(const std::vector<Type> &inputs_type,
+                                         const framework::NodeAttr &attrs,
+                                         const Target &target) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  std::vector<Type> res{inputs_type[0], inputs_type[0]};
+  return res;
+}
+
+StrategyForReduction(reduce_sum, Sum);
+StrategyForReduction(reduce_prod, Mul);
+StrategyForReduction(reduce_max, Max);
+StrategyForReduction(reduce_min, Min);
+
+#undef StrategyForReduction
+
+}  // namespace op
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(reduction_ops) {
+#define CINN_REGISTER_REDUCTION(op__, op_stragegy__)                                                                 \
+  CINN_REGISTER_OP(op__)                                                                                             \
+      .describe(#op__ " function")                                                                                   \
+      .set_num_inputs(1)                                                                                             \
+      .set_num_outputs(2)                                                                                            \
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyFor##op_stragegy__) \
+      .set_attr("infershape", std::function(cinn::hlir::op::InferShapeForReduction))                                 \
+      .set_attr("inferdtype", std::function(cinn::hlir::op::InferDtypeForReduction))                                 \
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kCommReduce) \
+      .set_support_level(4);
+
+  CINN_REGISTER_REDUCTION(reduce_sum, Sum);
+  CINN_REGISTER_REDUCTION(reduce_prod, Mul);
+  CINN_REGISTER_REDUCTION(reduce_max, Max);
+  CINN_REGISTER_REDUCTION(reduce_min, Min);
+#undef CINN_REGISTER_REDUCTION
+
+  return true;
+}
@@ -4,6 +4,7 @@
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
 #include "cinn/hlir/framework/op_strategy.h"
+#include "cinn/hlir/pe/elementwise.h"
 #include "cinn/hlir/pe/nn.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_printer.h"
@@ -100,11 +101,21 @@ void GetMatmulNewShapes(const std::vector<std::vector<int>> &inputs_shape,
   }
 }
 
+//! Whether a matmul or mul of \p type calls MKL, which only takes float32, the others are computed by the CINN kernels.
+bool UseMatmulMKL(const Type &type) {
+#ifdef CINN_WITH_MKL_CBLAS
+  return type == Float(32);
+#else
+  return false;
+#endif
+}
+
 std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
                                               const std::vector<ir::Tensor> &inputs,
                                               const std::vector<Type> &out_type,
                                               const std::vector<std::vector<int>> &output_shapes,
                                               const Target &target) {
+  bool use_mkl = !inputs.empty() && UseMatmulMKL(inputs[0]->type());
   framework::CINNCompute matmul_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of Matmul compute is empty! Please check.\n";
     CINNValuePack a = args[0];
@@ -161,11 +172,11 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
     new_B = tensor_B->Reshape(new_shape_B_e, stages);
     std::vector<ir::Tensor> out;
     if (target.arch == Target::Arch::X86) {
-#ifdef CINN_WITH_MKL_CBLAS
-      out = pe::MatmulMKL(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulMKL_output"), target);
-#else
-      out = pe::MatmulV2(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulV2_output"), target);
-#endif
+      if (UseMatmulMKL(tensor_A->type())) {
+        out = pe::MatmulMKL(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulMKL_output"), target);
+      } else {
+        out = pe::MatmulV2(new_A, new_B, trans_a, trans_b, alpha, UniqName("MatmulV2_output"), target);
+      }
     } else {
       out = pe::Matmul(new_A, new_B, trans_a, trans_b, alpha, UniqName("Matmul_output"));
     }
@@ -192,16 +203,16 @@ std::shared_ptr<OpStrategy> StrategyForMatMul(const framework::NodeAttr &attrs,
       stages[out.as_tensor_ref()]->Bind(0, "blockIdx.x");
       stages[out.as_tensor_ref()]->Bind(1, "threadIdx.x");
     } else if (target.arch == Target::Arch::X86) {
-#ifdef CINN_WITH_MKL_CBLAS
-      CHECK_EQ(arg_pack.size(), 3UL);
-#else
-      CHECK(arg_pack.size() == 3UL || arg_pack.size() == 4UL);
-      Expr packedB  = arg_pack[arg_size - 2];
-      Expr temp_out = arg_pack[arg_size - 3];
-      CHECK(packedB.as_tensor());
-      CHECK(temp_out.as_tensor());
-      pe::MatmulScheduleCPU(stages, temp_out.as_tensor_ref(), packedB.as_tensor_ref(), target);
-#endif
+      if (use_mkl) {
+        CHECK_EQ(arg_pack.size(), 3UL);
+      } else {
+        CHECK(arg_pack.size() == 3UL || arg_pack.size() == 4UL);
+        Expr packedB  = arg_pack[arg_size - 2];
+        Expr temp_out = arg_pack[arg_size - 3];
+        CHECK(packedB.as_tensor());
+        CHECK(temp_out.as_tensor());
+        pe::MatmulScheduleCPU(stages, temp_out.as_tensor_ref(), packedB.as_tensor_ref(), target);
+      }
     }
     *ret = arg_pack;
   });
@@ -255,7 +266,10 @@ std::vector<Type> InferDtypeForMatMul(const std::vector<Type> &inputs_type,
                                       const framework::NodeAttr &attrs,
                                       const Target &target) {
   CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
-  std::vector<Type> res{inputs_type[0], inputs_type[0], inputs_type[0]};
+  // The reduced floats are accumulated in float32 by MatmulV2 and rounded back, the int8 ones output the int32 sums.
+  Type acc_type = pe::AccumulationType(inputs_type[0]);
+  Type out_type = inputs_type[0].is_reduced_float() ? inputs_type[0] : acc_type;
+  std::vector<Type> res{out_type, acc_type, inputs_type[0]};
   return res;
 }
 
@@ -264,6 +278,7 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
                                            const std::vector<Type> &out_type,
                                            const std::vector<std::vector<int>> &output_shapes,
                                            const Target &target) {
+  bool use_mkl = !inputs.empty() && UseMatmulMKL(inputs[0]->type());
   framework::CINNCompute mul_compute([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of Mul compute is empty! Please check.\n";
     CINNValuePack a = args[0];
@@ -326,11 +341,11 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
     auto new_B = B_tensor->Reshape(new_shape_B, stages);
     std::vector<ir::Tensor> out;
     if (target.arch == Target::Arch::X86) {
-#ifdef CINN_WITH_MKL_CBLAS
-      out = pe::MulMKL(new_A, new_B, UniqName("Mul_mkl_output"), target);
-#else
-      out = pe::MulBase(new_A, new_B, UniqName("Mul_output"), target);
-#endif
+      if (UseMatmulMKL(A_tensor->type())) {
+        out = pe::MulMKL(new_A, new_B, UniqName("Mul_mkl_output"), target);
+      } else {
+        out = pe::MulBase(new_A, new_B, UniqName("Mul_output"), target);
+      }
     } else {
       out = pe::MulBase(new_A, new_B, UniqName("Mul_output"), target);
     }
@@ -356,11 +371,11 @@ std::shared_ptr<OpStrategy> StrategyForMul(const framework::NodeAttr &attrs,
       pe::CudaScheduleMul(stages, out.as_tensor_ref(), output_shapes.back(), target);
     } else if (target.arch == Target::Arch::X86) {
       CHECK_EQ(arg_pack.size(), 3UL);
-#ifndef CINN_WITH_MKL_CBLAS
-      Expr reduce_first = arg_pack[1];
-      CHECK(reduce_first.as_tensor());
-      pe::MulScheduleCPU(stages, out.as_tensor_ref(), reduce_first.as_tensor_ref(), target);
-#endif
+      if (!use_mkl) {
+        Expr reduce_first = arg_pack[1];
+        CHECK(reduce_first.as_tensor());
+        pe::MulScheduleCPU(stages, out.as_tensor_ref(), reduce_first.as_tensor_ref(), target);
+      }
     }
     *ret = arg_pack;
   });
@@ -519,7 +534,9 @@ std::vector<Type> InferDtypeForMul(const std::vector<Type> &inputs_type,
                                    const framework::NodeAttr &attrs,
                                    const Target &target) {
   CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
-  std::vector<Type> res{inputs_type[0], inputs_type[0]};
+  // The int8 inputs output the int32 sums, see MulBase.
+  Type out_type = inputs_type[0].is_int(8) ? pe::AccumulationType(inputs_type[0]) : inputs_type[0];
+  std::vector<Type> res{out_type, out_type};
   return res;
 }
 
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <any>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Scope;
+
+namespace {
+
+/**
+ * Run the op nodes \p nodes in topological order once, with the compiled kernels, and put the outputs in \p keep
+ * into \p scope. The inputs of the nodes are either in \p scope or outputs of the nodes.
+ */
+void Evaluate(const Graph& graph,
+              const std::vector<Node*>& nodes,
+              const std::unordered_set<std::string>& keep,
+              const std::shared_ptr<Scope>& scope) {
+  // The nodes make up a program of their own, with the same names of the variables.
+  std::shared_ptr<Scope> eval_scope;
+  CompileProgram(graph, GetProgram(graph, nodes), *scope, &eval_scope)->Execute();
+
+  // The tensors computed are shared, the rest of the evaluation is freed.
+  for (auto& id : keep) *scope->Var<framework::Tensor>(id) = *eval_scope->FindVar(id);
+}
+
+}  // namespace
+
+/**
+ * Fold the ops whose inputs are all parameters, that is in g.attrs["param_scope"], or the outputs of other such ops.
+ * They are run once by the compiled kernels, and their outputs used by the other ops, or not used by any, are put into
+ * the scope as new parameters. The folded ops, the intermediate tensors among them and the parameters used only by them
+ * are removed from the graph.
+ *
+ * If g.attrs["wait_params"] is set, it is called before the parameters are read, e.g. to wait for them to be loaded in
+ * the background.
+ */
+void ConstantFoldingPass(Graph* graph) {
+  CHECK(!graph->HasAttr("fusion_groups")) << "ConstantFolding should be applied before OpFusion";
+  auto& scope = graph->GetAttrs<std::shared_ptr<Scope>>("param_scope");
+
+  std::unordered_set<std::string> constants;
+  std::vector<Node*> folded;
+  int num_ops = 0;
+  for (auto* graph_node : std::get<0>(graph->topological_order())) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node) {
+      // The outputs of the folded ops are recorded with their producers.
+      if (graph_node->inlinks().empty() && scope->FindVar(graph_node->id())) constants.insert(graph_node->id());
+      continue;
+    }
+    num_ops++;
+    auto& inlinks = node->inlinks_in_order();
+    bool constant = !inlinks.empty() && std::all_of(inlinks.begin(), inlinks.end(), [&](auto& edge) {
+                      return constants.count(edge->source()->id());
+                    });
+    if (!constant) continue;
+    folded.push_back(node);
+    for (auto& edge : node->outlinks()) constants.insert(edge->sink()->id());
+  }
+  if (folded.empty()) return;
+  if (folded.size() == num_ops) {
+    VLOG(3) << "ConstantFolding: all the " << num_ops << " ops are constant, none is folded";
+    return;
+  }
+
+  // The outputs used out of the folded ops, or by no op, that is the outputs of the graph.
+  std::unordered_set<Node*> folded_set(folded.begin(), folded.end());
+  auto used_out = [&](const common::GraphNode* data) {
+    if (data->outlinks().empty()) return true;
+    for (auto& edge : data->outlinks()) {
+      if (!folded_set.count(edge->sink()->safe_as<Node>())) return true;
+    }
+    return false;
+  };
+  std::unordered_set<std::string> keep;
+  for (auto* node : folded) {
+    for (auto& edge : node->outlinks()) {
+      if (used_out(edge->sink())) keep.insert(edge->sink()->id());
+    }
+  }
+  for (auto* data : graph->outputs) {
+    if (constants.count(data->id())) keep.insert(data->id());
+  }
+
+  if (graph->HasAttr("wait_params")) graph->GetAttrs<std::function<void()>>("wait_params")();
+  {
+    utils::RecordEvent event("ConstantFolding::Evaluate", "hlir");
+    Evaluate(*graph, folded, keep, scope);
+  }
+
+  // Unlink and remove the folded ops, the tensors left with no links are no longer used by the graph.
+  std::vector<NodeData*> unlinked;
+  for (auto* node : folded) RemoveOp(graph, node, &unlinked);
+  std::unordered_set<NodeData*> removed;
+  for (auto* data : unlinked) {
+    if (removed.count(data)) continue;
+    if (keep.count(data->id())) {
+      // A tensor kept becomes a parameter with no producer.
+      data->source_node.reset();
+      continue;
+    }
+    if (!data->outlinks().empty()) continue;
+    removed.insert(data);
+    RemoveData(graph, data);
+  }
+
+  VLOG(3) << "ConstantFolding: " << folded.size() << " of " << num_ops << " ops folded into " << keep.size()
+          << " constant tensors, " << removed.size() << " tensors removed";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(ConstantFolding) {
+  CINN_REGISTER_PASS(ConstantFolding)
+      .describe(
+          "This pass runs the ops whose inputs are all parameters in g.attrs[\"param_scope\"] once at build time, and "
+          "replaces them with the constant tensors computed.")
+      .set_change_structure(true)
+      .depend_graph_attr("infershape")
+      .depend_graph_attr("inferdtype")
+      .depend_graph_attr("param_scope")
+      .set_body(cinn::hlir::pass::ConstantFoldingPass);
+  return true;
+}
@@ -0,0 +1,156 @@
+#include <any>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+namespace {
+
+std::string GetDataFormat(const Node* node) {
+  auto& attr_store = node->attrs.attr_store;
+  return attr_store.count("data_format") ? std::get<std::string>(attr_store.at("data_format")) : "NCHW";
+}
+
+//! Whether the strategy of the conv \p node applies an epilogue, see GetConvEpilogue in hlir/op/nn.cc.
+bool SupportsEpilogue(const Node* node) {
+  auto& op_name    = node->op()->name;
+  auto& attr_store = node->attrs.attr_store;
+  if (attr_store.count("epilogue_batchnorm") || attr_store.count("epilogue_activation")) return false;
+  if (op_name == "conv2d") {
+    // The grouped conv on X86 is called from MKLDNN.
+    int groups = attr_store.count("groups") ? std::get<int>(attr_store.at("groups")) : 1;
+    return GetDataFormat(node) == "NCHW" && groups == 1;
+  }
+  if (op_name == "depthwise_conv2d") return GetDataFormat(node) == "NCHW";
+  return op_name == "conv2d_NCHWc";
+}
+
+NodeData* GetOutput(const Node* node) { return node->outlinks_in_order().front()->sink()->safe_as<NodeData>(); }
+
+class ConvEpilogueFusionHelper {
+ public:
+  explicit ConvEpilogueFusionHelper(Graph* graph) : graph_(graph) {
+    for (auto* output : graph->outputs) graph_outputs_.insert(output);
+  }
+
+  //! Returns the number of the convs fused.
+  int operator()() {
+    // The ops fused are destroyed, so the convs are collected first.
+    std::vector<Node*> convs;
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && SupportsEpilogue(node)) convs.push_back(node);
+    }
+    int num_fused = 0;
+    for (auto* conv : convs) {
+      if (Fuse(conv)) num_fused++;
+    }
+    return num_fused;
+  }
+
+ private:
+  //! The op consuming \p data, nullptr if there are more than one, or \p data is used out of the graph.
+  Node* GetSoleConsumer(const NodeData* data) const {
+    if (data->outlinks().size() != 1 || graph_outputs_.count(data)) return nullptr;
+    return (*data->outlinks().begin())->sink()->safe_as<Node>();
+  }
+
+  //! Fuse the batchnorm and then the activation consuming the output of \p conv, returns false if there is none.
+  bool Fuse(Node* conv) {
+    framework::NodeAttr attrs = conv->attrs;
+    std::vector<NodeData*> inputs;
+    for (auto& edge : conv->inlinks_in_order()) inputs.push_back(edge->source()->safe_as<NodeData>());
+    std::vector<NodeData*> outputs;
+    for (auto& edge : conv->outlinks_in_order()) outputs.push_back(edge->sink()->safe_as<NodeData>());
+    std::vector<Node*> ops{conv};
+
+    Node* next = GetSoleConsumer(outputs[0]);
+    if (next && next->op()->name == "batchnorm") {
+      auto& in_links = next->inlinks_in_order();
+      CHECK_EQ(in_links.size(), 5U) << "The batchnorm " << next->id() << " should have 5 inputs";
+      // An op can not take the same tensor twice.
+      std::unordered_set<NodeData*> unique_inputs(inputs.begin(), inputs.end());
+      bool unique = in_links[0]->source() == outputs[0];
+      for (int i = 1; i < in_links.size(); i++) {
+        auto* param = in_links[i]->source()->safe_as<NodeData>();
+        unique     = unique && unique_inputs.insert(param).second;
+        inputs.push_back(param);
+      }
+      if (!unique) return false;
+      attrs.attr_store["epilogue_batchnorm"] = true;
+      if (next->attrs.attr_store.count("epsilon")) {
+        attrs.attr_store["epilogue_epsilon"] = next->attrs.attr_store.at("epsilon");
+      }
+      ops.push_back(next);
+      next = GetSoleConsumer(GetOutput(next));
+    }
+    if (next && (next->op()->name == "relu" || next->op()->name == "relu6")) {
+      attrs.attr_store["epilogue_activation"] = next->op()->name;
+      ops.push_back(next);
+    }
+    if (ops.size() == 1) return false;
+
+    // The tensors between the ops fused are no longer computed, the last op's output is stored by the conv instead.
+    std::vector<NodeData*> intermediates{outputs[0]};
+    for (int i = 1; i + 1 < ops.size(); i++) intermediates.push_back(GetOutput(ops[i]));
+    outputs[0] = GetOutput(ops.back());
+    VLOG(3) << "Fuse " << ops.size() - 1 << " ops into " << conv->id() << " as its epilogue";
+
+    // The conv and the ops fused into it are replaced by a single conv with the id of the conv.
+    ReplaceOps(graph_, ops, attrs, inputs, outputs);
+    for (auto* data : intermediates) RemoveData(graph_, data);
+    return true;
+  }
+
+  Graph* graph_;
+  std::unordered_set<const NodeData*> graph_outputs_;
+};
+
+}  // namespace
+
+/**
+ * Fuse the batchnorm of inference and then the relu or relu6 following a conv2d, conv2d_NCHWc or depthwise_conv2d into
+ * it as its epilogue, which is applied to each output value before it is stored, see pe::ConvEpilogue. The params of
+ * the batchnorm follow the input and the weights of the conv, and the attrs "epilogue_batchnorm", "epilogue_epsilon"
+ * and "epilogue_activation" are set on it. The output tensors of the conv and of the batchnorm are then never stored.
+ *
+ * Only the NCHW convs are fused, and no conv is when cudnn computes them.
+ */
+void ConvEpilogueFusionPass(Graph* graph) {
+  CHECK(!graph->HasAttr("fusion_groups")) << "ConvEpilogueFusion should be applied before OpFusion";
+#ifdef CINN_WITH_CUDNN
+  if (graph->target_.arch == Target::Arch::NVGPU) return;
+#endif
+  int num_fused = ConvEpilogueFusionHelper(graph)();
+  VLOG(3) << "ConvEpilogueFusion: " << num_fused << " convs fused with their epilogues";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(ConvEpilogueFusion) {
+  CINN_REGISTER_PASS(ConvEpilogueFusion)
+      .describe("This pass fuses the batchnorm and the activation following a conv into it as its epilogue.")
+      .set_change_structure(true)
+      .depend_graph_attr("infershape")
+      .depend_graph_attr("inferdtype")
+      .set_body(cinn::hlir::pass::ConvEpilogueFusionPass);
+  return true;
+}
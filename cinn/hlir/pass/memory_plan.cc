@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <any>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/string.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+
+namespace {
+
+// The offsets in the slab are aligned to the cache line.
+constexpr int kAlignment = 64;
+
+struct LiveRange {
+  std::string id;
+  int64_t nbytes{};
+  //! The first and the last step the tensor is live in, both inclusive.
+  int begin{};
+  int end{};
+
+  bool Overlaps(const LiveRange& other) const { return begin <= other.end && other.begin <= end; }
+};
+
+}  // namespace
+
+/**
+ * Plan the memory of the intermediate tensors by their live ranges, the tensors not live at the same time share the
+ * memory of a single slab. The graph outputs and the tensors without consumers are kept live till the end, so the caller
+ * can fetch them after the run.
+ */
+void MemoryPlanPass(Graph* graph) {
+  auto& shape_dict = graph->GetAttrs<std::unordered_map<std::string, framework::shape_t>>("infershape");
+  auto& dtype_dict = graph->GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  // The nodes of a fused group run in a single step, the same as the instructions GraphCompiler builds.
+  auto steps = graph->FusionGroups();
+
+  std::unordered_set<const NodeData*> graph_outputs(graph->outputs.begin(), graph->outputs.end());
+  std::unordered_map<std::string, LiveRange> ranges;
+  const int last_step = steps.size() - 1;
+  for (int step = 0; step < steps.size(); step++) {
+    for (auto* node : steps[step]) {
+      for (auto& out_edge : node->outlinks_in_order()) {
+        auto* sink = out_edge->sink()->safe_as<NodeData>();
+        CHECK(sink);
+        auto& range = ranges[sink->id()];
+        if (range.id.empty()) {
+          range.id     = sink->id();
+          range.begin  = step;
+          range.end    = sink->outlinks().empty() || graph_outputs.count(sink) ? last_step : step;
+          auto& shape  = shape_dict.at(sink->id());
+          range.nbytes = dtype_dict.at(sink->id()).bytes();
+          for (auto dim : shape) range.nbytes *= dim;
+        }
+      }
+    }
+    for (auto* node : steps[step]) {
+      for (auto& in_edge : node->inlinks_in_order()) {
+        auto it = ranges.find(in_edge->source()->safe_as<NodeData>()->id());
+        if (it != ranges.end()) it->second.end = std::max(it->second.end, step);
+      }
+    }
+  }
+
+  // Greedy by size: place the largest tensor first at the lowest offset not conflicting with the placed ones.
+  std::vector<LiveRange*> sorted;
+  for (auto& item : ranges) sorted.push_back(&item.second);
+  std::sort(sorted.begin(), sorted.end(), [](const LiveRange* a, const LiveRange* b) {
+    return a->nbytes != b->nbytes ? a->nbytes > b->nbytes : a->id < b->id;
+  });
+
+  std::unordered_map<std::string, int> offsets;
+  std::vector<std::pair<const LiveRange*, int64_t>> placed;
+  int64_t naive_bytes   = 0;
+  int64_t planned_bytes = 0;
+  for (auto* range : sorted) {
+    std::vector<std::pair<int64_t, int64_t>> conflicts;
+    for (auto& [other, offset] : placed) {
+      if (range->Overlaps(*other)) conflicts.emplace_back(offset, offset + other->nbytes);
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    int64_t offset = 0;
+    for (auto& [begin, end] : conflicts) {
+      if (offset + range->nbytes <= begin) break;
+      offset = std::max(offset, (end + kAlignment - 1) / kAlignment * kAlignment);
+    }
+    placed.emplace_back(range, offset);
+    offsets[range->id] = offset;
+    naive_bytes += range->nbytes;
+    planned_bytes = std::max(planned_bytes, offset + range->nbytes);
+  }
+  CHECK_LE(planned_bytes, std::numeric_limits<int>::max()) << "The planned memory is too large";
+
+  VLOG(3) << "MemoryPlan: " << ranges.size() << " intermediate tensors in " << steps.size()
+          << " steps, naive peak bytes: " << naive_bytes << ", planned peak bytes: " << planned_bytes;
+  graph->attrs["memory_plan"] = std::make_shared<std::any>(offsets);
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+CINN_REGISTER_HELPER(MemoryPlan) {
+  CINN_REGISTER_PASS(MemoryPlan)
+      .describe(
+          "This pass plans the memory of the intermediate tensors by their live ranges, and save the byte offsets of "
+          "them in a shared slab to g.attrs[\"memory_plan\"].")
+      .set_change_structure(false)
+      .depend_graph_attr("infershape")
+      .depend_graph_attr("inferdtype")
+      .provide_graph_attr("memory_plan")
+      .set_body(cinn::hlir::pass::MemoryPlanPass);
+  return true;
+}
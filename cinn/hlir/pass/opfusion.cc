@@ -1,3 +1,11 @@
+#include <algorithm>
+#include <any>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -15,31 +23,239 @@ using framework::Node;
 using framework::NodeData;
 using framework::Operator;
 using framework::OpPatternKind;
+using framework::shape_t;
 
-void OpFusionPass(Graph* graph) {
-  auto store_nodes      = std::get<0>(graph->topological_order());
-  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
-  for (int i = 0; i < store_nodes.size(); i++) {
-    auto node = store_nodes[i]->safe_as<Node>();
-    if (node) {
-      auto op_pattern = op_pattern_dict[node->op()];
-      if (op_pattern <= framework::kOutEWiseFusable) {
-        int fuse_number = 1;
-        while (i + 2 < store_nodes.size() && store_nodes[i + 2]->safe_as<Node>()) {
-          auto temp_node = store_nodes[i + 2]->safe_as<Node>();
-          if (op_pattern_dict[temp_node->op()] <= framework::kElemWise) {
-            i = i + 2;
-            fuse_number++;
-          } else {
-            break;
-          }
+namespace {
+
+struct Group {
+  std::vector<Node*> nodes;
+  //! The max pattern of the nodes.
+  OpPatternKind pattern;
+  //! The output shape of the reduction or the complex op in the group, the epilogues fused should be of the same shape.
+  shape_t master_shape;
+};
+
+/**
+ * Whether an op of pattern \p consumer can be fused into a group of pattern \p group it consumes.
+ */
+bool CanFuse(OpPatternKind group, OpPatternKind consumer) {
+  if (consumer <= framework::kInjective) {
+    // The injective ops fuse with each other, and the elementwise and broadcast ops fuse into a reduction or a complex
+    // op as the epilogue.
+    if (group <= framework::kInjective) return true;
+    bool complex = group == framework::kCommReduce || group == framework::kOutEWiseFusable;
+    return complex && consumer <= framework::kBroadcast;
+  }
+  // A reduction takes its injective producers as the prologue.
+  return consumer == framework::kCommReduce && group <= framework::kInjective;
+}
+
+//! The bool graph attr \p name, true if it is not set.
+bool GetOption(const Graph& graph, const std::string& name) {
+  return !graph.HasAttr(name) || graph.GetAttrs<bool>(name);
+}
+
+Node* GetProducer(const NodeData* data) {
+  if (data->inlinks().empty()) return nullptr;
+  return (*data->inlinks().begin())->source()->safe_as<Node>();
+}
+
+std::vector<Node*> GetConsumers(const NodeData* data) {
+  std::vector<Node*> consumers;
+  for (auto& edge : data->outlinks()) consumers.push_back(edge->sink()->safe_as<Node>());
+  return consumers;
+}
+
+class OpFusionHelper {
+ public:
+  explicit OpFusionHelper(Graph* graph)
+      : graph_(graph),
+        shape_dict_(graph->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape")),
+        fuse_elementwise_(GetOption(*graph, "op_fusion_elementwise")),
+        fuse_reduce_prologue_(GetOption(*graph, "op_fusion_reduce_prologue")) {
+    for (auto* graph_node : std::get<0>(graph->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (!node) continue;
+      topo_index_[node] = nodes_.size();
+      nodes_.push_back(node);
+    }
+    for (auto* output : graph->outputs) graph_outputs_.insert(output);
+  }
+
+  std::vector<std::vector<Node*>> operator()() {
+    auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+    for (auto* node : nodes_) {
+      OpPatternKind pattern = op_pattern_dict[node->op()];
+      if (!FuseIntoProducer(node, pattern)) {
+        group_of_[node] = groups_.size();
+        groups_.push_back(Group{{node}, pattern, {}});
+        if (pattern == framework::kCommReduce || pattern == framework::kOutEWiseFusable) {
+          groups_.back().master_shape = OutputShape(node);
+        }
+      }
+    }
+    return SortGroups();
+  }
+
+ private:
+  const shape_t& OutputShape(const Node* node) const {
+    CHECK(!node->outlinks_in_order().empty());
+    return shape_dict_.at(node->outlinks_in_order().front()->sink()->safe_as<NodeData>()->id());
+  }
+
+  /**
+   * Fuse \p node into the group of one of its producers, the first input's producer goes first. Returns false if none
+   * of them fits.
+   */
+  bool FuseIntoProducer(Node* node, OpPatternKind pattern) {
+    if (pattern <= framework::kInjective ? !fuse_elementwise_ : !fuse_reduce_prologue_) return false;
+    std::unordered_set<int> tried;
+    for (auto& in_edge : node->inlinks_in_order()) {
+      auto* producer = GetProducer(in_edge->source()->safe_as<NodeData>());
+      if (!producer) continue;
+      int group_id = group_of_.at(producer);
+      if (!tried.insert(group_id).second) continue;
+      auto& group = groups_[group_id];
+      if (!CanFuse(group.pattern, pattern)) continue;
+      if (!group.master_shape.empty() && pattern <= framework::kInjective && OutputShape(node) != group.master_shape) {
+        continue;
+      }
+      if (ReachableByOtherPath(group_id, node)) continue;
+      if (graph_->target_.arch == Target::Arch::NVGPU && !HasSingleOutput(group, node)) continue;
+
+      group.nodes.push_back(node);
+      group.pattern = std::max(group.pattern, pattern);
+      if (pattern == framework::kCommReduce) group.master_shape = OutputShape(node);
+      group_of_[node] = group_id;
+      VLOG(3) << "Fuse " << node->id() << " into the group of " << group.nodes.front()->id();
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * Whether \p node is reachable from the group \p group_id through a node out of the group. Fusing it then makes a
+   * cycle between the groups.
+   */
+  bool ReachableByOtherPath(int group_id, Node* node) const {
+    const int node_index = topo_index_.at(node);
+    std::vector<Node*> stack;
+    std::unordered_set<Node*> visited;
+    auto push_consumers = [&](const Node* from) {
+      for (auto& out_edge : from->outlinks_in_order()) {
+        for (auto* consumer : GetConsumers(out_edge->sink()->safe_as<NodeData>())) {
+          // The nodes after node in the topological order can not reach it.
+          if (consumer == node || topo_index_.at(consumer) > node_index) continue;
+          if (group_of_.count(consumer) && group_of_.at(consumer) == group_id) continue;
+          if (visited.insert(consumer).second) stack.push_back(consumer);
+        }
+      }
+    };
+    for (auto* member : groups_[group_id].nodes) push_consumers(member);
+    while (!stack.empty()) {
+      auto* current = stack.back();
+      stack.pop_back();
+      for (auto& out_edge : current->outlinks_in_order()) {
+        for (auto* consumer : GetConsumers(out_edge->sink()->safe_as<NodeData>())) {
+          if (consumer == node) return true;
         }
-        if (fuse_number > 1) {
-          node->attrs.attr_store["FuseNumber"] = fuse_number;
+      }
+      push_consumers(current);
+    }
+    return false;
+  }
+
+  //! Whether the group produces a single tensor used out of it after fusing \p node.
+  bool HasSingleOutput(const Group& group, Node* node) const {
+    std::unordered_set<const Node*> members(group.nodes.begin(), group.nodes.end());
+    members.insert(node);
+    int num_outputs = 0;
+    for (auto* member : members) {
+      for (auto& out_edge : member->outlinks_in_order()) {
+        auto* data     = out_edge->sink()->safe_as<NodeData>();
+        auto consumers = GetConsumers(data);
+        bool used_out  = consumers.empty() || graph_outputs_.count(data) ||
+                        std::any_of(consumers.begin(), consumers.end(), [&](Node* c) { return !members.count(c); });
+        if (used_out) num_outputs++;
+      }
+    }
+    return num_outputs <= 1;
+  }
+
+  //! Sort the groups in topological order, the nodes of each group are sorted too.
+  std::vector<std::vector<Node*>> SortGroups() {
+    std::vector<std::unordered_set<int>> successors(groups_.size());
+    std::vector<int> num_deps(groups_.size(), 0);
+    for (auto* node : nodes_) {
+      int group_id = group_of_.at(node);
+      for (auto& out_edge : node->outlinks_in_order()) {
+        for (auto* consumer : GetConsumers(out_edge->sink()->safe_as<NodeData>())) {
+          int consumer_group = group_of_.at(consumer);
+          if (consumer_group != group_id && successors[group_id].insert(consumer_group).second) {
+            num_deps[consumer_group]++;
+          }
         }
       }
     }
+    // Visit the ready groups by their first node, to keep the order close to the original one.
+    auto first_index = [&](int group_id) { return topo_index_.at(groups_[group_id].nodes.front()); };
+    auto later       = [&](int a, int b) { return first_index(a) > first_index(b); };
+    std::priority_queue<int, std::vector<int>, decltype(later)> ready(later);
+    for (int i = 0; i < groups_.size(); i++) {
+      if (num_deps[i] == 0) ready.push(i);
+    }
+    std::vector<std::vector<Node*>> sorted;
+    while (!ready.empty()) {
+      int group_id = ready.top();
+      ready.pop();
+      auto nodes = groups_[group_id].nodes;
+      std::sort(nodes.begin(), nodes.end(), [&](Node* a, Node* b) { return topo_index_.at(a) < topo_index_.at(b); });
+      sorted.push_back(std::move(nodes));
+      for (int successor : successors[group_id]) {
+        if (--num_deps[successor] == 0) ready.push(successor);
+      }
+    }
+    CHECK_EQ(sorted.size(), groups_.size()) << "The fused groups have a cycle";
+    return sorted;
+  }
+
+  Graph* graph_;
+  const std::unordered_map<std::string, shape_t>& shape_dict_;
+  //! Whether the first two rules of OpFusionPass apply.
+  bool fuse_elementwise_;
+  //! Whether the last rule of OpFusionPass applies.
+  bool fuse_reduce_prologue_;
+  std::vector<Node*> nodes_;
+  std::unordered_map<const Node*, int> topo_index_;
+  std::unordered_set<const NodeData*> graph_outputs_;
+  std::vector<Group> groups_;
+  std::unordered_map<const Node*, int> group_of_;
+};
+
+}  // namespace
+
+/**
+ * Group the op nodes along the producer-consumer edges by their OpPatternKind, each group is compiled into a single
+ * kernel by GraphCompiler. The groups are stored in the graph attribute "fusion_groups", see Graph::FusionGroups.
+ *
+ * An op is fused into the group of one of its producers if:
+ * - both are injective, that is elementwise, broadcast or injective;
+ * - the op is an elementwise or broadcast epilogue of the same shape as the reduction or the complex op of the group;
+ * - the op is a reduction and the group is injective, as its prologue;
+ * and the fusion makes no cycle between the groups. A tensor consumed both in and out of its group, or an output of the
+ * graph, is kept as an output of the group, the others are inlined into their consumers.
+ *
+ * The first two rules are disabled by setting the bool g.attrs["op_fusion_elementwise"] to false, and the last one by
+ * g.attrs["op_fusion_reduce_prologue"].
+ */
+void OpFusionPass(Graph* graph) {
+  auto groups   = OpFusionHelper(graph)();
+  int num_fused = 0;
+  for (auto& group : groups) {
+    if (group.size() > 1) num_fused++;
   }
+  VLOG(3) << "OpFusion: " << groups.size() << " groups, " << num_fused << " of them fused";
+  graph->attrs["fusion_groups"] = std::make_shared<std::any>(groups);
 }
 
 }  // namespace pass
@@ -47,8 +263,10 @@ void OpFusionPass(Graph* graph) {
 }  // namespace cinn
 CINN_REGISTER_HELPER(OpFusion) {
   CINN_REGISTER_PASS(OpFusion)
-      .describe("This pass traverse the graph and fuse all ops.")
+      .describe("This pass groups the ops along the producer-consumer edges by their patterns and fuses each group.")
       .set_change_structure(false)
+      .depend_graph_attr("infershape")
+      .provide_graph_attr("fusion_groups")
       .set_body(cinn::hlir::pass::OpFusionPass);
 
   return true;
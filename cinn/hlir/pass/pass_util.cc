@@ -0,0 +1,103 @@
+#include "cinn/hlir/pass/pass_util.h"
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Scope;
+using framework::shape_t;
+
+frontend::Program GetProgram(const Graph& graph, const std::vector<Node*>& nodes) {
+  auto& shape_dict = graph.GetAttrs<std::unordered_map<std::string, shape_t>>("infershape");
+  auto& dtype_dict = graph.GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  frontend::Program program;
+  for (auto* node : nodes) {
+    std::vector<frontend::Variable> inputs;
+    for (auto& edge : node->inlinks_in_order()) {
+      frontend::Variable var(edge->source()->id());
+      var->shape = shape_dict.at(var->id);
+      var->type  = dtype_dict.at(var->id);
+      inputs.push_back(var);
+    }
+    frontend::Instruction instr(node->op()->name, inputs);
+    instr->attrs = node->attrs.attr_store;
+    auto& outlinks = node->outlinks_in_order();
+    CHECK_EQ(instr->outputs.size(), outlinks.size()) << "The outputs of " << node->id() << " mismatch its op";
+    for (int i = 0; i < outlinks.size(); i++) instr->outputs[i].set_id(outlinks[i]->sink()->id());
+    program.AppendInstruction(instr);
+  }
+  return program;
+}
+
+std::unique_ptr<framework::Program> CompileProgram(const Graph& graph,
+                                                   const frontend::Program& program,
+                                                   const Scope& param_scope,
+                                                   std::shared_ptr<Scope>* scope) {
+  auto subgraph = std::make_shared<Graph>(program, graph.target_);
+  framework::ApplyPass(subgraph.get(), "InferShape");
+  *scope = std::make_shared<Scope>();
+  for (auto& [id, shape] : subgraph->GetAttrs<std::unordered_map<std::string, shape_t>>("infershape")) {
+    auto* var = param_scope.FindVar(id);
+    if (var) *(*scope)->Var<framework::Tensor>(id) = *var;
+  }
+  framework::BuildScope(graph.target_, subgraph, *scope);
+  framework::GraphCompiler compiler(graph.target_, *scope, subgraph);
+  return compiler.Build();
+}
+
+void RemoveOp(Graph* graph, Node* op, std::vector<NodeData*>* unlinked) {
+  // The links are copied as they are removed while iterating.
+  for (auto& edge : std::vector<common::Shared<common::GraphEdge>>(op->inlinks_in_order())) {
+    auto* data = edge->source()->safe_as<NodeData>();
+    data->UnLinkTo(op);
+    if (unlinked) unlinked->push_back(data);
+  }
+  for (auto& edge : std::vector<common::Shared<common::GraphEdge>>(op->outlinks_in_order())) {
+    auto* data = edge->sink()->safe_as<NodeData>();
+    op->UnLinkTo(data);
+    if (unlinked) unlinked->push_back(data);
+  }
+  graph->RemoveNode(op);
+}
+
+void RemoveData(Graph* graph, NodeData* data) {
+  graph->GetMutableAttrs<std::unordered_map<std::string, shape_t>>("infershape").erase(data->id());
+  graph->GetMutableAttrs<std::unordered_map<std::string, Type>>("inferdtype").erase(data->id());
+  graph->RemoveNode(data);
+}
+
+Node* ReplaceOps(Graph* graph,
+                 const std::vector<Node*>& ops,
+                 framework::NodeAttr attrs,
+                 const std::vector<NodeData*>& inputs,
+                 const std::vector<NodeData*>& outputs) {
+  CHECK(!ops.empty());
+  std::string id        = ops.front()->id();
+  std::string node_name = ops.front()->attrs.node_name;
+  for (auto* op : ops) RemoveOp(graph, op);
+  auto node   = Node::Create(attrs.op, node_name, id);
+  node->attrs = std::move(attrs);
+  for (auto* input : inputs) input->LinkTo(node.get());
+  for (int i = 0; i < outputs.size(); i++) {
+    node->LinkTo(outputs[i]);
+    outputs[i]->source_node  = node;
+    outputs[i]->output_index = i;
+  }
+  graph->RegisterNode(id, node.get());
+  return node.get();
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
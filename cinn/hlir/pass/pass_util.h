@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "cinn/frontend/syntax.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+//! The program of the op nodes \p nodes of \p graph in topological order, with the same names of the variables.
+frontend::Program GetProgram(const framework::Graph& graph, const std::vector<framework::Node*>& nodes);
+
+/**
+ * Compile \p program on the target of \p graph into a new \p scope, which shares the tensors it reads that are in
+ * \p param_scope.
+ */
+std::unique_ptr<framework::Program> CompileProgram(const framework::Graph& graph,
+                                                   const frontend::Program& program,
+                                                   const framework::Scope& param_scope,
+                                                   std::shared_ptr<framework::Scope>* scope);
+
+/**
+ * Unlink the op \p op from its inputs and outputs and remove it from \p graph, the tensors unlinked are appended to
+ * \p unlinked if it is not nullptr.
+ */
+void RemoveOp(framework::Graph* graph, framework::Node* op, std::vector<framework::NodeData*>* unlinked = nullptr);
+
+//! Remove the tensor \p data from \p graph and from its infershape and inferdtype, it should have no links left.
+void RemoveData(framework::Graph* graph, framework::NodeData* data);
+
+/**
+ * Replace the ops \p ops with a new op of \p attrs from \p inputs to \p outputs, with the id and the name of the first
+ * one. The ops are replaced as the order of the links of an op can not be changed. Returns the new op.
+ */
+framework::Node* ReplaceOps(framework::Graph* graph,
+                            const std::vector<framework::Node*>& ops,
+                            framework::NodeAttr attrs,
+                            const std::vector<framework::NodeData*>& inputs,
+                            const std::vector<framework::NodeData*>& outputs);
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <any>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/hlir/pass/pass_util.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/profiler.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using common::Type;
+using framework::Graph;
+using framework::Node;
+using framework::NodeData;
+using framework::Scope;
+using framework::shape_t;
+
+namespace {
+
+//! The largest magnitude of the symmetric int8, the -128 is not used.
+constexpr float kInt8Max = 127.f;
+
+//! The scale mapping the magnitudes up to \p abs_max onto the int8, 1 for all zeros.
+float GetScale(float abs_max) { return abs_max > 0.f ? abs_max / kInt8Max : 1.f; }
+
+template <typename T>
+T GetAttr(const Node* node, const std::string& name, T default_value) {
+  auto& attr_store = node->attrs.attr_store;
+  return attr_store.count(name) ? std::get<T>(attr_store.at(name)) : default_value;
+}
+
+/**
+ * Whether \p node computes in int8 once quantized, that is a conv2d in NCHW with no groups, with or without an
+ * epilogue, or a mul, whose weights, the input 1, are float32 parameters in \p scope.
+ */
+bool IsQuantizable(const Graph& graph, const Node* node, const Scope& scope) {
+  auto& op_name = node->op()->name;
+  if (op_name == "conv2d") {
+    if (GetAttr<std::string>(node, "data_format", "NCHW") != "NCHW" || GetAttr<int>(node, "groups", 1) != 1) {
+      return false;
+    }
+    // An epilogue requantized is already quantized.
+    if (node->attrs.attr_store.count("epilogue_dequantize")) return false;
+  } else if (op_name != "mul") {
+    return false;
+  }
+  auto& inlinks = node->inlinks_in_order();
+  if (inlinks.size() < 2) return false;
+  auto& dtype_dict = graph.GetAttrs<std::unordered_map<std::string, Type>>("inferdtype");
+  auto* weights    = inlinks[1]->source()->safe_as<NodeData>();
+  return weights->inlinks().empty() && scope.FindVar(weights->id()) &&
+         dtype_dict.at(inlinks[0]->source()->id()) == Float(32) && dtype_dict.at(weights->id()) == Float(32);
+}
+
+std::string GetActivation(const Node* node) { return node->inlinks_in_order()[0]->source()->id(); }
+
+class QuantizeHelper {
+ public:
+  QuantizeHelper(Graph* graph, Scope* scope, const std::unordered_map<std::string, float>& scales)
+      : graph_(graph),
+        scope_(scope),
+        scales_(scales),
+        shape_dict_(graph->GetMutableAttrs<std::unordered_map<std::string, shape_t>>("infershape")),
+        dtype_dict_(graph->GetMutableAttrs<std::unordered_map<std::string, Type>>("inferdtype")) {
+    for (auto* output : graph->outputs) graph_outputs_.insert(output);
+  }
+
+  //! Returns the number of the ops quantized.
+  int operator()() {
+    // The ops quantized are replaced, so they are collected first.
+    std::vector<Node*> ops;
+    std::unordered_set<const Node*> quantized;
+    for (auto* graph_node : std::get<0>(graph_->topological_order())) {
+      auto* node = graph_node->safe_as<Node>();
+      if (node && IsQuantizable(*graph_, node, *scope_) && scales_.count(GetActivation(node))) {
+        ops.push_back(node);
+        quantized.insert(node);
+      }
+    }
+    // The output of a conv used only as the activations of the ops quantized is requantized by the conv itself.
+    std::unordered_set<std::string> requantized;
+    for (auto* op : ops) {
+      auto* out = op->outlinks_in_order()[0]->sink()->safe_as<NodeData>();
+      if (op->op()->name != "conv2d" || graph_outputs_.count(out) || out->outlinks().empty()) continue;
+      bool all_quantized = std::all_of(out->outlinks().begin(), out->outlinks().end(), [&](auto& edge) {
+        auto* consumer = edge->sink()->template safe_as<Node>();
+        return quantized.count(consumer) && GetActivation(consumer) == out->id();
+      });
+      if (all_quantized) requantized.insert(out->id());
+    }
+    for (auto* op : ops) {
+      if (op->op()->name == "conv2d") {
+        QuantizeConv(op, requantized);
+      } else {
+        QuantizeMul(op, requantized);
+      }
+    }
+    return ops.size();
+  }
+
+ private:
+  //! The int8 activation of \p data, which is either requantized by its producer or quantized by a new op.
+  NodeData* GetQuantizedActivation(NodeData* data, const std::unordered_set<std::string>& requantized) {
+    if (requantized.count(data->id())) return data;
+    auto it = quantized_.find(data->id());
+    if (it != quantized_.end()) return it->second;
+    auto* out = AddOp("quantize", data->id() + "_quantize", {data}, {{"scale", scales_.at(data->id())}});
+    quantized_.emplace(data->id(), out);
+    return out;
+  }
+
+  /**
+   * Add an op \p id of \p op_name on \p inputs with \p attr_store, returns its output, \p output or a new tensor if it
+   * is nullptr.
+   */
+  NodeData* AddOp(const std::string& op_name,
+                  const std::string& id,
+                  const std::vector<NodeData*>& inputs,
+                  const std::unordered_map<std::string, framework::NodeAttr::attr_t>& attr_store,
+                  NodeData* output = nullptr) {
+    auto node              = Node::Create(framework::Operator::Get(op_name), op_name, id);
+    node->attrs.attr_store = attr_store;
+    for (auto* input : inputs) input->LinkTo(node.get());
+    if (!output) {
+      output = new NodeData(nullptr, 0, 0, id + "_out");
+      graph_->RegisterNode(output->id(), output);
+    }
+    node->LinkTo(output);
+    output->source_node  = node;
+    output->output_index = 0;
+    graph_->RegisterNode(id, node.get());
+    Infer(node.get());
+    return output;
+  }
+
+  //! Infer the shapes and dtypes of the outputs of \p node.
+  void Infer(const Node* node) {
+    auto& op_infershape = framework::Operator::GetAttrs<std::function<std::vector<shape_t>(
+        const std::vector<shape_t>&, const framework::NodeAttr&, const Target&)>>("infershape");
+    auto& op_inferdtype = framework::Operator::GetAttrs<
+        std::function<std::vector<Type>(const std::vector<Type>&, const framework::NodeAttr&, const Target&)>>(
+        "inferdtype");
+    std::vector<shape_t> inputs_shape;
+    std::vector<Type> inputs_dtype;
+    for (auto& edge : node->inlinks_in_order()) {
+      inputs_shape.push_back(shape_dict_.at(edge->source()->id()));
+      inputs_dtype.push_back(dtype_dict_.at(edge->source()->id()));
+    }
+    auto out_shape = op_infershape[node->op()](inputs_shape, node->attrs, graph_->target_);
+    auto out_dtype = op_inferdtype[node->op()](inputs_dtype, node->attrs, graph_->target_);
+    auto& outlinks = node->outlinks_in_order();
+    for (int i = 0; i < outlinks.size(); i++) {
+      shape_dict_[outlinks[i]->sink()->id()] = out_shape[i];
+      dtype_dict_[outlinks[i]->sink()->id()] = out_dtype[i];
+    }
+  }
+
+  //! A new parameter \p id of \p shape and \p type in the graph and the scope, returns the memory to fill.
+  NodeData* AddParam(const std::string& id, const shape_t& shape, const Type& type, void** memory) {
+    auto& tensor = std::get<framework::Tensor>(*scope_->Var<framework::Tensor>(id));
+    tensor->Resize(framework::Shape{shape});
+    *memory     = tensor->mutable_data(graph_->target_, type);
+    auto* param = new NodeData(nullptr, 0, 0, id);
+    graph_->RegisterNode(id, param);
+    shape_dict_[id] = shape;
+    dtype_dict_[id] = type;
+    return param;
+  }
+
+  /**
+   * The int8 of the weights \p weights, quantized by the scale of each output channel, that is each slice of the first
+   * \p num_col_dims dims. The scales are put into \p channel_scales.
+   */
+  NodeData* GetQuantizedWeights(NodeData* weights, int num_col_dims, std::vector<float>* channel_scales) {
+    auto& shape  = shape_dict_.at(weights->id());
+    int channels = 1;
+    for (int i = 0; i < num_col_dims; i++) channels *= shape[i];
+    auto tensor      = scope_->GetTensor(weights->id());
+    int size         = tensor->shape().numel() / channels;
+    const auto* data = tensor->data<float>();
+    channel_scales->resize(channels);
+    for (int c = 0; c < channels; c++) {
+      float abs_max = 0.f;
+      for (int i = 0; i < size; i++) abs_max = std::max(abs_max, std::abs(data[c * size + i]));
+      (*channel_scales)[c] = GetScale(abs_max);
+    }
+
+    std::string id = weights->id() + "_int8";
+    // The weights shared by several ops are quantized once.
+    if (auto* cached = graph_->RetrieveNode(id)) return cached->safe_as<NodeData>();
+    void* memory;
+    auto* quantized = AddParam(id, shape, Int(8), &memory);
+    auto* int8_data = reinterpret_cast<int8_t*>(memory);
+    for (int c = 0; c < channels; c++) {
+      for (int i = 0; i < size; i++) {
+        float value = std::round(data[c * size + i] / (*channel_scales)[c]);
+        int8_data[c * size + i] = static_cast<int8_t>(std::min(std::max(value, -kInt8Max), kInt8Max));
+      }
+    }
+    return quantized;
+  }
+
+  //! The float32 scales to dequantize the int32 sums of \p op by, the scale of its activation times \p channel_scales.
+  NodeData* AddDequantizeScales(const Node* op, const std::vector<float>& channel_scales) {
+    float scale = scales_.at(GetActivation(op));
+    shape_t shape{static_cast<int>(channel_scales.size())};
+    void* memory;
+    auto* param  = AddParam(op->id() + "_dequantize_scales", shape, Float(32), &memory);
+    auto* values = reinterpret_cast<float*>(memory);
+    for (int c = 0; c < channel_scales.size(); c++) values[c] = scale * channel_scales[c];
+    return param;
+  }
+
+  /**
+   * Replace \p op with a new op of \p attrs from \p inputs to \p outputs, and remove the inputs of \p op left unused,
+   * e.g. the float32 weights.
+   */
+  Node* Replace(Node* op,
+                const framework::NodeAttr& attrs,
+                const std::vector<NodeData*>& inputs,
+                const std::vector<NodeData*>& outputs) {
+    std::vector<NodeData*> old_inputs;
+    for (auto& edge : op->inlinks_in_order()) old_inputs.push_back(edge->source()->safe_as<NodeData>());
+    auto* node = ReplaceOps(graph_, {op}, attrs, inputs, outputs);
+    for (auto* input : old_inputs) {
+      if (!input->outlinks().empty() || !input->inlinks().empty() || graph_outputs_.count(input)) continue;
+      RemoveData(graph_, input);
+    }
+    return node;
+  }
+
+  //! The conv takes the int8 input and weights, and dequantizes the int32 sums before its epilogue.
+  void QuantizeConv(Node* conv, const std::unordered_set<std::string>& requantized) {
+    std::vector<NodeData*> inputs;
+    for (auto& edge : conv->inlinks_in_order()) inputs.push_back(edge->source()->safe_as<NodeData>());
+    std::vector<NodeData*> outputs;
+    for (auto& edge : conv->outlinks_in_order()) outputs.push_back(edge->sink()->safe_as<NodeData>());
+    std::vector<float> channel_scales;
+    inputs[0] = GetQuantizedActivation(inputs[0], requantized);
+    inputs[1] = GetQuantizedWeights(inputs[1], 1, &channel_scales);
+    inputs.push_back(AddDequantizeScales(conv, channel_scales));
+
+    framework::NodeAttr attrs               = conv->attrs;
+    attrs.attr_store["epilogue_dequantize"] = true;
+    if (requantized.count(outputs[0]->id())) {
+      attrs.attr_store["epilogue_requantize_scale"] = scales_.at(outputs[0]->id());
+    }
+    Infer(Replace(conv, attrs, inputs, outputs));
+  }
+
+  //! The mul of the int8 input and weights outputs the int32 sums, which are dequantized into its original output.
+  void QuantizeMul(Node* mul, const std::unordered_set<std::string>& requantized) {
+    std::vector<NodeData*> inputs;
+    for (auto& edge : mul->inlinks_in_order()) inputs.push_back(edge->source()->safe_as<NodeData>());
+    std::vector<NodeData*> outputs;
+    for (auto& edge : mul->outlinks_in_order()) outputs.push_back(edge->sink()->safe_as<NodeData>());
+    std::vector<float> channel_scales;
+    inputs[0]    = GetQuantizedActivation(inputs[0], requantized);
+    inputs[1]    = GetQuantizedWeights(inputs[1], GetAttr<int>(mul, "y_num_col_dims", 1), &channel_scales);
+    auto* scales = AddDequantizeScales(mul, channel_scales);
+
+    // The original output is taken by the dequantize, the mul outputs a new int32 tensor in its place.
+    framework::NodeAttr attrs = mul->attrs;
+    auto* out                 = outputs[0];
+    outputs[0] = new NodeData(nullptr, 0, 0, out->id() + "_int32");
+    graph_->RegisterNode(outputs[0]->id(), outputs[0]);
+    Infer(Replace(mul, attrs, inputs, outputs));
+    AddOp("dequantize", out->id() + "_dequantize", {outputs[0], scales}, {{"scale", 1.f}, {"axis", 1}}, out);
+  }
+
+  Graph* graph_;
+  Scope* scope_;
+  const std::unordered_map<std::string, float>& scales_;
+  std::unordered_map<std::string, shape_t>& shape_dict_;
+  std::unordered_map<std::string, Type>& dtype_dict_;
+  std::unordered_set<const NodeData*> graph_outputs_;
+  //! The outputs of the quantize ops added, by the ids of their inputs.
+  std::unordered_map<std::string, NodeData*> quantized_;
+};
+
+}  // namespace
+
+/**
+ * Pick the scales to quantize the activations of the conv2d and mul ops by, from running the graph over the samples of
+ * g.attrs["calibration_feed"], a std::function<bool(Scope*)> which fills the inputs of the graph in the scope with the
+ * next sample and returns false when there is none left. The graph is compiled and run as it is in float32, with the
+ * parameters in g.attrs["param_scope"], and the scale of an activation is the max of its magnitudes over all the
+ * samples divided by 127. The scales are put into g.attrs["quantize_scales"] by the ids of the activations, for the
+ * Quantize pass.
+ */
+void CalibratePass(Graph* graph) {
+  CHECK(!graph->HasAttr("fusion_groups")) << "Calibrate should be applied before OpFusion";
+  CHECK(graph->target_.arch == Target::Arch::X86) << "The int8 quantization is only implemented on X86";
+  auto& param_scope = graph->GetAttrs<std::shared_ptr<Scope>>("param_scope");
+  auto& feed        = graph->GetAttrs<std::function<bool(Scope*)>>("calibration_feed");
+  if (graph->HasAttr("wait_params")) graph->GetAttrs<std::function<void()>>("wait_params")();
+
+  std::unordered_map<std::string, float> abs_max;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<Node>();
+    if (node && IsQuantizable(*graph, node, *param_scope)) abs_max[GetActivation(node)] = 0.f;
+  }
+  std::unordered_map<std::string, float> scales;
+  if (!abs_max.empty()) {
+    utils::RecordEvent event("Calibrate", "hlir");
+    std::vector<Node*> ops;
+    for (auto* graph_node : std::get<0>(graph->topological_order())) {
+      if (auto* node = graph_node->safe_as<Node>()) ops.push_back(node);
+    }
+    std::shared_ptr<Scope> scope;
+    auto program    = CompileProgram(*graph, GetProgram(*graph, ops), *param_scope, &scope);
+    int num_samples = 0;
+    while (feed(scope.get())) {
+      program->Execute();
+      for (auto& [id, value] : abs_max) {
+        auto tensor      = scope->GetTensor(id);
+        const auto* data = tensor->data<float>();
+        for (int i = 0; i < tensor->shape().numel(); i++) value = std::max(value, std::abs(data[i]));
+      }
+      num_samples++;
+    }
+    CHECK_GT(num_samples, 0) << "No sample to calibrate the quantization with";
+    for (auto& [id, value] : abs_max) scales[id] = GetScale(value);
+    VLOG(3) << "Calibrate: the scales of " << scales.size() << " activations picked over " << num_samples
+            << " samples";
+  }
+  graph->attrs["quantize_scales"] = std::make_shared<std::any>(scales);
+}
+
+/**
+ * Rewrite the float32 conv2d and mul ops whose activations have a scale in g.attrs["quantize_scales"] into int8. The
+ * activation is quantized to int8 by the scale, the weights are quantized by a scale for each output channel into new
+ * parameters in g.attrs["param_scope"], and the int32 sums are dequantized by the product of the two:
+ *  - A conv2d dequantizes them in its epilogue, before the batchnorm and the activation fused, see pe::ConvEpilogue.
+ *    If its output is only the activations of the ops quantized, it is requantized to int8 by the epilogue as well,
+ *    so that no float32 of it is stored.
+ *  - A mul outputs the int32 sums, which a dequantize op computes the original float32 output from.
+ *
+ * Only the NCHW conv2d with no groups and the mul are quantized, on X86. It should be applied after ConvEpilogueFusion,
+ * for the epilogue to apply to the dequantized values.
+ */
+void QuantizePass(Graph* graph) {
+  CHECK(!graph->HasAttr("fusion_groups")) << "Quantize should be applied before OpFusion";
+  CHECK(graph->target_.arch == Target::Arch::X86) << "The int8 quantization is only implemented on X86";
+  auto& scope  = graph->GetAttrs<std::shared_ptr<Scope>>("param_scope");
+  auto& scales = graph->GetAttrs<std::unordered_map<std::string, float>>("quantize_scales");
+  if (graph->HasAttr("wait_params")) graph->GetAttrs<std::function<void()>>("wait_params")();
+  int num_quantized = QuantizeHelper(graph, scope.get(), scales)();
+  VLOG(3) << "Quantize: " << num_quantized << " ops quantized to int8";
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(Quantize) {
+  CINN_REGISTER_PASS(Calibrate)
+      .describe(
+          "This pass runs the graph over the samples of g.attrs[\"calibration_feed\"] to pick the scales of the int8 "
+          "activations into g.attrs[\"quantize_scales\"].")
+      .set_change_structure(false)
+      .depend_graph_attr("infershape")
+      .depend_graph_attr("inferdtype")
+      .depend_graph_attr("param_scope")
+      .depend_graph_attr("calibration_feed")
+      .provide_graph_attr("quantize_scales")
+      .set_body(cinn::hlir::pass::CalibratePass);
+
+  CINN_REGISTER_PASS(Quantize)
+      .describe("This pass rewrites the float32 conv2d and mul to int8 by the scales of g.attrs[\"quantize_scales\"].")
+      .set_change_structure(true)
+      .depend_graph_attr("infershape")
+      .depend_graph_attr("inferdtype")
+      .depend_graph_attr("param_scope")
+      .depend_graph_attr("quantize_scales")
+      .set_body(cinn::hlir::pass::QuantizePass);
+  return true;
+}
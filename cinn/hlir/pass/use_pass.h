@@ -4,3 +4,7 @@
 
 CINN_USE_REGISTER(InferShape)
 CINN_USE_REGISTER(OpFusion)
+CINN_USE_REGISTER(MemoryPlan)
+CINN_USE_REGISTER(ConstantFolding)
+CINN_USE_REGISTER(ConvEpilogueFusion)
+CINN_USE_REGISTER(Quantize)
@@ -89,6 +89,17 @@ HLIR_IMP_UNARY_PE(Sign);
 HLIR_IMP_UNARY_PE(Abs);
 HLIR_IMP_UNARY_PE(Rsqrt);
 
+Type AccumulationType(const Type& type) {
+  if (type.is_reduced_float()) return Float(32, type.lanes());
+  if (type.is_int(8)) return Int(32, type.lanes());
+  return type;
+}
+
+std::vector<ir::Tensor> Cast(const Tensor& A, const Type& type, const std::string& output_name) {
+  return {Compute(
+      A->shape, [&](const std::vector<Expr>& indice) { return ir::Cast::Make(type, A(indice)); }, output_name)};
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
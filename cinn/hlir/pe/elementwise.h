@@ -54,13 +54,29 @@ HLIR_DCL_UNARY_PE(Sigmoid);
 HLIR_DCL_UNARY_PE(Sign);
 HLIR_DCL_UNARY_PE(Abs);
 HLIR_DCL_UNARY_PE(Rsqrt);
-HLIR_DCL_UNARY_PE(Cast);
 HLIR_DCL_UNARY_PE(Clip);
 HLIR_DCL_UNARY_PE(Reinterpret);
 HLIR_DCL_UNARY_PE(ElementwiseSum);
 HLIR_DCL_UNARY_PE(Full);
 HLIR_DCL_UNARY_PE(FullLike);
 
+/**
+ * @brief Cast the elements of a Tensor to another type, e.g. between float32 and bfloat16.
+ *
+ * @param A The input Tensor
+ * @param type The type of the elements of the output
+ * @param output_name The name of the output Tensor
+ *
+ * @return The result Tensor.
+ */
+std::vector<ir::Tensor> Cast(const ir::Tensor& A, const Type& type, const std::string& output_name = "T_Cast_out");
+
+/**
+ * @brief The type the matmul and conv kernels accumulate the products of the inputs of \p type in, float32 for the
+ * reduced floats and int32 for int8, the type itself for the others.
+ */
+Type AccumulationType(const Type& type);
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -11,6 +11,7 @@
 #include "cinn/common/ir_util.h"
 #include "cinn/hlir/pe/broadcast.h"
 #include "cinn/hlir/pe/elementwise.h"
+#include "cinn/hlir/pe/quantize.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/lang/builtin.h"
@@ -40,6 +41,41 @@ Tensor PRelu(const Tensor &A, const Tensor &slope, const int axis, const std::st
       output_name);
 }
 
+Expr ConvEpilogue::operator()(Expr value, Expr channel) const {
+  if (dequantize_scales.defined()) value = DequantizeInt(value, dequantize_scales(channel));
+  if (scale.defined()) {
+    // The params of the reduced floats are computed in the float32 of the accumulated value.
+    auto param = [&](const ir::Tensor &t) {
+      Expr p = t(channel);
+      return p.type() == value.type() ? p : ir::Cast::Make(value.type(), p);
+    };
+    // The same as BatchNorm_NCHW.
+    value = (value - param(mean)) * param(scale) / lang::Sqrt(param(variance) + Expr(epsilon)) + param(bias);
+  }
+  if (activation == "relu") {
+    value = lang::Relu<float>(value, 0.f);
+  } else if (activation == "relu6") {
+    value = lang::Relu6<float>(value, 0.f);
+  } else {
+    CHECK(activation.empty()) << "The activation " << activation << " can not be fused into a convolution";
+  }
+  if (requantize_scale != 0.f) value = QuantizeInt8(value, requantize_scale);
+  return value;
+}
+
+ir::Tensor ConvEpilogue::Apply(const ir::Tensor &conv, const std::string &output_name) const {
+  CHECK(conv->shape.size() == 4U || conv->shape.size() == 5U) << "The output of a convolution should be 4-D or 5-D";
+  auto epilogue = *this;
+  return Compute(
+      conv->shape,
+      [=](const std::vector<Expr> &indice) {
+        // The channel of an NCHWc output is split into the dims 1 and 4.
+        Expr channel = indice.size() == 5U ? indice[1] * conv->shape[4] + indice[4] : indice[1];
+        return epilogue(conv(indice), channel);
+      },
+      output_name);
+}
+
 std::vector<ir::Tensor> Conv2d_NCHW(const ir::Tensor &input,
                                     const ir::Tensor &weights,
                                     int pad_h,
@@ -115,7 +151,8 @@ std::vector<ir::Tensor> Conv2d_NCHW_5D(const ir::Tensor &input,
                                        int dilation_h,
                                        int dilation_w,
                                        const std::string &output_name,
-                                       const common::Target &target) {
+                                       const common::Target &target,
+                                       const ConvEpilogue &epilogue) {
   // input: 4D to 5D, NCHW->NCHWc
   // [batch, in_channel, in_height, in_width] ->
   // [batch, in_channel_chunk, in_height, in_width, in_channel_block]
@@ -131,7 +168,9 @@ std::vector<ir::Tensor> Conv2d_NCHW_5D(const ir::Tensor &input,
   int oc      = c_out.as_int32();
   int ic      = c_in.as_int32();
   int fc_size = c_filter.as_int32();
-  GetConv2dFactors(&conv2d_factors, oc, fc_size, -1, type, target);
+  // The reduced floats are accumulated in float32 and the int8 in int32 by Conv2d_NCHWc, which the factors are for.
+  Type acc_type = AccumulationType(type);
+  GetConv2dFactors(&conv2d_factors, oc, fc_size, -1, acc_type, target);
   int ic_bn_size = conv2d_factors["ic_bn"];
   int oc_bn_size = conv2d_factors["oc_bn"];
   Expr ic_bn     = Expr(ic_bn_size);
@@ -174,7 +213,11 @@ std::vector<ir::Tensor> Conv2d_NCHW_5D(const ir::Tensor &input,
   };
   auto res = Compute(
       output_shape,
-      [=](Expr n, Expr c, Expr h, Expr w) { return packed_out(n, c / oc_bn, h, w, c % oc_bn); },
+      [=](Expr n, Expr c, Expr h, Expr w) {
+        Expr value = packed_out(n, c / oc_bn, h, w, c % oc_bn);
+        if (!epilogue.empty()) value = epilogue(value, c);
+        return type.is_reduced_float() ? ir::Cast::Make(type, value) : value;
+      },
       UniqName("conv2d_nchw_out"));
   return {res, packed_out, input_pad, weights_dilation, data};
 }
@@ -244,10 +287,14 @@ std::vector<ir::Tensor> Conv2d_NCHWc(const ir::Tensor &input,
           ic_inner = common::AutoSimplify(((oc_chunk * c_out_inner + oc_block) / c_out_per_group * c_filter + fc) %
                                           c_in_inner);
         }
-        return lang::ReduceSum(
-            input_pad(n, ic_outer, oh * stride_h + fy * dilation_h, ow * stride_w + fx * dilation_w, ic_inner) *
-                weights(oc_chunk, fc / c_filter_inner, fy, fx, fc % c_filter_inner, oc_block),
-            {fc, fy, fx});
+        Expr a = input_pad(n, ic_outer, oh * stride_h + fy * dilation_h, ow * stride_w + fx * dilation_w, ic_inner);
+        Expr b = weights(oc_chunk, fc / c_filter_inner, fy, fx, fc % c_filter_inner, oc_block);
+        // The reduced floats are accumulated in float32 and the int8 in int32.
+        if (AccumulationType(type) != type) {
+          a = ir::Cast::Make(AccumulationType(type), a);
+          b = ir::Cast::Make(AccumulationType(type), b);
+        }
+        return lang::ReduceSum(a * b, {fc, fy, fx});
       },
       UniqName("conv2d_NCHWc_out"));
   return {packed_out, input_pad};
@@ -75,6 +75,43 @@ ir::Tensor PRelu(const ir::Tensor &A,
                  const int axis                 = 1,
                  const std::string &output_name = UniqName("T_PRelu_out"));
 
+/**
+ * @brief The elementwise epilogue fused into a convolution, applied to each output value before it is stored: the
+ * dequantization of an int8 convolution, the batchnorm of inference if the scale is defined, the activation, and then
+ * the requantization to int8.
+ */
+struct ConvEpilogue {
+  //! The params of the batchnorm, each of shape {C_out}.
+  ir::Tensor scale;
+  ir::Tensor bias;
+  ir::Tensor mean;
+  ir::Tensor variance;
+  float epsilon{1e-5f};
+  //! "relu", "relu6" or empty for no activation.
+  std::string activation;
+  //! The scales of the output channels to dequantize the int32 sums of an int8 conv by, of shape {C_out}.
+  ir::Tensor dequantize_scales;
+  //! The scale to requantize the output to int8 by, 0 to output float32.
+  float requantize_scale{0.f};
+
+  bool empty() const {
+    return !scale.defined() && activation.empty() && !dequantize_scales.defined() && requantize_scale == 0.f;
+  }
+
+  //! The value stored for the output \p value of the output channel \p channel.
+  Expr operator()(Expr value, Expr channel) const;
+
+  /**
+   * @brief Apply the epilogue to an NCHW or NCHWc output of a convolution, as a separate tensor.
+   *
+   * @param conv The 4-D output tensor {N, C_out, H, W}, or the 5-D one {N, C_out_outer, H, W, C_out_inner}
+   * @param output_name The name of the output tensor
+   *
+   * @return the output tensor
+   */
+  ir::Tensor Apply(const ir::Tensor &conv, const std::string &output_name = UniqName("T_Conv_epilogue_out")) const;
+};
+
 /**
  * @brief Perform a 2-D convolution with an NCHW-layout and support group and depthwise convolution.
  *
@@ -101,6 +138,7 @@ std::vector<ir::Tensor> Conv2d_NCHW(const ir::Tensor &input,
                                     int dilation_w,
                                     const std::string &output_name = UniqName("T_Conv2d_NCHW_out"));
 
+//! Perform a 2-D convolution with an NCHW-layout in the packed NCHWc one, \p epilogue is applied on unpacking.
 std::vector<ir::Tensor> Conv2d_NCHW_5D(const ir::Tensor &input,
                                        const ir::Tensor &weights,
                                        int pad_h,
@@ -110,7 +148,8 @@ std::vector<ir::Tensor> Conv2d_NCHW_5D(const ir::Tensor &input,
                                        int dilation_h,
                                        int dilation_w,
                                        const std::string &output_name = UniqName("T_Conv2d_NCHW_5D_out"),
-                                       const common::Target &target   = common::DefaultHostTarget());
+                                       const common::Target &target   = common::DefaultHostTarget(),
+                                       const ConvEpilogue &epilogue   = ConvEpilogue());
 
 /**
  * @brief Perform a 2-D convolution with an NCHWc-layout.
@@ -0,0 +1,70 @@
+#include "cinn/hlir/pe/quantize.h"
+
+#include <vector>
+
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/ir_operators.h"
+#include "cinn/lang/builtin.h"
+#include "cinn/lang/compute.h"
+
+namespace cinn {
+namespace hlir {
+namespace pe {
+
+using cinn::lang::Compute;
+using ir::Tensor;
+
+namespace {
+
+//! The scale of the element at \p indice of a Tensor of \p rank dims, dequantized as Dequantize does.
+Expr GetScale(float scale, const Tensor &scales, int axis, int rank, const std::vector<Expr> &indice) {
+  if (!scales.defined()) return Expr(scale);
+  if (axis < 0) axis += rank;
+  CHECK(axis >= 0 && axis < rank) << "The axis of the scales is out of the " << rank << " dims";
+  Expr channel_scale = scales(indice[axis]);
+  return scale == 1.f ? channel_scale : channel_scale * Expr(scale);
+}
+
+}  // namespace
+
+Expr QuantizeInt8(Expr value, float scale) {
+  CHECK_GT(scale, 0.f) << "The scale to quantize by should be positive";
+  Expr rounded = lang::Round(value * Expr(1.f / scale));
+  Expr clamped = ir::Min::Make(ir::Max::Make(rounded, Expr(-127.f)), Expr(127.f));
+  return ir::Cast::Make(Int(8), clamped);
+}
+
+Expr DequantizeInt(Expr value, Expr scale) { return ir::Cast::Make(Float(32), value) * scale; }
+
+Tensor Quantize(const Tensor &A, float scale, const std::string &output_name) {
+  CHECK_EQ(A->type(), Float(32)) << "Only the float32 tensors can be quantized";
+  return Compute(
+      A->shape, [=](const std::vector<Expr> &indice) { return QuantizeInt8(A(indice), scale); }, output_name);
+}
+
+Tensor Dequantize(const Tensor &A, float scale, const Tensor &scales, int axis, const std::string &output_name) {
+  CHECK(A->type().is_int(8) || A->type().is_int(32)) << "Only the int8 and int32 tensors can be dequantized";
+  int rank = A->shape.size();
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) {
+        return DequantizeInt(A(indice), GetScale(scale, scales, axis, rank, indice));
+      },
+      output_name);
+}
+
+Tensor Requantize(
+    const Tensor &A, float scale, float out_scale, const Tensor &scales, int axis, const std::string &output_name) {
+  CHECK(A->type().is_int(32)) << "Only the int32 tensors can be requantized";
+  int rank = A->shape.size();
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) {
+        return QuantizeInt8(DequantizeInt(A(indice), GetScale(scale, scales, axis, rank, indice)), out_scale);
+      },
+      output_name);
+}
+
+}  // namespace pe
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+
+#include "cinn/common/context.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn {
+namespace hlir {
+namespace pe {
+
+/**
+ * The symmetric int8 quantization of the float32 \p value by \p scale, round(value / scale) clamped to [-127, 127],
+ * so that a value of the magnitude 127 * scale keeps the most precision.
+ */
+Expr QuantizeInt8(Expr value, float scale);
+
+//! The float32 of the int8 or int32 \p value quantized by \p scale, a float32 expression.
+Expr DequantizeInt(Expr value, Expr scale);
+
+/**
+ * @brief Quantize a float32 Tensor to int8 by a scale for all of it.
+ *
+ * @param A The float32 input Tensor
+ * @param scale The scale, the value each step of the int8 stands for
+ * @param output_name The name of the output Tensor
+ *
+ * @return The int8 Tensor.
+ */
+ir::Tensor Quantize(const ir::Tensor &A, float scale, const std::string &output_name = UniqName("T_Quantize_out"));
+
+/**
+ * @brief Dequantize an int8 or int32 Tensor to float32, by a scale for all of it or by one for each channel.
+ *
+ * @param A The int8 or int32 input Tensor, e.g. the int32 output of an int8 mul
+ * @param scale The scale of all the elements
+ * @param scales The scales of the channels of \p axis, multiplied by \p scale, undefined for none
+ * @param axis The axis of the channels, a negative one counts from the last axis
+ * @param output_name The name of the output Tensor
+ *
+ * @return The float32 Tensor.
+ */
+ir::Tensor Dequantize(const ir::Tensor &A,
+                      float scale,
+                      const ir::Tensor &scales       = ir::Tensor(),
+                      int axis                       = 1,
+                      const std::string &output_name = UniqName("T_Dequantize_out"));
+
+/**
+ * @brief Requantize an int32 Tensor, e.g. the sums of an int8 conv, to int8 by \p out_scale, after it is dequantized
+ * as Dequantize does.
+ *
+ * @return The int8 Tensor.
+ */
+ir::Tensor Requantize(const ir::Tensor &A,
+                      float scale,
+                      float out_scale,
+                      const ir::Tensor &scales       = ir::Tensor(),
+                      int axis                       = 1,
+                      const std::string &output_name = UniqName("T_Requantize_out"));
+
+}  // namespace pe
+}  // namespace hlir
+}  // namespace cinn
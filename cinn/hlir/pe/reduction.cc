@@ -4,6 +4,7 @@
 
 #include "cinn/common/ir_util.h"
 #include "cinn/hlir/pe/broadcast.h"
+#include "cinn/hlir/pe/transform.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
@@ -44,8 +45,8 @@ void GetRealAxes(int ndim, const std::vector<Expr>& axes, std::vector<int>* real
       CHECK_GE(val, 0);
       real_axes->push_back(val);
     }
-    real_axes->resize(std::unique(real_axes->begin(), real_axes->end()) - real_axes->begin());
     std::sort(real_axes->begin(), real_axes->end());
+    real_axes->resize(std::unique(real_axes->begin(), real_axes->end()) - real_axes->begin());
   }
 }
 
@@ -192,6 +193,167 @@ Tensor Min(
   return Reduce(A, stages, axes, lang::ReduceMin, keep_dims, Expr(), output_name);
 }
 
+namespace {
+
+//! The least number of the elements a part of the two-phase reduction reduces, to pay for the second phase.
+constexpr int kMinReducePerPart = 4096;
+//! The most parts of the two-phase reduction. It is fixed instead of the number of the threads, so the shape of the
+//! partial results does not depend on the host and the kernels cached elsewhere fit the buffers.
+constexpr int kMaxReduceParts = 16;
+
+std::vector<int> NormalizeAxes(int ndim, const std::vector<int>& axes) {
+  std::vector<Expr> axes_expr;
+  for (int axis : axes) axes_expr.push_back(Expr(axis));
+  std::vector<int> real_axes;
+  GetRealAxes(ndim, axes_expr, &real_axes);
+  return real_axes;
+}
+
+bool IsReduced(const std::vector<int>& real_axes, int axis) {
+  return std::find(real_axes.begin(), real_axes.end(), axis) != real_axes.end();
+}
+
+Expr MakeReduce(ir::Reduce::ReduceType reduce_type, Expr body, const std::vector<Var>& reduce_axes) {
+  switch (reduce_type) {
+    case ir::Reduce::kSum:
+      return lang::ReduceSum(body, reduce_axes);
+    case ir::Reduce::kMul:
+      return lang::ReduceMul(body, reduce_axes);
+    case ir::Reduce::kMax:
+      return lang::ReduceMax(body, reduce_axes);
+    case ir::Reduce::kMin:
+      return lang::ReduceMin(body, reduce_axes);
+    default:
+      LOG(FATAL) << "Unsupported reduce type: " << reduce_type;
+  }
+  return Expr();
+}
+
+}  // namespace
+
+void GetReduceFactors(const std::vector<int>& shape,
+                      const std::vector<int>& axes,
+                      const common::Target& target,
+                      int* num_parts,
+                      int* num_lanes) {
+  CHECK(!shape.empty());
+  *num_parts     = 1;
+  *num_lanes     = 1;
+  int last       = shape.size() - 1;
+  auto real_axes = NormalizeAxes(shape.size(), axes);
+  if (real_axes.back() != last) return;
+
+  int num_kept = 1, num_reduced = 1;
+  for (int i = 0; i < shape.size(); i++) {
+    if (IsReduced(real_axes, i)) {
+      num_reduced *= shape[i];
+    } else {
+      num_kept *= shape[i];
+    }
+  }
+  *num_lanes = GetMulFactor(shape[last], Float(32), target);
+  // The parts reduce in parallel only when the outputs are too few for the threads.
+  int extent = shape[last] / *num_lanes;
+  for (int parts = kMaxReduceParts / num_kept; parts > 1; parts--) {
+    if (extent % parts == 0 && num_reduced / parts >= kMinReducePerPart) {
+      *num_parts = parts;
+      break;
+    }
+  }
+}
+
+std::vector<int> GetReducePartialShape(const std::vector<int>& shape,
+                                       const std::vector<int>& axes,
+                                       const common::Target& target) {
+  int num_parts, num_lanes;
+  GetReduceFactors(shape, axes, target, &num_parts, &num_lanes);
+  if (num_parts * num_lanes == 1) return {};
+  auto real_axes = NormalizeAxes(shape.size(), axes);
+  std::vector<int> partial_shape;
+  if (num_parts > 1) partial_shape.push_back(num_parts);
+  for (int i = 0; i < shape.size(); i++) {
+    if (!IsReduced(real_axes, i)) partial_shape.push_back(shape[i]);
+  }
+  if (num_lanes > 1) partial_shape.push_back(num_lanes);
+  return partial_shape;
+}
+
+std::vector<Tensor> ReduceCPU(const Tensor& A,
+                              StageMap stages,
+                              ir::Reduce::ReduceType reduce_type,
+                              const std::vector<int>& axes,
+                              bool keep_dims,
+                              const common::Target& target,
+                              const std::string& output_name) {
+  int ndim = A->shape.size();
+  CHECK_NE(ndim, 0) << "Reduce tensor's dim must be more than 0";
+  std::vector<int> shape;
+  for (auto& dim : A->shape) shape.push_back(dim.as_int32());
+  auto real_axes = NormalizeAxes(ndim, axes);
+  std::vector<Expr> output_shape;
+  GetOutputShape(real_axes, &output_shape, A, keep_dims);
+  auto fn = [=](Expr body, const std::vector<Var>& reduce_axes, const Expr& initial) {
+    return MakeReduce(reduce_type, body, reduce_axes);
+  };
+
+  int num_parts, num_lanes;
+  GetReduceFactors(shape, axes, target, &num_parts, &num_lanes);
+  if (num_parts * num_lanes == 1) {
+    auto squeeze_axes = keep_dims ? std::vector<int>() : real_axes;
+    return {DoReduce(A, stages, fn, output_shape, real_axes, squeeze_axes, Expr(), output_name)};
+  }
+
+  // The first phase: [T, kept dims..., V] reduced over the other reduced axes and k0.
+  std::vector<Expr> partial_shape;
+  for (int dim : GetReducePartialShape(shape, axes, target)) partial_shape.push_back(Expr(dim));
+  const int last      = ndim - 1;
+  const int part_size = shape[last] / num_parts;
+  std::vector<Var> first_axes;
+  for (int axis : real_axes) {
+    if (axis != last) first_axes.push_back(Var(A->shape[axis], UniqName("kk")));
+  }
+  Var k0(Expr(part_size / num_lanes), UniqName("kk"));
+  first_axes.push_back(k0);
+  auto partial = Compute(
+      partial_shape,
+      [=](const std::vector<Expr>& indices) {
+        int pos = num_parts > 1 ? 1 : 0;
+        int r   = 0;
+        std::vector<Expr> eval_indices;
+        for (int i = 0; i < last; i++) {
+          eval_indices.push_back(IsReduced(real_axes, i) ? Expr(first_axes[r++]) : indices[pos++]);
+        }
+        Expr k = Expr(k0) * Expr(num_lanes);
+        if (num_lanes > 1) k = k + indices[pos];
+        if (num_parts > 1) k = indices[0] * Expr(part_size) + k;
+        eval_indices.push_back(k);
+        return MakeReduce(reduce_type, A(eval_indices), first_axes);
+      },
+      UniqName(output_name + "_partial"));
+
+  // The second phase: the outputs reduced over T and V.
+  std::vector<Var> second_axes;
+  if (num_parts > 1) second_axes.push_back(Var(Expr(num_parts), UniqName("kk")));
+  if (num_lanes > 1) second_axes.push_back(Var(Expr(num_lanes), UniqName("kk")));
+  auto out = Compute(
+      output_shape,
+      [=](const std::vector<Expr>& indices) {
+        std::vector<Expr> partial_indices;
+        if (num_parts > 1) partial_indices.push_back(second_axes.front());
+        int pos = 0;
+        for (int i = 0; i < ndim; i++) {
+          if (IsReduced(real_axes, i)) continue;
+          partial_indices.push_back(indices[keep_dims ? i : pos++]);
+        }
+        if (num_lanes > 1) partial_indices.push_back(second_axes.back());
+        return MakeReduce(reduce_type, partial(partial_indices), second_axes);
+      },
+      output_name);
+  stages->InsertLazily(partial);
+  stages->InsertLazily(out);
+  return {out, partial};
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -1,6 +1,8 @@
 #pragma once
+#include <string>
 #include <vector>
 
+#include "cinn/common/target.h"
 #include "cinn/ir/ir.h"
 
 namespace cinn {
@@ -86,6 +88,57 @@ ir::Tensor Min(const ir::Tensor& A,
                bool keep_dims                 = false,
                const std::string& output_name = "T_Reduce_Min_out");
 
+/**
+ * @brief The factors to reduce \p shape over \p axes in two phases on CPU, see ReduceCPU. Both are 1 if the last axis
+ * is not reduced.
+ *
+ * @param shape The shape of the input.
+ * @param axes The axes to reduce, all the axes if it is empty.
+ * @param target The target the reduction runs on.
+ * @param num_parts The number of the parts the last axis is split into, to reduce in parallel.
+ * @param num_lanes The number of the partial results of a part, each accumulating a lane of the contiguous elements.
+ */
+void GetReduceFactors(const std::vector<int>& shape,
+                      const std::vector<int>& axes,
+                      const common::Target& target,
+                      int* num_parts,
+                      int* num_lanes);
+
+/**
+ * @brief The shape of the partial results of ReduceCPU, that is [num_parts, the dims not reduced..., num_lanes] with
+ * the factors of extent 1 left out, empty if the reduction is done in one phase.
+ */
+std::vector<int> GetReducePartialShape(const std::vector<int>& shape,
+                                       const std::vector<int>& axes,
+                                       const common::Target& target);
+
+/**
+ * @brief The reduction of CPU, which is scheduled by ReduceScheduleCPU.
+ *
+ * If the last axis of extent K is reduced, it is split as t * K / T + k0 * V + v by the factors T and V of
+ * GetReduceFactors. The first phase reduces k0 and the other reduced axes into the partial results, the V lanes are
+ * independent accumulators of the contiguous elements to vectorize, and the T parts are reduced in parallel when the
+ * dims not reduced are too few to keep the threads busy. The second phase reduces the T * V partial results of each
+ * output.
+ *
+ * @param A The input Tensor.
+ * @param stages The stage map.
+ * @param reduce_type The reduction, one of ir::Reduce::kSum, kMul, kMax and kMin.
+ * @param axes The axes to reduce, all the axes if it is empty. If an axis is negative it counts from the last axis.
+ * @param keep_dims If it is set true, the axes which are reduced are left in the result as dimensions with size one.
+ * @param target The target the reduction runs on.
+ * @param output_name The name of the output Tensor.
+ *
+ * @return The result Tensor, followed by the partial results if the reduction is in two phases.
+ */
+std::vector<ir::Tensor> ReduceCPU(const ir::Tensor& A,
+                                  poly::StageMap stages,
+                                  ir::Reduce::ReduceType reduce_type,
+                                  const std::vector<int>& axes,
+                                  bool keep_dims,
+                                  const common::Target& target,
+                                  const std::string& output_name = "T_Reduce_out");
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -8,6 +8,8 @@
 #include <utility>
 
 #include "cinn/common/cas.h"
+#include "cinn/hlir/pe/reduction.h"
+#include "cinn/hlir/pe/schedule_config.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/poly/isl_utils.h"
 
@@ -15,6 +17,24 @@ namespace cinn {
 namespace hlir {
 namespace pe {
 
+namespace {
+
+/**
+ * Compute \p output into a local buffer like Stage::CacheWrite, but store it by \p epilogue, an elementwise consumer of
+ * it, instead of a copy if defined. Returns the local tensor and sets \p output to the one stored.
+ */
+ir::Tensor CacheWriteOrEpilogue(poly::StageMap stages, ir::Tensor &output, const ir::Tensor &epilogue) {
+  if (!epilogue.defined()) return stages[output]->CacheWrite("local", stages, output);
+  CHECK(!output->buffer.defined()) << "The tensor " << output->name << " is already binded to a buffer";
+  auto local = output;
+  local->WithBuffer("local");
+  stages[epilogue]->CtrlDepend(local);
+  output = epilogue;
+  return local;
+}
+
+}  // namespace
+
 int GetInnerSplitter(int origin, int other_axis) {
   int two_exp = 1;
   while (origin % two_exp == 0) {
@@ -69,17 +89,16 @@ void ScheduleInjectiveCPU(poly::Stage *stage, const std::vector<int> &output_sha
     int type_bits                 = stage->tensor()->type().bits();
     int prod_size                 = output_shape.back();
     // fuse conservatively for the complex index from poly and may not benefit a lot compared with llvm optimization,
-    // only fuse the last two dims when the last dimension is too small and can split and vectorize Todo: try reorder
+    // only fuse the last two dims when the last dimension is too small to fill a vector, the vectorized loop handles
+    // the elements left over by a scalar remainder. Todo: try reorder
     if (output_shape.back() * type_bits < target_native_vector_bits) {
-      int last_two_dim_bits = output_shape[dims - 2] * output_shape[dims - 1] * type_bits;
-      if (last_two_dim_bits % target_native_vector_bits == 0) {
-        fused = stage->Fuse(dims - 2, dims - 1);
-        prod_size *= output_shape[dims - 2];
-      }
+      fused = stage->Fuse(dims - 2, dims - 1);
+      prod_size *= output_shape[dims - 2];
     }
     int split_factor = target_native_vector_bits / type_bits;
     if (prod_size <= split_factor) {
-      split_factor = GetBetterSplitFactor(prod_size, split_factor);
+      // A factor not exceeding the extent, the rest is left to the remainder.
+      while (split_factor > prod_size) split_factor /= 2;
       if (split_factor >= 8) {
         stage->Vectorize(fused, split_factor);
       }
@@ -112,8 +131,8 @@ void MatmulScheduleCPU(poly::StageMap stages,
                        const ir::Tensor &output,
                        const ir::Tensor &packedB,
                        const common::Target &target) {
-  CHECK_EQ(output->type(), packedB->type());
-  int basic_split_factor = GetBasicFactor(packedB->type(), target);
+  // The output accumulates in its own type, which is float32 for the packedB of the reduced floats.
+  int basic_split_factor = GetBasicFactor(output->type(), target);
   // packedB
   int packedB_dims         = stages[packedB]->axis_names().size();
   int packed_last_dim      = packedB->shape[packedB_dims - 1].as_int32();
@@ -130,6 +149,8 @@ void MatmulScheduleCPU(poly::StageMap stages,
   int bm            = GetArrayPackingFactor(M, output->type(), target);
   int bn            = GetArrayPackingFactor(N, output->type(), target);
   int out_axis_dims = stages[output]->axis_names().size();
+  // The split of N follows the packing of B, only the split of M is tunable.
+  bm = GetTunableFactor("bm", bm, GetSplitCandidates(M, 4, 64));
   CHECK_GE(out_axis_dims, 3U) << "output tensor's size should be at least 3";
   poly::Iterator i_axis = stages[output]->axis(out_axis_dims - 3);
   poly::Iterator j_axis = stages[output]->axis(out_axis_dims - 2);
@@ -162,6 +183,7 @@ void MatmulScheduleCPU(poly::StageMap stages,
   // K
   int K              = packedB->shape[packedB->shape.size() - 2].as_int32();
   int k_split_factor = GetBetterSplitFactor(K, basic_split_factor);
+  k_split_factor     = GetTunableFactor("bk", k_split_factor, GetSplitCandidates(K, 4, 64));
   out_axis_dims      = stages[output]->axis_names().size();
   auto k_axis        = stages[output]->axis(out_axis_dims - 1);
   bool is_k_splited  = false;
@@ -244,6 +266,59 @@ void MulScheduleCPU(poly::StageMap stages,
   }
 }
 
+void ReduceScheduleCPU(poly::StageMap stages,
+                       const ir::Tensor &output,
+                       const ir::Tensor &partial,
+                       const std::vector<int> &input_shape,
+                       const std::vector<int> &axes,
+                       const common::Target &target) {
+  int num_parts, num_lanes;
+  GetReduceFactors(input_shape, axes, target, &num_parts, &num_lanes);
+  int out_dims = output->shape.size();
+  if (partial.defined()) {
+    // partial: [parts, kept..., lanes, reduced..., k0] -> [parts, kept..., reduced..., k0, lanes]
+    int spatial_dims = partial->shape.size();
+    int dims         = stages[partial]->n_out_dims();
+    if (num_lanes > 1) {
+      std::vector<int> order;
+      for (int i = spatial_dims; i < dims; i++) order.push_back(i);
+      order.push_back(spatial_dims - 1);
+      stages[partial]->Reorder(order);
+      stages[partial]->Vectorize(dims - 1, num_lanes);
+      auto partial_init = partial->GetInitTensor(stages, target);
+      if (spatial_dims > 1) {
+        stages[partial_init]->Vectorize(stages[partial_init]->n_out_dims() - 1, num_lanes);
+      }
+    }
+    if (spatial_dims > (num_lanes > 1 ? 1 : 0)) stages[partial]->Parallel(0);
+    // The outputs reduce only parts * lanes partial results each.
+    if (out_dims > 1) stages[output]->Parallel(0);
+    return;
+  }
+
+  // The last axis of output is contiguous in the input if it is not reduced, and the reduction of each lane of it is
+  // independent.
+  int last = input_shape.size() - 1;
+  int dims = stages[output]->n_out_dims();
+  std::vector<int> real_axes;
+  for (int axis : axes) real_axes.push_back(axis < 0 ? axis + input_shape.size() : axis);
+  bool last_reduced = axes.empty() || std::find(real_axes.begin(), real_axes.end(), last) != real_axes.end();
+  if (!last_reduced && dims > out_dims) {
+    std::vector<int> order;
+    for (int i = out_dims; i < dims; i++) order.push_back(i);
+    order.push_back(out_dims - 1);
+    stages[output]->Reorder(order);
+    int factor = GetBasicFactor(output->type(), target);
+    while (factor > input_shape[last]) factor /= 2;
+    if (factor > 1) {
+      stages[output]->Vectorize(dims - 1, factor);
+      auto output_init = output->GetInitTensor(stages, target);
+      if (out_dims > 1) stages[output_init]->Vectorize(stages[output_init]->n_out_dims() - 1, factor);
+    }
+  }
+  if (out_dims > 1) stages[output]->Parallel(0);
+}
+
 void GetConv2dFactors(std::unordered_map<std::string, int> *factors,
                       int oc,
                       int ic,
@@ -275,6 +350,8 @@ void GetConv2dFactors(std::unordered_map<std::string, int> *factors,
       break;
     }
   }
+  // The block of the output width only changes the schedule, the blocks of the channels change the packed layouts.
+  if (ow > 0) ow_bn = GetTunableFactor("ow_bn", ow_bn, GetSplitCandidates(ow, 1, bn_base));
 
   (*factors)["oc_bn"] = oc_bn;
   (*factors)["ic_bn"] = ic_bn;
@@ -317,8 +394,8 @@ void GetConv2d1x1Factors(std::unordered_map<std::string, int> *factors,
       for (int j = oh; j >= 1; j--) {
         if (oh % j == 0 && j * ow_bn <= 16) {
           oh_bn               = j;
-          (*factors)["oh_bn"] = oh_bn;
-          (*factors)["ow_bn"] = ow_bn;
+          (*factors)["oh_bn"] = GetTunableFactor("oh_bn", oh_bn, GetSplitCandidates(oh, 1, 16));
+          (*factors)["ow_bn"] = GetTunableFactor("ow_bn", ow_bn, GetSplitCandidates(ow, 1, bn_base));
           return;
         }
       }
@@ -451,7 +528,8 @@ void Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse(poly::StageMap stages,
                                           const ir::Tensor &input_pad,
                                           const ir::Tensor &weights_dilation,
                                           const ir::Tensor &data,
-                                          const common::Target &target) {
+                                          const common::Target &target,
+                                          const ir::Tensor &epilogue) {
   CHECK(target.arch == Target::Arch::X86) << "Conv2d_NCHWc_Schedule_CPU schedule only used in x86";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
@@ -491,7 +569,7 @@ void Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse(poly::StageMap stages,
   }
 
   // packed_out
-  auto CC = stages[packed_out]->CacheWrite("local", stages, packed_out);
+  auto CC = CacheWriteOrEpilogue(stages, packed_out, epilogue);
   VLOG(4) << "stages[packed_out]->transformed_domain()" << stages[packed_out]->transformed_domain();
   VLOG(4) << "stages[CC]->transformed_domain()" << stages[CC]->transformed_domain();
   // packed_out: [batch, oc_outer, oh, ow, oc_inner]
@@ -556,7 +634,8 @@ void Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                       const ir::Tensor &input_pad,
                                       const ir::Tensor &weights_dilation,
                                       const ir::Tensor &data,
-                                      const common::Target &target) {
+                                      const common::Target &target,
+                                      const ir::Tensor &epilogue) {
   CHECK(target.arch == Target::Arch::X86) << "Conv2d_NCHWc_Schedule_CPU schedule only used in x86";
   CHECK(packed_out.defined());
   CHECK(input_pad.defined());
@@ -592,7 +671,7 @@ void Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
     stages[weights_dilation]->Reorder({2, 1});
   }
   // packed_out
-  auto CC = stages[packed_out]->CacheWrite("local", stages, packed_out);
+  auto CC = CacheWriteOrEpilogue(stages, packed_out, epilogue);
   VLOG(4) << "stages[packed_out]->transformed_domain()" << stages[packed_out]->transformed_domain();
   VLOG(4) << "stages[CC]->transformed_domain()" << stages[CC]->transformed_domain();
   // packed_out: [batch, oc_outer, oh, ow, oc_inner]
@@ -748,7 +827,11 @@ void CudaScheduleMul(poly::StageMap stages,
   return;
 }
 
-void CudaScheduleConv(poly::StageMap stages, ir::Tensor &input_pad, ir::Tensor &output, const common::Target &target) {
+void CudaScheduleConv(poly::StageMap stages,
+                      ir::Tensor &input_pad,
+                      ir::Tensor &output,
+                      const common::Target &target,
+                      const ir::Tensor &epilogue) {
   stages[input_pad]->ComputeInline();
   int n = output->shape[0].as_int32();
   int c = output->shape[1].as_int32();
@@ -764,7 +847,7 @@ void CudaScheduleConv(poly::StageMap stages, ir::Tensor &input_pad, ir::Tensor &
 
   int rc_factor = SplitEven(rc);
 
-  auto OL = stages[output]->CacheWrite("local", stages, output);
+  auto OL = CacheWriteOrEpilogue(stages, output, epilogue);
 
   auto tx        = stages[output]->axis(3);
   auto by        = stages[output]->axis(2);
@@ -825,6 +908,22 @@ void CudaScheduleInjective(poly::Stage *stage, const std::vector<int> &output_sh
   return;
 }
 
+void CudaScheduleReduce(poly::Stage *stage, const std::vector<int> &output_shape, const common::Target &target) {
+  int dims = output_shape.size();
+  for (int i = 1; i < dims; i++) {
+    stage->Fuse(0, 1);
+  }
+  int num_thread = target.max_num_threads();
+  int prod_size  = std::accumulate(output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
+  if (prod_size > num_thread) {
+    stage->Split(0, num_thread);
+    stage->Bind(0, "blockIdx.x");
+    stage->Bind(1, "threadIdx.x");
+  } else {
+    stage->Bind(0, "threadIdx.x");
+  }
+}
+
 void CudaSplitSchedule(poly::Stage *stage, const std::vector<int> &output_shape) {
   if (output_shape.size() > 1 && output_shape[1] >= 512) {
     int temp_split = 1;
@@ -33,6 +33,19 @@ void MulScheduleCPU(poly::StageMap stage,
                     const ir::Tensor &input_tensor,
                     const common::Target &target);
 
+/**
+ * Schedule the reduction of \p input_shape over \p axes by ReduceCPU. The lanes of the partial results are vectorized
+ * and the outermost axis is parallel, or the last axis of \p output is vectorized inside the reduced axes if it is not
+ * reduced.
+ * @param partial The partial results of the two-phase reduction, undefined if it is in one phase.
+ */
+void ReduceScheduleCPU(poly::StageMap stages,
+                       const ir::Tensor &output,
+                       const ir::Tensor &partial,
+                       const std::vector<int> &input_shape,
+                       const std::vector<int> &axes,
+                       const common::Target &target);
+
 void GetConv2dFactors(std::unordered_map<std::string, int> *factors,
                       int oc,
                       int ic,
@@ -55,13 +68,18 @@ void Conv2d_NCHWc_Schedule_CPU(poly::StageMap stages,
                                const ir::Tensor &data,
                                const common::Target &target);
 
+/**
+ * The packed_out is computed into a local buffer, and stored by \p epilogue if defined, an elementwise consumer of it
+ * such as ConvEpilogue::Apply, or by a copy otherwise. Either is returned in \p packed_out.
+ */
 void Conv2d_NCHWc_Schedule_CPU_Nofuse(poly::StageMap stages,
                                       const ir::Tensor &res,
                                       ir::Tensor &packed_out,
                                       const ir::Tensor &input_pad,
                                       const ir::Tensor &weights_dilation,
                                       const ir::Tensor &data,
-                                      const common::Target &target);
+                                      const common::Target &target,
+                                      const ir::Tensor &epilogue = ir::Tensor());
 
 void Conv2d_NCHWc_1X1_Schedule_CPU(poly::StageMap stages,
                                    const ir::Tensor &res,
@@ -77,17 +95,25 @@ void Conv2d_NCHWc_1X1_Schedule_CPU_Nofuse(poly::StageMap stages,
                                           const ir::Tensor &input_pad,
                                           const ir::Tensor &weights_dilation,
                                           const ir::Tensor &data,
-                                          const common::Target &target);
+                                          const common::Target &target,
+                                          const ir::Tensor &epilogue = ir::Tensor());
 
 void CudaScheduleMul(poly::StageMap stages,
                      ir::Tensor output,
                      const std::vector<int> &output_shape,
                      const common::Target &target);
 
-void CudaScheduleConv(poly::StageMap stages, ir::Tensor &input_pad, ir::Tensor &output, const common::Target &target);
+void CudaScheduleConv(poly::StageMap stages,
+                      ir::Tensor &input_pad,
+                      ir::Tensor &output,
+                      const common::Target &target,
+                      const ir::Tensor &epilogue = ir::Tensor());
 
 void CudaScheduleInjective(poly::Stage *stage, const std::vector<int> &output_shape, const common::Target &target);
 
+//! Bind an output of the reduction \p stage to each thread, the reduced axes are looped in the thread.
+void CudaScheduleReduce(poly::Stage *stage, const std::vector<int> &output_shape, const common::Target &target);
+
 void CudaSplitSchedule(poly::Stage *stage, const std::vector<int> &output_shape);
 
 }  // namespace pe
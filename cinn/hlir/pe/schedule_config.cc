@@ -0,0 +1,74 @@
+#include "cinn/hlir/pe/schedule_config.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace cinn {
+namespace hlir {
+namespace pe {
+
+namespace {
+thread_local ScheduleConfig* current_config = nullptr;
+}  // namespace
+
+ScheduleConfig ScheduleConfig::FromString(const std::string& str) {
+  ScheduleConfig config;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) continue;
+    auto pos = item.find('=');
+    CHECK(pos != std::string::npos) << "Invalid schedule config: " << str;
+    config.Set(item.substr(0, pos), std::stoi(item.substr(pos + 1)));
+  }
+  return config;
+}
+
+std::string ScheduleConfig::ToString() const {
+  std::stringstream ss;
+  for (auto& [name, value] : factors_) {
+    if (ss.tellp() > 0) ss << ",";
+    ss << name << "=" << value;
+  }
+  return ss.str();
+}
+
+int ScheduleConfig::Get(const std::string& name, int default_value, const std::vector<int>& candidates) {
+  auto knob = std::find_if(knobs_.begin(), knobs_.end(), [&](const Knob& x) { return x.name == name; });
+  if (knob == knobs_.end()) {
+    knobs_.push_back(Knob{name, default_value, candidates});
+    auto& values = knobs_.back().candidates;
+    if (std::find(values.begin(), values.end(), default_value) == values.end()) values.push_back(default_value);
+    std::sort(values.begin(), values.end());
+  }
+  auto it = factors_.find(name);
+  return it == factors_.end() ? default_value : it->second;
+}
+
+ScheduleConfig* ScheduleConfig::Current() { return current_config; }
+
+ScheduleConfig::Guard::Guard(ScheduleConfig* config) : prev_(current_config) { current_config = config; }
+
+ScheduleConfig::Guard::~Guard() { current_config = prev_; }
+
+int GetTunableFactor(const std::string& name, int default_value, const std::vector<int>& candidates) {
+  auto* config = ScheduleConfig::Current();
+  if (!config) return default_value;
+  int value = config->Get(name, default_value, candidates);
+  VLOG(4) << "Schedule factor " << name << " = " << value << ", the heuristic one is " << default_value;
+  return value;
+}
+
+std::vector<int> GetSplitCandidates(int extent, int min_factor, int max_factor) {
+  std::vector<int> candidates;
+  for (int factor = min_factor; factor <= std::min(extent, max_factor); factor++) {
+    if (extent % factor == 0) candidates.push_back(factor);
+  }
+  return candidates;
+}
+
+}  // namespace pe
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cinn {
+namespace hlir {
+namespace pe {
+
+/**
+ * The tunable factors of the CPU schedules, e.g. the block size of the output width of conv2d. A schedule reads its
+ * factors by GetTunableFactor, the ones not set in the current config fall back to the heuristics.
+ *
+ * The factors only change the schedules, not the shapes of the tensors an op computes, so a config can be applied
+ * after the InferShape pass.
+ */
+class ScheduleConfig {
+ public:
+  //! A factor read by a schedule.
+  struct Knob {
+    std::string name;
+    int default_value{};
+    std::vector<int> candidates;
+  };
+
+  ScheduleConfig() = default;
+
+  //! Parse a config in the format of ToString, e.g. "bk=16,bm=8".
+  static ScheduleConfig FromString(const std::string& str);
+
+  std::string ToString() const;
+
+  void Set(const std::string& name, int value) { factors_[name] = value; }
+
+  const std::map<std::string, int>& factors() const { return factors_; }
+
+  /**
+   * Get the factor \p name, or \p default_value if it is not set. The factor is recorded in the knobs with its
+   * candidates.
+   */
+  int Get(const std::string& name, int default_value, const std::vector<int>& candidates);
+
+  //! The factors read by the schedules lowered with this config, in the order of reading.
+  const std::vector<Knob>& knobs() const { return knobs_; }
+
+  //! The config of the schedules lowered on the current thread, null if none is set.
+  static ScheduleConfig* Current();
+
+  //! Set the config of the schedules lowered on the current thread during the lifetime of the guard.
+  class Guard {
+   public:
+    explicit Guard(ScheduleConfig* config);
+    ~Guard();
+
+   private:
+    ScheduleConfig* prev_;
+  };
+
+ private:
+  std::map<std::string, int> factors_;
+  std::vector<Knob> knobs_;
+};
+
+/**
+ * Get the factor \p name of the current config, or \p default_value got by the heuristics if there is none.
+ * @param candidates The values to try when tuning, \p default_value included.
+ */
+int GetTunableFactor(const std::string& name, int default_value, const std::vector<int>& candidates);
+
+//! The factors of \p extent in [\p min_factor, \p max_factor], as the candidates of a split factor.
+std::vector<int> GetSplitCandidates(int extent, int min_factor, int max_factor);
+
+}  // namespace pe
+}  // namespace hlir
+}  // namespace cinn
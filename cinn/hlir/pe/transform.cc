@@ -6,6 +6,7 @@
 #include "cinn/common/cas.h"
 #include "cinn/common/context.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/hlir/pe/elementwise.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
@@ -108,9 +109,12 @@ std::vector<Tensor> MatmulV2(const Tensor& A,
   } else {
     output_shape = {M, N};
   }
+  // The reduced floats are accumulated in float32, only the result is rounded to the type of the inputs. The int8
+  // inputs are accumulated in int32, which is the result for a dequantize or requantize to follow.
+  Type acc_type = AccumulationType(A->type());
   // array packing
   int shape_B_N = N.as_int32();
-  int bn        = GetArrayPackingFactor(shape_B_N, B->type(), target);
+  int bn        = GetArrayPackingFactor(shape_B_N, acc_type, target);
   // {N / bn, K, bn}
   std::vector<Expr> packedB_shape = {Expr(shape_B_N / bn), y_height, Expr(bn)};
   if (b_dim == 3) {
@@ -155,13 +159,23 @@ std::vector<Tensor> MatmulV2(const Tensor& A,
         if (trans_a) {
           std::swap(indice_a.back(), indice_a[indice_a.size() - 2]);
         }
-        return lang::ReduceSum(A(indice_a) * packedB(indice_b), {reduce_k});
+        Expr a = A(indice_a);
+        Expr b = packedB(indice_b);
+        if (acc_type != A->type()) {
+          a = ir::Cast::Make(acc_type, a);
+          b = ir::Cast::Make(acc_type, b);
+        }
+        return lang::ReduceSum(a * b, {reduce_k});
       },
       UniqName("temp_matmulV2_out"));
-  if (alpha != 1) {
+  if (alpha != 1 || A->type().is_reduced_float()) {
     auto res = Compute(
         output_shape,
-        [=](const std::vector<Expr>& indice) { return temp_res(indice) * make_const(temp_res->type(), alpha); },
+        [=](const std::vector<Expr>& indice) {
+          Expr value = temp_res(indice);
+          if (alpha != 1) value = value * make_const(acc_type, alpha);
+          return A->type().is_reduced_float() ? ir::Cast::Make(A->type(), value) : value;
+        },
         name);
     return {res, temp_res, packedB};
   }
@@ -272,16 +286,22 @@ std::vector<Tensor> MulBase(const Tensor& A, const Tensor& B, const std::string&
   output_shape.push_back(B->shape[0]);
 
   if (target.arch == Target::Arch::X86) {
+    // The int8 inputs are accumulated in int32, which is the result for a dequantize or requantize to follow.
+    Type acc_type    = A->type().is_int(8) ? AccumulationType(A->type()) : A->type();
     int reduce_dim   = A->shape[1].as_int32();
-    int split_factor = GetMulFactor(reduce_dim, A->type(), target);
+    int split_factor = GetMulFactor(reduce_dim, acc_type, target);
     Var reduce_k_first(common::make_const(A->shape[1]->type(), reduce_dim / split_factor), UniqName("reduce_k_first"));
     auto mul_reduce_first = Compute(
         {A->shape[0], B->shape[0], Expr(split_factor)},
         [=](const std::vector<Expr>& indice) {
           CHECK_EQ(indice.size(), 3U) << "indice size should be three while current size is " << indice.size();
-          return lang::ReduceSum(A({indice[0], reduce_k_first * Expr(split_factor) + indice[2]}) *
-                                     B({indice[1], reduce_k_first * Expr(split_factor) + indice[2]}),
-                                 {reduce_k_first});
+          Expr a = A({indice[0], reduce_k_first * Expr(split_factor) + indice[2]});
+          Expr b = B({indice[1], reduce_k_first * Expr(split_factor) + indice[2]});
+          if (acc_type != A->type()) {
+            a = ir::Cast::Make(acc_type, a);
+            b = ir::Cast::Make(acc_type, b);
+          }
+          return lang::ReduceSum(a * b, {reduce_k_first});
         },
         UniqName("mul_reduce_k_first"));
     Var reduce_k_second(common::make_const(A->shape[1]->type(), split_factor), UniqName("reduce_k_second"));
@@ -11,6 +11,7 @@
 #include "cinn/ir/ir_printer.h"
 #include "cinn/lang/lower_impl.h"
 #include "cinn/optim/optimize.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace lang {
@@ -80,6 +81,7 @@ ir::LoweredFunc Lower(const std::string& name,
                       const std::vector<Tensor>& temp_tensors,
                       Module::Builder* b,
                       const Target& target) {
+  utils::RecordEvent event("lang::Lower", "lower");
   // Init the reduce tensors first before any process.
   for (auto& t : tensor_args) InitReduceTensor(stages, t, target);
   for (auto& t : temp_tensors) InitReduceTensor(stages, t, target);
@@ -9,6 +9,7 @@
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/compute_at_postprocess.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace lang {
@@ -71,9 +72,12 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
   // get isl generated expression
   isl::set context(Context::Global().isl_ctx(), "{:}");
   poly::AstGen gen(context, stages, group);
-  isl::ast_node ast = gen.Build();
   ir::Expr e;
-  poly::IslAstNodeToCinnExpr(ast, &e);
+  {
+    utils::RecordEvent event("poly::AstGen", "poly");
+    isl::ast_node ast = gen.Build();
+    poly::IslAstNodeToCinnExpr(ast, &e);
+  }
   // now we get a workable expression, but the statement are something like `B(((16 * po0) + po1), po2)`, we need to
   // transform this to some realworld statement in CINN.
 
@@ -423,9 +427,13 @@ ir::LoweredFunc LowerImpl::operator()() {
     if (!stages_[t]->inlined()) stages.push_back(stages_[t]);
   }
 
-  auto deps     = CollectExtraDependencies();
-  auto schedule = poly::CreateSchedule(
-      stages, poly::ScheduleKind::Poly, std::vector<std::pair<std::string, std::string>>(deps.begin(), deps.end()));
+  auto deps = CollectExtraDependencies();
+  std::unique_ptr<poly::Schedule> schedule;
+  {
+    utils::RecordEvent event("poly::CreateSchedule", "poly");
+    schedule = poly::CreateSchedule(
+        stages, poly::ScheduleKind::Poly, std::vector<std::pair<std::string, std::string>>(deps.begin(), deps.end()));
+  }
 
   auto func_body = GenerateFunctionBody(schedule.get());
 
@@ -468,7 +476,10 @@ ir::LoweredFunc LowerImpl::operator()() {
   auto func = ir::_LoweredFunc_::Make(fn_name_, func_args, func_body, temp_buffers);
 
   // some necessary modification.
-  optim::ComputeInlineExpand(&func->body, stages_, &all_tensor_map);
+  {
+    utils::RecordEvent event("ComputeInlineExpand", "optim");
+    optim::ComputeInlineExpand(&func->body, stages_, &all_tensor_map);
+  }
   Target target = cuda_axis_info_.valid() ? common::DefaultNVGPUTarget() : common::DefaultHostTarget();
   auto res      = optim::Optimize(func, target, FLAGS_cinn_runtime_display_debug_info);
 
@@ -12,6 +12,12 @@ ir::Tensor CreatePlaceHolder(const std::vector<Expr> &shape, Type type, const st
     return Placeholder<double>(name, shape);
   } else if (type == Int(32)) {
     return Placeholder<int32_t>(name, shape);
+  } else if (type == Int(8)) {
+    return Placeholder<int8_t>(name, shape);
+  } else if (type == common::F16()) {
+    return Placeholder<common::float16>(name, shape);
+  } else if (type == common::BF16()) {
+    return Placeholder<common::bfloat16>(name, shape);
   }
   CINN_NOT_IMPLEMENTED
 }
@@ -14,54 +14,67 @@
 #include "cinn/optim/lower_function_call_bind_vars.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
+#include "cinn/optim/promote_reduced_floats.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
 #include "cinn/optim/transform_gpu_forloop.h"
 #include "cinn/optim/transform_polyfor_to_for.h"
 #include "cinn/optim/unroll_loops.h"
 #include "cinn/optim/vectorize_loops.h"
+#include "cinn/utils/profiler.h"
 
 namespace cinn {
 namespace optim {
 
+//! Run the pass \p pass__, recorded by the build profiler.
+#define CINN_RUN_PASS(pass__, ...)                     \
+  {                                                    \
+    utils::RecordEvent pass_event__(#pass__, "optim"); \
+    pass__(__VA_ARGS__);                               \
+  }
+
 Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   CHECK(e.defined());
+  utils::RecordEvent event("optim::Optimize", "optim");
   auto copied = IRCopy(e);
 
-  FoldCINNCallArguments(&copied);
-  TransformPolyForToFor(&copied);
-  ReplaceConstParamToInteger(&copied);
-  CastSimplify(&copied);
-  Simplify(&copied);
-  VectorizeLoops(&copied, Target());
-  UnrollLoop(&copied);
+  CINN_RUN_PASS(FoldCINNCallArguments, &copied);
+  CINN_RUN_PASS(TransformPolyForToFor, &copied);
+  CINN_RUN_PASS(ReplaceConstParamToInteger, &copied);
+  CINN_RUN_PASS(CastSimplify, &copied);
+  CINN_RUN_PASS(Simplify, &copied);
+  CINN_RUN_PASS(VectorizeLoops, &copied, Target());
+  CINN_RUN_PASS(UnrollLoop, &copied, target);
 #ifdef CINN_WITH_CUDA
-  RemoveGpuForloopsAxis(&copied);
-  CudaSyncThreadsDropIfThenElse(&copied);
+  CINN_RUN_PASS(RemoveGpuForloopsAxis, &copied);
+  CINN_RUN_PASS(CudaSyncThreadsDropIfThenElse, &copied);
 #endif
 
-  RemoveNestedBlock(&copied);
+  CINN_RUN_PASS(RemoveNestedBlock, &copied);
 
-  MapExternCall(&copied, target);
-  ExternCallMultiOutputShallowStore(&copied);
+  // Before the math functions are mapped by their types, the ones of the reduced floats are computed in float32.
+  CINN_RUN_PASS(PromoteReducedFloats, &copied, target);
+  CINN_RUN_PASS(MapExternCall, &copied, target);
+  CINN_RUN_PASS(ExternCallMultiOutputShallowStore, &copied);
 
-  CastSimplify(&copied);
-  Simplify(&copied);
-  IfSimplify(&copied);
+  CINN_RUN_PASS(CastSimplify, &copied);
+  CINN_RUN_PASS(Simplify, &copied);
+  CINN_RUN_PASS(IfSimplify, &copied);
 
   if (runtime_debug_info) {
     LOG(WARNING) << "Turn on runtime debug information output";
-    InsertDebugLogCallee(&copied);
+    CINN_RUN_PASS(InsertDebugLogCallee, &copied);
   }
   return copied;
 }
 
 ir::Module Optimize(const ir::Module& module, const Target& target) {
+  utils::RecordEvent event("optim::Optimize(module)", "optim");
   auto copied = IRCopy(Expr(module));
 
-  LowerFunctionCallBindVars(&copied);
-  CallArgListToPodValue(&copied);
-  LowerIntrin(&copied, target);
+  CINN_RUN_PASS(LowerFunctionCallBindVars, &copied);
+  CINN_RUN_PASS(CallArgListToPodValue, &copied);
+  CINN_RUN_PASS(LowerIntrin, &copied, target);
 
   return copied.as_module_ref();
 }
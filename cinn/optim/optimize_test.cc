@@ -2,7 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "cinn/cinn.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/utils/string.h"
 
@@ -39,5 +42,56 @@ TEST(Optimize, Unroll) {
   EXPECT_EQ(utils::Trim(out), utils::Trim(utils::GetStreamCnt(func->body)));
 }
 
+TEST(Optimize, UnrollPartial) {
+  Placeholder<float> A("A", {100, 67});
+
+  auto C      = Compute({Expr(100), Expr(67)}, [&](Var i, Var j) { return A(i, j) + 1.f; });
+  auto stages = CreateStages({C});
+  stages[C]->Unroll(1);
+
+  // j is too long to unroll completely, it is unrolled by 8 with the remaining 3 iterations unrolled after the loop.
+  auto func   = Lower("fn", stages, {A, C});
+  auto stores = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::Store>(); });
+  auto loops  = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::For>(); });
+  EXPECT_EQ(stores.size(), 8UL + 3UL);
+  EXPECT_EQ(loops.size(), 2UL);
+}
+
+TEST(Optimize, UnrollAndJam) {
+  Placeholder<float> A("A", {48, 64});
+
+  auto C      = Compute({Expr(48), Expr(64)}, [&](Var i, Var j) { return A(i, j) + 1.f; });
+  auto stages = CreateStages({C});
+  stages[C]->Unroll(0);
+
+  // The copies of the body of i are jammed into j, as many as the registers allow, and at most 8.
+  auto func = Lower("fn", stages, {A, C});
+  LOG(INFO) << "fn:\n" << func;
+  auto stores = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::Store>(); });
+  auto loops  = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::For>(); });
+  EXPECT_EQ(stores.size(), 8UL);
+  ASSERT_EQ(loops.size(), 2UL);
+  auto is_outer = [](const Expr& x) { return x.As<ir::For>()->extent.as_int32() == 6; };
+  EXPECT_TRUE(std::any_of(loops.begin(), loops.end(), is_outer));
+}
+
+TEST(Optimize, UnrollAndJamSplit) {
+  Placeholder<float> A("A", {64, 8});
+
+  auto C      = Compute({Expr(64), Expr(8)}, [&](Var i, Var j) { return A(i, j) + 1.f; });
+  auto stages = CreateStages({C});
+  stages[C]->Split(0, 4);
+  stages[C]->Unroll(1);
+
+  // The stores of C are at (4 * i_outer + i_inner, j), distinct for each i_inner, so i_inner is jammed into j.
+  auto func   = Lower("fn", stages, {A, C});
+  auto stores = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::Store>(); });
+  auto loops  = ir::CollectIRNodes(func->body, [](const Expr* x) { return x->As<ir::For>(); });
+  EXPECT_EQ(stores.size(), 4UL);
+  ASSERT_EQ(loops.size(), 2UL);
+  auto is_inner = [](const Expr& x) { return x.As<ir::For>()->extent.as_int32() == 8; };
+  EXPECT_TRUE(std::any_of(loops.begin(), loops.end(), is_inner));
+}
+
 }  // namespace optim
 }  // namespace cinn
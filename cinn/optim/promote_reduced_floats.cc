@@ -0,0 +1,78 @@
+#include "cinn/optim/promote_reduced_floats.h"
+
+#include <glog/logging.h>
+
+#include "cinn/ir/ir_mutator.h"
+
+namespace cinn::optim {
+
+namespace {
+
+//! \p value of a reduced float as a float32.
+Expr ToFloat(const Expr& value) {
+  if (auto* imm = value.As<ir::FloatImm>()) return Expr(static_cast<float>(imm->value));
+  return ir::Cast::Make(Float(32, value.type().lanes()), value);
+}
+
+struct Mutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+#define __(op__) void Visit(const ir::op__* op, Expr* expr) override { PromoteBinary<ir::op__>(expr); }
+  __(Add)
+  __(Sub)
+  __(Mul)
+  __(Div)
+  __(Min)
+  __(Max)
+  __(EQ)
+  __(NE)
+  __(LT)
+  __(LE)
+  __(GT)
+  __(GE)
+#undef __
+
+  void Visit(const ir::Minus* op, Expr* expr) override {
+    auto* node = expr->As<ir::Minus>();
+    Visit(&node->v(), &node->v());
+    if (!node->v().type().is_reduced_float()) return;
+    *expr = ir::Cast::Make(node->type(), ir::Minus::Make(ToFloat(node->v())));
+  }
+
+  void Visit(const ir::Call* op, Expr* expr) override {
+    auto* node = expr->As<ir::Call>();
+    for (auto& arg : node->read_args) Visit(&arg, &arg);
+    for (auto& arg : node->write_args) Visit(&arg, &arg);
+    // The math functions of the reduced floats are the ones of float32.
+    if (!node->is_extern_call() || !node->type().is_reduced_float()) return;
+    Type type = node->type();
+    for (auto& arg : node->read_args) {
+      if (arg.type().is_reduced_float()) arg = ToFloat(arg);
+    }
+    node->set_type(Float(32, type.lanes()));
+    *expr = ir::Cast::Make(type, *expr);
+  }
+
+ private:
+  template <typename T>
+  void PromoteBinary(Expr* expr) {
+    auto* node = expr->As<T>();
+    Visit(&node->a(), &node->a());
+    Visit(&node->b(), &node->b());
+    if (!node->a().type().is_reduced_float()) return;
+    Type type = node->type();
+    *expr     = T::Make(ToFloat(node->a()), ToFloat(node->b()));
+    if (type.is_reduced_float()) *expr = ir::Cast::Make(type, *expr);
+  }
+};
+
+}  // namespace
+
+void PromoteReducedFloats(Expr* e, Target target) {
+  if (target.arch == Target::Arch::X86) {
+    Mutator mutator;
+    mutator.Visit(e, e);
+  }
+}
+
+}  // namespace cinn::optim
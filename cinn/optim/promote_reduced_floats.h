@@ -0,0 +1,24 @@
+#pragma once
+#include "cinn/ir/ir.h"
+
+namespace cinn::optim {
+
+/**
+ * Compute the arithmetic on the reduced floats, float16 and bfloat16, in float32 for the llvm codegen, which keeps
+ * the bfloat16 values as their bits and has no native arithmetic of float16 on x86. The operands are cast to float32,
+ * and the result is rounded back to the reduced float, as each op of the reduced float does.
+ *
+ * e.g.
+ *
+ * The expression:
+ * C[i] = A[i] + B[i]
+ *
+ * to
+ *
+ * C[i] = bfloat16(float32(A[i]) + float32(B[i]))
+ *
+ * The loads, stores and selects of the reduced floats are left.
+ */
+void PromoteReducedFloats(Expr* e, Target target);
+
+}  // namespace cinn::optim
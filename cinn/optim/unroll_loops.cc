@@ -1,57 +1,330 @@
 #include "cinn/optim/unroll_loops.h"
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include "cinn/common/cas.h"
+#include "cinn/common/context.h"
+#include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_mutator.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/optim/ir_copy.h"
 #include "cinn/optim/ir_replace.h"
+#include "cinn/utils/string.h"
 
 namespace cinn {
 namespace optim {
 
 namespace {
 
+//! The loops of a constant extent up to it are unrolled completely if the unrolled body is small enough.
+constexpr int kMaxFullUnrollExtent = 50;
+//! The most IR nodes of the unrolled body of a loop, which bounds the code size.
+constexpr int kMaxUnrolledSize = 512;
+//! The most copies of the body in a loop unrolled partially.
+constexpr int kMaxUnrollFactor = 8;
+//! The pseudo var of the lanes of a ramp in an AffineIndex.
+constexpr char kLaneVar[] = "$lane";
+
+bool UsesVar(const Expr& expr, const Var& var) {
+  return !ir::CollectIRNodes(expr, [&](const Expr* x) { return x->as_var() && x->as_var()->name == var->name; })
+              .empty();
+}
+
+bool UsesVar(const std::vector<Expr>& exprs, const Var& var) {
+  return std::any_of(exprs.begin(), exprs.end(), [&](const Expr& e) { return UsesVar(e, var); });
+}
+
+std::string AccessKey(const std::string& tensor_name, const std::vector<Expr>& indices) {
+  return tensor_name + "[" + utils::Join(indices, ", ") + "]";
+}
+
+int BodySize(const Expr& body) {
+  return ir::CollectIRNodes(body, [](const Expr* x) { return true; }).size();
+}
+
+//! The number of the vector registers the distinct elements \p body loads or stores that vary with \p var take, each
+//! copy of the body keeps them in registers.
+int LiveRegisters(const Expr& body, const Var& var, const Target& target) {
+  int vector_bits = target.vector_bits();
+  std::unordered_map<std::string, int> registers;
+  auto add = [&](const std::string& key, const Type& type) {
+    int bits       = type.bits() * type.lanes();
+    registers[key] = vector_bits > 0 ? (bits + vector_bits - 1) / vector_bits : 1;
+  };
+  ir::CollectIRNodes(body, [&](const Expr* x) {
+    if (auto* load = x->As<ir::Load>()) {
+      if (load->is_addr_tensor() && UsesVar(load->indices, var)) add(AccessKey(load->name(), load->indices), x->type());
+    } else if (auto* store = x->As<ir::Store>()) {
+      if (store->is_addr_tensor() && UsesVar(store->indices, var)) {
+        add(AccessKey(store->tensor.as_tensor()->name, store->indices), store->value.type());
+      }
+    }
+    return false;
+  });
+  int res = 0;
+  for (auto& [key, num] : registers) res += num;
+  return std::max(res, 1);
+}
+
+//! An index in the form of sum(coefficients[var] * var) + constant, the vars other than the loop vars are symbols.
+struct AffineIndex {
+  std::map<std::string, int64_t> coefficients;
+  int64_t constant{};
+
+  bool operator==(const AffineIndex& other) const {
+    return coefficients == other.coefficients && constant == other.constant;
+  }
+
+  int64_t coefficient(const std::string& var) const {
+    auto it = coefficients.find(var);
+    return it == coefficients.end() ? 0 : it->second;
+  }
+};
+
+/**
+ * Get \p expr in the affine form, with the lanes of a ramp as the var kLaneVar, scaled by \p scale.
+ * @return false if \p expr is not affine.
+ */
+bool GetAffineIndex(const Expr& expr, int64_t scale, AffineIndex* res) {
+  if (expr.is_constant() && expr.type().is_int()) {
+    res->constant += scale * expr.as_int64();
+  } else if (auto* var = expr.as_var()) {
+    res->coefficients[var->name] += scale;
+  } else if (auto* add = expr.As<ir::Add>()) {
+    return GetAffineIndex(add->a(), scale, res) && GetAffineIndex(add->b(), scale, res);
+  } else if (auto* sub = expr.As<ir::Sub>()) {
+    return GetAffineIndex(sub->a(), scale, res) && GetAffineIndex(sub->b(), -scale, res);
+  } else if (auto* minus = expr.As<ir::Minus>()) {
+    return GetAffineIndex(minus->v(), -scale, res);
+  } else if (auto* mul = expr.As<ir::Mul>()) {
+    auto is_int = [](const Expr& e) { return e.is_constant() && e.type().is_int(); };
+    if (is_int(mul->b())) return GetAffineIndex(mul->a(), scale * mul->b().as_int64(), res);
+    if (is_int(mul->a())) return GetAffineIndex(mul->b(), scale * mul->a().as_int64(), res);
+    return false;
+  } else if (auto* ramp = expr.As<ir::Ramp>()) {
+    if (!(ramp->stride.is_constant() && ramp->stride.type().is_int())) return false;
+    res->coefficients[kLaneVar] += scale * ramp->stride.as_int64();
+    return GetAffineIndex(ramp->base, scale, res);
+  } else if (auto* broadcast = expr.As<ir::Broadcast>()) {
+    return GetAffineIndex(broadcast->value, scale, res);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Whether the accesses of the same tensor at \p a and \p b touch distinct elements in distinct iterations of \p var,
+ * so jamming the iterations of \p var does not reorder a dependence. That holds if some dimension of both is the same
+ * affine index with a nonzero coefficient on \p var and none on the \p inner_vars, which vary within an iteration.
+ */
+bool IndependentAcrossIterations(const std::vector<Expr>& a,
+                                 const std::vector<Expr>& b,
+                                 const Var& var,
+                                 const std::unordered_set<std::string>& inner_vars) {
+  if (a.size() != b.size()) return false;
+  for (int i = 0; i < a.size(); i++) {
+    AffineIndex index_a, index_b;
+    if (!GetAffineIndex(common::AutoSimplify(a[i]), 1, &index_a) ||
+        !GetAffineIndex(common::AutoSimplify(b[i]), 1, &index_b) || !(index_a == index_b)) {
+      continue;
+    }
+    if (index_a.coefficient(var->name) == 0) continue;
+    bool invariant = std::none_of(index_a.coefficients.begin(), index_a.coefficients.end(), [&](auto& item) {
+      return item.second != 0 && (item.first == kLaneVar || inner_vars.count(item.first));
+    });
+    if (invariant) return true;
+  }
+  return false;
+}
+
+/**
+ * The loops perfectly nested in \p op, from the outermost, if the copies of the body of \p op can be jammed into the
+ * innermost one. That is the loops are serial with bounds independent of the loop var of \p op, and no two distinct
+ * iterations of \p op access the same element of a tensor stored in the body, see IndependentAcrossIterations; the
+ * accesses in the same iteration keep their order.
+ */
+std::vector<const ir::For*> GetJamNest(const ir::For* op) {
+  std::vector<const ir::For*> nest;
+  Expr body = op->body;
+  while (true) {
+    auto* block = body.As<ir::Block>();
+    if (block && block->stmts.size() == 1) body = block->stmts[0];
+    auto* inner = body.As<ir::For>();
+    if (!inner) break;
+    if (!(inner->is_serial() || inner->for_type() == ir::ForType::Unrolled)) return {};
+    if (UsesVar(inner->min, op->loop_var) || UsesVar(inner->extent, op->loop_var)) return {};
+    nest.push_back(inner);
+    body = inner->body;
+  }
+  if (nest.empty()) return {};
+
+  // The vars of the loops in the body, the nest and the ones below it.
+  std::unordered_set<std::string> inner_vars;
+  std::unordered_map<std::string, std::vector<const std::vector<Expr>*>> stores;
+  bool legal = true;
+  ir::CollectIRNodes(op->body, [&](const Expr* x) {
+    if (auto* loop = x->As<ir::For>()) inner_vars.insert(loop->loop_var->name);
+    if (auto* store = x->As<ir::Store>()) {
+      legal = legal && store->is_addr_tensor();
+      if (legal) stores[store->tensor.as_tensor()->name].push_back(&store->indices);
+    }
+    return false;
+  });
+  if (!legal) return {};
+  ir::CollectIRNodes(op->body, [&](const Expr* x) {
+    const std::vector<Expr>* indices = nullptr;
+    std::string name;
+    if (auto* load = x->As<ir::Load>()) {
+      if (load->is_addr_tensor()) {
+        indices = &load->indices;
+        name    = load->name();
+      }
+    } else if (auto* store = x->As<ir::Store>()) {
+      indices = &store->indices;
+      name    = store->tensor.as_tensor()->name;
+    }
+    if (legal && indices && stores.count(name)) {
+      for (auto* stored : stores.at(name)) {
+        legal = legal && IndependentAcrossIterations(*stored, *indices, op->loop_var, inner_vars);
+      }
+    }
+    return false;
+  });
+  if (!legal) return {};
+  return nest;
+}
+
+/**
+ * The number of the copies of the body to unroll a loop of \p trip_count iterations into, all of them if it is small,
+ * or by the size of \p body, which is jammed into the inner loops if \p jam is set, and the vector registers of
+ * \p target its copies take. Returns 1 if the loop is not worth unrolling.
+ */
+int GetUnrollFactor(int trip_count, const Expr& body, const Var& var, bool jam, const Target& target) {
+  int size = BodySize(body);
+  int live = LiveRegisters(body, var, target);
+  // The targets of no vector registers, e.g. NVGPU, bound the copies by the code size only.
+  int num_registers = target.num_vector_registers() > 0 ? target.num_vector_registers() : kMaxUnrollFactor * live;
+  // The copies jammed into an inner loop are live together for all its iterations.
+  bool fits = !jam || trip_count * live <= num_registers;
+  if (trip_count > 0 && trip_count <= kMaxFullUnrollExtent && trip_count * size <= kMaxUnrolledSize && fits) {
+    return trip_count;
+  }
+  int limit = std::min({kMaxUnrollFactor, kMaxUnrolledSize / size, num_registers / live});
+  if (trip_count > 0) limit = std::min(limit, trip_count / 2);
+  if (limit < 2) return 1;
+  // A factor dividing the trip count leaves no remainder.
+  if (trip_count > 0) {
+    for (int factor = limit; factor > limit / 2; factor--) {
+      if (trip_count % factor == 0) return factor;
+    }
+  }
+  int factor = 1;
+  while (factor * 2 <= limit) factor *= 2;
+  return factor;
+}
+
+//! The copies of \p body for \p var being \p base + i, i in [0, \p count).
+Expr Replicate(const Expr& body, const Var& var, Expr base, int count) {
+  std::vector<Expr> copies;
+  for (int i = 0; i < count; i++) {
+    copies.push_back(optim::IRCopy(body));
+    optim::IrReplace(&copies.back(), var, common::AutoSimplify(base + i));
+  }
+  return ir::Block::Make(copies);
+}
+
 struct UnrollMutator : public ir::IRMutator<Expr*> {
+  explicit UnrollMutator(const Target& target) : target_(target) {}
+
   void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
 
  private:
+  Target target_;
+
   void Visit(const ir::For* op, Expr* expr) override {
-    if (is_unrollable(op)) {
-      Unroll(op, expr);
-      IRMutator<>::Visit(expr, expr);
-    } else {
-      auto* node = expr->As<ir::For>();
-      ir::IRMutator<>::Visit(&node->body, &node->body);
+    if (op->is_unrolled()) {
+      if (Unroll(op, expr)) {
+        IRMutator<>::Visit(expr, expr);
+        return;
+      }
+      expr->As<ir::For>()->set_unrolled(false);
     }
+    auto* node = expr->As<ir::For>();
+    ir::IRMutator<>::Visit(&node->body, &node->body);
   }
 
-  bool is_unrollable(const ir::For* op) const {
-    return op->is_unrolled() && op->extent.is_constant() && op->extent.as_int32() < 50;
-  }
-
-  //! Unroll a forloop.
-  void Unroll(const ir::For* op, Expr* expr) {
-    std::vector<Expr> body;
+  /**
+   * Unroll a forloop by the factor of GetUnrollFactor, completely or partially with a remainder. An outer loop is
+   * unrolled and jammed, that is the copies of its body are put into the innermost loop nested, for the values they
+   * reuse to stay in the registers. Returns false if the loop is left.
+   */
+  bool Unroll(const ir::For* op, Expr* expr) {
+    Expr trip      = common::AutoSimplify(op->extent - op->min);
+    int trip_count = trip.is_constant() ? trip.as_int32() : -1;
+    if (trip_count == 0) return false;
 
-    auto* min    = op->min.As<ir::IntImm>();
-    auto* extent = op->extent.As<ir::IntImm>();
-    if (!(min && extent)) return;
+    auto nest        = GetJamNest(op);
+    const Expr& body = nest.empty() ? op->body : nest.back()->body;
+    int factor       = GetUnrollFactor(trip_count, body, op->loop_var, !nest.empty(), target_);
+    if (factor <= 1) return false;
+    VLOG(3) << "Unroll " << op->loop_var << " of " << trip << " iterations by " << factor
+            << (nest.empty() ? "" : ", jammed into " + nest.back()->loop_var->name);
 
-    for (int i = min->value; i < extent->value; i++) {
-      Expr start = op->min + i;
-      body.push_back(optim::IRCopy(op->body));
-      optim::IrReplace(&body.back(), op->loop_var, start);
+    // The copies of the body for the iterations from base, jammed into a copy of the nest if there is.
+    auto unrolled_body = [&](Expr base) {
+      if (nest.empty()) return Replicate(op->body, op->loop_var, base, factor);
+      Expr jammed = Replicate(nest.back()->body, op->loop_var, base, factor);
+      for (int i = nest.size() - 1; i >= 0; i--) {
+        jammed = ir::For::Make(nest[i]->loop_var,
+                               nest[i]->min,
+                               nest[i]->extent,
+                               nest[i]->for_type(),
+                               nest[i]->device_api,
+                               ir::Block::Make({jammed}),
+                               nest[i]->vectorize_info());
+      }
+      return ir::Block::Make({jammed});
+    };
+    if (factor == trip_count) {
+      *expr = unrolled_body(op->min);
+      return true;
     }
 
-    *expr = ir::Block::Make(body);
+    Var outer(common::UniqName(op->loop_var->name + "_outer"));
+    Expr count = common::AutoSimplify(trip / factor);
+    Expr main  = ir::For::Make(outer,
+                              common::make_const(0),
+                              count,
+                              op->for_type(),
+                              op->device_api,
+                              unrolled_body(op->min + Expr(outer) * factor),
+                              op->vectorize_info());
+    main.As<ir::For>()->set_unrolled(false);
+    std::vector<Expr> stmts{main};
+    // The remainder runs the original body, unrolled if the number of its iterations is known.
+    Expr rest_min = common::AutoSimplify(op->min + count * factor);
+    if (trip_count > 0) {
+      if (trip_count % factor > 0) stmts.push_back(Replicate(op->body, op->loop_var, rest_min, trip_count % factor));
+    } else {
+      stmts.push_back(ir::For::Make(
+          op->loop_var, rest_min, op->extent, ir::ForType::Serial, op->device_api, optim::IRCopy(op->body)));
+    }
+    *expr = ir::Block::Make(stmts);
+    return true;
   }
 };
 
 }  // namespace
 
-void UnrollLoop(Expr* expr) { UnrollMutator()(expr); }
+void UnrollLoop(Expr* expr, const Target& target) { UnrollMutator(target)(expr); }
 
 }  // namespace optim
 }  // namespace cinn
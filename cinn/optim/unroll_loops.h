@@ -4,7 +4,10 @@
 namespace cinn {
 namespace optim {
 
-void UnrollLoop(Expr* expr);
+/**
+ * Unroll the forloops marked unrolled, by factors bounded by the code size and the vector registers of \p target.
+ */
+void UnrollLoop(Expr* expr, const Target& target);
 
 }  // namespace optim
 }  // namespace cinn
@@ -404,16 +404,41 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
 
       vectorizable_ = true;
       IRMutator<>::Visit(&node->body, &node->body);
-      if (extent_min || extent_max || !vectorizable_) {
-        // not vectorize if has tail blocks, for llvm to optimize
+      const int factor = forloop->vectorize_info().factor;
+      // The inner loop of a split with a tail, e.g. min(16, 1000 - 16 * j_outer), is vectorized by its full extent,
+      // but in the last iterations of the outer loop, which run a scalar copy of it instead.
+      Expr full_cond, scalar_loop;
+      if (extent_min && vectorizable_) {
+        Expr full = extent_min->a().is_constant() ? extent_min->a() : extent_min->b();
+        Expr rest = extent_min->a().is_constant() ? extent_min->b() : extent_min->a();
+        if (full.is_constant() && full.as_int32() >= factor) {
+          full_cond   = GE::Make(rest, full);
+          scalar_loop = For::Make(
+              node->loop_var, node->min, for_extent, ForType::Serial, node->device_api, IRCopy(node->body));
+          node->extent = full;
+          extent_min   = nullptr;
+          var_intervals.erase(forloop->loop_var->name);
+          var_intervals.emplace(forloop->loop_var->name, common::CasInterval{0, full.as_int32() - 1});
+        }
+      }
+      auto with_tail = [&] {
+        if (full_cond.defined()) *expr = IfThenElse::Make(full_cond, Block::Make({*expr}), Block::Make({scalar_loop}));
+      };
+      bool too_short = node->extent.is_constant() && node->extent.as_int32() < factor;
+      if (extent_min || extent_max || !vectorizable_ || too_short) {
+        // not vectorize if has tail blocks of unknown extents, for llvm to optimize
         node->reset_vectorize_info();
         var_intervals.erase(forloop->loop_var->name);
         return;
       }
 
-      auto _new_forloop = SplitForLoop(node, forloop->vectorize_info().factor);
+      // The iterations beyond the multiple of the factor run in a scalar loop after it.
+      Expr remainder;
+      auto _new_forloop = SplitForLoop(node, factor, &remainder);
       if (!_new_forloop.defined()) {
         IRMutator<>::Visit(&node->body, &node->body);
+        if (remainder.defined()) *expr = Block::Make({*expr, remainder});
+        with_tail();
         var_intervals.erase(forloop->loop_var->name);
         return;
       }
@@ -428,6 +453,8 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
 
       if (!extent_int) {
         IRMutator<>::Visit(&node->body, &node->body);
+        if (remainder.defined()) *expr = Block::Make({*expr, remainder});
+        with_tail();
         var_intervals.erase(forloop->loop_var->name);
         return;
       }
@@ -445,6 +472,8 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
 
       // Remove the forloop, the new_forloop's body is vectorized to Ramp, so no forloop is needed.
       node->body = new_forloop->body;
+      if (remainder.defined()) *expr = Block::Make({*expr, remainder});
+      with_tail();
     } else {
       IRMutator::Visit(forloop, expr);
     }
@@ -516,9 +545,10 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
-  //! Split the forloop with size \p factor.
+  //! Split the forloop with size \p factor, the iterations beyond the multiple of \p factor are put into the serial
+  //! loop \p remainder, which is left undefined if there is none.
   //! @return The new forloop.
-  Expr SplitForLoop(For *forloop, int factor) {
+  Expr SplitForLoop(For *forloop, int factor, Expr *remainder) {
     CHECK_GT(factor, 1);
     auto *for_min_i = forloop->min.As<IntImm>();
     CHECK(forloop);
@@ -528,14 +558,17 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     auto *extent_ptr = forloop->extent.As<IntImm>();
     Expr times;
     if (extent_ptr) {
-      int extent_int   = forloop->extent.as_int32();
-      int extent_trunc = extent_int / factor;
-      int extent_times = extent_int % factor == 0 ? extent_trunc : extent_trunc + 1;
-      times            = common::make_const(forloop->extent->type(), extent_times);
+      times = common::make_const(forloop->extent->type(), forloop->extent.as_int32() / factor);
     } else {
       times = common::AutoSimplify(Div::Make(forloop->extent, make_const(factor)));
       Simplify(&times);
     }
+    bool divisible = extent_ptr && extent_ptr->value % factor == 0;
+    if (!divisible) {
+      Expr rest_min = common::AutoSimplify(times * factor);
+      *remainder    = For::Make(
+          forloop->loop_var, rest_min, forloop->extent, ForType::Serial, forloop->device_api, IRCopy(forloop->body));
+    }
 
     // update the current forloop
     auto times_int = times.As<IntImm>();
@@ -7,6 +7,7 @@
 #include "cinn/cinn.h"
 #include "cinn/common/common.h"
 #include "cinn/common/ir_util.h"
+#include "cinn/ir/collect_ir_nodes.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/optim/ir_simplify.h"
 #include "cinn/optim/optimize.h"
@@ -65,9 +66,12 @@ void matmul(void* _args, int32_t num_args)
   const float* B = ((const float*)(_B->memory));
   float* C = ((float*)(_C->memory));
   for (int32_t i = 0; i < 100; i += 1) {
-    for (int32_t j = 0; j < 32; j += 1) {
+    for (int32_t j = 0; j < 31; j += 1) {
       C[StackVec<16,int32_t>::Ramp(((500 * i) + (16 * j)), 1, 16)] = (StackedVec<float,16>::Load(A,((500 * i) + (16 * j))) * StackedVec<float,16>::Load(B,((500 * i) + (16 * j))));
     };
+    for (int32_t j = 496; j < 500; j += 1) {
+      C[((500 * i) + j)] = (A[((500 * i) + j)] * B[((500 * i) + j)]);
+    };
   };
   cinn_buffer_free((void*)(0), _C);
 }
@@ -218,5 +222,26 @@ TEST(Vectorize, single_for) {
   LOG(INFO) << "Forloop\n" << forloop;
 }
 
+TEST(Vectorize, split_tail) {
+  Placeholder<float> A("A", {Expr(100), Expr(1000)});
+
+  Tensor C = Compute(
+      {Expr(100), Expr(1000)}, [&](Var i, Var j) { return A(i, j) + 1.f; }, "C");
+
+  auto stages = CreateStages({C});
+  // The last iteration of j_outer has 8 elements of j_inner.
+  stages[C]->Split(1, 16);
+  stages[C]->Vectorize(2, 16);
+
+  auto func = Lower("fn", stages, {A, C});
+  LOG(INFO) << "fn:\n" << func;
+
+  // The full iterations are vectorized, the last one runs a scalar loop.
+  auto ramps   = ir::CollectIRNodes(func->body, [](const Expr *x) { return x->As<ir::Ramp>(); });
+  auto if_else = ir::CollectIRNodes(func->body, [](const Expr *x) { return x->As<ir::IfThenElse>(); });
+  EXPECT_FALSE(ramps.empty());
+  EXPECT_EQ(if_else.size(), 1UL);
+}
+
 }  // namespace optim
 }  // namespace cinn
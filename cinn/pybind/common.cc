@@ -93,6 +93,7 @@ void BindType(py::module *m) {
       .value("int", Type::type_t::Int)
       .value("uInt", Type::type_t::UInt)
       .value("float", Type::type_t::Float)
+      .value("bfloat", Type::type_t::BFloat)
       .value("string", Type::type_t::String)
       .value("void", Type::type_t::Void)
       .value("customized", Type::type_t::Customized)
@@ -141,6 +142,8 @@ void BindType(py::module *m) {
   m->def("type_of", [](std::string_view dtype) {
     if (dtype == "float32") return common::type_of<float>();
     if (dtype == "float64") return common::type_of<double>();
+    if (dtype == "float16") return common::F16();
+    if (dtype == "bfloat16") return common::BF16();
     if (dtype == "uchar") return common::type_of<unsigned char>();
     if (dtype == "int8") return common::type_of<int8_t>();
     if (dtype == "int16") return common::type_of<int16_t>();
@@ -114,6 +114,7 @@ void BindCinnRuntime(py::module *m) {
       .value("cinn_type_uint", cinn_type_uint)
       .value("cinn_type_float", cinn_type_float)
       .value("cinn_type_handle", cinn_type_handle)
+      .value("cinn_type_bfloat", cinn_type_bfloat)
       .export_values();
 
   py::class_<cinn_type_t> cinn_type(*m, "cinn_type_t");
@@ -2,9 +2,6 @@
 
 #include <vector>
 
-#include "cinn/backends/extern_func_jit_register.h"
-#include "cinn/common/cas.h"
-
 namespace {
 
 inline CBLAS_TRANSPOSE ToCblasTranspose(bool trans) { return trans ? CblasTrans : CblasNoTrans; }
@@ -85,89 +82,3 @@ void cinn_cpu_mkl_gemm_batch_fp32(float alpha,
                     1,
                     &batch_size);
 }
-
-CINN_REGISTER_HELPER(cinn_cpu_mkl) {
-  using namespace cinn;  // NOLINT
-  using backends::FunctionProto;
-  auto host_target = common::DefaultHostTarget();
-
-  FunctionProto::shape_inference_t inference_shape_gemm = [](const std::vector<Expr>& args, int offset) {
-    CHECK_EQ(offset, 0UL) << "Only one output";
-    CHECK_EQ(args.size(), 12UL) << "Wrong number of arguments passed in";
-    auto M = common::AutoSimplify(args[1]);
-    auto N = common::AutoSimplify(args[2]);
-    std::vector<Expr> shape;
-    shape.push_back(M);
-    shape.push_back(N);
-    return shape;
-  };
-
-  FunctionProto::shape_inference_t inference_shape_gemm_batch = [](const std::vector<Expr>& args, int offset) {
-    CHECK_EQ(offset, 0UL) << "Only one output";
-    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
-    auto& A       = args[14];
-    auto A_tensor = A.as_tensor();
-    CHECK(A_tensor);
-
-    auto batch_size        = common::AutoSimplify(args[1]);
-    int32_t batch_size_val = batch_size.as_int32();
-
-    auto M = common::AutoSimplify(args[2]);
-    auto N = common::AutoSimplify(args[3]);
-
-    std::vector<Expr> shape;
-    int total = 1;
-    for (auto& v : A_tensor->shape) {
-      auto val = common::AutoSimplify(v);
-      CHECK(val.is_constant());
-      shape.push_back(val);
-      total *= val.as_int32();
-      if (total >= batch_size_val) break;
-    }
-    shape.push_back(M);
-    shape.push_back(N);
-    return shape;
-  };
-
-  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_fp32, host_target)
-      .SetRetType<void>()
-      .AddInputType<float>()            // alpha
-      .AddInputType<int>()              // M
-      .AddInputType<int>()              // N
-      .AddInputType<int>()              // K
-      .AddInputType<bool>()             // ta
-      .AddInputType<bool>()             // tb
-      .AddInputType<int>()              // lda
-      .AddInputType<int>()              // ldb
-      .AddInputType<int>()              // ldc
-      .AddInputType<float>()            // beta
-      .AddInputType<cinn_buffer_t*>()   // A
-      .AddInputType<cinn_buffer_t*>()   // B
-      .AddOutputType<cinn_buffer_t*>()  // C
-      .SetShapeInference(inference_shape_gemm)
-      .End();
-
-  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_batch_fp32, host_target)
-      .SetRetType<void>()
-      .AddInputType<float>()            // alpha
-      .AddInputType<int>()              // batch
-      .AddInputType<int>()              // M
-      .AddInputType<int>()              // N
-      .AddInputType<int>()              // K
-      .AddInputType<bool>()             // ta
-      .AddInputType<bool>()             // tb
-      .AddInputType<int>()              // lda
-      .AddInputType<int>()              // ldb
-      .AddInputType<int>()              // ldc
-      .AddInputType<int>()              // a_stride
-      .AddInputType<int>()              // b_stride
-      .AddInputType<int>()              // c_stride
-      .AddInputType<float>()            // beta
-      .AddInputType<cinn_buffer_t*>()   // A
-      .AddInputType<cinn_buffer_t*>()   // B
-      .AddOutputType<cinn_buffer_t*>()  // C
-      .SetShapeInference(inference_shape_gemm_batch)
-      .End();
-
-  return true;
-}
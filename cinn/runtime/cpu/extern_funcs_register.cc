@@ -0,0 +1,242 @@
+// The registrations of the extern functions of CPU to the JIT. They are apart from the definitions, which build into
+// cinn_runtime_cpu with no LLVM for the processes only loading the libraries exported ahead of time.
+#include <vector>
+
+#include "cinn/backends/extern_func_jit_register.h"
+#include "cinn/backends/function_prototype.h"
+#include "cinn/backends/llvm/runtime_symbol_registry.h"
+#include "cinn/common/cas.h"
+#include "cinn/runtime/cpu/cblas.h"
+#include "cinn/runtime/cpu/host_intrinsics.h"
+#include "cinn/runtime/cpu/mkl_math.h"
+#include "cinn/runtime/cpu/mkldnn_math.h"
+#include "cinn/runtime/cpu/thread_backend.h"
+#include "cinn/runtime/intrinsic.h"
+
+CINN_REGISTER_HELPER(host_intrinsics) {
+  auto host_target = cinn::common::DefaultHostTarget();
+  using cinn::backends::FunctionProto;
+
+#define REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(func__) REGISTER_EXTERN_FUNC_1_IN_1_OUT(func__, host_target, float, float);
+
+#define REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32_INT(func__) \
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT(func__, host_target, float, int);
+
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(erff);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(acosf);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(acoshf);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(asinf);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(asinhf);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(atanf);
+  REGISTER_EXTERN_FUNC_1_IN_1_OUT_FP32(atanhf);
+
+  return true;
+}
+
+CINN_REGISTER_HELPER(mkl_math) {
+  using cinn::backends::FunctionProto;
+
+  auto host_target = cinn::common::DefaultHostTarget();
+
+#define REGISTER_MKL_FUNCS(fn__)                                     \
+  REGISTER_EXTERN_FUNC_HELPER(cinn_mkl_##fn__##_v_fp32, host_target) \
+      .SetRetType<void>()                                            \
+      .AddInputType<cinn_buffer_t *>()                               \
+      .AddOutputType<cinn_buffer_t *>()                              \
+      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(0))   \
+      .End();                                                        \
+  REGISTER_EXTERN_FUNC_HELPER(cinn_mkl_##fn__##_v_fp64, host_target) \
+      .SetRetType<void>()                                            \
+      .AddInputType<cinn_buffer_t *>()                               \
+      .AddOutputType<cinn_buffer_t *>()                              \
+      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(0))   \
+      .End();
+
+  REGISTER_MKL_FUNCS(exp);
+  REGISTER_MKL_FUNCS(erf);
+  REGISTER_MKL_FUNCS(sqrt);
+  REGISTER_MKL_FUNCS(log);
+  REGISTER_MKL_FUNCS(floor);
+  REGISTER_MKL_FUNCS(ceil);
+  REGISTER_MKL_FUNCS(round);
+  REGISTER_MKL_FUNCS(tanh);
+  //! Todo: current mklml.so not support
+  // REGISTER_MKL_FUNCS(log2);
+  // REGISTER_MKL_FUNCS(log10);
+  // REGISTER_MKL_FUNCS(trunc);
+  // REGISTER_MKL_FUNCS(cos);
+  // REGISTER_MKL_FUNCS(sin);
+  // REGISTER_MKL_FUNCS(cosh);
+  // REGISTER_MKL_FUNCS(tan);
+  // REGISTER_MKL_FUNCS(sinh);
+  // REGISTER_MKL_FUNCS(acos);
+  // REGISTER_MKL_FUNCS(acosh);
+  // REGISTER_MKL_FUNCS(asin);
+  // REGISTER_MKL_FUNCS(asinh);
+  // REGISTER_MKL_FUNCS(atan);
+  // REGISTER_MKL_FUNCS(atanh);
+
+  return true;
+}
+
+CINN_REGISTER_HELPER(cinn_cpu_mkl) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  FunctionProto::shape_inference_t inference_shape_gemm = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 12UL) << "Wrong number of arguments passed in";
+    auto M = common::AutoSimplify(args[1]);
+    auto N = common::AutoSimplify(args[2]);
+    std::vector<Expr> shape;
+    shape.push_back(M);
+    shape.push_back(N);
+    return shape;
+  };
+
+  FunctionProto::shape_inference_t inference_shape_gemm_batch = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
+    auto& A       = args[14];
+    auto A_tensor = A.as_tensor();
+    CHECK(A_tensor);
+
+    auto batch_size        = common::AutoSimplify(args[1]);
+    int32_t batch_size_val = batch_size.as_int32();
+
+    auto M = common::AutoSimplify(args[2]);
+    auto N = common::AutoSimplify(args[3]);
+
+    std::vector<Expr> shape;
+    int total = 1;
+    for (auto& v : A_tensor->shape) {
+      auto val = common::AutoSimplify(v);
+      CHECK(val.is_constant());
+      shape.push_back(val);
+      total *= val.as_int32();
+      if (total >= batch_size_val) break;
+    }
+    shape.push_back(M);
+    shape.push_back(N);
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<float>()            // beta
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkl_gemm_batch_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<float>()            // alpha
+      .AddInputType<int>()              // batch
+      .AddInputType<int>()              // M
+      .AddInputType<int>()              // N
+      .AddInputType<int>()              // K
+      .AddInputType<bool>()             // ta
+      .AddInputType<bool>()             // tb
+      .AddInputType<int>()              // lda
+      .AddInputType<int>()              // ldb
+      .AddInputType<int>()              // ldc
+      .AddInputType<int>()              // a_stride
+      .AddInputType<int>()              // b_stride
+      .AddInputType<int>()              // c_stride
+      .AddInputType<float>()            // beta
+      .AddInputType<cinn_buffer_t*>()   // A
+      .AddInputType<cinn_buffer_t*>()   // B
+      .AddOutputType<cinn_buffer_t*>()  // C
+      .SetShapeInference(inference_shape_gemm_batch)
+      .End();
+
+  return true;
+}
+
+CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  FunctionProto::shape_inference_t inference_shape_conv2d_nchw = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
+    auto N         = common::AutoSimplify(args[0]);
+    int input_h    = common::AutoSimplify(args[2]).as_int32();
+    int input_w    = common::AutoSimplify(args[3]).as_int32();
+    auto c_out     = common::AutoSimplify(args[4]);
+    int filter_h   = common::AutoSimplify(args[6]).as_int32();
+    int filter_w   = common::AutoSimplify(args[7]).as_int32();
+    int pad_h      = common::AutoSimplify(args[8]).as_int32();
+    int pad_w      = common::AutoSimplify(args[9]).as_int32();
+    int stride_h   = common::AutoSimplify(args[10]).as_int32();
+    int stride_w   = common::AutoSimplify(args[11]).as_int32();
+    int dilation_h = common::AutoSimplify(args[12]).as_int32();
+    int dilation_w = common::AutoSimplify(args[13]).as_int32();
+    int out_h      = (input_h - ((filter_h - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1;
+    int out_w      = (input_w - ((filter_w - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1;
+
+    std::vector<Expr> shape;
+    shape.push_back(N);
+    shape.push_back(c_out);
+    shape.push_back(Expr(out_h));
+    shape.push_back(Expr(out_w));
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_conv2d_nchw_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch_size
+      .AddInputType<int>()              // c_in
+      .AddInputType<int>()              // input_h
+      .AddInputType<int>()              // input_w
+      .AddInputType<int>()              // c_out
+      .AddInputType<int>()              // group
+      .AddInputType<int>()              // filter_h
+      .AddInputType<int>()              // filter_w
+      .AddInputType<int>()              // pad_h
+      .AddInputType<int>()              // pad_w
+      .AddInputType<int>()              // stride_h
+      .AddInputType<int>()              // stride_w
+      .AddInputType<int>()              // dilation_h
+      .AddInputType<int>()              // dilation_w
+      .AddInputType<cinn_buffer_t*>()   // inputs
+      .AddInputType<cinn_buffer_t*>()   // weights
+      .AddOutputType<cinn_buffer_t*>()  // out
+      .SetShapeInference(inference_shape_conv2d_nchw)
+      .End();
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_softmax_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch_size
+      .AddInputType<int>()              // c_in
+      .AddInputType<int>()              // h
+      .AddInputType<int>()              // w
+      .AddInputType<int>()              // axis
+      .AddInputType<cinn_buffer_t*>()   // inputs
+      .AddOutputType<cinn_buffer_t*>()  // out
+      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(5))
+      .End();
+
+  return true;
+}
+
+CINN_REGISTER_HELPER(cinn_backend_parallel) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+  backends::RuntimeSymbolRegistry::Global().RegisterFn(runtime::intrinsic::parallel_launch,
+                                                       reinterpret_cast<void*>(&cinn_backend_parallel_launch));
+  return true;
+}
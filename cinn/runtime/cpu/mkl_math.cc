@@ -6,8 +6,6 @@
 
 #include <cmath>
 
-#include "cinn/backends/extern_func_jit_register.h"
-#include "cinn/backends/function_prototype.h"
 #include "cinn/runtime/cpu/host_intrinsics.h"
 
 #define CINN_MKL_VECTOR_MATH_FP(fn__, name__)                                                                    \
@@ -43,49 +41,3 @@ CINN_MKL_VECTOR_MATH_FP(Tanh, tanh);
 // CINN_MKL_VECTOR_MATH_FP(Asinh, asinh);
 // CINN_MKL_VECTOR_MATH_FP(Atan, atan);
 // CINN_MKL_VECTOR_MATH_FP(Atanh, atanh);
-
-CINN_REGISTER_HELPER(mkl_math) {
-  using cinn::backends::FunctionProto;
-
-  auto host_target = cinn::common::DefaultHostTarget();
-
-#define REGISTER_MKL_FUNCS(fn__)                                     \
-  REGISTER_EXTERN_FUNC_HELPER(cinn_mkl_##fn__##_v_fp32, host_target) \
-      .SetRetType<void>()                                            \
-      .AddInputType<cinn_buffer_t *>()                               \
-      .AddOutputType<cinn_buffer_t *>()                              \
-      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(0))   \
-      .End();                                                        \
-  REGISTER_EXTERN_FUNC_HELPER(cinn_mkl_##fn__##_v_fp64, host_target) \
-      .SetRetType<void>()                                            \
-      .AddInputType<cinn_buffer_t *>()                               \
-      .AddOutputType<cinn_buffer_t *>()                              \
-      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(0))   \
-      .End();
-
-  REGISTER_MKL_FUNCS(exp);
-  REGISTER_MKL_FUNCS(erf);
-  REGISTER_MKL_FUNCS(sqrt);
-  REGISTER_MKL_FUNCS(log);
-  REGISTER_MKL_FUNCS(floor);
-  REGISTER_MKL_FUNCS(ceil);
-  REGISTER_MKL_FUNCS(round);
-  REGISTER_MKL_FUNCS(tanh);
-  //! Todo: current mklml.so not support
-  // REGISTER_MKL_FUNCS(log2);
-  // REGISTER_MKL_FUNCS(log10);
-  // REGISTER_MKL_FUNCS(trunc);
-  // REGISTER_MKL_FUNCS(cos);
-  // REGISTER_MKL_FUNCS(sin);
-  // REGISTER_MKL_FUNCS(cosh);
-  // REGISTER_MKL_FUNCS(tan);
-  // REGISTER_MKL_FUNCS(sinh);
-  // REGISTER_MKL_FUNCS(acos);
-  // REGISTER_MKL_FUNCS(acosh);
-  // REGISTER_MKL_FUNCS(asin);
-  // REGISTER_MKL_FUNCS(asinh);
-  // REGISTER_MKL_FUNCS(atan);
-  // REGISTER_MKL_FUNCS(atanh);
-
-  return true;
-}
@@ -1,9 +1,8 @@
 #include "cinn/runtime/cpu/mkldnn_math.h"
 
-#include <vector>
+#include <glog/logging.h>
 
-#include "cinn/backends/extern_func_jit_register.h"
-#include "cinn/common/cas.h"
+#include <vector>
 
 using mkldnn::algorithm;
 using mkldnn::memory;
@@ -121,70 +120,3 @@ void cinn_cpu_mkldnn_conv2d_nchw_fp32(int batch_size,
 
   cpu_stream.wait();
 }
-
-CINN_REGISTER_HELPER(cinn_cpu_mkldnn) {
-  using namespace cinn;  // NOLINT
-  using backends::FunctionProto;
-  auto host_target = common::DefaultHostTarget();
-
-  FunctionProto::shape_inference_t inference_shape_conv2d_nchw = [](const std::vector<Expr>& args, int offset) {
-    CHECK_EQ(args.size(), 16UL) << "Wrong number of arguments passed in";
-    auto N         = common::AutoSimplify(args[0]);
-    int input_h    = common::AutoSimplify(args[2]).as_int32();
-    int input_w    = common::AutoSimplify(args[3]).as_int32();
-    auto c_out     = common::AutoSimplify(args[4]);
-    int filter_h   = common::AutoSimplify(args[6]).as_int32();
-    int filter_w   = common::AutoSimplify(args[7]).as_int32();
-    int pad_h      = common::AutoSimplify(args[8]).as_int32();
-    int pad_w      = common::AutoSimplify(args[9]).as_int32();
-    int stride_h   = common::AutoSimplify(args[10]).as_int32();
-    int stride_w   = common::AutoSimplify(args[11]).as_int32();
-    int dilation_h = common::AutoSimplify(args[12]).as_int32();
-    int dilation_w = common::AutoSimplify(args[13]).as_int32();
-    int out_h      = (input_h - ((filter_h - 1) * dilation_h + 1) + 2 * pad_h) / stride_h + 1;
-    int out_w      = (input_w - ((filter_w - 1) * dilation_w + 1) + 2 * pad_w) / stride_w + 1;
-
-    std::vector<Expr> shape;
-    shape.push_back(N);
-    shape.push_back(c_out);
-    shape.push_back(Expr(out_h));
-    shape.push_back(Expr(out_w));
-    return shape;
-  };
-
-  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_conv2d_nchw_fp32, host_target)
-      .SetRetType<void>()
-      .AddInputType<int>()              // batch_size
-      .AddInputType<int>()              // c_in
-      .AddInputType<int>()              // input_h
-      .AddInputType<int>()              // input_w
-      .AddInputType<int>()              // c_out
-      .AddInputType<int>()              // group
-      .AddInputType<int>()              // filter_h
-      .AddInputType<int>()              // filter_w
-      .AddInputType<int>()              // pad_h
-      .AddInputType<int>()              // pad_w
-      .AddInputType<int>()              // stride_h
-      .AddInputType<int>()              // stride_w
-      .AddInputType<int>()              // dilation_h
-      .AddInputType<int>()              // dilation_w
-      .AddInputType<cinn_buffer_t*>()   // inputs
-      .AddInputType<cinn_buffer_t*>()   // weights
-      .AddOutputType<cinn_buffer_t*>()  // out
-      .SetShapeInference(inference_shape_conv2d_nchw)
-      .End();
-
-  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_mkldnn_softmax_fp32, host_target)
-      .SetRetType<void>()
-      .AddInputType<int>()              // batch_size
-      .AddInputType<int>()              // c_in
-      .AddInputType<int>()              // h
-      .AddInputType<int>()              // w
-      .AddInputType<int>()              // axis
-      .AddInputType<cinn_buffer_t*>()   // inputs
-      .AddOutputType<cinn_buffer_t*>()  // out
-      .SetShapeInference(FunctionProto::ShapeFollowNthArgument(5))
-      .End();
-
-  return true;
-}
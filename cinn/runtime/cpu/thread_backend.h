@@ -1,9 +1,8 @@
 #pragma once
-#include <omp.h>
-
 #include <thread>
 
 #include "cinn/runtime/cinn_runtime.h"
+#include "cinn/utils/thread_pool.h"
 
 extern "C" {
 
@@ -19,7 +18,9 @@ int max_concurrency();
 typedef int (*FCINNParallelLambda)(int task_id, int num_task, void* datas);
 
 /**
- * @brief Backend function for running parallel jobs.
+ * @brief Backend function for running parallel jobs on the thread pool returned by cinn::runtime::CpuThreadPool. When
+ *        called from a task running on the pool, e.g. an instruction run by the DataflowExecutor, the jobs share the
+ *        threads of the pool instead of starting more.
  *
  * @param flambda The parallel function to be launched.
  * @param datas The closure datas.
@@ -31,3 +32,15 @@ typedef int (*FCINNParallelLambda)(int task_id, int num_task, void* datas);
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda, void* datas, int num_task);
 
 }  // extern "C"
+
+namespace cinn {
+namespace runtime {
+
+/**
+ * The thread pool of max_concurrency() threads shared by the parallel jobs and the DataflowExecutor. The workers are
+ * pinned to the CPUs if the environment variable CINN_BIND_THREADS is set and not 0.
+ */
+utils::ThreadPool* CpuThreadPool();
+
+}  // namespace runtime
+}  // namespace cinn
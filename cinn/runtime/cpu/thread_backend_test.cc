@@ -0,0 +1,55 @@
+#include "cinn/runtime/cpu/thread_backend.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "cinn/runtime/cpu/thread_backend_test_helper.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+namespace {
+
+int CountLambda(int task_id, int num_task, void* datas) {
+  (*static_cast<std::vector<std::atomic<int>>*>(datas))[task_id]++;
+  return 0;
+}
+
+}  // namespace
+
+TEST(cinn_backend_parallel_launch, basic) {
+  for (int num_task : {0, 1, 3, 100}) {
+    std::vector<std::atomic<int>> counts(num_task ? num_task : max_concurrency());
+    ASSERT_EQ(cinn_backend_parallel_launch(CountLambda, &counts, num_task), 0);
+    for (auto& count : counts) ASSERT_EQ(count, 1);
+  }
+}
+
+// The CINN pool computes the same partial sums as the OpenMP path, see tests/benchmark/test_parallel_launch.cc for
+// the timings.
+TEST(cinn_backend_parallel_launch, sum) {
+  std::vector<float> input(1 << 16);
+  for (int i = 0; i < input.size(); i++) input[i] = (i % 13) * 0.25f;
+  double expected = 0;
+  for (float x : input) expected += x * x;
+
+  for (int num_task : {1, 3, max_concurrency()}) {
+    std::vector<double> cinn_sums(num_task), omp_sums(num_task);
+    SumData cinn_data{input.data(), static_cast<int>(input.size()), &cinn_sums};
+    SumData omp_data{input.data(), static_cast<int>(input.size()), &omp_sums};
+    ASSERT_EQ(cinn_backend_parallel_launch(SumLambda, &cinn_data, num_task), 0);
+    ASSERT_EQ(OmpParallelLaunch(SumLambda, &omp_data, num_task), 0);
+    ASSERT_EQ(cinn_sums, omp_sums);
+    double sum = 0;
+    for (double x : cinn_sums) sum += x;
+    // The squares are multiples of 1 / 16, so the sums are exact in any order.
+    ASSERT_EQ(sum, expected);
+  }
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <omp.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "cinn/runtime/cpu/thread_backend.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+//! The closure of SumLambda.
+struct SumData {
+  const float* input;
+  int num_elements;
+  std::vector<double>* partial_sums;
+};
+
+//! Sum the squares of a chunk of the input into the partial sum of the task.
+inline int SumLambda(int task_id, int num_task, void* datas) {
+  auto* data = static_cast<SumData*>(datas);
+  int chunk  = (data->num_elements + num_task - 1) / num_task;
+  int begin  = task_id * chunk;
+  int end    = std::min(begin + chunk, data->num_elements);
+  double sum = 0;
+  for (int i = begin; i < end; i++) sum += data->input[i] * data->input[i];
+  (*data->partial_sums)[task_id] = sum;
+  return 0;
+}
+
+//! The OpenMP path cinn_backend_parallel_launch used to take.
+inline int OmpParallelLaunch(FCINNParallelLambda flambda, void* datas, int num_task) {
+  if (num_task == 0) num_task = max_concurrency();
+  omp_set_num_threads(num_task);
+#pragma omp parallel num_threads(num_task)
+  {
+    int thread_num = omp_get_thread_num();
+    (*flambda)(thread_num, num_task, datas);
+  }
+  return 0;
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
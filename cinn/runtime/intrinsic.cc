@@ -7,12 +7,18 @@ namespace cinn {
 namespace runtime {
 
 cinn_type_t ToRuntimeType(Type type) {
-  if (type == Int(32)) {
+  if (type == Int(8)) {
+    return cinn_int8_t();
+  } else if (type == Int(32)) {
     return cinn_int32_t();
   } else if (type == Int(64)) {
     return cinn_int64_t();
   } else if (type == UInt(32)) {
     return cinn_uint64_t();
+  } else if (type == Float(16)) {
+    return cinn_float16_t();
+  } else if (type == BFloat(16)) {
+    return cinn_bfloat16_t();
   } else if (type == Float(32)) {
     return cinn_float32_t();
   } else if (type == Float(64)) {
@@ -0,0 +1,78 @@
+#include "cinn/utils/mapped_file.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace cinn {
+namespace utils {
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+  std::shared_ptr<MappedFile> file(new MappedFile);
+  file->path_ = path;
+  int fd      = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Failed to open " << path << ": " << std::strerror(errno);
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Failed to stat " << path << ": " << std::strerror(errno);
+  file->size_ = st.st_size;
+  // An empty file can not be mapped.
+  if (file->size_ > 0) {
+    void* data = mmap(nullptr, file->size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    CHECK(data != MAP_FAILED) << "Failed to map " << path << ": " << std::strerror(errno);
+    file->data_ = static_cast<uint8_t*>(data);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  return file;
+}
+
+namespace {
+
+//! The pages overlapping [\p begin, \p begin + \p size), or the whole pages in it if \p inner is set, returns false if
+//! there is none.
+bool PageRange(const void* begin, size_t size, bool inner, void** page_begin, size_t* page_size) {
+  static const uintptr_t kPageSize = sysconf(_SC_PAGESIZE);
+  uintptr_t first = reinterpret_cast<uintptr_t>(begin);
+  uintptr_t last  = first + size;
+  if (inner) {
+    first = (first + kPageSize - 1) / kPageSize * kPageSize;
+    last  = last / kPageSize * kPageSize;
+  } else {
+    first = first / kPageSize * kPageSize;
+    last  = (last + kPageSize - 1) / kPageSize * kPageSize;
+  }
+  if (first >= last) return false;
+  *page_begin = reinterpret_cast<void*>(first);
+  *page_size  = last - first;
+  return true;
+}
+
+}  // namespace
+
+void MappedFile::Prefetch(const void* begin, size_t size) const {
+  void* page_begin;
+  size_t page_size;
+  // It is a hint only, a failure is harmless.
+  if (PageRange(begin, size, false, &page_begin, &page_size)) madvise(page_begin, page_size, MADV_WILLNEED);
+}
+
+void MappedFile::Discard(const void* begin, size_t size) const {
+  void* page_begin;
+  size_t page_size;
+  if (PageRange(begin, size, true, &page_begin, &page_size)) {
+    CHECK_EQ(madvise(page_begin, page_size, MADV_DONTNEED), 0)
+        << "Failed to discard the pages of " << path_ << ": " << std::strerror(errno);
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (data_) munmap(data_, size_);
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "cinn/common/macros.h"
+
+namespace cinn {
+namespace utils {
+
+/**
+ * A file mapped into the memory. The pages are read on the first access and are shared with the page cache, so the
+ * processes mapping the same file share the physical memory. The mapping is private, a page written is copied for the
+ * process and the file is never modified.
+ */
+class MappedFile {
+ public:
+  static std::shared_ptr<MappedFile> Open(const std::string& path);
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  const std::string& path() const { return path_; }
+
+  //! Start reading the pages of [\p begin, \p begin + \p size) in the background, they are likely used soon.
+  void Prefetch(const void* begin, size_t size) const;
+
+  /**
+   * Drop the whole pages in [\p begin, \p begin + \p size) from the memory of the process, a later access reads them
+   * from the file again and the writes to them are lost. It bounds the memory used by the data copied out.
+   */
+  void Discard(const void* begin, size_t size) const;
+
+  ~MappedFile();
+
+ private:
+  MappedFile() = default;
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+
+  std::string path_;
+  uint8_t* data_{};
+  size_t size_{};
+};
+
+}  // namespace utils
+}  // namespace cinn
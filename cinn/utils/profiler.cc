@@ -0,0 +1,224 @@
+#include "cinn/utils/profiler.h"
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace cinn {
+
+DEFINE_string(cinn_build_profile,
+              "",
+              "The path to write the Chrome trace of the builds to, the builds are profiled if it is not empty.");
+
+namespace utils {
+
+namespace {
+
+int64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+//! A small id of the current thread, in the order the threads record their first events.
+uint32_t CurrentThreadId() {
+  static std::atomic<uint32_t> next{0};
+  thread_local uint32_t id = next++;
+  return id;
+}
+
+//! The node the phases on the current thread work on behalf of.
+thread_local std::string current_node;
+//! The names of the phases on the current thread that have not ended yet.
+thread_local std::vector<std::string> open_phases;
+
+std::string EscapeJson(const std::string& str) {
+  std::string res;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      res += '\\';
+      res += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+      res += buf;
+    } else {
+      res += c;
+    }
+  }
+  return res;
+}
+
+struct Stat {
+  std::string category;
+  int count{};
+  int64_t total_us{};
+  int64_t max_us{};
+  int64_t rss_delta_kb{};
+};
+
+}  // namespace
+
+int64_t GetResidentMemoryKB() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident)) return 0;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+BuildProfiler::BuildProfiler() : origin_ns_(SteadyNowNs()) {}
+
+BuildProfiler& BuildProfiler::Global() {
+  static BuildProfiler profiler;
+  return profiler;
+}
+
+int64_t BuildProfiler::NowUs() const { return (SteadyNowNs() - origin_ns_) / 1000; }
+
+void BuildProfiler::Record(Event event) {
+  std::lock_guard<std::mutex> lock(mu_);
+  events_.push_back(std::move(event));
+}
+
+void BuildProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mu_);
+  events_.clear();
+}
+
+std::vector<BuildProfiler::Event> BuildProfiler::events() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return events_;
+}
+
+std::string BuildProfiler::ToChromeTrace() const {
+  auto events = this->events();
+  std::stringstream ss;
+  ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); i++) {
+    auto& e = events[i];
+    if (i > 0) ss << ",";
+    ss << "\n{\"name\":\"" << EscapeJson(e.name) << "\",\"cat\":\"" << EscapeJson(e.category)
+       << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.tid << ",\"ts\":" << e.start_us << ",\"dur\":" << e.dur_us
+       << ",\"args\":{\"node\":\"" << EscapeJson(e.node) << "\",\"rss_delta_kb\":" << e.rss_delta_kb << "}}";
+    ss << ",\n{\"name\":\"rss\",\"ph\":\"C\",\"pid\":0,\"ts\":" << e.start_us + e.dur_us
+       << ",\"args\":{\"rss_mb\":" << e.rss_kb / 1024. << "}}";
+  }
+  ss << "\n]}\n";
+  return ss.str();
+}
+
+void BuildProfiler::SaveChromeTrace(const std::string& path) const {
+  std::ofstream file(path);
+  CHECK(file) << "Failed to open " << path;
+  file << ToChromeTrace();
+  VLOG(1) << "Saved the build profile to " << path;
+}
+
+std::string BuildProfiler::Summary() const {
+  auto events = this->events();
+  std::map<std::string, Stat> phases;
+  // The time of a node is that of the phases the node is set by, its slowest phase is one of the nested phases.
+  std::map<std::string, int64_t> node_total_us;
+  std::map<std::string, std::map<std::string, int64_t>> node_phase_us;
+  for (auto& e : events) {
+    auto& stat    = phases[e.name];
+    stat.category = e.category;
+    stat.count++;
+    stat.total_us += e.dur_us;
+    stat.max_us = std::max(stat.max_us, e.dur_us);
+    if (!e.reentrant) stat.rss_delta_kb += e.rss_delta_kb;
+    if (e.node.empty()) continue;
+    if (e.node_root) {
+      node_total_us[e.node] += e.dur_us;
+    } else {
+      node_phase_us[e.node][e.name] += e.dur_us;
+    }
+  }
+
+  int64_t first_start_us = 0, last_end_us = 0, rss_start_kb = 0, rss_end_kb = 0;
+  for (size_t i = 0; i < events.size(); i++) {
+    auto& e = events[i];
+    if (i == 0 || e.start_us < first_start_us) {
+      first_start_us = e.start_us;
+      rss_start_kb   = e.rss_kb - e.rss_delta_kb;
+    }
+    if (i == 0 || e.start_us + e.dur_us >= last_end_us) {
+      last_end_us = e.start_us + e.dur_us;
+      rss_end_kb  = e.rss_kb;
+    }
+  }
+
+  std::vector<std::pair<std::string, Stat>> sorted_phases(phases.begin(), phases.end());
+  std::sort(sorted_phases.begin(), sorted_phases.end(), [](auto& a, auto& b) {
+    return a.second.total_us > b.second.total_us;
+  });
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << std::left << std::setw(32) << "Phase" << std::setw(10) << "Category" << std::right << std::setw(8) << "Calls"
+     << std::setw(14) << "Total(ms)" << std::setw(12) << "Avg(ms)" << std::setw(12) << "Max(ms)"
+     << std::setw(15) << "RSS delta(KB)" << "\n";
+  for (auto& [name, stat] : sorted_phases) {
+    ss << std::left << std::setw(32) << name << std::setw(10) << stat.category << std::right << std::setw(8)
+       << stat.count << std::setw(14) << stat.total_us / 1e3 << std::setw(12) << stat.total_us / 1e3 / stat.count
+       << std::setw(12) << stat.max_us / 1e3 << std::setw(15) << stat.rss_delta_kb << "\n";
+  }
+  if (!events.empty()) {
+    ss << std::left << std::setw(42) << "Total" << std::right << std::setw(8) << events.size() << std::setw(14)
+       << (last_end_us - first_start_us) / 1e3 << std::setw(39) << rss_end_kb - rss_start_kb << "\n";
+  }
+
+  if (!node_total_us.empty()) {
+    std::vector<std::pair<std::string, int64_t>> sorted_nodes(node_total_us.begin(), node_total_us.end());
+    std::sort(sorted_nodes.begin(), sorted_nodes.end(), [](auto& a, auto& b) { return a.second > b.second; });
+    ss << "\n"
+       << std::left << std::setw(32) << "Node" << std::right << std::setw(14) << "Total(ms)"
+       << "  Slowest phase\n";
+    for (auto& [node, total_us] : sorted_nodes) {
+      ss << std::left << std::setw(32) << node << std::right << std::setw(14) << total_us / 1e3 << "  ";
+      auto& nested = node_phase_us[node];
+      auto slowest = std::max_element(
+          nested.begin(), nested.end(), [](auto& a, auto& b) { return a.second < b.second; });
+      if (slowest != nested.end()) ss << slowest->first << " (" << slowest->second / 1e3 << " ms)";
+      ss << "\n";
+    }
+  }
+  return ss.str();
+}
+
+RecordEvent::RecordEvent(std::string_view name, std::string_view category, std::string_view node) {
+  auto& profiler = BuildProfiler::Global();
+  enabled_       = profiler.enabled();
+  if (!enabled_) return;
+  event_.name     = std::string(name);
+  event_.category = std::string(category);
+  parent_node_    = current_node;
+  if (!node.empty()) current_node = std::string(node);
+  event_.node         = current_node;
+  event_.node_root    = !event_.node.empty() && event_.node != parent_node_;
+  event_.reentrant    = std::find(open_phases.begin(), open_phases.end(), event_.name) != open_phases.end();
+  open_phases.push_back(event_.name);
+  event_.tid          = CurrentThreadId();
+  event_.rss_delta_kb = -GetResidentMemoryKB();
+  event_.start_us     = profiler.NowUs();
+}
+
+RecordEvent::~RecordEvent() {
+  if (!enabled_) return;
+  auto& profiler = BuildProfiler::Global();
+  event_.dur_us  = profiler.NowUs() - event_.start_us;
+  event_.rss_kb  = GetResidentMemoryKB();
+  event_.rss_delta_kb += event_.rss_kb;
+  current_node = parent_node_;
+  open_phases.pop_back();
+  profiler.Record(std::move(event_));
+}
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cinn/common/macros.h"
+
+namespace cinn {
+
+DECLARE_string(cinn_build_profile);
+
+namespace utils {
+
+/**
+ * BuildProfiler records the wall time and the memory of the phases of a build, e.g. the lowering of a graph node or an
+ * optimization pass, and exports them as a Chrome trace (to view in chrome://tracing or Perfetto) and as a summary
+ * table.
+ *
+ * It is enabled by the flag cinn_build_profile, the path GraphCompiler::Build writes the trace to, or by Enable.
+ */
+class BuildProfiler {
+ public:
+  struct Event {
+    std::string name;
+    std::string category;
+    //! The id of the graph node the phase works on, empty if it is not on behalf of a node.
+    std::string node;
+    //! Whether the node is set by this phase rather than inherited from the enclosing one.
+    bool node_root{};
+    //! Whether the phase is nested in another phase of the same name on the same thread, e.g. a build in a build.
+    bool reentrant{};
+    uint32_t tid{};
+    //! The start time since the profiler is created and the duration, in microseconds.
+    int64_t start_us{};
+    int64_t dur_us{};
+    //! The resident memory at the end of the phase and its change during the phase, in KB.
+    int64_t rss_kb{};
+    int64_t rss_delta_kb{};
+  };
+
+  static BuildProfiler& Global();
+
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed) || !FLAGS_cinn_build_profile.empty(); }
+  void Enable(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+  void Record(Event event);
+  void Clear();
+  std::vector<Event> events() const;
+
+  //! The events in the Trace Event Format, the phases as complete events and the memory as a counter.
+  std::string ToChromeTrace() const;
+  void SaveChromeTrace(const std::string& path) const;
+
+  /**
+   * A table of the phases by their total time, followed by a table of the graph nodes by their total time. The memory
+   * of a phase is summed over its calls that are not nested in another call of it, as the nested ones are part of
+   * those, and the total memory is that from the start of the first event to the end of the last one.
+   */
+  std::string Summary() const;
+
+  //! The microseconds since the profiler is created.
+  int64_t NowUs() const;
+
+ private:
+  BuildProfiler();
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(BuildProfiler);
+
+  std::atomic<bool> enabled_{false};
+  int64_t origin_ns_{};
+  mutable std::mutex mu_;
+  std::vector<Event> events_;
+};
+
+/**
+ * Record the phase from the construction to the destruction of a RecordEvent, if the BuildProfiler is enabled. The
+ * phase works on behalf of \p node if given, otherwise of the node of the enclosing phase on the same thread.
+ */
+class RecordEvent {
+ public:
+  RecordEvent(std::string_view name, std::string_view category, std::string_view node = {});
+  ~RecordEvent();
+
+ private:
+  CINN_DISALLOW_COPY_AND_ASSIGN(RecordEvent);
+
+  bool enabled_{};
+  BuildProfiler::Event event_;
+  std::string parent_node_;
+};
+
+//! The resident memory of the process in KB.
+int64_t GetResidentMemoryKB();
+
+}  // namespace utils
+}  // namespace cinn
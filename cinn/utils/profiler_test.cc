@@ -0,0 +1,82 @@
+#include "cinn/utils/profiler.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <chrono>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+namespace cinn {
+namespace utils {
+
+TEST(BuildProfiler, disabled) {
+  auto& profiler = BuildProfiler::Global();
+  profiler.Clear();
+  { RecordEvent event("Lower", "lower"); }
+  ASSERT_TRUE(profiler.events().empty());
+}
+
+TEST(BuildProfiler, record) {
+  auto& profiler = BuildProfiler::Global();
+  profiler.Clear();
+  profiler.Enable(true);
+  {
+    RecordEvent op("GetOpFunc", "hlir", "relu_0");
+    {
+      RecordEvent pass("Simplify", "optim");
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    { RecordEvent pass("Simplify", "optim"); }
+  }
+  { RecordEvent emit("EmitLLVMIR", "llvm"); }
+  profiler.Enable(false);
+
+  // The events are recorded as they end.
+  auto events = profiler.events();
+  ASSERT_EQ(events.size(), 4UL);
+  ASSERT_EQ(events[0].name, "Simplify");
+  ASSERT_EQ(events[0].node, "relu_0");
+  ASSERT_FALSE(events[0].node_root);
+  ASSERT_GE(events[0].dur_us, 2000);
+  ASSERT_EQ(events[2].name, "GetOpFunc");
+  ASSERT_TRUE(events[2].node_root);
+  ASSERT_GE(events[2].dur_us, events[0].dur_us + events[1].dur_us);
+  ASSERT_TRUE(events[3].node.empty());
+  ASSERT_GT(events[3].rss_kb, 0);
+  for (auto& e : events) ASSERT_FALSE(e.reentrant);
+
+  auto trace = profiler.ToChromeTrace();
+  ASSERT_NE(trace.find("\"traceEvents\""), std::string::npos);
+  ASSERT_NE(trace.find("\"name\":\"GetOpFunc\",\"cat\":\"hlir\",\"ph\":\"X\""), std::string::npos);
+
+  auto summary = profiler.Summary();
+  LOG(INFO) << "The summary:\n" << summary;
+  // The phases are sorted by the total time, and the nodes by theirs.
+  ASSERT_LT(summary.find("GetOpFunc"), summary.find("Simplify"));
+  ASSERT_LT(summary.find("Simplify"), summary.find("EmitLLVMIR"));
+  ASSERT_NE(summary.find("relu_0"), std::string::npos);
+  ASSERT_NE(summary.find("Total"), std::string::npos);
+  profiler.Clear();
+}
+
+TEST(BuildProfiler, reentrant) {
+  auto& profiler = BuildProfiler::Global();
+  profiler.Clear();
+  profiler.Enable(true);
+  {
+    RecordEvent outer("GraphCompiler::Build", "hlir");
+    { RecordEvent inner("GraphCompiler::Build", "hlir"); }
+  }
+  profiler.Enable(false);
+
+  // The memory of the nested build is part of that of the outer one.
+  auto events = profiler.events();
+  ASSERT_EQ(events.size(), 2UL);
+  ASSERT_TRUE(events[0].reentrant);
+  ASSERT_FALSE(events[1].reentrant);
+  profiler.Clear();
+}
+
+}  // namespace utils
+}  // namespace cinn
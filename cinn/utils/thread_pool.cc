@@ -0,0 +1,317 @@
+#include "cinn/utils/thread_pool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>  //NOLINT
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+namespace cinn {
+namespace utils {
+
+namespace {
+
+// The number of failed attempts to find a task before a worker yields the CPU, and before it backs off to sleep.
+constexpr int kPauseCount   = 64;
+constexpr int kSpinCount    = 1024;
+constexpr auto kBackOffTime = std::chrono::microseconds(100);
+// How long a worker spins waiting for the next Run before parking.
+constexpr auto kParkTime = std::chrono::milliseconds(1);
+// The max number of tasks of a ParallelFor kept on the stack.
+constexpr int kMaxInlineTasks = 64;
+
+thread_local ThreadPool* current_pool = nullptr;
+thread_local int current_worker       = -1;
+
+//! Pause for the first spins, then yield the CPU in case the cores are oversubscribed.
+inline void CpuRelax(int num_spins) {
+#if defined(__x86_64__) || defined(_M_X64)
+  if (num_spins < kPauseCount) {
+    __builtin_ia32_pause();
+    return;
+  }
+#endif
+  std::this_thread::yield();
+}
+
+#ifdef __linux__
+//! Parse a CPU list in the format of sysfs, e.g. "0-3,8-11".
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    auto dash = range.find('-');
+    int begin = std::stoi(range.substr(0, dash));
+    int end   = dash == std::string::npos ? begin : std::stoi(range.substr(dash + 1));
+    for (int cpu = begin; cpu <= end; cpu++) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+std::string ReadLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+/**
+ * The CPUs this process can run on. The first hyper-threads of all the physical cores go before their siblings, and
+ * the CPUs of a NUMA node go before the next node.
+ */
+std::vector<int> GetCpuOrder() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return {};
+
+  std::vector<int> cpu_node(CPU_SETSIZE, 0);
+  for (int node = 0;; node++) {
+    auto cpus = ReadLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (cpus.empty()) break;
+    for (int cpu : ParseCpuList(cpus)) {
+      if (cpu < CPU_SETSIZE) cpu_node[cpu] = node;
+    }
+  }
+
+  std::vector<std::tuple<int, int, int>> keys;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed)) continue;
+    auto siblings =
+        ParseCpuList(ReadLine("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list"));
+    int sibling_rank = std::find(siblings.begin(), siblings.end(), cpu) - siblings.begin();
+    if (sibling_rank == siblings.size()) sibling_rank = 0;
+    keys.emplace_back(sibling_rank, cpu_node[cpu], cpu);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<int> cpus;
+  for (auto& key : keys) cpus.push_back(std::get<2>(key));
+  return cpus;
+}
+
+void BindThread(std::thread* thread, int cpu) {
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  if (pthread_setaffinity_np(thread->native_handle(), sizeof(cpuset), &cpuset) != 0) {
+    LOG(WARNING) << "Failed to bind a thread to the CPU " << cpu;
+  }
+}
+#endif
+
+struct ForJob {
+  void (*fn)(int task_id, void* data);
+  void* data;
+  std::atomic<int> remaining;
+};
+
+struct ForTask {
+  ThreadPool::Task task;
+  int task_id;
+  ForJob* job;
+};
+
+void RunForTask(void* data) {
+  auto* task = static_cast<ForTask*>(data);
+  task->job->fn(task->task_id, task->job->data);
+  task->job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(int num_threads, int64_t deque_capacity, bool bind_threads) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; i++) {
+    deques_.emplace_back(new WorkStealingDeque<Task*>(deque_capacity));
+  }
+  for (int i = 1; i < num_threads; i++) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+#ifdef __linux__
+  if (bind_threads) {
+    // The worker 0 is the thread calling Run, it is left to the caller.
+    auto cpus = GetCpuOrder();
+    for (int i = 1; i < num_threads && !cpus.empty(); i++) {
+      BindThread(&workers_[i - 1], cpus[i % cpus.size()]);
+    }
+  }
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  run_cv_.notify_all();
+  for (auto& worker : workers_) worker.join();
+}
+
+void ThreadPool::Run(Task* const* tasks, int num_tasks) {
+  if (num_tasks == 0) return;
+  CHECK(current_pool != this) << "ThreadPool::Run should not be called from a task running on the same pool";
+  std::lock_guard<std::mutex> run_lock(run_mu_);
+  RunLocked(tasks, num_tasks);
+}
+
+void ThreadPool::RunLocked(Task* const* tasks, int num_tasks) {
+  auto* prev_pool = current_pool;
+  int prev_worker = current_worker;
+  current_pool    = this;
+  current_worker  = 0;
+
+  pending_.store(num_tasks, std::memory_order_release);
+  for (int i = 0; i < num_tasks; i++) {
+    if (!deques_[0]->Push(tasks[i])) {
+      tasks[i]->fn(tasks[i]->data);
+      FinishTask();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+  }
+  run_cv_.notify_all();
+  Drain(0);
+
+  current_pool   = prev_pool;
+  current_worker = prev_worker;
+}
+
+void ThreadPool::Spawn(Task* task) {
+  CHECK(current_pool == this) << "ThreadPool::Spawn should be called from a task running on the same pool";
+  pending_.fetch_add(1);
+  if (!deques_[current_worker]->Push(task)) {
+    // The deque is full, run it inline.
+    task->fn(task->data);
+    FinishTask();
+    return;
+  }
+  WakeUpSleeping();
+}
+
+void ThreadPool::FinishTask() {
+  // Wake up the thread waiting for the Run to finish.
+  if (pending_.fetch_sub(1) == 1) WakeUpSleeping();
+}
+
+void ThreadPool::WakeUpSleeping() {
+  if (num_sleeping_.load() == 0) return;
+  {
+    // Not to notify between a worker deciding to sleep and it starting to wait.
+    std::lock_guard<std::mutex> lock(mu_);
+  }
+  work_cv_.notify_all();
+}
+
+void ThreadPool::ParallelFor(int num_tasks, void (*fn)(int task_id, void* data), void* data) {
+  if (num_tasks <= 0) return;
+  std::unique_lock<std::mutex> run_lock(run_mu_, std::defer_lock);
+  if (num_tasks == 1 || num_threads() == 1 || (current_pool != this && !run_lock.try_lock())) {
+    for (int i = 0; i < num_tasks; i++) fn(i, data);
+    return;
+  }
+
+  ForJob job{fn, data, {num_tasks}};
+  std::array<ForTask, kMaxInlineTasks> inline_tasks;
+  std::array<Task*, kMaxInlineTasks> inline_task_ptrs;
+  std::vector<ForTask> heap_tasks;
+  std::vector<Task*> heap_task_ptrs;
+  ForTask* tasks   = inline_tasks.data();
+  Task** task_ptrs = inline_task_ptrs.data();
+  if (num_tasks > kMaxInlineTasks) {
+    heap_tasks.resize(num_tasks);
+    heap_task_ptrs.resize(num_tasks);
+    tasks     = heap_tasks.data();
+    task_ptrs = heap_task_ptrs.data();
+  }
+  for (int i = 0; i < num_tasks; i++) {
+    tasks[i].task    = Task{RunForTask, &tasks[i]};
+    tasks[i].task_id = i;
+    tasks[i].job     = &job;
+    task_ptrs[i]     = &tasks[i].task;
+  }
+
+  if (current_pool != this) {
+    RunLocked(task_ptrs, num_tasks);
+    return;
+  }
+
+  // Nested in a task of this pool, spawn the others and help running the tasks till all of them are finished.
+  for (int i = 1; i < num_tasks; i++) Spawn(task_ptrs[i]);
+  RunForTask(&tasks[0]);
+  int num_failures = 0;
+  while (job.remaining.load(std::memory_order_acquire) > 0) {
+    Task* task;
+    if (FindTask(current_worker, &task)) {
+      task->fn(task->data);
+      FinishTask();
+      num_failures = 0;
+    } else {
+      CpuRelax(num_failures++);
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop(int id) {
+  current_pool        = this;
+  current_worker      = id;
+  uint64_t generation = 0;
+  while (true) {
+    auto park_time = std::chrono::steady_clock::now() + kParkTime;
+    for (int num_spins = 0; generation_.load(std::memory_order_acquire) == generation && !stop_ &&
+                            std::chrono::steady_clock::now() < park_time;
+         num_spins++) {
+      CpuRelax(num_spins);
+    }
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      run_cv_.wait(lock, [&] { return stop_ || generation_.load(std::memory_order_acquire) != generation; });
+      if (stop_) return;
+      generation = generation_.load(std::memory_order_acquire);
+    }
+    Drain(id);
+  }
+}
+
+void ThreadPool::Drain(int id) {
+  int num_failures = 0;
+  while (pending_.load(std::memory_order_acquire) > 0) {
+    Task* task;
+    if (FindTask(id, &task)) {
+      task->fn(task->data);
+      FinishTask();
+      num_failures = 0;
+    } else if (num_failures < kSpinCount) {
+      CpuRelax(num_failures++);
+    } else {
+      // Back off to leave the cores to the running tasks till a task is spawned or the Run is finished.
+      std::unique_lock<std::mutex> lock(mu_);
+      num_sleeping_++;
+      if (pending_.load() > 0) work_cv_.wait_for(lock, kBackOffTime);
+      num_sleeping_--;
+      num_failures = 0;
+    }
+  }
+}
+
+bool ThreadPool::FindTask(int id, Task** task) {
+  if (deques_[id]->Pop(task)) return true;
+  int num_threads = deques_.size();
+  for (int i = 1; i < num_threads; i++) {
+    if (deques_[(id + i) % num_threads]->Steal(task)) return true;
+  }
+  return false;
+}
+
+}  // namespace utils
+}  // namespace cinn
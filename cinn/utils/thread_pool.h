@@ -0,0 +1,159 @@
+#pragma once
+
+#include <glog/logging.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cinn/common/macros.h"
+
+namespace cinn {
+namespace utils {
+
+/**
+ * A fixed capacity Chase-Lev deque. The owner thread pushes and pops at the bottom, the other threads steal from the
+ * top, none of them takes a lock.
+ */
+template <typename T>
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(int64_t capacity) {
+    while (capacity_ < capacity) capacity_ <<= 1;
+    buffer_.reset(new std::atomic<T>[capacity_]);
+  }
+
+  //! Push \p value at the bottom, returns false if the deque is full. Called by the owner only.
+  bool Push(T value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top    = top_.load(std::memory_order_acquire);
+    if (bottom - top >= capacity_) return false;
+    buffer_[bottom & (capacity_ - 1)].store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  //! Pop a value from the bottom, returns false if the deque is empty. Called by the owner only.
+  bool Pop(T* value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    *value = buffer_[bottom & (capacity_ - 1)].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // The last one, race with the thieves for it.
+      bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  //! Steal a value from the top, returns false if the deque is empty or another thread won the race.
+  bool Steal(T* value) {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) return false;
+    *value = buffer_[top & (capacity_ - 1)].load(std::memory_order_relaxed);
+    return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+ private:
+  int64_t capacity_{1};
+  std::unique_ptr<std::atomic<T>[]> buffer_;
+  std::atomic<int64_t> top_{0};
+  std::atomic<int64_t> bottom_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+/**
+ * A work-stealing thread pool. Each worker owns a WorkStealingDeque, the tasks spawned by a worker go to its own deque,
+ * and an idle worker steals from the others. The thread calling Run joins as the worker 0, so a pool of N threads
+ * starts N - 1 threads. Between two Runs the workers spin for a while before parking, so that the back to back Runs do
+ * not pay for waking them up.
+ *
+ * The tasks are owned by the caller, the pool allocates nothing and takes no lock while there are tasks to run.
+ */
+class ThreadPool {
+ public:
+  struct Task {
+    void (*fn)(void* data);
+    void* data;
+  };
+
+  /**
+   * Constructor.
+   * @param num_threads The number of threads including the one calling Run.
+   * @param deque_capacity The max number of tasks queued by a worker, the tasks spawned beyond run inline.
+   * @param bind_threads Whether to pin the workers to the CPUs, the physical cores first and filling a NUMA node before
+   * the next one.
+   */
+  explicit ThreadPool(int num_threads, int64_t deque_capacity = 1 << 16, bool bind_threads = false);
+  ~ThreadPool();
+
+  int num_threads() const { return deques_.size(); }
+
+  /**
+   * Run \p tasks and all the tasks they spawn, returns when all of them are finished.
+   *
+   * The pool serves a single Run at a time, its caller joins as the worker 0: a call from another thread while a Run is
+   * in progress blocks till that Run is finished, and the tasks of two Runs never run at the same time. The threads
+   * submitting work concurrently should have pools of their own, or run inline, e.g. the programs by Program::Clone.
+   */
+  void Run(Task* const* tasks, int num_tasks);
+
+  /**
+   * Schedule \p task in the current Run, it should be called from a task running on this pool.
+   */
+  void Spawn(Task* task);
+
+  /**
+   * Run fn(i, data) for i in [0, num_tasks) in parallel, returns when all of them are finished.
+   *
+   * Called from a task running on this pool, the calls are spawned in the current Run and the calling worker runs the
+   * other tasks while waiting, so the nested parallelism shares the same threads. Called from another thread while the
+   * pool is running for someone else, the calls run inline instead of waiting for the pool.
+   */
+  void ParallelFor(int num_tasks, void (*fn)(int task_id, void* data), void* data);
+
+ private:
+  void WorkerLoop(int id);
+  //! Run the tasks till all of the current Run are finished.
+  void Drain(int id);
+  bool FindTask(int id, Task** task);
+  //! Run with run_mu_ held.
+  void RunLocked(Task* const* tasks, int num_tasks);
+  void FinishTask();
+  void WakeUpSleeping();
+
+  std::vector<std::unique_ptr<WorkStealingDeque<Task*>>> deques_;
+  std::vector<std::thread> workers_;
+  //! The number of the tasks scheduled and not finished in the current Run.
+  std::atomic<int64_t> pending_{0};
+  std::atomic<int> num_sleeping_{0};
+
+  std::mutex run_mu_;
+  std::mutex mu_;
+  //! Wakes up the workers parked when a Run starts.
+  std::condition_variable run_cv_;
+  //! Wakes up the workers backing off when a task is spawned.
+  std::condition_variable work_cv_;
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<bool> stop_{false};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+};
+
+}  // namespace utils
+}  // namespace cinn
@@ -0,0 +1,187 @@
+#include "cinn/utils/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace utils {
+
+TEST(WorkStealingDeque, basic) {
+  WorkStealingDeque<int> deque(3);
+  ASSERT_TRUE(deque.Push(1));
+  ASSERT_TRUE(deque.Push(2));
+  ASSERT_TRUE(deque.Push(3));
+  ASSERT_TRUE(deque.Push(4));
+  ASSERT_FALSE(deque.Push(5));
+
+  int value;
+  ASSERT_TRUE(deque.Pop(&value));
+  ASSERT_EQ(value, 4);
+  ASSERT_TRUE(deque.Steal(&value));
+  ASSERT_EQ(value, 1);
+  ASSERT_TRUE(deque.Pop(&value));
+  ASSERT_EQ(value, 3);
+  ASSERT_TRUE(deque.Pop(&value));
+  ASSERT_EQ(value, 2);
+  ASSERT_FALSE(deque.Pop(&value));
+  ASSERT_FALSE(deque.Steal(&value));
+}
+
+TEST(WorkStealingDeque, steal_concurrently) {
+  const int num_values = 100000;
+  WorkStealingDeque<int> deque(num_values);
+  for (int i = 0; i < num_values; i++) ASSERT_TRUE(deque.Push(i));
+
+  std::atomic<bool> done{false};
+  std::vector<std::vector<int>> taken(5);
+  std::vector<std::thread> thieves;
+  for (int t = 1; t < taken.size(); t++) {
+    thieves.emplace_back([&, t] {
+      int value;
+      while (!done) {
+        if (deque.Steal(&value)) taken[t].push_back(value);
+      }
+    });
+  }
+  int value;
+  while (deque.Pop(&value)) taken[0].push_back(value);
+  done = true;
+  for (auto& thief : thieves) thief.join();
+
+  // Every value is taken exactly once.
+  std::vector<int> counts(num_values);
+  for (auto& values : taken) {
+    for (int v : values) counts[v]++;
+  }
+  for (int i = 0; i < num_values; i++) ASSERT_EQ(counts[i], 1);
+}
+
+namespace {
+
+struct SpawnContext {
+  ThreadPool* pool;
+  std::atomic<int>* count;
+  std::vector<ThreadPool::Task> children;
+};
+
+void CountTask(void* data) { (*static_cast<std::atomic<int>*>(data))++; }
+
+void SpawnTask(void* data) {
+  auto* context = static_cast<SpawnContext*>(data);
+  (*context->count)++;
+  for (auto& child : context->children) context->pool->Spawn(&child);
+}
+
+}  // namespace
+
+TEST(ThreadPool, spawn) {
+  ThreadPool pool(4);
+  std::atomic<int> count{0};
+  std::vector<SpawnContext> contexts(100);
+  std::vector<ThreadPool::Task> roots;
+  for (auto& context : contexts) {
+    context.pool  = &pool;
+    context.count = &count;
+    context.children.assign(10, ThreadPool::Task{CountTask, &count});
+    roots.push_back(ThreadPool::Task{SpawnTask, &context});
+  }
+  std::vector<ThreadPool::Task*> tasks;
+  for (auto& root : roots) tasks.push_back(&root);
+
+  for (int i = 0; i < 100; i++) {
+    count = 0;
+    pool.Run(tasks.data(), tasks.size());
+    ASSERT_EQ(count, 1100);
+  }
+}
+
+namespace {
+
+constexpr int kNumSubmitters = 4;
+constexpr int kTasksPerRun   = 16;
+
+struct SubmitterContext {
+  std::vector<std::atomic<int>>* counts;
+  int submitter;
+  std::atomic<bool>* interleaved;
+};
+
+// The other submitters have no Run in progress, so their counts are at the boundaries of their Runs.
+void CheckSerializedTask(void* data) {
+  auto* context = static_cast<SubmitterContext*>(data);
+  for (int t = 0; t < kNumSubmitters; t++) {
+    if (t != context->submitter && (*context->counts)[t] % kTasksPerRun != 0) *context->interleaved = true;
+  }
+  (*context->counts)[context->submitter]++;
+}
+
+}  // namespace
+
+TEST(ThreadPool, run_from_threads) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> counts(kNumSubmitters);
+  std::atomic<bool> interleaved{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumSubmitters; t++) {
+    threads.emplace_back([&, t] {
+      SubmitterContext context{&counts, t, &interleaved};
+      std::vector<ThreadPool::Task> tasks(kTasksPerRun, ThreadPool::Task{CheckSerializedTask, &context});
+      std::vector<ThreadPool::Task*> task_ptrs;
+      for (auto& task : tasks) task_ptrs.push_back(&task);
+      for (int i = 0; i < 100; i++) {
+        pool.Run(task_ptrs.data(), task_ptrs.size());
+        // All the tasks of a Run are finished when it returns.
+        ASSERT_EQ(counts[t], (i + 1) * kTasksPerRun);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  ASSERT_FALSE(interleaved);
+}
+
+namespace {
+
+struct ForContext {
+  ThreadPool* pool;
+  std::vector<std::atomic<int>>* counts;
+};
+
+void CountFor(int task_id, void* data) { (*static_cast<std::vector<std::atomic<int>>*>(data))[task_id]++; }
+
+void NestedFor(int task_id, void* data) {
+  auto* context = static_cast<ForContext*>(data);
+  context->pool->ParallelFor(10, CountFor, context->counts);
+}
+
+}  // namespace
+
+TEST(ThreadPool, parallel_for) {
+  ThreadPool pool(4);
+  for (int num_tasks : {1, 3, 64, 1000}) {
+    std::vector<std::atomic<int>> counts(num_tasks);
+    pool.ParallelFor(num_tasks, CountFor, &counts);
+    for (auto& count : counts) ASSERT_EQ(count, 1);
+  }
+
+  // Nested in the tasks of the same pool.
+  std::vector<std::atomic<int>> counts(10);
+  ForContext context{&pool, &counts};
+  pool.ParallelFor(100, NestedFor, &context);
+  for (auto& count : counts) ASSERT_EQ(count, 100);
+
+  // Called from several threads at the same time.
+  std::vector<std::atomic<int>> shared_counts(10);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 100; i++) pool.ParallelFor(10, CountFor, &shared_counts);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (auto& count : shared_counts) ASSERT_EQ(count, 400);
+}
+
+}  // namespace utils
+}  // namespace cinn
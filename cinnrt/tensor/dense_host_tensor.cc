@@ -12,6 +12,15 @@ DenseHostTensor::DenseHostTensor(const TensorShape& shape, DType dtype) : HostTe
   buffer_->ResizeLazy(dtype.GetHostSize() * shape.GetNumElements());
 }
 
+DenseHostTensor::DenseHostTensor(const TensorShape& shape,
+                                 DType dtype,
+                                 const std::shared_ptr<cinn::hlir::framework::Buffer>& buffer)
+    : HostTensor(TensorMetadata{dtype, shape}) {
+  CHECK(metadata().IsValid()) << "Tensor construct get invalid metadata";
+  buffer_.reset(new cinn::hlir::framework::Buffer(cinn::common::DefaultHostTarget()));
+  buffer_->ShareMemory(buffer, 0, dtype.GetHostSize() * shape.GetNumElements());
+}
+
 const TensorShape& DenseHostTensor::shape() const { return metadata().shape; }
 
 void DenseHostTensor::Init(const std::vector<int64_t>& shape, DType dtype) {
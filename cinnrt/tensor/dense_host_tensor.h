@@ -51,6 +51,8 @@ class DenseHostTensor : public HostTensor {
  public:
   DenseHostTensor() = default;
   DenseHostTensor(const TensorShape& shape, DType dtype);
+  //! Share the memory of \p buffer instead of allocating, \p buffer is kept alive by the tensor.
+  DenseHostTensor(const TensorShape& shape, DType dtype, const std::shared_ptr<cinn::hlir::framework::Buffer>& buffer);
 
   void Init(const std::vector<int64_t>& shape, DType dtype);
   const TensorShape& shape() const;
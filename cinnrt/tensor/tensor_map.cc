@@ -44,7 +44,6 @@ TensorMap *LoadParams(const std::string &path) {
   for (auto &var : main_block.vars()) {
     if (var.name() == "feed" || var.name() == "fetch" || !var.persistable()) continue;
     std::string param_path = path + "/" + var.name();
-    std::ifstream param_file(param_path, std::ios::binary);
     switch (var.type().type()) {
       case paddle::framework::proto::VarType_Type_LOD_TENSOR: {
         using CinnTensor = cinn::hlir::framework::Tensor;
@@ -52,19 +51,15 @@ TensorMap *LoadParams(const std::string &path) {
         auto var_name = TransValidVarName(var.name());
         // std::cout << "var name: " << var.name() << " " << var_name << std::endl;
         auto *_var = scope.Var<CinnTensor>(var_name);
-        cinn::frontend::paddle::LoadLoDTensor(param_file, _var, target);
+        cinn::frontend::paddle::LoadParam(param_path, _var, target);
         auto tensor     = scope.GetTensor(var_name);
-        auto *src_data  = tensor->data<float>();
         auto &cinn_type = tensor->type();
         std::vector<int64_t> shape;
         for (int dim : tensor->shape().data()) shape.push_back(dim);
         auto shape_array = llvm::ArrayRef<int64_t>(shape.data(), shape.size());
         auto dtype       = CinnType2DType_(cinn_type);
-        auto *dht        = new DenseHostTensor(TensorShape(shape_array), dtype);
-        int num_elements = dht->shape().GetNumElements();
-        auto *dst_data   = reinterpret_cast<float *>(dht->raw_data());
-        for (int i = 0; i < num_elements; ++i) dst_data[i] = src_data[i];
-        (*map)[var.name()] = dht;
+        // The tensor shares the memory of the loaded one, which maps the file if FLAGS_cinn_mmap_params is set.
+        (*map)[var.name()] = new DenseHostTensor(TensorShape(shape_array), dtype, tensor->shared_buffer());
         break;
       }
       default:
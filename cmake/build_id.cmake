@@ -0,0 +1,31 @@
+# Generate the header of CINN_BUILD_ID, the id of the CINN sources the library is built from: the git commit, and the
+# hash of the uncommitted changes if any. The header is only rewritten when the id changes.
+#
+# Usage: cmake -DSOURCE_DIR=<the CINN sources> -DOUTPUT=<the header> -P build_id.cmake
+
+execute_process(
+  COMMAND git rev-parse HEAD
+  WORKING_DIRECTORY ${SOURCE_DIR}
+  OUTPUT_VARIABLE commit
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+  RESULT_VARIABLE result
+  ERROR_QUIET)
+if (NOT result EQUAL 0)
+  set(commit "unknown")
+endif()
+
+execute_process(
+  COMMAND git diff HEAD
+  WORKING_DIRECTORY ${SOURCE_DIR}
+  OUTPUT_VARIABLE diff
+  RESULT_VARIABLE result
+  ERROR_QUIET)
+set(build_id ${commit})
+if (result EQUAL 0 AND NOT diff STREQUAL "")
+  string(SHA1 diff_hash "${diff}")
+  set(build_id "${commit}-dirty-${diff_hash}")
+endif()
+
+file(WRITE ${OUTPUT}.tmp "#pragma once\n\n#define CINN_BUILD_ID \"${build_id}\"\n")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
@@ -92,6 +92,12 @@ TEST_DEFAULT(elementwise_add, add5_0, type1, type)
 TEST_DEFAULT(elementwise_add, add5_1, type1, type)
 TEST_DEFAULT(elementwise_add, add5_2, type1, type)
 TEST_DEFAULT(elementwise_add, add5_3, type1, type)
+std::vector<std::vector<int>> shapes_add6_0 = {{32, 1000}, {32, 1000}};
+std::vector<std::vector<int>> shapes_add6_1 = {{1024, 7}, {1024, 7}};
+std::vector<std::vector<int>> shapes_add6_2 = {{256, 56, 56, 3}, {256, 56, 56, 3}};
+TEST_DEFAULT(elementwise_add, add6_0, type1, type)
+TEST_DEFAULT(elementwise_add, add6_1, type1, type)
+TEST_DEFAULT(elementwise_add, add6_2, type1, type)
 // mul
 std::vector<std::vector<int>> shapes_elementwise_mul = {{1024, 1024, 1024}, {1024, 1024, 1024}};
 TEST_DEFAULT(elementwise_mul, elementwise_mul, type1, type)
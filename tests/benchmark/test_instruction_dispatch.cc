@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "cinn/common/test_helper.h"
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/scope.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+using hlir::framework::Instruction;
+using hlir::framework::Scope;
+using hlir::framework::Shape;
+using hlir::framework::Tensor;
+
+namespace {
+
+void NoopLoweredFunc(void* args, int32_t num_args) {}
+
+}  // namespace
+
+// Measures the per-instruction dispatch cost with a function doing nothing, compared with resolving the arguments from
+// the scope on each call as Run did before the instructions were bound.
+TEST(InstructionDispatch, bound_vs_lookup) {
+  const int repeat = 1000000;
+  Scope scope;
+  std::vector<std::string> names({"x", "y", "z"});
+  for (auto& name : names) {
+    auto& tensor = std::get<Tensor>(*scope.Var<Tensor>(name));
+    tensor->Resize(Shape{{1}});
+    tensor->mutable_data<float>(common::DefaultHostTarget());
+  }
+
+  Instruction instr(common::DefaultHostTarget(), &scope, {"x", "y"}, {"z"}, "elementwise_add");
+  instr.SetLoweredFunc(NoopLoweredFunc);
+  instr.Bind();
+
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) instr.Run();
+  double bound_ns = timer.Stop() * 1e6 / repeat;
+
+  timer.Start();
+  for (int i = 0; i < repeat; i++) {
+    common::ArgsBuilder builder;
+    for (auto& name : names) builder.Add(std::get<Tensor>(*scope.FindVar(name))->buffer());
+    auto args = builder.Build();
+    NoopLoweredFunc(args.data(), args.size());
+  }
+  double lookup_ns = timer.Stop() * 1e6 / repeat;
+
+  LOG(INFO) << "Instruction dispatch: " << bound_ns << " ns per Run when bound, " << lookup_ns
+            << " ns per Run resolving the arguments from the scope";
+}
+
+}  // namespace tests
+}  // namespace cinn
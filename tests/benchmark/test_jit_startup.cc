@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/execution_engine.h"
+#include "cinn/cinn.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/runtime/cinn_runtime.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+namespace {
+
+constexpr int kM = 64;
+constexpr int kN = 32;
+
+ir::Module CreateAddModule(const std::string& name) {
+  Expr M(kM);
+  Expr N(kN);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {M, N});
+  auto C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(i, j); }, "C");
+  auto stages = CreateStages({C});
+  Module::Builder builder("module_" + name, common::DefaultHostTarget());
+  builder.AddFunction(Lower(name, stages, {A, B, C}));
+  return builder.Build();
+}
+
+}  // namespace
+
+// The cost of setting up the JIT, that is creating an engine and linking the modules one by one, as a GraphCompiler
+// or the AutoTuner does.
+TEST(JitStartup, link_modules) {
+  constexpr int kNumModules = 20;
+  std::vector<ir::Module> modules;
+  for (int i = 0; i < kNumModules; i++) modules.push_back(CreateAddModule("add_" + std::to_string(i)));
+
+  utils::Timer timer;
+  timer.Start();
+  auto engine = backends::ExecutionEngine::Create({});
+  LOG(INFO) << "Create the engine: " << timer.Stop() << " ms";
+
+  std::vector<float> costs;
+  for (int i = 0; i < kNumModules; i++) {
+    timer.Start();
+    engine->Link<backends::CodeGenX86>(modules[i]);
+    // The lookup triggers the compilation.
+    ASSERT_TRUE(engine->Lookup("add_" + std::to_string(i)));
+    costs.push_back(timer.Stop());
+  }
+  float rest = 0;
+  for (int i = 1; i < kNumModules; i++) rest += costs[i];
+  LOG(INFO) << "Link the first module: " << costs[0] << " ms, the others: " << rest / (kNumModules - 1)
+            << " ms per module";
+
+  // The modules run with the runtime functions they call only.
+  auto* a = common::BufferBuilder(Float(32), {kM, kN}).set_random().Build();
+  auto* b = common::BufferBuilder(Float(32), {kM, kN}).set_random().Build();
+  auto* c = common::BufferBuilder(Float(32), {kM, kN}).set_zero().Build();
+  cinn_pod_value_t args[] = {cinn_pod_value_t(a), cinn_pod_value_t(b), cinn_pod_value_t(c)};
+  auto fn = reinterpret_cast<void (*)(void*, int32_t)>(engine->Lookup("add_" + std::to_string(kNumModules - 1)));
+  fn(args, 3);
+  auto* a_data = reinterpret_cast<float*>(a->memory);
+  auto* b_data = reinterpret_cast<float*>(b->memory);
+  auto* c_data = reinterpret_cast<float*>(c->memory);
+  for (int i = 0; i < kM * kN; i++) ASSERT_NEAR(c_data[i], a_data[i] + b_data[i], 1e-5);
+}
+
+}  // namespace tests
+}  // namespace cinn
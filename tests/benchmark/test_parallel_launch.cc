@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "cinn/runtime/cpu/thread_backend.h"
+#include "cinn/runtime/cpu/thread_backend_test_helper.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace tests {
+
+using runtime::cpu::OmpParallelLaunch;
+using runtime::cpu::SumData;
+using runtime::cpu::SumLambda;
+
+namespace {
+
+int EmptyLambda(int task_id, int num_task, void* datas) { return 0; }
+
+// Time per launch in microseconds.
+double TimeLaunch(decltype(&cinn_backend_parallel_launch) launch,
+                  FCINNParallelLambda flambda,
+                  void* datas,
+                  int num_task,
+                  int repeat) {
+  for (int i = 0; i < 10; i++) launch(flambda, datas, num_task);
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) launch(flambda, datas, num_task);
+  return timer.Stop() * 1e3 / repeat;
+}
+
+}  // namespace
+
+// Compares the launch latency and the scaling of the CINN thread pool with the OpenMP path.
+TEST(ParallelLaunch, cinn_pool_vs_openmp) {
+  const int num_threads = max_concurrency();
+  std::vector<int> task_nums;
+  for (int num_task = 1; num_task < num_threads; num_task *= 2) task_nums.push_back(num_task);
+  task_nums.push_back(num_threads);
+
+  for (int num_task : task_nums) {
+    LOG(INFO) << "Empty launch with " << num_task << " tasks, CINN pool: "
+              << TimeLaunch(cinn_backend_parallel_launch, EmptyLambda, nullptr, num_task, 10000)
+              << " us, OpenMP: " << TimeLaunch(OmpParallelLaunch, EmptyLambda, nullptr, num_task, 10000) << " us";
+  }
+
+  std::vector<float> input(1 << 22, 0.5f);
+  std::vector<double> partial_sums(num_threads);
+  SumData data{input.data(), static_cast<int>(input.size()), &partial_sums};
+  for (int num_task : task_nums) {
+    double cinn_time = TimeLaunch(cinn_backend_parallel_launch, SumLambda, &data, num_task, 20);
+    double omp_time  = TimeLaunch(OmpParallelLaunch, SumLambda, &data, num_task, 20);
+    LOG(INFO) << "Sum of " << input.size() << " floats with " << num_task << " tasks, CINN pool: " << cinn_time
+              << " us, OpenMP: " << omp_time << " us";
+  }
+}
+
+}  // namespace tests
+}  // namespace cinn